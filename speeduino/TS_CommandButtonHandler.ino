@@ -10,6 +10,8 @@
 #include "scheduledIO.h"
 #include "sensors.h"
 #include "storage.h"
+#include "pages.h"
+#include "page_crc.h"
 #ifdef USE_MC33810
   #include "acc_mc33810.h"
 #endif
@@ -358,4 +360,7 @@ void TS_CommandButtonsHandler(uint16_t buttonCommand)
     default:
       break;
   }
+
+  //The VSS calibration buttons write straight to configPage2
+  if( (buttonCommand >= TS_CMD_VSS_60KMH) && (buttonCommand <= TS_CMD_VSS_RATIO6) ) { invalidatePageCRC(veSetPage); }
 }
@@ -117,6 +117,25 @@
   #define IGN7_TIMER_DISABLE() TIMSK3 &= ~(1 << OCIE3C) //Replaces injector 3
   #define IGN8_TIMER_DISABLE() TIMSK3 &= ~(1 << OCIE3B) //Replaces injector 2
 
+  //The interrupt vector of each channels compare unit. Channels that share a compare unit cannot both be enabled (See INJ_CHANNELS / IGN_CHANNELS)
+  #define FUEL1_VECTOR TIMER3_COMPA_vect
+  #define FUEL2_VECTOR TIMER3_COMPB_vect
+  #define FUEL3_VECTOR TIMER3_COMPC_vect
+  #define FUEL4_VECTOR TIMER4_COMPB_vect
+  #define FUEL5_VECTOR TIMER4_COMPC_vect
+  #define FUEL6_VECTOR TIMER4_COMPA_vect
+  #define FUEL7_VECTOR TIMER5_COMPC_vect
+  #define FUEL8_VECTOR TIMER5_COMPB_vect
+
+  #define IGN1_VECTOR TIMER5_COMPA_vect
+  #define IGN2_VECTOR TIMER5_COMPB_vect
+  #define IGN3_VECTOR TIMER5_COMPC_vect
+  #define IGN4_VECTOR TIMER4_COMPA_vect
+  #define IGN5_VECTOR TIMER4_COMPC_vect
+  #define IGN6_VECTOR TIMER4_COMPB_vect
+  #define IGN7_VECTOR TIMER3_COMPC_vect
+  #define IGN8_VECTOR TIMER3_COMPB_vect
+
   #define MAX_TIMER_PERIOD 262140UL //The longest period of time (in uS) that the timer can permit (IN this case it is 65535 * 4, as each timer tick is 4uS)
   #define uS_TO_TIMER_COMPARE(uS1) ((uS1) >> 2) //Converts a given number of uS into the required number of timer ticks until that time has passed
 
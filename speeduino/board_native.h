@@ -0,0 +1,155 @@
+#ifndef NATIVE_H
+#define NATIVE_H
+#if defined(CORE_NATIVE)
+
+/*
+***********************************************************************************************************
+* General
+* The native 'board' runs the firmware on the build host (See src/native/Arduino.h). It has no real hardware, instead the timers
+* are simulated from the (also simulated) micros() clock. Time only moves when nativeAdvanceTime() is called.
+*/
+  #define PORT_TYPE uint8_t //Size of the port variables (Eg inj1_pin_port).
+  #define PINMASK_TYPE uint8_t
+  #define COMPARE_TYPE uint16_t
+  #define COUNTER_TYPE uint16_t
+  #define EEPROM_LIB_H <EEPROM.h> //RAM backed, see src/native/EEPROM.h
+  void initBoard();
+  uint16_t freeRam();
+  void doSystemReset();
+  void jumpToBootloader();
+
+  #define micros_safe() micros() //There are no interrupts on the host, so micros() is always safe
+  #define pinIsReserved(pin)  ( ((pin) == 0) ) //Forbiden pins like USB on other boards
+
+/*
+***********************************************************************************************************
+* Schedules
+* All compare channels share a single simulated 16-bit counter that ticks every 4uS (The same as the Mega 2560)
+*/
+  #define NATIVE_TIMER_COUNTER ((COUNTER_TYPE)(micros() >> 2))
+  #define NATIVE_FUEL_CHANNELS 8
+  #define NATIVE_IGN_CHANNELS 8
+
+  extern volatile COMPARE_TYPE nativeFuelCompare[NATIVE_FUEL_CHANNELS];
+  extern volatile COMPARE_TYPE nativeIgnCompare[NATIVE_IGN_CHANNELS];
+  extern volatile bool nativeFuelTimerEnabled[NATIVE_FUEL_CHANNELS];
+  extern volatile bool nativeIgnTimerEnabled[NATIVE_IGN_CHANNELS];
+
+  #define FUEL1_COUNTER NATIVE_TIMER_COUNTER
+  #define FUEL2_COUNTER NATIVE_TIMER_COUNTER
+  #define FUEL3_COUNTER NATIVE_TIMER_COUNTER
+  #define FUEL4_COUNTER NATIVE_TIMER_COUNTER
+  #define FUEL5_COUNTER NATIVE_TIMER_COUNTER
+  #define FUEL6_COUNTER NATIVE_TIMER_COUNTER
+  #define FUEL7_COUNTER NATIVE_TIMER_COUNTER
+  #define FUEL8_COUNTER NATIVE_TIMER_COUNTER
+
+  #define IGN1_COUNTER  NATIVE_TIMER_COUNTER
+  #define IGN2_COUNTER  NATIVE_TIMER_COUNTER
+  #define IGN3_COUNTER  NATIVE_TIMER_COUNTER
+  #define IGN4_COUNTER  NATIVE_TIMER_COUNTER
+  #define IGN5_COUNTER  NATIVE_TIMER_COUNTER
+  #define IGN6_COUNTER  NATIVE_TIMER_COUNTER
+  #define IGN7_COUNTER  NATIVE_TIMER_COUNTER
+  #define IGN8_COUNTER  NATIVE_TIMER_COUNTER
+
+  #define FUEL1_COMPARE nativeFuelCompare[0]
+  #define FUEL2_COMPARE nativeFuelCompare[1]
+  #define FUEL3_COMPARE nativeFuelCompare[2]
+  #define FUEL4_COMPARE nativeFuelCompare[3]
+  #define FUEL5_COMPARE nativeFuelCompare[4]
+  #define FUEL6_COMPARE nativeFuelCompare[5]
+  #define FUEL7_COMPARE nativeFuelCompare[6]
+  #define FUEL8_COMPARE nativeFuelCompare[7]
+
+  #define IGN1_COMPARE  nativeIgnCompare[0]
+  #define IGN2_COMPARE  nativeIgnCompare[1]
+  #define IGN3_COMPARE  nativeIgnCompare[2]
+  #define IGN4_COMPARE  nativeIgnCompare[3]
+  #define IGN5_COMPARE  nativeIgnCompare[4]
+  #define IGN6_COMPARE  nativeIgnCompare[5]
+  #define IGN7_COMPARE  nativeIgnCompare[6]
+  #define IGN8_COMPARE  nativeIgnCompare[7]
+
+  #define FUEL1_TIMER_ENABLE() nativeFuelTimerEnabled[0] = true
+  #define FUEL2_TIMER_ENABLE() nativeFuelTimerEnabled[1] = true
+  #define FUEL3_TIMER_ENABLE() nativeFuelTimerEnabled[2] = true
+  #define FUEL4_TIMER_ENABLE() nativeFuelTimerEnabled[3] = true
+  #define FUEL5_TIMER_ENABLE() nativeFuelTimerEnabled[4] = true
+  #define FUEL6_TIMER_ENABLE() nativeFuelTimerEnabled[5] = true
+  #define FUEL7_TIMER_ENABLE() nativeFuelTimerEnabled[6] = true
+  #define FUEL8_TIMER_ENABLE() nativeFuelTimerEnabled[7] = true
+
+  #define FUEL1_TIMER_DISABLE() nativeFuelTimerEnabled[0] = false
+  #define FUEL2_TIMER_DISABLE() nativeFuelTimerEnabled[1] = false
+  #define FUEL3_TIMER_DISABLE() nativeFuelTimerEnabled[2] = false
+  #define FUEL4_TIMER_DISABLE() nativeFuelTimerEnabled[3] = false
+  #define FUEL5_TIMER_DISABLE() nativeFuelTimerEnabled[4] = false
+  #define FUEL6_TIMER_DISABLE() nativeFuelTimerEnabled[5] = false
+  #define FUEL7_TIMER_DISABLE() nativeFuelTimerEnabled[6] = false
+  #define FUEL8_TIMER_DISABLE() nativeFuelTimerEnabled[7] = false
+
+  #define IGN1_TIMER_ENABLE() nativeIgnTimerEnabled[0] = true
+  #define IGN2_TIMER_ENABLE() nativeIgnTimerEnabled[1] = true
+  #define IGN3_TIMER_ENABLE() nativeIgnTimerEnabled[2] = true
+  #define IGN4_TIMER_ENABLE() nativeIgnTimerEnabled[3] = true
+  #define IGN5_TIMER_ENABLE() nativeIgnTimerEnabled[4] = true
+  #define IGN6_TIMER_ENABLE() nativeIgnTimerEnabled[5] = true
+  #define IGN7_TIMER_ENABLE() nativeIgnTimerEnabled[6] = true
+  #define IGN8_TIMER_ENABLE() nativeIgnTimerEnabled[7] = true
+
+  #define IGN1_TIMER_DISABLE() nativeIgnTimerEnabled[0] = false
+  #define IGN2_TIMER_DISABLE() nativeIgnTimerEnabled[1] = false
+  #define IGN3_TIMER_DISABLE() nativeIgnTimerEnabled[2] = false
+  #define IGN4_TIMER_DISABLE() nativeIgnTimerEnabled[3] = false
+  #define IGN5_TIMER_DISABLE() nativeIgnTimerEnabled[4] = false
+  #define IGN6_TIMER_DISABLE() nativeIgnTimerEnabled[5] = false
+  #define IGN7_TIMER_DISABLE() nativeIgnTimerEnabled[6] = false
+  #define IGN8_TIMER_DISABLE() nativeIgnTimerEnabled[7] = false
+
+  #define MAX_TIMER_PERIOD 262140UL //The longest period of time (in uS) that the timer can permit (IN this case it is 65535 * 4, as each timer tick is 4uS)
+  #define uS_TO_TIMER_COMPARE(uS1) ((uS1) >> 2) //Converts a given number of uS into the required number of timer ticks until that time has passed
+
+  /**
+   * Moves the simulated clock forward by the given number of uS.
+   * Every enabled compare channel that matches along the way has its ISR called, in time order, with micros() set to the match time.
+   * The 1ms timer interrupt (oneMSInterval()) is also run for every whole ms that passes.
+   */
+  void nativeAdvanceTime(unsigned long uS);
+
+/*
+***********************************************************************************************************
+* Auxilliaries
+* Boost, VVT and idle PWM are not simulated. The registers exist only so that the code compiles
+*/
+  extern volatile COMPARE_TYPE nativeAuxCompare[3];
+
+  #define ENABLE_BOOST_TIMER()
+  #define DISABLE_BOOST_TIMER()
+
+  #define ENABLE_VVT_TIMER()
+  #define DISABLE_VVT_TIMER()
+
+  #define BOOST_TIMER_COMPARE   nativeAuxCompare[0]
+  #define BOOST_TIMER_COUNTER   NATIVE_TIMER_COUNTER
+  #define VVT_TIMER_COMPARE     nativeAuxCompare[1]
+  #define VVT_TIMER_COUNTER     NATIVE_TIMER_COUNTER
+
+/*
+***********************************************************************************************************
+* Idle
+*/
+  #define IDLE_COUNTER          NATIVE_TIMER_COUNTER
+  #define IDLE_COMPARE          nativeAuxCompare[2]
+
+  #define IDLE_TIMER_ENABLE()
+  #define IDLE_TIMER_DISABLE()
+
+/*
+***********************************************************************************************************
+* CAN / Second serial
+* Not available on the native board
+*/
+
+#endif //CORE_NATIVE
+#endif //NATIVE_H
@@ -0,0 +1,122 @@
+#if defined(CORE_NATIVE)
+#include "globals.h"
+#include "scheduler.h"
+#include "timers.h"
+
+volatile COMPARE_TYPE nativeFuelCompare[NATIVE_FUEL_CHANNELS];
+volatile COMPARE_TYPE nativeIgnCompare[NATIVE_IGN_CHANNELS];
+volatile bool nativeFuelTimerEnabled[NATIVE_FUEL_CHANNELS];
+volatile bool nativeIgnTimerEnabled[NATIVE_IGN_CHANNELS];
+volatile COMPARE_TYPE nativeAuxCompare[3];
+
+static void (* const nativeFuelISR[NATIVE_FUEL_CHANNELS])() =
+{
+  fuelSchedule1Interrupt, fuelSchedule2Interrupt, fuelSchedule3Interrupt, fuelSchedule4Interrupt,
+  fuelSchedule5Interrupt, fuelSchedule6Interrupt, fuelSchedule7Interrupt, fuelSchedule8Interrupt,
+};
+static void (* const nativeIgnISR[NATIVE_IGN_CHANNELS])() =
+{
+  ignitionSchedule1Interrupt, ignitionSchedule2Interrupt, ignitionSchedule3Interrupt, ignitionSchedule4Interrupt,
+  ignitionSchedule5Interrupt, ignitionSchedule6Interrupt, ignitionSchedule7Interrupt, ignitionSchedule8Interrupt,
+};
+
+void initBoard()
+{
+    /*
+    ***********************************************************************************************************
+    * General
+    */
+    setMicros(0);
+
+    /*
+    ***********************************************************************************************************
+    * Timers
+    */
+
+    /*
+    ***********************************************************************************************************
+    * Auxilliaries
+    */
+
+    /*
+    ***********************************************************************************************************
+    * Idle
+    */
+
+    /*
+    ***********************************************************************************************************
+    * Schedules
+    */
+    for(byte x = 0; x < NATIVE_FUEL_CHANNELS; x++) { nativeFuelTimerEnabled[x] = false; }
+    for(byte x = 0; x < NATIVE_IGN_CHANNELS; x++) { nativeIgnTimerEnabled[x] = false; }
+}
+
+/*
+ * Returns the number of timer ticks until the counter next matches the given compare value.
+ * A match on the current tick has already fired, so it is a full timer period away.
+ */
+static inline uint32_t ticksToCompare(COMPARE_TYPE compare, COUNTER_TYPE counter)
+{
+  COUNTER_TYPE ticks = (COUNTER_TYPE)(compare - counter);
+  return (ticks == 0) ? 0x10000UL : ticks;
+}
+
+void nativeAdvanceTime(unsigned long uS)
+{
+  unsigned long endTime = micros() + uS;
+
+  while(micros() < endTime)
+  {
+    //Find the time of the next event. This is either a compare match on one of the enabled channels or the next ms tick
+    unsigned long now = micros();
+    unsigned long nextEvent = ((now / 1000UL) + 1UL) * 1000UL;
+    COUNTER_TYPE counter = NATIVE_TIMER_COUNTER;
+    unsigned long tickStart = now - (now & 3UL); //Start of the current 4uS tick
+
+    for(byte x = 0; x < NATIVE_FUEL_CHANNELS; x++)
+    {
+      if(nativeFuelTimerEnabled[x] == true)
+      {
+        unsigned long matchTime = tickStart + (ticksToCompare(nativeFuelCompare[x], counter) << 2);
+        if(matchTime < nextEvent) { nextEvent = matchTime; }
+      }
+    }
+    for(byte x = 0; x < NATIVE_IGN_CHANNELS; x++)
+    {
+      if(nativeIgnTimerEnabled[x] == true)
+      {
+        unsigned long matchTime = tickStart + (ticksToCompare(nativeIgnCompare[x], counter) << 2);
+        if(matchTime < nextEvent) { nextEvent = matchTime; }
+      }
+    }
+
+    if(nextEvent > endTime)
+    {
+      setMicros(endTime);
+      break;
+    }
+    setMicros(nextEvent);
+
+    //Fire everything that matches at this time. The ISRs can enable/move other channels, but a new match cannot be on the current tick
+    counter = NATIVE_TIMER_COUNTER;
+    for(byte x = 0; x < NATIVE_FUEL_CHANNELS; x++)
+    {
+      if( (nativeFuelTimerEnabled[x] == true) && (nativeFuelCompare[x] == counter) ) { nativeFuelISR[x](); }
+    }
+    for(byte x = 0; x < NATIVE_IGN_CHANNELS; x++)
+    {
+      if( (nativeIgnTimerEnabled[x] == true) && (nativeIgnCompare[x] == counter) ) { nativeIgnISR[x](); }
+    }
+    if( (nextEvent % 1000UL) == 0) { oneMSInterval(); }
+  }
+}
+
+uint16_t freeRam()
+{
+  return 0xFFFF; //Host memory is effectively unlimited
+}
+
+void doSystemReset() { return; }
+void jumpToBootloader() { return; }
+
+#endif
@@ -17,6 +17,8 @@ A full copy of the license may be found in the projects root directory
 #include "errors.h"
 #include "pages.h"
 #include "page_crc.h"
+#include "comms_frame.h"
+#include "scheduler.h"
 #include "table_iterator.h"
 #ifdef RTC_ENABLED
   #include "rtc_common.h"
@@ -38,6 +40,15 @@ uint32_t inProgressCompositeTime;
 bool serialInProgress = false;
 bool toothLogSendInProgress = false;
 bool compositeLogSendInProgress = false;
+static bool calibrationPending = false; /**< Whether the table ID of a 't' command has been received and its data is now being received */
+
+/** State of the calibration table that is being received. See receiveCalibration() */
+static struct
+{
+  byte tableID;
+  uint16_t received; /**< Number of bytes of the table received so far */
+  byte valueLow; /**< Low byte of the temperature value that is being received */
+} calibration;
 
 /** Processes the incoming data on the serial buffer based on the command sent.
 Can be either data for a new command or a continuation of data for command that is already in progress:
@@ -119,39 +130,45 @@ void command()
       {
         byte cmdGroup = Serial.read();
         byte cmdValue = Serial.read();
-        uint16_t cmdCombined = word(cmdGroup, cmdValue);
-
-        if ( ((cmdCombined >= TS_CMD_INJ1_ON) && (cmdCombined <= TS_CMD_IGN8_50PC)) || (cmdCombined == TS_CMD_TEST_ENBL) || (cmdCombined == TS_CMD_TEST_DSBL) )
-        {
-          //Hardware test buttons
-          if (currentStatus.RPM == 0) { TS_CommandButtonsHandler(cmdCombined); }
-          cmdPending = false;
-        }
-        else if( (cmdCombined >= TS_CMD_VSS_60KMH) && (cmdCombined <= TS_CMD_VSS_RATIO6) )
-        {
-          //VSS Calibration commands
-          TS_CommandButtonsHandler(cmdCombined);
-          cmdPending = false;
-        }
-        else if( (cmdCombined >= TS_CMD_STM32_REBOOT) && (cmdCombined <= TS_CMD_STM32_BOOTLOADER) )
-        {
-          //STM32 DFU mode button
-          TS_CommandButtonsHandler(cmdCombined);
-          cmdPending = false;
-        }
+        processCommandButton(word(cmdGroup, cmdValue));
+        cmdPending = false;
       }
       break;
 
     case 'F': // send serial protocol version
-      Serial.print(F("001"));
+      Serial.print(F(TS_PROTOCOL_VERSION));
+      break;
+
+    case 'g': // Send the timing accuracy histogram of a fuel or ignition schedule. Command structure: "g", <channel> (0-7 = fuel 1-8, 8-15 = ignition 1-8, add 0x80 to clear the histogram once it is sent)
+      cmdPending = true;
+
+      if (Serial.available() >= 1)
+      {
+        byte channel = Serial.read();
+        struct scheduleAccuracy accuracy;
+        if( getScheduleAccuracy((channel & 0x7F), accuracy, (channel & 0x80)) == false ) { memset(&accuracy, 0, sizeof(accuracy)); } //Channels this board doesn't have, and builds without SCHEDULE_ACCURACY, return all 0s
+
+        //The number of timer ticks in 1ms, so that the histogram can be converted to time
+        uint16_t ticksPerMs = uS_TO_TIMER_COMPARE(1000UL);
+        Serial.write(lowByte(ticksPerMs));
+        Serial.write(highByte(ticksPerMs));
+        uint16_t maxLate = (uint16_t)min((uint32_t)accuracy.maxLate, (uint32_t)UINT16_MAX); //Some boards have 32-bit compares
+        Serial.write(lowByte(maxLate));
+        Serial.write(highByte(maxLate));
+        for(byte x = 0; x < SCHEDULE_ACCURACY_BINS; x++)
+        {
+          Serial.write(lowByte(accuracy.lateCount[x]));
+          Serial.write(highByte(accuracy.lateCount[x]));
+        }
+
+        cmdPending = false;
+      }
       break;
 
     case 'H': //Start the tooth logger
       currentStatus.toothLogEnabled = true;
       currentStatus.compositeLogEnabled = false; //Safety first (Should never be required)
-      BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
-      toothHistoryIndex = 0;
-      toothHistorySerialIndex = 0;
+      resetToothLog();
 
       //Disconnect the standard interrupt and add the logger version
       detachInterrupt( digitalPinToInterrupt(pinTrigger) );
@@ -168,19 +185,17 @@ void command()
 
       //Disconnect the logger interrupts and attach the normal ones
       detachInterrupt( digitalPinToInterrupt(pinTrigger) );
-      attachInterrupt( digitalPinToInterrupt(pinTrigger), triggerHandler, primaryTriggerEdge );
+      attachInterrupt( digitalPinToInterrupt(pinTrigger), triggerPrimaryISR, primaryTriggerEdge );
 
       detachInterrupt( digitalPinToInterrupt(pinTrigger2) );
-      attachInterrupt( digitalPinToInterrupt(pinTrigger2), triggerSecondaryHandler, secondaryTriggerEdge );
+      attachInterrupt( digitalPinToInterrupt(pinTrigger2), triggerSecondaryISR, secondaryTriggerEdge );
       break;
 
     case 'J': //Start the composite logger
       currentStatus.compositeLogEnabled = true;
       currentStatus.toothLogEnabled = false; //Safety first (Should never be required)
-      BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
-      toothHistoryIndex = 0;
-      toothHistorySerialIndex = 0;
-      compositeLastToothTime = 0;
+      resetToothLog();
+      inProgressCompositeTime = 0;
 
       //Disconnect the standard interrupt and add the logger version
       detachInterrupt( digitalPinToInterrupt(pinTrigger) );
@@ -197,10 +212,43 @@ void command()
 
       //Disconnect the logger interrupts and attach the normal ones
       detachInterrupt( digitalPinToInterrupt(pinTrigger) );
-      attachInterrupt( digitalPinToInterrupt(pinTrigger), triggerHandler, primaryTriggerEdge );
+      attachInterrupt( digitalPinToInterrupt(pinTrigger), triggerPrimaryISR, primaryTriggerEdge );
 
       detachInterrupt( digitalPinToInterrupt(pinTrigger2) );
-      attachInterrupt( digitalPinToInterrupt(pinTrigger2), triggerSecondaryHandler, secondaryTriggerEdge );
+      attachInterrupt( digitalPinToInterrupt(pinTrigger2), triggerSecondaryISR, secondaryTriggerEdge );
+      break;
+
+    case 'k': // Send the record of the last sync loss. Command structure: "k", <clear> (1 to clear the record once it is sent, so that the next sync loss is recorded)
+      cmdPending = true;
+
+      if (Serial.available() >= 1)
+      {
+        byte clear = Serial.read();
+        const struct syncLossRecord &record = lockSyncLossRecord(); //Sent in place rather than copied onto the stack
+
+        Serial.write(record.reason);
+        Serial.write(record.decoder);
+        Serial.write(record.syncLossCounter);
+        Serial.write(record.postEdges);
+        Serial.write(lowByte(record.RPM));
+        Serial.write(highByte(record.RPM));
+        Serial.write(record.secondaryToothCount);
+        Serial.write(record.revolutionOne);
+        Serial.write(record.time);
+        Serial.write(record.time >> 8);
+        Serial.write(record.time >> 16);
+        Serial.write(record.time >> 24);
+        for(byte x = 0; x < (SYNC_LOSS_PRE_TEETH + SYNC_LOSS_POST_TEETH); x++)
+        {
+          Serial.write(lowByte(record.edges[x].gap));
+          Serial.write(highByte(record.edges[x].gap));
+          Serial.write(record.edges[x].tooth);
+          Serial.write(record.edges[x].flags);
+        }
+        unlockSyncLossRecord(clear == 1);
+
+        cmdPending = false;
+      }
       break;
 
     case 'L': // List the contents of current page in human readable form
@@ -273,9 +321,13 @@ void command()
         length1 = Serial.read();
         length2 = Serial.read();
         length = word(length2, length1);
-        for(int i = 0; i < length; i++)
+
+        byte values[32];
+        for(int i = 0; i < length; i += sizeof(values))
         {
-          Serial.write( getPageValue(tempPage, valueOffset + i) );
+          uint16_t count = min(length - i, (int)sizeof(values));
+          getPageValues(tempPage, valueOffset + i, values, count);
+          Serial.write(values, count);
         }
 
         cmdPending = false;
@@ -283,7 +335,7 @@ void command()
       break;
 
     case 'Q': // send code version
-      Serial.print(F("speeduino 202104-dev"));
+      Serial.print(F(TS_SIGNATURE));
       break;
 
     case 'r': //New format for the optimised OutputChannels
@@ -443,7 +495,7 @@ void command()
       break;
 
     case 'S': // send code version
-      Serial.print(F("Speeduino 2021.04-dev"));
+      Serial.print(F(TS_FIRMWARE_VERSION));
       currentStatus.secl = 0; //This is required in TS3 due to its stricter timings
       break;
 
@@ -473,16 +525,25 @@ void command()
       break;
 
     case 't': // receive new Calibration info. Command structure: "t", <tble_idx> <data array>.
-      byte tableID;
-      //byte canID;
-
-      //The first 2 bytes sent represent the canID and tableID
-      while (Serial.available() == 0) { }
-      tableID = Serial.read(); //Not currently used for anything
-
-      receiveCalibration(tableID); //Receive new values and store in memory
-      writeCalibration(); //Store received values in EEPROM
+      //The table is taken in as it arrives, so the main loop keeps running for the whole transfer
+      if (cmdPending == false) { calibrationPending = false; }
+      cmdPending = true;
 
+      if( (calibrationPending == false) && (Serial.available() > 0) )
+      {
+        beginCalibration(Serial.read());
+        calibrationPending = true;
+      }
+      while( (calibrationPending == true) && (Serial.available() > 0) )
+      {
+        byte value = Serial.read();
+        if(receiveCalibration(&value, 1) == true)
+        {
+          writeCalibration(); //Store received values in EEPROM
+          calibrationPending = false;
+          cmdPending = false;
+        }
+      }
       break;
 
     case 'U': //User wants to reset the Arduino (probably for FW update)
@@ -492,8 +553,13 @@ void command()
         if (!cmdPending) { Serial.println(F("Comms halted. Next byte will reset the Arduino.")); }
       #endif
 
-        while (Serial.available() == 0) { }
-        digitalWrite(pinResetControl, LOW);
+        cmdPending = true;
+        if (Serial.available() > 0)
+        {
+          Serial.read();
+          digitalWrite(pinResetControl, LOW);
+          cmdPending = false;
+        }
       }
       else
       {
@@ -567,11 +633,15 @@ void command()
       //This CANNOT be an else of the above if statement as chunkPending gets set to true above
       if(chunkPending == true)
       { 
-        while( (Serial.available() > 0) && (chunkComplete < chunkSize) )
+        //Take whatever has arrived so far and write it to the page as a block
+        byte values[32];
+        uint16_t count = 0;
+        while( (Serial.available() > 0) && (count < sizeof(values)) && ((chunkComplete + count) < chunkSize) )
         {
-          setPageValue(currentPage, (valueOffset + chunkComplete), Serial.read());
-          chunkComplete++;
+          values[count++] = Serial.read();
         }
+        setPageValues(currentPage, (valueOffset + chunkComplete), values, count);
+        chunkComplete += count;
         if(chunkComplete >= chunkSize) { cmdPending = false; chunkPending = false; }
       }
       break;
@@ -714,6 +784,7 @@ void command()
 
       if (Serial.available() >= 1) {
         configPage4.bootloaderCaps = Serial.read();
+        invalidatePageCRC(ignSetPage);
         cmdPending = false;
       }
       break;
@@ -733,6 +804,8 @@ void command()
          "B - Burn current map and configPage values to eeprom\n"
          "C - Test COM port.  Used by Tunerstudio to see whether an ECU is on a given serial \n"
          "    port. Returns a binary number.\n"
+         "g - Send the timing accuracy histogram of a schedule.  Syntax:  g+<channel>\n"
+         "k - Send the record of the last sync loss.  Syntax:  k+<clear>\n"
          "N - Print new line.\n"
          "P - Set current page.  Syntax:  P+<pageNumber>\n"
          "R - Same as A command\n"
@@ -757,173 +830,6 @@ void command()
       break;
   }
 }
-/** Send a numbered byte-field (partial field in case of mul;ti-byte fields) from "current status" structure.
- * Notes on fields:
- * - Numbered field will be fields from @ref currentStatus, but not at all in the internal order of strct (e.g. field RPM value, number 14 will be
- *   2nd field in struct)
- * - The fields stored in multi-byte types will be accessed lowbyte and highbyte separately (e.g. PW1 will be broken into numbered byte-fields 75,76)
- * @param byteNum - byte-Field number
- * @return Field value in 1 byte size struct fields or 1 byte partial value (chunk) on multibyte fields.
- */
-byte getStatusEntry(uint16_t byteNum)
-{
-  byte statusValue = 0;
-
-  switch(byteNum)
-  {
-    case 0: statusValue = currentStatus.secl; break; //secl is simply a counter that increments each second. Used to track unexpected resets (Which will reset this count to 0)
-    case 1: statusValue = currentStatus.status1; break; //status1 Bitfield
-    case 2: statusValue = currentStatus.engine; break; //Engine Status Bitfield
-    case 3: statusValue = currentStatus.syncLossCounter; break;
-    case 4: statusValue = lowByte(currentStatus.MAP); break; //2 bytes for MAP
-    case 5: statusValue = highByte(currentStatus.MAP); break;
-    case 6: statusValue = (byte)(currentStatus.IAT + CALIBRATION_TEMPERATURE_OFFSET); break; //mat
-    case 7: statusValue = (byte)(currentStatus.coolant + CALIBRATION_TEMPERATURE_OFFSET); break; //Coolant ADC
-    case 8: statusValue = currentStatus.batCorrection; break; //Battery voltage correction (%)
-    case 9: statusValue = currentStatus.battery10; break; //battery voltage
-    case 10: statusValue = currentStatus.O2; break; //O2
-    case 11: statusValue = currentStatus.egoCorrection; break; //Exhaust gas correction (%)
-    case 12: statusValue = currentStatus.iatCorrection; break; //Air temperature Correction (%)
-    case 13: statusValue = currentStatus.wueCorrection; break; //Warmup enrichment (%)
-    case 14: statusValue = lowByte(currentStatus.RPM); break; //rpm HB
-    case 15: statusValue = highByte(currentStatus.RPM); break; //rpm LB
-    case 16: statusValue = (byte)(currentStatus.AEamount >> 1); break; //TPS acceleration enrichment (%) divided by 2 (Can exceed 255)
-    case 17: statusValue = lowByte(currentStatus.corrections); break; //Total GammaE (%)
-    case 18: statusValue = highByte(currentStatus.corrections); break; //Total GammaE (%)
-    case 19: statusValue = currentStatus.VE1; break; //VE 1 (%)
-    case 20: statusValue = currentStatus.VE2; break; //VE 2 (%)
-    case 21: statusValue = currentStatus.afrTarget; break;
-    case 22: statusValue = currentStatus.tpsDOT; break; //TPS DOT
-    case 23: statusValue = currentStatus.advance; break;
-    case 24: statusValue = currentStatus.TPS; break; // TPS (0% to 100%)
-    
-    case 25: 
-      if(currentStatus.loopsPerSecond > 60000) { currentStatus.loopsPerSecond = 60000;}
-      statusValue = lowByte(currentStatus.loopsPerSecond); 
-      break;
-    case 26: 
-      if(currentStatus.loopsPerSecond > 60000) { currentStatus.loopsPerSecond = 60000;}
-      statusValue = highByte(currentStatus.loopsPerSecond); 
-      break;
-    
-    case 27: 
-      currentStatus.freeRAM = freeRam();
-      statusValue = lowByte(currentStatus.freeRAM); //(byte)((currentStatus.loopsPerSecond >> 8) & 0xFF);
-      break; 
-    case 28: 
-      currentStatus.freeRAM = freeRam();
-      statusValue = highByte(currentStatus.freeRAM); 
-      break;
-
-    case 29: statusValue = (byte)(currentStatus.boostTarget >> 1); break; //Divide boost target by 2 to fit in a byte
-    case 30: statusValue = (byte)(currentStatus.boostDuty / 100); break;
-    case 31: statusValue = currentStatus.spark; break; //Spark related bitfield
-
-    //rpmDOT must be sent as a signed integer
-    case 32: statusValue = lowByte(currentStatus.rpmDOT); break;
-    case 33: statusValue = highByte(currentStatus.rpmDOT); break;
-
-    case 34: statusValue = currentStatus.ethanolPct; break; //Flex sensor value (or 0 if not used)
-    case 35: statusValue = currentStatus.flexCorrection; break; //Flex fuel correction (% above or below 100)
-    case 36: statusValue = currentStatus.flexIgnCorrection; break; //Ignition correction (Increased degrees of advance) for flex fuel
-
-    case 37: statusValue = currentStatus.idleLoad; break;
-    case 38: statusValue = currentStatus.testOutputs; break;
-
-    case 39: statusValue = currentStatus.O2_2; break; //O2
-    case 40: statusValue = currentStatus.baro; break; //Barometer value
-
-    case 41: statusValue = lowByte(currentStatus.canin[0]); break;
-    case 42: statusValue = highByte(currentStatus.canin[0]); break;
-    case 43: statusValue = lowByte(currentStatus.canin[1]); break;
-    case 44: statusValue = highByte(currentStatus.canin[1]); break;
-    case 45: statusValue = lowByte(currentStatus.canin[2]); break;
-    case 46: statusValue = highByte(currentStatus.canin[2]); break;
-    case 47: statusValue = lowByte(currentStatus.canin[3]); break;
-    case 48: statusValue = highByte(currentStatus.canin[3]); break;
-    case 49: statusValue = lowByte(currentStatus.canin[4]); break;
-    case 50: statusValue = highByte(currentStatus.canin[4]); break;
-    case 51: statusValue = lowByte(currentStatus.canin[5]); break;
-    case 52: statusValue = highByte(currentStatus.canin[5]); break;
-    case 53: statusValue = lowByte(currentStatus.canin[6]); break;
-    case 54: statusValue = highByte(currentStatus.canin[6]); break;
-    case 55: statusValue = lowByte(currentStatus.canin[7]); break;
-    case 56: statusValue = highByte(currentStatus.canin[7]); break;
-    case 57: statusValue = lowByte(currentStatus.canin[8]); break;
-    case 58: statusValue = highByte(currentStatus.canin[8]); break;
-    case 59: statusValue = lowByte(currentStatus.canin[9]); break;
-    case 60: statusValue = highByte(currentStatus.canin[9]); break;
-    case 61: statusValue = lowByte(currentStatus.canin[10]); break;
-    case 62: statusValue = highByte(currentStatus.canin[10]); break;
-    case 63: statusValue = lowByte(currentStatus.canin[11]); break;
-    case 64: statusValue = highByte(currentStatus.canin[11]); break;
-    case 65: statusValue = lowByte(currentStatus.canin[12]); break;
-    case 66: statusValue = highByte(currentStatus.canin[12]); break;
-    case 67: statusValue = lowByte(currentStatus.canin[13]); break;
-    case 68: statusValue = highByte(currentStatus.canin[13]); break;
-    case 69: statusValue = lowByte(currentStatus.canin[14]); break;
-    case 70: statusValue = highByte(currentStatus.canin[14]); break;
-    case 71: statusValue = lowByte(currentStatus.canin[15]); break;
-    case 72: statusValue = highByte(currentStatus.canin[15]); break;
-
-    case 73: statusValue = currentStatus.tpsADC; break;
-    case 74: statusValue = getNextError(); break;
-
-    case 75: statusValue = lowByte(currentStatus.PW1); break; //Pulsewidth 1 multiplied by 10 in ms. Have to convert from uS to mS.
-    case 76: statusValue = highByte(currentStatus.PW1); break; //Pulsewidth 1 multiplied by 10 in ms. Have to convert from uS to mS.
-    case 77: statusValue = lowByte(currentStatus.PW2); break; //Pulsewidth 2 multiplied by 10 in ms. Have to convert from uS to mS.
-    case 78: statusValue = highByte(currentStatus.PW2); break; //Pulsewidth 2 multiplied by 10 in ms. Have to convert from uS to mS.
-    case 79: statusValue = lowByte(currentStatus.PW3); break; //Pulsewidth 3 multiplied by 10 in ms. Have to convert from uS to mS.
-    case 80: statusValue = highByte(currentStatus.PW3); break; //Pulsewidth 3 multiplied by 10 in ms. Have to convert from uS to mS.
-    case 81: statusValue = lowByte(currentStatus.PW4); break; //Pulsewidth 4 multiplied by 10 in ms. Have to convert from uS to mS.
-    case 82: statusValue = highByte(currentStatus.PW4); break; //Pulsewidth 4 multiplied by 10 in ms. Have to convert from uS to mS.
-
-    case 83: statusValue = currentStatus.status3; break;
-    case 84: statusValue = currentStatus.engineProtectStatus; break;
-    case 85: statusValue = lowByte(currentStatus.fuelLoad); break;
-    case 86: statusValue = highByte(currentStatus.fuelLoad); break;
-    case 87: statusValue = lowByte(currentStatus.ignLoad); break;
-    case 88: statusValue = highByte(currentStatus.ignLoad); break;
-    case 89: statusValue = lowByte(currentStatus.dwell); break;
-    case 90: statusValue = highByte(currentStatus.dwell); break;
-    case 91: statusValue = currentStatus.CLIdleTarget; break;
-    case 92: statusValue = currentStatus.mapDOT; break;
-    case 93: statusValue = lowByte(currentStatus.vvt1Angle); break; //2 bytes for vvt1Angle
-    case 94: statusValue = highByte(currentStatus.vvt1Angle); break;
-    case 95: statusValue = currentStatus.vvt1TargetAngle; break;
-    case 96: statusValue = (byte)(currentStatus.vvt1Duty); break;
-    case 97: statusValue = lowByte(currentStatus.flexBoostCorrection); break;
-    case 98: statusValue = highByte(currentStatus.flexBoostCorrection); break;
-    case 99: statusValue = currentStatus.baroCorrection; break;
-    case 100: statusValue = currentStatus.VE; break; //Current VE (%). Can be equal to VE1 or VE2 or a calculated value from both of them
-    case 101: statusValue = currentStatus.ASEValue; break; //Current ASE (%)
-    case 102: statusValue = lowByte(currentStatus.vss); break;
-    case 103: statusValue = highByte(currentStatus.vss); break;
-    case 104: statusValue = currentStatus.gear; break;
-    case 105: statusValue = currentStatus.fuelPressure; break;
-    case 106: statusValue = currentStatus.oilPressure; break;
-    case 107: statusValue = currentStatus.wmiPW; break;
-    case 108: statusValue = currentStatus.status4; break;
-    case 109: statusValue = lowByte(currentStatus.vvt2Angle); break; //2 bytes for vvt2Angle
-    case 110: statusValue = highByte(currentStatus.vvt2Angle); break;
-    case 111: statusValue = currentStatus.vvt2TargetAngle; break;
-    case 112: statusValue = (byte)(currentStatus.vvt2Duty); break;
-    case 113: statusValue = currentStatus.outputsStatus; break;
-    case 114: statusValue = (byte)(currentStatus.fuelTemp + CALIBRATION_TEMPERATURE_OFFSET); break; //Fuel temperature from flex sensor
-    case 115: statusValue = currentStatus.fuelTempCorrection; break; //Fuel temperature Correction (%)
-    case 116: statusValue = currentStatus.advance1; break; //advance 1 (%)
-    case 117: statusValue = currentStatus.advance2; break; //advance 2 (%)
-    case 118: statusValue = currentStatus.TS_SD_Status; break; //SD card status
-    case 119: statusValue = lowByte(currentStatus.EMAP); break; //2 bytes for EMAP
-    case 120: statusValue = highByte(currentStatus.EMAP); break;
-  }
-
-  return statusValue;
-
-  //Each new inclusion here need to be added on speeduino.ini@L78, only list first byte of an integer and second byte as "INVALID"
-  //Every 2-byte integer added here should have it's lowByte index added to fsIntIndex array on globals.ino@L116
-}
-
 /** Send a status record back to tuning/logging SW.
  * This will "live" information from @ref currentStatus struct.
  * @param offset - Start field number
@@ -956,25 +862,44 @@ void sendValues(uint16_t offset, uint16_t packetLength, byte cmd, byte portNum)
     requestCount++;
   }
 
-  currentStatus.spark ^= (-currentStatus.hasSync ^ currentStatus.spark) & (1U << BIT_SPARK_SYNC); //Set the sync bit of the Spark variable to match the hasSync variable
+  //The whole entry is built in one go when a packet starts. A packet that is resumed carries on from that same entry, so every byte comes from the same moment
+  //The entry is kept in the framed protocol's buffer, which is free whenever a legacy command is being processed
+  static_assert(LOG_ENTRY_SIZE <= SERIAL_BUFFER_SIZE, "The live data packet must fit in serialBuffer");
+  byte *logEntry = serialBuffer;
+  if( (serialInProgress == false) || (portNum != 0) ) { createLog(logEntry, 0, LOG_ENTRY_SIZE); }
 
-  for(byte x=0; x<packetLength; x++)
+  uint16_t x = 0;
+  while(x < packetLength)
   {
-    if (portNum == 0) { Serial.write(getStatusEntry(offset+x)); }
-    #if defined(CANSerial_AVAILABLE)
-      else if (portNum == 3){ CANSerial.write(getStatusEntry(offset+x)); }
-    #endif
+    uint16_t position = offset + x;
+    uint16_t chunk = 1; //Bytes past the end of the entry are sent as 0, one at a time
+    if(position < LOG_ENTRY_SIZE) { chunk = min((uint16_t)(packetLength - x), (uint16_t)(LOG_ENTRY_SIZE - position)); }
 
-    //Check whether the tx buffer still has space
-    if(Serial.availableForWrite() < 1) 
-    { 
-      //tx buffer is full. Store the current state so it can be resumed later
-      inProgressOffset = offset + x + 1;
-      inProgressLength = packetLength - x - 1;
-      serialInProgress = true;
-      return;
+    if (portNum == 0)
+    {
+      //Only write as much as the tx buffer has space for
+      int space = Serial.availableForWrite();
+      if(space < 1) 
+      { 
+        //tx buffer is full. Store the current state so it can be resumed later
+        inProgressOffset = position;
+        inProgressLength = packetLength - x;
+        serialInProgress = true;
+        return;
+      }
+      if(chunk > (uint16_t)space) { chunk = space; }
+
+      if(position < LOG_ENTRY_SIZE) { Serial.write(&logEntry[position], chunk); }
+      else { Serial.write((uint8_t)0); }
     }
-    
+    #if defined(CANSerial_AVAILABLE)
+      else if (portNum == 3)
+      {
+        if(position < LOG_ENTRY_SIZE) { CANSerial.write(&logEntry[position], chunk); }
+        else { CANSerial.write((uint8_t)0); }
+      }
+    #endif
+    x += chunk;
   }
   serialInProgress = false;
   // Reset any flags that are being used to trigger page refreshes
@@ -1382,18 +1307,30 @@ void sendPageASCII()
 }
 
 
-/** Processes an incoming stream of calibration data (for CLT, IAT or O2) from TunerStudio.
- * Result is store in EEPROM and memory.
+/** Starts receiving a new calibration table from TunerStudio. The table data is then passed to receiveCalibration() as it arrives.
+ * 
+ * @param tableID - calibration table to receive. 0 = Coolant Sensor. 1 = IAT Sensor. 2 = O2 Sensor.
+ */
+void beginCalibration(byte tableID)
+{
+  calibration.tableID = tableID;
+  calibration.received = 0;
+}
+
+/** Processes the next part of an incoming stream of calibration data (for CLT, IAT or O2) from TunerStudio.
+ * Values are stored in memory as they are received. The data can be split up in any way, including part way through a 16-bit value.
  * 
- * @param tableID - calibration table to process. 0 = Coolant Sensor. 1 = IAT Sensor. 2 = O2 Sensor.
+ * @param data - The next bytes of the table
+ * @param length - Number of bytes in data
+ * @return true once the whole table has been received. Any bytes after that are ignored. The caller then stores the table in EEPROM with writeCalibration()
  */
-void receiveCalibration(byte tableID)
+bool receiveCalibration(const byte *data, uint16_t length)
 {
   void* pnt_TargetTable_values; //Pointer that will be used to point to the required target table values
   uint16_t* pnt_TargetTable_bins;   //Pointer that will be used to point to the required target table bins
   int OFFSET, DIVISION_FACTOR;
 
-  switch (tableID)
+  switch (calibration.tableID)
   {
     case 0:
       //coolant table
@@ -1426,35 +1363,25 @@ void receiveCalibration(byte tableID)
       break; //Should never get here, but if we do, just fail back to main loop
   }
 
-  int16_t tempValue;
-  byte tempBuffer[2];
+  //O2 calibration comes through as 1024 8-bit values of which we use every 32nd. Temperature calibrations are sent as 32 16-bit values
+  uint16_t tableLength = (calibration.tableID == 2) ? 1024 : 64;
 
-  if(tableID == 2)
+  for (uint16_t x = 0; (x < length) && (calibration.received < tableLength); x++)
   {
-    //O2 calibration. Comes through as 1024 8-bit values of which we use every 32nd
-    for (int x = 0; x < 1024; x++)
-    {
-      while ( Serial.available() < 1 ) {}
-      tempValue = Serial.read();
+    uint16_t position = calibration.received++;
 
-      if( (x % 32) == 0)
+    if(calibration.tableID == 2)
+    {
+      if( (position % 32) == 0)
       {
-        ((uint8_t*)pnt_TargetTable_values)[(x/32)] = (byte)tempValue; //O2 table stores 8 bit values
-        pnt_TargetTable_bins[(x/32)] = (x);
+        ((uint8_t*)pnt_TargetTable_values)[(position/32)] = data[x]; //O2 table stores 8 bit values
+        pnt_TargetTable_bins[(position/32)] = position;
       }
-      
     }
-  }
-  else
-  {
-    //Temperature calibrations are sent as 32 16-bit values
-    for (uint16_t x = 0; x < 32; x++)
+    else if( (position & 1) == 0 ) { calibration.valueLow = data[x]; }
+    else
     {
-      while ( Serial.available() < 2 ) {}
-      tempBuffer[0] = Serial.read();
-      tempBuffer[1] = Serial.read();
-
-      tempValue = (int16_t)(word(tempBuffer[1], tempBuffer[0])); //Combine the 2 bytes into a single, signed 16-bit value
+      int16_t tempValue = (int16_t)(word(data[x], calibration.valueLow)); //Combine the 2 bytes into a single, signed 16-bit value
       tempValue = div(tempValue, DIVISION_FACTOR).quot; //TS sends values multipled by 10 so divide back to whole degrees. 
       tempValue = ((tempValue - 32) * 5) / 9; //Convert from F to C
       
@@ -1462,17 +1389,23 @@ void receiveCalibration(byte tableID)
       tempValue = tempValue + OFFSET;
       if (tempValue < 0) { tempValue = 0; }
 
-      
-      ((uint16_t*)pnt_TargetTable_values)[x] = tempValue; //Both temp tables have 16-bit values
-      pnt_TargetTable_bins[x] = (x * 32U);
-      writeCalibration();
+      ((uint16_t*)pnt_TargetTable_values)[position/2] = tempValue; //Both temp tables have 16-bit values
+      pnt_TargetTable_bins[position/2] = ((position/2) * 32U);
     }
   }
 
-  writeCalibration();
+  return (calibration.received >= tableLength);
 }
 
-/** Send 256 tooth log entries to serial.
+/** Expands a 16 bit tooth log entry back to uS. See encodeToothLogGap()
+ */
+static inline uint32_t decodeToothLogGap(uint16_t entry)
+{
+  if(entry & TOOTH_LOG_LONG_GAP) { return (uint32_t)(entry & ~TOOTH_LOG_LONG_GAP) << TOOTH_LOG_LONG_SHIFT; }
+  return entry;
+}
+
+/** Send the TOOTH_LOG_SIZE tooth log entries of the buffer that has been filled to serial.
  * if useChar is true, the values are sent as chars to be printed out by a terminal emulator
  * if useChar is false, the values are sent as a 2 byte integer which is readable by TunerStudios tooth logger
 */
@@ -1491,15 +1424,11 @@ void sendToothLog(byte startOffset)
           toothLogSendInProgress = true;
           return;
         }
-        //Serial.write(highByte(toothHistory[toothHistorySerialIndex]));
-        //Serial.write(lowByte(toothHistory[toothHistorySerialIndex]));
-        Serial.write(toothHistory[toothHistorySerialIndex] >> 24);
-        Serial.write(toothHistory[toothHistorySerialIndex] >> 16);
-        Serial.write(toothHistory[toothHistorySerialIndex] >> 8);
-        Serial.write(toothHistory[toothHistorySerialIndex]);
-
-        if(toothHistorySerialIndex == (TOOTH_LOG_BUFFER-1)) { toothHistorySerialIndex = 0; }
-        else { toothHistorySerialIndex++; }
+        uint32_t toothTime = decodeToothLogGap(toothHistory[(toothHistorySendBuffer * TOOTH_LOG_SIZE) + x]);
+        Serial.write(toothTime >> 24);
+        Serial.write(toothTime >> 16);
+        Serial.write(toothTime >> 8);
+        Serial.write(toothTime);
       }
       BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
       cmdPending = false;
@@ -1520,7 +1449,7 @@ void sendCompositeLog(byte startOffset)
 {
   if (BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY)) //Sanity check. Flagging system means this should always be true
   {
-      if(startOffset == 0) { inProgressCompositeTime = 0; }
+      //inProgressCompositeTime is not reset between logs as each one carries on from the end of the last
       for (int x = startOffset; x < TOOTH_LOG_SIZE; x++)
       {
         //Check whether the tx buffer still has space
@@ -1532,25 +1461,21 @@ void sendCompositeLog(byte startOffset)
           return;
         }
 
-        inProgressCompositeTime += toothHistory[toothHistorySerialIndex]; //This combined runtime (in us) that the log was going for by this record)
+        uint16_t entry = (toothHistorySendBuffer * TOOTH_LOG_SIZE) + x;
+        inProgressCompositeTime += decodeToothLogGap(toothHistory[entry]); //This combined runtime (in us) that the log was going for by this record)
         
         Serial.write(inProgressCompositeTime >> 24);
         Serial.write(inProgressCompositeTime >> 16);
         Serial.write(inProgressCompositeTime >> 8);
         Serial.write(inProgressCompositeTime);
 
-        Serial.write(compositeLogHistory[toothHistorySerialIndex]); //The status byte (Indicates the trigger edge, whether it was a pri/sec pulse, the sync status)
-
-        if(toothHistorySerialIndex == (TOOTH_LOG_BUFFER-1)) { toothHistorySerialIndex = 0; }
-        else { toothHistorySerialIndex++; }
+        byte compositeStatus = compositeLogHistory[entry >> 1];
+        if(entry & 1) { compositeStatus = compositeStatus >> 4; }
+        Serial.write(compositeStatus & 0x0F); //The status byte (Indicates the trigger edge, whether it was a pri/sec pulse, the sync status)
       }
-      BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
-      toothHistoryIndex = 0;
-      toothHistorySerialIndex = 0;
-      compositeLastToothTime = 0;
+      BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY); //The buffer that was just sent can now be filled again
       cmdPending = false;
       compositeLogSendInProgress = false;
-      inProgressCompositeTime = 0;
   }
   else 
   { 
@@ -1563,6 +1488,34 @@ void sendCompositeLog(byte startOffset)
   } 
 }
 
+/** Runs a TunerStudio command button (The 'E' command).
+ * The hardware test buttons only run while the engine is stopped.
+ * 
+ * @param cmdCombined - Command group in the high byte and command value in the low byte
+ * @return false if cmdCombined is not a known command button
+ */
+bool processCommandButton(uint16_t cmdCombined)
+{
+  if ( ((cmdCombined >= TS_CMD_INJ1_ON) && (cmdCombined <= TS_CMD_IGN8_50PC)) || (cmdCombined == TS_CMD_TEST_ENBL) || (cmdCombined == TS_CMD_TEST_DSBL) )
+  {
+    //Hardware test buttons
+    if (currentStatus.RPM == 0) { TS_CommandButtonsHandler(cmdCombined); }
+  }
+  else if( (cmdCombined >= TS_CMD_VSS_60KMH) && (cmdCombined <= TS_CMD_VSS_RATIO6) )
+  {
+    //VSS Calibration commands
+    TS_CommandButtonsHandler(cmdCombined);
+  }
+  else if( (cmdCombined >= TS_CMD_STM32_REBOOT) && (cmdCombined <= TS_CMD_STM32_BOOTLOADER) )
+  {
+    //STM32 DFU mode button
+    TS_CommandButtonsHandler(cmdCombined);
+  }
+  else { return false; }
+
+  return true;
+}
+
 void testComm()
 {
   Serial.write(1);
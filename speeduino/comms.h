@@ -34,6 +34,10 @@
 #define SD_RTC_READ_OFFSET  0x4D02
 #define SD_RTC_READ_LENGTH  0x0800
 
+#define TS_SIGNATURE        "speeduino 202104-dev" //Sent in reply to 'Q'. Must match the signature in speeduino.ini
+#define TS_FIRMWARE_VERSION "Speeduino 2021.04-dev" //Sent in reply to 'S'
+#define TS_PROTOCOL_VERSION "001" //Sent in reply to 'F'
+
 
 extern byte currentPage;//Not the same as the speeduino config page numbers
 extern bool isMap; /**< Whether or not the currentPage contains only a 3D map that would require translation */
@@ -58,11 +62,12 @@ void sendValuesLegacy();
 void saveConfig();
 void sendPage();
 void sendPageASCII();
-void receiveCalibration(byte);
+void beginCalibration(byte);
+bool receiveCalibration(const byte*, uint16_t);
 void sendToothLog(uint8_t);
 void testComm();
 void commandButtons(int16_t);
+bool processCommandButton(uint16_t);
 void sendCompositeLog(uint8_t);
-byte getStatusEntry(uint16_t);
 
 #endif // COMMS_H
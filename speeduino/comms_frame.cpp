@@ -0,0 +1,291 @@
+/** \file comms_frame.cpp
+ * @brief Receive state machine and command handlers for the framed serial protocol. See comms_frame.h
+ */
+#include "globals.h"
+#include "comms_frame.h"
+#include "comms.h"
+#include "logger.h"
+#include "pages.h"
+#include "page_crc.h"
+#include "storage.h"
+#include "src/FastCRC/FastCRC.h"
+
+#define SERIAL_FRAME_HEADER 2 //Length bytes
+#define SERIAL_FRAME_CRC    4
+
+enum frameState_t
+{
+  FRAME_IDLE,     //Waiting for the start of the next frame
+  FRAME_LENGTH,   //Receiving the 2 length bytes
+  FRAME_PAYLOAD,  //Receiving the payload
+  FRAME_CRC,      //Receiving the 4 CRC bytes
+  FRAME_TRANSMIT, //Sending the response. Nothing more is received until it has all been sent
+};
+
+static FastCRC32 CRC32;
+
+static const char frameSignature[] PROGMEM = TS_SIGNATURE;
+static const char frameFirmwareVersion[] PROGMEM = TS_FIRMWARE_VERSION;
+static const char frameProtocolVersion[] PROGMEM = TS_PROTOCOL_VERSION;
+
+/*
+The request is received into the same buffer that the response is then built in. Handlers must read everything they need from the request before they write the response
+*/
+byte serialBuffer[SERIAL_BUFFER_SIZE];
+static_assert((LOG_ENTRY_SIZE + 1) <= SERIAL_FRAME_PAYLOAD_MAX, "The 'A' response must fit in a frame");
+static byte frameState = FRAME_IDLE;
+static uint16_t frameLength; //Payload length of the frame being received
+static uint16_t framePosition; //Bytes of serialBuffer received or sent so far
+static uint16_t frameTxLength; //Total bytes of serialBuffer to send
+static unsigned long frameStartTime; //millis() at the first byte of the frame being received
+static uint16_t frameCalibrationOffset; //Next byte expected of the calibration table being received by 't'
+
+static inline uint32_t readFrameCRC(const byte *data)
+{
+  return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+}
+
+static inline uint16_t copyFrameString(byte *data, const char *source, uint16_t size)
+{
+  memcpy_P(data, source, size - 1); //Strings are sent without the terminating null
+  return size - 1;
+}
+
+/** Adds the length and CRC to the response payload of responseLength bytes and starts sending it
+ */
+static void sendFrame(uint16_t responseLength)
+{
+  serialBuffer[0] = highByte(responseLength);
+  serialBuffer[1] = lowByte(responseLength);
+
+  uint32_t crc = CRC32.crc32(&serialBuffer[SERIAL_FRAME_HEADER], responseLength);
+  byte *crcBytes = &serialBuffer[SERIAL_FRAME_HEADER + responseLength];
+  crcBytes[0] = (crc >> 24) & 255;
+  crcBytes[1] = (crc >> 16) & 255;
+  crcBytes[2] = (crc >> 8) & 255;
+  crcBytes[3] = crc & 255;
+
+  frameTxLength = SERIAL_FRAME_HEADER + responseLength + SERIAL_FRAME_CRC;
+  framePosition = 0;
+  frameState = FRAME_TRANSMIT;
+}
+
+/** Sends a response that is only a return code */
+static inline void sendFrameCode(byte returnCode)
+{
+  serialBuffer[SERIAL_FRAME_HEADER] = returnCode;
+  sendFrame(1);
+}
+
+/** Writes as much of the response as the tx buffer has space for. Called again on the next loop until it has all been sent
+ */
+static void transmitFrame()
+{
+  uint16_t length = frameTxLength - framePosition;
+  int space = Serial.availableForWrite();
+  if(space <= 0) { return; }
+  if(length > (uint16_t)space) { length = space; }
+
+  Serial.write(&serialBuffer[framePosition], length);
+  framePosition += length;
+  if(framePosition >= frameTxLength) { frameState = FRAME_IDLE; }
+}
+
+/** Runs the command in a received frame and sends the response
+ * @param length - Length of the request payload, which starts at serialBuffer[SERIAL_FRAME_HEADER]
+ */
+static void processFrame(uint16_t length)
+{
+  byte *payload = &serialBuffer[SERIAL_FRAME_HEADER];
+  byte *response = &payload[1]; //After the return code
+  uint16_t responseLength = 0;
+  byte returnCode = SERIAL_RC_OK;
+
+  switch(payload[0])
+  {
+    case 'A': //Realtime values
+      createLog(response, 0, LOG_ENTRY_SIZE);
+      responseLength = LOG_ENTRY_SIZE;
+      break;
+
+    case 'B': //Burn all pages to EEPROM
+      writeAllConfig();
+      returnCode = SERIAL_RC_BURN_OK;
+      break;
+
+    case 'b': //Burn a single page. Command structure: 'b', 0, <page>
+      if(length != 3) { returnCode = SERIAL_RC_RANGE; break; }
+      writeConfig(payload[2]);
+      returnCode = SERIAL_RC_BURN_OK;
+      break;
+
+    case 'C': //Test communications
+      response[0] = 1;
+      responseLength = 1;
+      break;
+
+    case 'c': //Loops per second
+      response[0] = lowByte(currentStatus.loopsPerSecond);
+      response[1] = highByte(currentStatus.loopsPerSecond);
+      responseLength = 2;
+      break;
+
+    case 'd': //CRC32 of a page. Command structure: 'd', 0, <page>
+    {
+      if(length != 3) { returnCode = SERIAL_RC_RANGE; break; }
+      uint32_t CRC32_val = calculateCRC32(payload[2]);
+      response[0] = (CRC32_val >> 24) & 255;
+      response[1] = (CRC32_val >> 16) & 255;
+      response[2] = (CRC32_val >> 8) & 255;
+      response[3] = CRC32_val & 255;
+      responseLength = 4;
+      break;
+    }
+
+    case 'E': //Command button. Command structure: 'E', <group>, <value>
+      if(length != 3) { returnCode = SERIAL_RC_RANGE; break; }
+      if(processCommandButton(word(payload[1], payload[2])) == false) { returnCode = SERIAL_RC_UNKNOWN; }
+      break;
+
+    case 'F': //Serial protocol version
+      responseLength = copyFrameString(response, frameProtocolVersion, sizeof(frameProtocolVersion));
+      break;
+
+    case 'M': //Write page values. Command structure: 'M', 0, <page>, <offset LSB>, <offset MSB>, <length LSB>, <length MSB>, <data>
+    {
+      if(length < 7) { returnCode = SERIAL_RC_RANGE; break; }
+      byte page = payload[2];
+      uint16_t offset = word(payload[4], payload[3]);
+      uint16_t valueCount = word(payload[6], payload[5]);
+      if(length != (7 + valueCount)) { returnCode = SERIAL_RC_RANGE; break; }
+      setPageValues(page, offset, &payload[7], valueCount);
+      break;
+    }
+
+    case 'p': //Read page values. Command structure: 'p', 0, <page>, <offset LSB>, <offset MSB>, <length LSB>, <length MSB>
+    {
+      if(length != 7) { returnCode = SERIAL_RC_RANGE; break; }
+      byte page = payload[2];
+      uint16_t offset = word(payload[4], payload[3]);
+      uint16_t valueCount = word(payload[6], payload[5]);
+      if(valueCount > (SERIAL_FRAME_PAYLOAD_MAX - 1)) { returnCode = SERIAL_RC_RANGE; break; }
+      getPageValues(page, offset, response, valueCount);
+      responseLength = valueCount;
+      break;
+    }
+
+    case 'Q': //Signature
+      responseLength = copyFrameString(response, frameSignature, sizeof(frameSignature));
+      break;
+
+    case 'r': //Output channels. Command structure: 'r', <canID>, 0x30, <offset LSB>, <offset MSB>, <length LSB>, <length MSB>
+    {
+      if(length != 7) { returnCode = SERIAL_RC_RANGE; break; }
+      if(payload[2] != 0x30) { returnCode = SERIAL_RC_UNKNOWN; break; }
+      uint16_t offset = word(payload[4], payload[3]);
+      uint16_t valueCount = word(payload[6], payload[5]);
+      if(valueCount > (SERIAL_FRAME_PAYLOAD_MAX - 1)) { returnCode = SERIAL_RC_RANGE; break; }
+      createLog(response, offset, valueCount);
+      responseLength = valueCount;
+      break;
+    }
+
+    case 'S': //Firmware version
+      responseLength = copyFrameString(response, frameFirmwareVersion, sizeof(frameFirmwareVersion));
+      currentStatus.secl = 0; //This is required in TS3 due to its stricter timings
+      break;
+
+    case 't': //Calibration data. Command structure: 't', <table ID>, <offset LSB>, <offset MSB>, <data>. A table is sent as a series of these, in order, each starting where the last finished
+    {
+      if(length < 4) { returnCode = SERIAL_RC_RANGE; break; }
+      uint16_t offset = word(payload[3], payload[2]);
+      if(offset == 0) { beginCalibration(payload[1]); frameCalibrationOffset = 0; }
+      else if(offset != frameCalibrationOffset) { returnCode = SERIAL_RC_RANGE; break; }
+
+      frameCalibrationOffset += length - 4;
+      if(receiveCalibration(&payload[4], length - 4) == true) { writeCalibration(); }
+      break;
+    }
+
+    default:
+      returnCode = SERIAL_RC_UNKNOWN;
+      break;
+  }
+
+  payload[0] = returnCode;
+  sendFrame(responseLength + 1);
+}
+
+/** Takes whatever serial bytes are available and moves the frame state machine on. Never waits for more bytes to arrive.
+ * Bytes that are not part of a frame are passed to command(), as are all bytes while a legacy command is part way through
+ */
+void serialReceive()
+{
+  if(frameState == FRAME_TRANSMIT)
+  {
+    transmitFrame();
+    return;
+  }
+
+  if(frameState == FRAME_IDLE)
+  {
+    if(Serial.available() == 0) { return; }
+    if(serialInProgress == true) { return; } //serialBuffer still holds the live data packet that is being sent
+    if( (cmdPending == true) || (Serial.peek() > (SERIAL_FRAME_PAYLOAD_MAX >> 8)) )
+    {
+      command();
+      return;
+    }
+    frameState = FRAME_LENGTH;
+    framePosition = 0;
+    frameStartTime = millis();
+  }
+
+  while(Serial.available() > 0)
+  {
+    serialBuffer[framePosition++] = Serial.read();
+
+    switch(frameState)
+    {
+      case FRAME_LENGTH:
+        if(framePosition == SERIAL_FRAME_HEADER)
+        {
+          frameLength = word(serialBuffer[0], serialBuffer[1]);
+          if( (frameLength == 0) || (frameLength > SERIAL_FRAME_PAYLOAD_MAX) )
+          {
+            sendFrameCode(SERIAL_RC_RANGE);
+            return;
+          }
+          frameState = FRAME_PAYLOAD;
+        }
+        break;
+
+      case FRAME_PAYLOAD:
+        if(framePosition == (SERIAL_FRAME_HEADER + frameLength)) { frameState = FRAME_CRC; }
+        break;
+
+      case FRAME_CRC:
+        if(framePosition == (SERIAL_FRAME_HEADER + frameLength + SERIAL_FRAME_CRC))
+        {
+          uint32_t crc = CRC32.crc32(&serialBuffer[SERIAL_FRAME_HEADER], frameLength);
+          if(crc != readFrameCRC(&serialBuffer[SERIAL_FRAME_HEADER + frameLength])) { sendFrameCode(SERIAL_RC_CRC_ERROR); }
+          else { processFrame(frameLength); }
+          return;
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  //A partial frame that has stalled is dropped so that the next one can be received
+  if( (millis() - frameStartTime) > SERIAL_FRAME_TIMEOUT) { frameState = FRAME_IDLE; }
+}
+
+/** Whether serialReceive() needs to be called even when no serial bytes are available, to finish sending a response or to time out a partial frame
+ */
+bool serialFramePending()
+{
+  return (frameState != FRAME_IDLE);
+}
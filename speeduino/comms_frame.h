@@ -0,0 +1,32 @@
+/** \file comms_frame.h
+ * @brief Framed serial protocol
+ *
+ * Requests and responses are sent as frames:
+ * - 2 bytes - Payload length (Big endian)
+ * - n bytes - Payload. The first byte of a request is the command. The first byte of a response is one of the SERIAL_RC_ return codes, followed by any data
+ * - 4 bytes - CRC32 of the payload (Big endian)
+ *
+ * Frames are received and sent a piece at a time by serialReceive(), which only ever takes the bytes that are already available and never waits for more.
+ * The first byte of a frame is always 0 (SERIAL_FRAME_PAYLOAD_MAX >> 8). Any other byte is a single letter command and is passed to command(), so the legacy protocol keeps working alongside the framed one.
+ */
+#pragma once
+#include <Arduino.h>
+
+#define SERIAL_RC_OK        0x00 //Success
+#define SERIAL_RC_BURN_OK   0x04 //EEPROM write succeeded
+#define SERIAL_RC_CRC_ERROR 0x82 //The CRC of the request did not match its payload
+#define SERIAL_RC_UNKNOWN   0x83 //Unrecognised command
+#define SERIAL_RC_RANGE     0x84 //The request length, or an offset/length within it, is out of range
+
+#define SERIAL_FRAME_PAYLOAD_MAX  135 //Largest payload, an 'M' request with 128 bytes of data. Pages are read and written in pieces no bigger than this
+#define SERIAL_FRAME_TIMEOUT      500 //mS. A frame that is not complete within this time is thrown away
+#define SERIAL_BUFFER_SIZE        (2 + SERIAL_FRAME_PAYLOAD_MAX + 4) //Length, payload and CRC of the largest frame
+
+/*
+The frame that is being received or sent. When there is no frame in progress the legacy protocol builds the live data packet that sendValues() is sending in here instead,
+and serialReceive() doesn't start a new frame until that packet has been sent
+*/
+extern byte serialBuffer[SERIAL_BUFFER_SIZE];
+
+void serialReceive();
+bool serialFramePending();
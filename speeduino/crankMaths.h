@@ -7,6 +7,16 @@
 #define CRANKMATH_METHOD_ALPHA_BETA        3
 #define CRANKMATH_METHOD_2ND_DERIVATIVE    4
 
+//Alpha-beta filter (CRANKMATH_METHOD_ALPHA_BETA) gains, out of 256
+#define CRANKMATH_FILTER_ALPHA    64
+#define CRANKMATH_FILTER_BETA     16
+#define CRANKMATH_FILTER_MAX_DT   65535UL //uS. If the teeth are further apart than this (Or the filter has not been updated for this long) the filter restarts from the next tooth
+#define CRANKMATH_FILTER_MAX_RATE 32767L  //Limit on the rate of change so that the prediction over CRANKMATH_FILTER_MAX_DT can't overflow
+
+#define CRANKMATH_HISTORY_SIZE    4 //Number of tooth gaps kept for the 2nd derivative (CRANKMATH_METHOD_2ND_DERIVATIVE) calculation. Must be a power of 2
+#define CRANKMATH_HISTORY_MASK    (CRANKMATH_HISTORY_SIZE - 1)
+#define CRANKMATH_ANGLE_TABLE_SIZE 4 //Number of different tooth gap angles that the reciprocal is kept for
+
 //#define fastDegreesToUS(targetDegrees) ((targetDegrees) * (unsigned long)timePerDegree)
 #define fastDegreesToUS(targetDegrees) (((targetDegrees) * (unsigned long)timePerDegreex16) >> 4)
 /*#define fastTimeToAngle(time) (((unsigned long)time * degreesPeruSx2048) / 2048) */ //Divide by 2048 will be converted at compile time to bitshift
@@ -18,14 +28,50 @@
 unsigned long angleToTime(int16_t, byte);
 uint16_t timeToAngle(unsigned long, byte);
 void doCrankSpeedCalcs();
+void crankSpeedFilterUpdate();
+void crankSpeedFilterReset();
+bool crankToothHistoryUpdate();
+void crankToothHistoryReset();
+
+/** State of the CRANKMATH_METHOD_ALPHA_BETA filter.
+ * The filter tracks the time taken per degree of crank rotation and how fast that time is changing. Each tooth gap gives a new measurement of the time per degree,
+ * which applies to the middle of the gap. The estimate is moved forward to that time using the rate and then corrected by alpha times the error, with the rate
+ * corrected by beta times the error.
+ */
+struct crankSpeedFilter {
+  uint32_t period;             ///< Estimated uS per degree * 256, at filterTime
+  int32_t rate;                ///< Change in period per 65536uS
+  unsigned long filterTime;    ///< The time (micros()) that period applies to
+  unsigned long lastToothTime; ///< The last tooth time that was fed to the filter
+  bool isValid;
+};
+
+/** Tooth gap history for CRANKMATH_METHOD_2ND_DERIVATIVE.
+ * This is kept separately from the tooth logger (toothHistory) so that it works whether or not a log is running. Each entry is the time per degree
+ * of one gap. The reciprocals of the gap angles are kept in a small table so that getting the time per degree from a gap is a multiply rather than a divide.
+ */
+struct crankToothHistory {
+  uint16_t timePerDegreex16[CRANKMATH_HISTORY_SIZE]; ///< Time per degree * 16 across each gap
+  uint16_t angle[CRANKMATH_HISTORY_SIZE];            ///< Angle of each gap
+  uint8_t index;                                     ///< Most recent entry
+  uint8_t count;                                     ///< Number of consecutive gaps in the history
+  unsigned long lastToothTime;                       ///< The last tooth time that was added
+  uint16_t tableAngle[CRANKMATH_ANGLE_TABLE_SIZE];
+  uint32_t tableReciprocal[CRANKMATH_ANGLE_TABLE_SIZE]; ///< 65536 / tableAngle
+  uint8_t tableNext;                                 ///< The table entry that is replaced next
+  uint16_t factorAngle;                              ///< The last gap angle and span that factor was calculated for
+  uint16_t factorSpan;
+  uint16_t factor;                                   ///< Extrapolation from the history to the middle of the next gap * 256
+  bool isValid;                                      ///< Whether timePerDegreex16 was last set from the history
+};
 
 volatile uint16_t timePerDegree;
 volatile uint16_t timePerDegreex16;
 volatile uint16_t degreesPeruSx2048;
 volatile unsigned long degreesPeruSx32768;
 
-//These are only part of the experimental 2nd deriv calcs
-byte deltaToothCount = 0; //The last tooth that was used with the deltaV calc
-int rpmDelta;
+byte crankMathDefaultMethod = CRANKMATH_METHOD_INTERVAL_REV; ///< The method used when CRANKMATH_METHOD_INTERVAL_DEFAULT is requested (Eg by getCrankAngle() and the schedule timing in the main loop). Set from configPage4.crankMathMethod by initialiseTriggers()
+struct crankSpeedFilter crankFilter;
+struct crankToothHistory crankHistory;
 
 #endif
\ No newline at end of file
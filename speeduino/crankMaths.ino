@@ -3,6 +3,20 @@
 #include "decoders.h"
 #include "timers.h"
 
+/*
+* Returns the alpha-beta filters estimate of the time per degree (uS * 256) at the given time
+*/
+static inline uint32_t crankSpeedFilterPeriod(unsigned long time)
+{
+  long dt = (long)(time - crankFilter.filterTime);
+  if(dt > (long)CRANKMATH_FILTER_MAX_DT) { dt = CRANKMATH_FILTER_MAX_DT; }
+  else if(dt < -(long)CRANKMATH_FILTER_MAX_DT) { dt = -(long)CRANKMATH_FILTER_MAX_DT; }
+
+  int32_t period = (int32_t)crankFilter.period + ((crankFilter.rate * dt) / 65536);
+  if(period < 256) { period = 256; } //Never less than 1uS per degree
+  return period;
+}
+
 /*
 * Converts a crank angle into a time from or since that angle occurred.
 * Positive angles are assumed to be in the future, negative angles in the past:
@@ -19,6 +33,8 @@ unsigned long angleToTime(int16_t angle, byte method)
 {
     unsigned long returnTime = 0;
 
+    if(method == CRANKMATH_METHOD_INTERVAL_DEFAULT) { method = crankMathDefaultMethod; }
+
     if( (method == CRANKMATH_METHOD_INTERVAL_REV) || (method == CRANKMATH_METHOD_INTERVAL_DEFAULT) )
     {
         returnTime = ((angle * revolutionTime) / 360);
@@ -27,16 +43,33 @@ unsigned long angleToTime(int16_t angle, byte method)
     else if (method == CRANKMATH_METHOD_INTERVAL_TOOTH)
     {
         //Still uses a last interval method (ie retrospective), but bases the interval on the gap between the 2 most recent teeth rather than the last full revolution
-        if(triggerToothAngleIsCorrect == true)
+        struct triggerSnapshot snapshot;
+        getTriggerSnapshot(snapshot);
+        if(snapshot.triggerToothAngleIsCorrect == true)
         {
-          noInterrupts();
-          unsigned long toothTime = (toothLastToothTime - toothLastMinusOneToothTime);
-          interrupts();
-          
-          returnTime = ( (toothTime / triggerToothAngle) * angle );
+          unsigned long toothTime = (snapshot.toothLastToothTime - snapshot.toothLastMinusOneToothTime);
+          returnTime = ( (toothTime / snapshot.triggerToothAngle) * angle );
         }
         else { returnTime = angleToTime(angle, CRANKMATH_METHOD_INTERVAL_REV); } //Safety check. This can occur if the last tooth seen was outside the normal pattern etc
     }
+    else if (method == CRANKMATH_METHOD_ALPHA_BETA)
+    {
+        if( (crankFilter.isValid == true) && (angle > 0) )
+        {
+          unsigned long now = micros();
+          uint32_t period = crankSpeedFilterPeriod(now);
+          returnTime = ((uint32_t)angle * (period >> 4)) >> 4;
+          //The speed keeps changing while the crank turns through the angle, so the estimate from half way there is used
+          period = crankSpeedFilterPeriod(now + (returnTime >> 1));
+          returnTime = ((uint32_t)angle * (period >> 4)) >> 4;
+        }
+        else { returnTime = angleToTime(angle, CRANKMATH_METHOD_INTERVAL_REV); } //The filter has not had enough teeth yet
+    }
+    else if (method == CRANKMATH_METHOD_2ND_DERIVATIVE)
+    {
+        if( (crankHistory.isValid == true) && (angle > 0) ) { returnTime = fastDegreesToUS((uint32_t)angle); }
+        else { returnTime = angleToTime(angle, CRANKMATH_METHOD_INTERVAL_REV); } //Not enough consecutive teeth have been seen
+    }
 
     return returnTime;
 }
@@ -53,6 +86,8 @@ uint16_t timeToAngle(unsigned long time, byte method)
 {
     uint16_t returnAngle = 0;
 
+    if(method == CRANKMATH_METHOD_INTERVAL_DEFAULT) { method = crankMathDefaultMethod; }
+
     if( (method == CRANKMATH_METHOD_INTERVAL_REV) || (method == CRANKMATH_METHOD_INTERVAL_DEFAULT) )
     {
         //A last interval method of calculating angle that does not take into account any acceleration. The interval used is the time taken to complete the last full revolution
@@ -62,89 +97,212 @@ uint16_t timeToAngle(unsigned long time, byte method)
     else if (method == CRANKMATH_METHOD_INTERVAL_TOOTH)
     {
         //Still uses a last interval method (ie retrospective), but bases the interval on the gap between the 2 most recent teeth rather than the last full revolution
-        if(triggerToothAngleIsCorrect == true)
+        struct triggerSnapshot snapshot;
+        getTriggerSnapshot(snapshot);
+        if(snapshot.triggerToothAngleIsCorrect == true)
         {
-          noInterrupts();
-          unsigned long toothTime = (toothLastToothTime - toothLastMinusOneToothTime);
-          interrupts();
-
-          returnAngle = ( (unsigned long)(time * triggerToothAngle) / toothTime );
+          unsigned long toothTime = (snapshot.toothLastToothTime - snapshot.toothLastMinusOneToothTime);
+          returnAngle = ( (unsigned long)(time * snapshot.triggerToothAngle) / toothTime );
         }
         else { returnAngle = timeToAngle(time, CRANKMATH_METHOD_INTERVAL_REV); } //Safety check. This can occur if the last tooth seen was outside the normal pattern etc
     }
     else if (method == CRANKMATH_METHOD_ALPHA_BETA)
     {
-        //Not yet implemented. Default to Rev
-        returnAngle = timeToAngle(time, CRANKMATH_METHOD_INTERVAL_REV);
+        if(crankFilter.isValid == true) { returnAngle = (time << 8) / crankSpeedFilterPeriod(micros()); }
+        else { returnAngle = timeToAngle(time, CRANKMATH_METHOD_INTERVAL_REV); } //The filter has not had enough teeth yet
     }
     else if (method == CRANKMATH_METHOD_2ND_DERIVATIVE)
     {
-        //Not yet implemented. Default to Rev
-        returnAngle = timeToAngle(time, CRANKMATH_METHOD_INTERVAL_REV);
+        if(crankHistory.isValid == true) { returnAngle = fastTimeToAngle(time); } //degreesPeruSx32768 is set from the 2nd derivative timePerDegreex16
+        else { returnAngle = timeToAngle(time, CRANKMATH_METHOD_INTERVAL_REV); }
     }
 
    return returnAngle;
     
 }
 
+/*
+* Feeds the latest tooth gap into the alpha-beta filter (CRANKMATH_METHOD_ALPHA_BETA). Does nothing if there hasn't been a new tooth since the last call.
+* This is called from the main loop rather than the decoders so that it adds nothing to the trigger interrupts. If teeth are missed between calls, the
+* filter steps over the whole time since the last tooth it saw.
+*/
+void crankSpeedFilterUpdate()
+{
+  struct triggerSnapshot snapshot;
+  getTriggerSnapshot(snapshot);
+  unsigned long toothTime = snapshot.toothLastToothTime;
+  unsigned long lastToothTime = snapshot.toothLastMinusOneToothTime;
+  uint16_t toothAngle = snapshot.triggerToothAngle;
+  bool toothAngleIsCorrect = snapshot.triggerToothAngleIsCorrect;
+
+  if(toothTime == crankFilter.lastToothTime) { return; } //No new tooth
+  crankFilter.lastToothTime = toothTime;
+  //Gaps that don't have a known angle (Eg across the missing tooth on some patterns) are skipped over
+  if( (toothAngleIsCorrect == false) || (toothAngle == 0) ) { return; }
+
+  unsigned long gap = toothTime - lastToothTime;
+  if( (gap == 0) || (gap > CRANKMATH_FILTER_MAX_DT) ) { crankFilter.isValid = false; return; } //Too slow (Or stopped) to track
+
+  uint32_t measured = (gap << 8) / toothAngle;
+  unsigned long measuredTime = toothTime - (gap >> 1); //The gap gives the average speed across it, which is the speed half way through
+  unsigned long dt = measuredTime - crankFilter.filterTime;
+
+  struct crankSpeedFilter filter = crankFilter;
+  if( (filter.isValid == true) && (dt > 0) && (dt <= CRANKMATH_FILTER_MAX_DT) )
+  {
+    int32_t predicted = (int32_t)filter.period + ((filter.rate * (int32_t)dt) / 65536);
+    int32_t residual = (int32_t)measured - predicted;
+
+    if( labs(residual) <= (int32_t)(measured >> 1) )
+    {
+      filter.period = predicted + ((CRANKMATH_FILTER_ALPHA * residual) / 256);
+      if((int32_t)filter.period < 256) { filter.period = 256; }
+
+      //The rate is per 65536uS, so beta * residual / dt needs to be scaled up by 65536 (256 of which is the scale of beta)
+      int32_t step = CRANKMATH_FILTER_BETA * residual;
+      if( labs(step) < (INT32_MAX / 256) ) { filter.rate += (step * 256) / (int32_t)dt; }
+      else { filter.rate += (step / (int32_t)dt) * 256; } //Only at very low speeds, where the precision doesn't matter
+      if(filter.rate > CRANKMATH_FILTER_MAX_RATE) { filter.rate = CRANKMATH_FILTER_MAX_RATE; }
+      else if(filter.rate < -CRANKMATH_FILTER_MAX_RATE) { filter.rate = -CRANKMATH_FILTER_MAX_RATE; }
+    }
+    else
+    {
+      //The speed has jumped by more than the filter can follow (Eg a noise pulse or the engine has only just started), so start again from this tooth
+      filter.period = measured;
+      filter.rate = 0;
+    }
+  }
+  else
+  {
+    filter.period = measured;
+    filter.rate = 0;
+  }
+  filter.filterTime = measuredTime;
+  filter.isValid = true;
+
+  //getCrankAngle() can be called from the trigger interrupts, so the filter is only ever seen fully updated
+  noInterrupts();
+  crankFilter = filter;
+  interrupts();
+}
+
+void crankSpeedFilterReset()
+{
+  crankFilter.isValid = false;
+  crankFilter.lastToothTime = 0;
+}
+
+/*
+* Returns 65536 / angle from the table of gap angles, adding it to the table if it isn't there yet.
+* Decoders only ever produce a few different gap angles, so after the first few teeth this never needs to divide
+*/
+static uint32_t crankAngleReciprocal(uint16_t angle)
+{
+  for(uint8_t x = 0; x < CRANKMATH_ANGLE_TABLE_SIZE; x++)
+  {
+    if(crankHistory.tableAngle[x] == angle) { return crankHistory.tableReciprocal[x]; }
+  }
+
+  uint8_t entry = crankHistory.tableNext;
+  crankHistory.tableNext = (entry + 1) & (CRANKMATH_ANGLE_TABLE_SIZE - 1);
+  crankHistory.tableAngle[entry] = angle;
+  crankHistory.tableReciprocal[entry] = (65536UL + (angle >> 1)) / angle;
+  return crankHistory.tableReciprocal[entry];
+}
+
+/*
+* Adds the latest tooth gap to the tooth history and, once there are 2 consecutive gaps, sets timePerDegreex16 to the time per degree expected over
+* the next gap. The time per degree of the last 2 gaps gives the rate it is changing (per degree), which is extended forward from the middle of the last
+* gap to the middle of the next.
+* Returns true if timePerDegreex16 was set. If the gaps aren't consecutive (Eg a gap of unknown angle or the loop didn't run for a whole tooth) the history
+* starts again and this returns false until there are 2 more gaps.
+*/
+bool crankToothHistoryUpdate()
+{
+  struct triggerSnapshot snapshot;
+  getTriggerSnapshot(snapshot);
+  unsigned long toothTime = snapshot.toothLastToothTime;
+  unsigned long lastToothTime = snapshot.toothLastMinusOneToothTime;
+  uint16_t toothAngle = snapshot.triggerToothAngle;
+  bool toothAngleIsCorrect = snapshot.triggerToothAngleIsCorrect;
+
+  if(toothTime != crankHistory.lastToothTime)
+  {
+    unsigned long gap = toothTime - lastToothTime;
+    if( (toothAngleIsCorrect == false) || (toothAngle == 0) || (gap > UINT16_MAX) ) { crankHistory.count = 0; }
+    else
+    {
+      if(lastToothTime != crankHistory.lastToothTime) { crankHistory.count = 0; } //At least one tooth has been missed since the last update
+
+      uint32_t timePerDegreeGap = ((uint32_t)gap * crankAngleReciprocal(toothAngle)) >> 12;
+      crankHistory.index = (crankHistory.index + 1) & CRANKMATH_HISTORY_MASK;
+      crankHistory.timePerDegreex16[crankHistory.index] = (timePerDegreeGap > UINT16_MAX) ? UINT16_MAX : timePerDegreeGap;
+      crankHistory.angle[crankHistory.index] = toothAngle;
+      if(crankHistory.count < CRANKMATH_HISTORY_SIZE) { crankHistory.count++; }
+    }
+    crankHistory.lastToothTime = toothTime;
+  }
+
+  if(crankHistory.count < 2) { crankHistory.isValid = false; return false; }
+
+  //The change is measured from the oldest gap in the history to reduce the effect of noise on the individual tooth times
+  uint8_t oldest = (crankHistory.index - (crankHistory.count - 1)) & CRANKMATH_HISTORY_MASK;
+  uint16_t lastAngle = crankHistory.angle[crankHistory.index];
+  uint16_t spanAngle = crankHistory.angle[oldest] + lastAngle; //Twice the angle between the middle of the oldest and last gaps
+  for(uint8_t entry = (oldest + 1) & CRANKMATH_HISTORY_MASK; entry != crankHistory.index; entry = (entry + 1) & CRANKMATH_HISTORY_MASK) { spanAngle += crankHistory.angle[entry] << 1; }
+
+  if( (lastAngle != crankHistory.factorAngle) || (spanAngle != crankHistory.factorSpan) )
+  {
+    //The distance from the middle of the last gap to the middle of the next (Assumed to be the same angle as the last) over the distance between the middle of the oldest and last gaps
+    crankHistory.factorAngle = lastAngle;
+    crankHistory.factorSpan = spanAngle;
+    while(lastAngle > 127) { lastAngle = lastAngle >> 1; spanAngle = spanAngle >> 1; } //Keeps this to a 16 bit divide
+    crankHistory.factor = (uint16_t)(lastAngle << 9) / spanAngle;
+  }
+
+  int32_t timePerDegreeNext = crankHistory.timePerDegreex16[crankHistory.index];
+  int32_t change = timePerDegreeNext - (int32_t)crankHistory.timePerDegreex16[oldest];
+  timePerDegreeNext += (change * crankHistory.factor) / 256;
+  if(timePerDegreeNext < 16) { timePerDegreeNext = 16; } //Never less than 1uS per degree
+  else if(timePerDegreeNext > UINT16_MAX) { timePerDegreeNext = UINT16_MAX; }
+
+  timePerDegreex16 = timePerDegreeNext;
+  crankHistory.isValid = true;
+  return true;
+}
+
+void crankToothHistoryReset()
+{
+  memset(&crankHistory, 0, sizeof(crankHistory));
+}
+
 void doCrankSpeedCalcs()
 {
+      if(crankMathDefaultMethod == CRANKMATH_METHOD_ALPHA_BETA) { crankSpeedFilterUpdate(); }
+
      //********************************************************
       //How fast are we going? Need to know how long (uS) it will take to get from one tooth to the next. We then use that to estimate how far we are between the last tooth and the next one
       //We use a 1st Deriv accleration prediction, but only when there is an even spacing between primary sensor teeth
       //Any decoder that has uneven spacing has its triggerToothAngle set to 0
-      //THIS IS CURRENTLY DISABLED FOR ALL DECODERS! It needs more work. 
-      if( (secondDerivEnabled > 0) && (toothHistoryIndex >= 3) && (currentStatus.RPM < 2000) ) //toothHistoryIndex must be greater than or equal to 3 as we need the last 3 entries. Currently this mode only runs below 3000 rpm
+      //Decoders that set secondDerivEnabled can also use the 2nd derivative (Acceleration) prediction if it is selected as the default method
+      if( (secondDerivEnabled == true) && (crankMathDefaultMethod == CRANKMATH_METHOD_2ND_DERIVATIVE) && (crankToothHistoryUpdate() == true) )
       {
-        //Only recalculate deltaV if the tooth has changed since last time (DeltaV stays the same until the next tooth)
-        //if (deltaToothCount != toothCurrentCount)
-        {
-          deltaToothCount = toothCurrentCount;
-          int angle1, angle2; //These represent the crank angles that are travelled for the last 2 pulses
-          if(configPage4.TrigPattern == 4)
-          {
-            //Special case for 70/110 pattern on 4g63
-            angle2 = triggerToothAngle; //Angle 2 is the most recent
-            if (angle2 == 70) { angle1 = 110; }
-            else { angle1 = 70; }
-          }
-          else if(configPage4.TrigPattern == 0)
-          {
-            //Special case for missing tooth decoder where the missing tooth was one of the last 2 seen
-            if(toothCurrentCount == 1) { angle2 = 2*triggerToothAngle; angle1 = triggerToothAngle; }
-            else if(toothCurrentCount == 2) { angle1 = 2*triggerToothAngle; angle2 = triggerToothAngle; }
-            else { angle1 = triggerToothAngle; angle2 = triggerToothAngle; }
-          }
-          else { angle1 = triggerToothAngle; angle2 = triggerToothAngle; }
-
-          uint32_t toothDeltaV = (1000000L * angle2 / toothHistory[toothHistoryIndex]) - (1000000L * angle1 / toothHistory[toothHistoryIndex-1]);
-          uint32_t toothDeltaT = toothHistory[toothHistoryIndex];
-          //long timeToLastTooth = micros() - toothLastToothTime;
-
-          rpmDelta = (toothDeltaV << 10) / (6 * toothDeltaT);
-        }
-
-          timePerDegreex16 = ldiv( 2666656L, currentStatus.RPM + rpmDelta).quot; //This give accuracy down to 0.1 of a degree and can provide noticably better timing results on low res triggers
-          timePerDegree = timePerDegreex16 / 16;
+        //timePerDegreex16 has been set from the tooth history
+        timePerDegree = timePerDegreex16 / 16;
       }
       else
       {
         //If we can, attempt to get the timePerDegree by comparing the times of the last two teeth seen. This is only possible for evenly spaced teeth
-        noInterrupts();
-        if( (triggerToothAngleIsCorrect == true) && (toothLastToothTime > toothLastMinusOneToothTime) && (abs(currentStatus.rpmDOT) > 30) )
+        struct triggerSnapshot snapshot;
+        getTriggerSnapshot(snapshot);
+        if( (snapshot.triggerToothAngleIsCorrect == true) && (snapshot.toothLastToothTime > snapshot.toothLastMinusOneToothTime) && (abs(currentStatus.rpmDOT) > 30) )
         {
-          //noInterrupts();
-          unsigned long tempToothLastToothTime = toothLastToothTime;
-          unsigned long tempToothLastMinusOneToothTime = toothLastMinusOneToothTime;
-          uint16_t tempTriggerToothAngle = triggerToothAngle;
-          interrupts();
-          timePerDegreex16 = (unsigned long)( (tempToothLastToothTime - tempToothLastMinusOneToothTime)*16) / tempTriggerToothAngle;
+          timePerDegreex16 = (unsigned long)( (snapshot.toothLastToothTime - snapshot.toothLastMinusOneToothTime)*16) / snapshot.triggerToothAngle;
           timePerDegree = timePerDegreex16 / 16;
         }
         else
         {
           //long timeThisRevolution = (micros_safe() - toothOneTime);
-          interrupts();
           //Take into account any likely accleration that has occurred since the last full revolution completed:
           //long rpm_adjust = (timeThisRevolution * (long)currentStatus.rpmDOT) / 1000000; 
           long rpm_adjust = 0;
@@ -36,7 +36,34 @@
 //This isn't to to filter out wrong pulses on triggers, but just to smooth out the cam angle reading for better closed loop VVT control.
 #define ANGLE_FILTER(input, alpha, prior) (((long)input * (256 - alpha) + ((long)prior * alpha))) >> 8
 
+#define GENERIC_MAX_TEETH     64 //The most primary teeth that a generic decoder pattern (triggerPatternDescriptor.teeth) can have
+#define GENERIC_MAX_REPEATS   8  //The most times a generic pattern can repeat per cycle (cycleAngle / patternAngle)
+#define GENERIC_KEY_GAPS      3  //Number of consecutive gap ratios that are matched against the pattern to find sync
+#define GENERIC_KEY_SIZE      64 //4 gap classes per gap, so 4^GENERIC_KEY_GAPS keys
+
+/** Describes a trigger wheel to the generic decoder (triggerSetup_Generic()).
+ * The primary wheel is a list of tooth angles covering patternAngle degrees. If the pattern repeats within the cycle (Eg a crank wheel on a 4 stroke
+ * engine with cycleAngle 720) the secondary input is used to tell which repeat is which. secondaryCounts gives the number of secondary edges expected
+ * between the first tooth of the previous repeat and the first tooth of each repeat. Any count that only appears once in the list identifies that repeat.
+ *
+ * Sync is found by comparing the ratio of each primary gap to the one before it against the pattern (See genericGapClass()). Every tooth where the last
+ * GENERIC_KEY_GAPS ratios are unique within the pattern is a sync point, so gap ratios must not fall close to the 0.75, 1.5 or 2.5 class boundaries.
+ */
+struct triggerPatternDescriptor
+{
+  uint16_t cycleAngle;            ///< 360 or 720. The angle between tooth #1s
+  uint16_t patternAngle;          ///< The angle that the angles cover. cycleAngle must be a multiple of this
+  uint8_t teeth;                  ///< Number of entries in angles
+  const uint16_t *angles;         ///< Angle of each primary tooth from the tooth #1 reference, ascending and less than patternAngle
+  const uint8_t *secondaryCounts; ///< Secondary edges before each repeat of the pattern (cycleAngle / patternAngle entries). NULL if there is no secondary, in which case patternAngle must equal cycleAngle
+};
+
+void triggerPrimaryISR();
+void triggerSecondaryISR();
 void loggerPrimaryISR();
+void resetToothLog();
+void triggerSetEndTeethReset();
+void triggerSetFilterReset();
 void loggerSecondaryISR();
 
 //All of the below are the 6 required functions for each decoder / pattern
@@ -161,12 +188,7 @@ uint16_t getRPM_ThirtySixMinus222();
 int getCrankAngle_ThirtySixMinus222();
 void triggerSetEndTeeth_ThirtySixMinus222();
 
-void triggerSetup_ThirtySixMinus21();
-void triggerPri_ThirtySixMinus21();
-void triggerSec_ThirtySixMinus21();
-uint16_t getRPM_ThirtySixMinus21();
-int getCrankAngle_ThirtySixMinus21();
-void triggerSetEndTeeth_ThirtySixMinus21();
+extern const triggerPatternDescriptor triggerPattern36_2_1;
 
 void triggerSetup_420a();
 void triggerPri_420a();
@@ -184,6 +206,13 @@ uint16_t getRPM_FordST170();
 int getCrankAngle_FordST170();
 void triggerSetEndTeeth_FordST170();
 
+void triggerSetup_Generic(const triggerPatternDescriptor &pattern);
+void triggerPri_Generic();
+void triggerSec_Generic();
+uint16_t getRPM_Generic();
+int getCrankAngle_Generic();
+void triggerSetEndTeeth_Generic();
+
 
 extern void (*triggerHandler)(); //Pointer for the trigger function (Gets pointed to the relevant decoder)
 extern void (*triggerSecondaryHandler)(); //Pointer for the secondary trigger function (Gets pointed to the relevant decoder)
@@ -229,6 +258,41 @@ extern volatile bool validTrigger; //Is set true when the last trigger (Primary
 extern unsigned int triggerSecFilterTime_duration; // The shortest valid time (in uS) pulse DURATION
 extern volatile uint16_t triggerToothAngle; //The number of crank degrees that elapse per tooth
 extern volatile bool triggerToothAngleIsCorrect; //Whether or not the triggerToothAngle variable is currently accurate. Some patterns have times when the triggerToothAngle variable cannot be accurately set.
+extern volatile uint8_t triggerSequence; //Incremented after every primary and secondary trigger interrupt. See getTriggerSnapshot()
+
+//A consistent copy of the crank state that the trigger interrupts update
+struct triggerSnapshot
+{
+  unsigned long toothLastToothTime;
+  unsigned long toothLastMinusOneToothTime;
+  uint16_t toothCurrentCount;
+  uint16_t triggerToothAngle;
+  bool triggerToothAngleIsCorrect;
+  bool revolutionOne;
+};
+
+/*
+Copies the crank state without disabling interrupts, so the schedule compare interrupts are never held off by the main loop reading it.
+If a trigger interrupt runs part way through the copy, triggerSequence will have changed and the copy is simply made again. A trigger interrupt
+always runs to completion before the loop can continue, so a copy with an unchanged sequence can't have been torn.
+Variables that aren't in the snapshot are read with the same pattern:
+  uint8_t sequence;
+  do { sequence = triggerSequence; ... } while(sequence != triggerSequence);
+*/
+static inline void getTriggerSnapshot(struct triggerSnapshot &snapshot)
+{
+  uint8_t sequence;
+  do
+  {
+    sequence = triggerSequence;
+    snapshot.toothLastToothTime = toothLastToothTime;
+    snapshot.toothLastMinusOneToothTime = toothLastMinusOneToothTime;
+    snapshot.toothCurrentCount = toothCurrentCount;
+    snapshot.triggerToothAngle = triggerToothAngle;
+    snapshot.triggerToothAngleIsCorrect = triggerToothAngleIsCorrect;
+    snapshot.revolutionOne = revolutionOne;
+  } while(sequence != triggerSequence);
+}
 extern bool secondDerivEnabled; //The use of the 2nd derivative calculation is limited to certain decoders. This is set to either true or false in each decoders setup routine
 extern bool decoderIsSequential; //Whether or not the decoder supports sequential operation
 extern bool decoderIsLowRes; //Is set true, certain extra calculations are performed for better timing accuracy
@@ -249,7 +313,22 @@ extern uint16_t ignition6EndTooth;
 extern uint16_t ignition7EndTooth;
 extern uint16_t ignition8EndTooth;
 
-extern int16_t toothAngles[24]; //An array for storing fixed tooth angles. Currently sized at 24 for the GM 24X decoder, but may grow later if there are other decoders that use this style
+#define TOOTH_ANGLES_SIZE 120 //Enough for both revolutions of a 60-2 wheel. Teeth past this are worked out from triggerToothAngle, see getToothAngle()
+
+/** The tables of the decoders that need one. Only one decoder is active at a time, so they share the same memory, which the active decoders triggerSetup_*() fills */
+union decoderTables
+{
+  int16_t toothAngles[TOOTH_ANGLES_SIZE]; ///< See toothAngles
+  struct
+  {
+    uint8_t toothFlags[GENERIC_MAX_TEETH]; ///< Expected gap class and other per tooth information, built from the pattern by triggerSetup_Generic()
+    uint8_t keyTooth[GENERIC_KEY_SIZE];    ///< The tooth (Index + 1) that each sync key identifies, or 0 if it doesn't identify a unique tooth
+  } generic;
+};
+extern union decoderTables decoderTables;
+#define toothAngles (decoderTables.toothAngles) //The angle of each tooth from tooth #1, filled by the triggerSetup_*() functions of the decoders that use it
+extern uint8_t toothAnglesCount; //The number of entries in toothAngles for evenly spaced wheels. 0 for decoders that index toothAngles directly
+extern uint8_t toothAnglesRevolution; //Where the second revolution of a crank speed wheel starts in toothAngles, or 0 if it isn't stored
 
 //Used for identifying long and short pulses on the 4G63 (And possibly other) trigger patterns
 #define LONG 0;
@@ -261,4 +340,43 @@ extern int16_t toothAngles[24]; //An array for storing fixed tooth angles. Curre
 #define TOOTH_CRANK 0
 #define TOOTH_CAM   1
 
+//Why a decoder lost sync. See triggerSyncLoss()
+#define SYNC_LOSS_UNEXPECTED_GAP  1 //A primary gap that doesn't fit the pattern at the current tooth (Eg the missing tooth gap seen early)
+#define SYNC_LOSS_TOO_MANY_TEETH  2 //More primary teeth than the pattern has before the sync point
+#define SYNC_LOSS_CAM_MISMATCH    3 //The secondary input was seen somewhere it shouldn't be, or doesn't agree with the primary position
+#define SYNC_LOSS_NOISE           4 //An edge that can't be a real tooth (Eg the input at the wrong level after the edge)
+
+#define SYNC_LOSS_PRE_TEETH   16 //Edges kept from before a sync loss. Must be a power of 2
+#define SYNC_LOSS_POST_TEETH  8 //Edges recorded after the loss
+
+#define SYNC_LOSS_EDGE_SECONDARY  0 //Bits in syncLossEdge.flags
+#define SYNC_LOSS_EDGE_VALID      1 //The decoder accepted the edge (validTrigger)
+#define SYNC_LOSS_EDGE_SYNC       2 //hasSync after the edge
+
+struct syncLossEdge
+{
+  uint16_t gap; //Primary: the gap from the previous primary tooth. Secondary: the time since the last primary tooth. Encoded as a tooth log entry (See TOOTH_LOG_LONG_GAP)
+  uint8_t tooth; //toothCurrentCount after the edge
+  uint8_t flags;
+};
+
+/*
+The edges either side of a sync loss and the state of the decoder when it happened. The first sync loss is kept until it is read (and cleared) with the 'k' serial command
+RAM: 108 bytes for the record plus 64 for the ring of SYNC_LOSS_PRE_TEETH edges it is copied from (And 3 bytes of state)
+*/
+struct syncLossRecord
+{
+  uint8_t reason; //SYNC_LOSS_* or 0 if there has been no sync loss
+  uint8_t decoder; //configPage4.TrigPattern
+  uint8_t syncLossCounter; //currentStatus.syncLossCounter including this one
+  uint8_t postEdges; //How many of the SYNC_LOSS_POST_TEETH edges have been recorded so far
+  uint16_t RPM;
+  uint8_t secondaryToothCount;
+  uint8_t revolutionOne;
+  uint32_t time; //millis() at the sync loss
+  struct syncLossEdge edges[SYNC_LOSS_PRE_TEETH + SYNC_LOSS_POST_TEETH]; //Oldest first. The edge that lost sync is edges[SYNC_LOSS_PRE_TEETH - 1]
+};
+const struct syncLossRecord &lockSyncLossRecord();
+void unlockSyncLossRecord(bool clear);
+
 #endif
@@ -81,7 +81,8 @@ volatile bool validTrigger; //Is set true when the last trigger (Primary or seco
 unsigned int triggerSecFilterTime_duration; // The shortest valid time (in uS) pulse DURATION
 volatile uint16_t triggerToothAngle; //The number of crank degrees that elapse per tooth
 volatile bool triggerToothAngleIsCorrect = false; //Whether or not the triggerToothAngle variable is currently accurate. Some patterns have times when the triggerToothAngle variable cannot be accurately set.
-bool secondDerivEnabled = false; //The use of the 2nd derivative calculation is limited to certain decoders. This is set to either true or false in each decoders setup routine
+volatile uint8_t triggerSequence = 0; //Incremented after every primary and secondary trigger interrupt so that the loop can tell whether it read the trigger state part way through an update
+bool secondDerivEnabled = false; //The use of the 2nd derivative calculation is limited to decoders that set triggerToothAngle (Or clear triggerToothAngleIsCorrect) for every gap. This is set to either true or false in each decoders setup routine
 bool decoderIsSequential; //Whether or not the decoder supports sequential operation
 bool decoderIsLowRes = false; //Is set true, certain extra calculations are performed for better timing accuracy
 bool decoderHasSecondary = false; //Whether or not the pattern uses a secondary input
@@ -101,7 +102,84 @@ uint16_t ignition6EndTooth = 0;
 uint16_t ignition7EndTooth = 0;
 uint16_t ignition8EndTooth = 0;
 
-int16_t toothAngles[24]; //An array for storing fixed tooth angles. Currently sized at 24 for the GM 24X decoder, but may grow later if there are other decoders that use this style
+//The end angle and end tooth of each ignition channel, so that triggerSetEndTeeth() can loop over the channels
+static int * const ignitionEndAngles[IGN_CHANNELS] = {
+  &ignition1EndAngle, &ignition2EndAngle, &ignition3EndAngle, &ignition4EndAngle,
+#if IGN_CHANNELS >= 5
+  &ignition5EndAngle,
+#endif
+#if IGN_CHANNELS >= 6
+  &ignition6EndAngle,
+#endif
+#if IGN_CHANNELS >= 7
+  &ignition7EndAngle,
+#endif
+#if IGN_CHANNELS >= 8
+  &ignition8EndAngle,
+#endif
+};
+static uint16_t * const ignitionEndTeeth[IGN_CHANNELS] = {
+  &ignition1EndTooth, &ignition2EndTooth, &ignition3EndTooth, &ignition4EndTooth,
+#if IGN_CHANNELS >= 5
+  &ignition5EndTooth,
+#endif
+#if IGN_CHANNELS >= 6
+  &ignition6EndTooth,
+#endif
+#if IGN_CHANNELS >= 7
+  &ignition7EndTooth,
+#endif
+#if IGN_CHANNELS >= 8
+  &ignition8EndTooth,
+#endif
+};
+
+//What the current end teeth were calculated from. See endTeethKeyChanged()
+#define END_TEETH_RECIPROCAL_SHIFT 20
+static struct
+{
+  int endAngle[IGN_CHANNELS]; //The end angle each channels end tooth was last calculated for
+  uint16_t toothAngle; //The triggerToothAngle that reciprocal was calculated for. 0 for decoders that don't use it
+  uint32_t reciprocal; //(1 << END_TEETH_RECIPROCAL_SHIFT) / toothAngle, rounded up
+  int16_t triggerAngle;
+  int8_t toothOffset;
+  uint16_t cycleTeeth;
+  uint16_t maxTooth;
+  bool isValid;
+} endTeethCache;
+
+union decoderTables decoderTables; //toothAngles and the generic decoders tables
+uint8_t toothAnglesCount = 0;
+uint8_t toothAnglesRevolution = 0; //Where the second revolution of a crank speed wheel starts in toothAngles, or 0 if it isn't stored. See setSecondRevolutionToothAngles()
+
+//Sync loss forensics. See recordSyncLossEdge()
+static struct syncLossEdge syncLossRing[SYNC_LOSS_PRE_TEETH]; //The most recent edges, always recorded
+static uint8_t syncLossRingIndex = 0;
+static volatile uint8_t syncLossReason = 0; //Set by triggerSyncLoss() for the edge that is being decoded
+static struct syncLossRecord syncLossCapture;
+static volatile bool syncLossCaptureLocked = false; //The record is being sent and must not change. See lockSyncLossRecord()
+
+//Adaptive trigger filter. See setAdaptiveFilter()
+static struct
+{
+  unsigned long lastGap; //The gap setFilter() was last called with
+  unsigned long predictedGap; //The gap that was predicted for the tooth after lastGap
+  unsigned long jitter; //Running average of the difference between the predicted and actual gaps
+  volatile bool isActive; //Whether triggerFilterTime is the adaptive window, which the trigger interrupts then enforce before calling the decoder
+} adaptiveFilter;
+
+//Generic decoder state. See triggerSetup_Generic()
+const triggerPatternDescriptor *genericPattern = NULL;
+uint8_t genericRepeats; //Number of times the pattern repeats per cycle
+uint8_t genericTeethPer360; //Number of teeth in the first 360 degrees of the cycle
+volatile uint8_t genericToothIndex; //Index into the pattern of the last tooth
+volatile uint8_t genericRepeat; //Which repeat of the pattern the last tooth was in
+volatile uint16_t genericRepeatAngle; //genericRepeat * patternAngle
+volatile uint8_t genericSyncKey; //Gap classes of the last GENERIC_KEY_GAPS gaps
+volatile uint8_t genericKeyGaps; //Number of gaps in genericSyncKey (Up to GENERIC_KEY_GAPS)
+volatile bool genericPatternSync; //Whether the position within the pattern is known. The phase (Which repeat) may not be
+volatile uint8_t genericSecondaryCount; //Secondary edges since the first tooth of the current repeat
+volatile bool genericSecondaryCountValid; //Whether genericSecondaryCount covers a full repeat
 
 
 /** Universal (shared between decoders) decoder routines.
@@ -112,6 +190,43 @@ int16_t toothAngles[24]; //An array for storing fixed tooth angles. Currently si
 */
 // whichTooth - 0 for Primary (Crank), 1 for Secondary (Cam)
 
+/*
+The tooth log is double buffered. The trigger interrupt fills one half of toothHistory while the other half is sent, so the log is continuous as long
+as each half is sent before the next one fills. A full half is handed over (BIT_STATUS1_TOOTHLOG1READY set) as soon as the previous one has been sent.
+If it hasn't been, new entries are dropped until it has.
+*/
+static inline void swapToothLogBuffers()
+{
+  if( (toothHistoryIndex >= TOOTH_LOG_SIZE) && !BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY) )
+  {
+    toothHistorySendBuffer = toothHistoryFillBuffer;
+    toothHistoryFillBuffer ^= 1;
+    toothHistoryIndex = 0;
+    BIT_SET(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
+  }
+}
+
+/** Encodes a tooth gap into a 16 bit log entry.
+ * Gaps below TOOTH_LOG_LONG_GAP are stored as they are. Longer gaps (Only seen while cranking) lose the bottom TOOTH_LOG_LONG_SHIFT bits
+ */
+static inline uint16_t encodeToothLogGap(unsigned long gap)
+{
+  if(gap < TOOTH_LOG_LONG_GAP) { return gap; }
+  if(gap < (TOOTH_LOG_LONG_GAP << TOOTH_LOG_LONG_SHIFT)) { return TOOTH_LOG_LONG_GAP | (gap >> TOOTH_LOG_LONG_SHIFT); }
+  return UINT16_MAX;
+}
+
+/** Empties both tooth log buffers. Called when a log is started
+ */
+void resetToothLog()
+{
+  toothHistoryIndex = 0;
+  toothHistoryFillBuffer = 0;
+  toothHistorySendBuffer = 1;
+  compositeLastToothTime = micros();
+  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
+}
+
 /** Add tooth log entry to toothHistory (array).
  * Enabled by (either) currentStatus.toothLogEnabled and currentStatus.compositeLogEnabled.
  * @param toothTime - Tooth Time
@@ -119,52 +234,175 @@ int16_t toothAngles[24]; //An array for storing fixed tooth angles. Currently si
  */
 static inline void addToothLogEntry(unsigned long toothTime, bool whichTooth)
 {
-  if(BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY)) { return; }
   //High speed tooth logging history
   if( (currentStatus.toothLogEnabled == true) || (currentStatus.compositeLogEnabled == true) ) 
   {
+    swapToothLogBuffers(); //In case the last buffer filled while the one before it was still being sent
+    if(toothHistoryIndex >= TOOTH_LOG_SIZE) { return; } //Both buffers are full
+
+    uint16_t entry = (toothHistoryFillBuffer * TOOTH_LOG_SIZE) + toothHistoryIndex;
     bool valueLogged = false;
     if(currentStatus.toothLogEnabled == true)
     {
       //Tooth log only works on the Crank tooth
       if(whichTooth == TOOTH_CRANK)
       { 
-        toothHistory[toothHistoryIndex] = toothTime; //Set the value in the log. 
+        toothHistory[entry] = encodeToothLogGap(toothTime); //Set the value in the log. 
         valueLogged = true;
       } 
     }
     else if(currentStatus.compositeLogEnabled == true)
     {
-      compositeLogHistory[toothHistoryIndex] = 0;
-      if(READ_PRI_TRIGGER() == true) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_PRI); }
-      if(READ_SEC_TRIGGER() == true) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_SEC); }
-      if(whichTooth == TOOTH_CAM) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_TRIG); }
-      if(currentStatus.hasSync == true) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_SYNC); }
-
-      toothHistory[toothHistoryIndex] = micros() - compositeLastToothTime;
-      compositeLastToothTime = micros();
+      byte compositeStatus = 0;
+      if(READ_PRI_TRIGGER() == true) { BIT_SET(compositeStatus, COMPOSITE_LOG_PRI); }
+      if(READ_SEC_TRIGGER() == true) { BIT_SET(compositeStatus, COMPOSITE_LOG_SEC); }
+      if(whichTooth == TOOTH_CAM) { BIT_SET(compositeStatus, COMPOSITE_LOG_TRIG); }
+      if(currentStatus.hasSync == true) { BIT_SET(compositeStatus, COMPOSITE_LOG_SYNC); }
+      if(entry & 1) { compositeLogHistory[entry >> 1] = (compositeLogHistory[entry >> 1] & 0x0F) | (compositeStatus << 4); }
+      else { compositeLogHistory[entry >> 1] = (compositeLogHistory[entry >> 1] & 0xF0) | compositeStatus; }
+
+      unsigned long logTime = micros();
+      toothHistory[entry] = encodeToothLogGap(logTime - compositeLastToothTime);
+      compositeLastToothTime = logTime;
       valueLogged = true;
     }
 
-    //If there has been a value logged above, update the indexes
+    //If there has been a value logged above, move on to the next entry and hand the buffer over to be sent if it is now full
     if(valueLogged == true)
     {
-      if(toothHistoryIndex == (TOOTH_LOG_BUFFER-1)) { toothHistoryIndex = 0; }
-      else { toothHistoryIndex++; }
-
-      uint16_t absoluteToothHistoryIndex = toothHistoryIndex;
-      if(toothHistoryIndex < toothHistorySerialIndex)
-      {
-        //If the main history index is lower than the serial index, it means that this has looped. To calculate the delta between the two indexes, add the buffer size back on 
-        absoluteToothHistoryIndex += TOOTH_LOG_BUFFER;
-      }
-      //Check whether the current index is ahead of the serial index by at least the size of the log
-      if( (absoluteToothHistoryIndex - toothHistorySerialIndex) >= TOOTH_LOG_SIZE ) { BIT_SET(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY); }
-      else { BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY); } //Tooth log is not yet ahead of the serial index by enough, so mark the log as not yet ready
+      toothHistoryIndex++;
+      swapToothLogBuffers();
     }
+  } //Tooth/Composite log enabled
+}
 
+/** Flags a sync loss. Used by the decoders in place of incrementing currentStatus.syncLossCounter directly, so that the reason is recorded along with
+ * the edges around it.
+ * @param reason - One of the SYNC_LOSS_* reasons
+ */
+static inline void triggerSyncLoss(uint8_t reason)
+{
+  currentStatus.syncLossCounter++;
+  syncLossReason = reason;
+  adaptiveFilter.isActive = false; //The prediction has to start again once the decoder has resynced
+}
 
-  } //Tooth/Composite log enabled
+/** Adds the edge that has just been decoded to the sync loss ring. If the decoder lost sync on this edge, and there isn't already a record that hasn't
+ * been read, the ring is copied into the sync loss record, which then takes the next SYNC_LOSS_POST_TEETH edges as well.
+ * This is called for every edge so is kept short. The ring is only copied when sync is lost.
+ * @param gap - See syncLossEdge.gap
+ * @param whichTooth - TOOTH_CRANK or TOOTH_CAM
+ */
+static inline void recordSyncLossEdge(unsigned long gap, bool whichTooth)
+{
+  struct syncLossEdge edge;
+  edge.gap = encodeToothLogGap(gap);
+  edge.tooth = toothCurrentCount;
+  edge.flags = 0;
+  if(whichTooth == TOOTH_CAM) { BIT_SET(edge.flags, SYNC_LOSS_EDGE_SECONDARY); }
+  if(validTrigger == true) { BIT_SET(edge.flags, SYNC_LOSS_EDGE_VALID); }
+  if(currentStatus.hasSync == true) { BIT_SET(edge.flags, SYNC_LOSS_EDGE_SYNC); }
+
+  syncLossRing[syncLossRingIndex] = edge;
+  syncLossRingIndex = (syncLossRingIndex + 1) & (SYNC_LOSS_PRE_TEETH - 1);
+
+  if(syncLossCaptureLocked == true) { syncLossReason = 0; return; } //The record is being sent, so a loss now is only counted
+  if(syncLossCapture.reason == 0)
+  {
+    if(syncLossReason == 0) { return; }
+
+    //Freeze the edges leading up to the sync loss, oldest first
+    syncLossCapture.reason = syncLossReason;
+    syncLossCapture.decoder = configPage4.TrigPattern;
+    syncLossCapture.syncLossCounter = currentStatus.syncLossCounter;
+    syncLossCapture.postEdges = 0;
+    syncLossCapture.RPM = currentStatus.RPM;
+    syncLossCapture.secondaryToothCount = secondaryToothCount;
+    syncLossCapture.revolutionOne = revolutionOne;
+    syncLossCapture.time = millis();
+    for(uint8_t x = 0; x < SYNC_LOSS_PRE_TEETH; x++) { syncLossCapture.edges[x] = syncLossRing[(syncLossRingIndex + x) & (SYNC_LOSS_PRE_TEETH - 1)]; }
+  }
+  else if(syncLossCapture.postEdges < SYNC_LOSS_POST_TEETH)
+  {
+    syncLossCapture.edges[SYNC_LOSS_PRE_TEETH + syncLossCapture.postEdges] = edge;
+    syncLossCapture.postEdges++;
+  }
+  syncLossReason = 0;
+}
+
+/** Stops the trigger interrupts changing the sync loss record so that it can be read in place, rather than copied. Must be followed by unlockSyncLossRecord()
+ * @return The record. The reason is 0 if there hasn't been a sync loss since it was last cleared
+ */
+const struct syncLossRecord &lockSyncLossRecord()
+{
+  noInterrupts();
+  syncLossCaptureLocked = true;
+  interrupts();
+
+  return syncLossCapture;
+}
+
+/** Lets the trigger interrupts update the sync loss record again after lockSyncLossRecord()
+ * @param clear - Clear the record, so that the next sync loss is recorded
+ */
+void unlockSyncLossRecord(bool clear)
+{
+  noInterrupts();
+  if(clear == true) { syncLossCapture.reason = 0; }
+  syncLossCaptureLocked = false;
+  interrupts();
+}
+
+/** Adaptive trigger filter check for the primary input. Edges that arrive before the window set by setAdaptiveFilter() are counted and dropped here
+ * instead of in the decoder, so that the count means the same thing for every decoder that uses setFilter().
+ * Only called when adaptiveFilter.isActive is set.
+ * @return Whether the edge was rejected as noise
+ */
+static inline bool isPrimaryTriggerNoise()
+{
+  unsigned long gap = micros() - toothLastToothTime;
+  if( (currentStatus.hasSync == false) || (gap >= triggerFilterTime) ) { return false; }
+
+  currentStatus.priTriggerNoise++;
+  recordSyncLossEdge(gap, TOOTH_CRANK);
+  return true;
+}
+
+/** As isPrimaryTriggerNoise(), for the secondary input. The window is whatever triggerSecFilterTime the decoder has set, as secondary patterns vary too
+ * much to predict generally.
+ */
+static inline bool isSecondaryTriggerNoise()
+{
+  unsigned long gap = micros() - toothLastSecToothTime;
+  if( (currentStatus.hasSync == false) || (gap >= triggerSecFilterTime) ) { return false; }
+
+  currentStatus.secTriggerNoise++;
+  recordSyncLossEdge(micros() - toothLastToothTime, TOOTH_CAM);
+  return true;
+}
+
+/** Interrupt handler for the primary trigger.
+* Calls the decoder and then marks the crank state as updated for getTriggerSnapshot()
+*/
+void triggerPrimaryISR()
+{
+  validTrigger = false; //Decoders only set this when the edge is accepted
+  if( (adaptiveFilter.isActive == true) && (isPrimaryTriggerNoise() == true) ) { return; }
+  triggerHandler();
+  triggerSequence++;
+  recordSyncLossEdge(curGap, TOOTH_CRANK);
+}
+
+/** Interrupt handler for the secondary trigger.
+* As triggerPrimaryISR(). Some decoders change the tooth count or revolution from the secondary input
+*/
+void triggerSecondaryISR()
+{
+  validTrigger = false;
+  if( (adaptiveFilter.isActive == true) && (isSecondaryTriggerNoise() == true) ) { return; }
+  triggerSecondaryHandler();
+  triggerSequence++;
+  recordSyncLossEdge(micros() - toothLastToothTime, TOOTH_CAM); //Not all decoders time the secondary edges, so the position is taken from the last primary tooth
 }
 
 /** Interrupt handler for primary trigger.
@@ -184,7 +422,12 @@ void loggerPrimaryISR()
   */
   if( ( (primaryTriggerEdge == RISING) && (READ_PRI_TRIGGER() == HIGH) ) || ( (primaryTriggerEdge == FALLING) && (READ_PRI_TRIGGER() == LOW) ) || (primaryTriggerEdge == CHANGE) )
   {
-    triggerHandler();
+    if( (adaptiveFilter.isActive == false) || (isPrimaryTriggerNoise() == false) )
+    {
+      triggerHandler();
+      triggerSequence++;
+      recordSyncLossEdge(curGap, TOOTH_CRANK);
+    }
     validEdge = true;
   }
   if( (currentStatus.toothLogEnabled == true) && (validTrigger == true) )
@@ -215,7 +458,12 @@ void loggerSecondaryISR()
   */
   if( ( (secondaryTriggerEdge == RISING) && (READ_SEC_TRIGGER() == HIGH) ) || ( (secondaryTriggerEdge == FALLING) && (READ_SEC_TRIGGER() == LOW) ) || (secondaryTriggerEdge == CHANGE) )
   {
-    triggerSecondaryHandler();
+    if( (adaptiveFilter.isActive == false) || (isSecondaryTriggerNoise() == false) )
+    {
+      triggerSecondaryHandler();
+      triggerSequence++;
+      recordSyncLossEdge(micros() - toothLastToothTime, TOOTH_CAM);
+    }
   }
   //No tooth logger for the secondary input
   if( (currentStatus.compositeLogEnabled == true) && (validTrigger == true) )
@@ -240,9 +488,12 @@ static inline uint16_t stdGetRPM(uint16_t degreesOver)
     else if( (toothOneTime == 0) || (toothOneMinusOneTime == 0) ) { tempRPM = 0; }
     else
     {
-      noInterrupts();
-      revolutionTime = (toothOneTime - toothOneMinusOneTime); //The time in uS that one revolution would take at current speed (The time tooth 1 was last seen, minus the time it was seen prior to that)
-      interrupts();
+      uint8_t sequence;
+      do
+      {
+        sequence = triggerSequence;
+        revolutionTime = (toothOneTime - toothOneMinusOneTime); //The time in uS that one revolution would take at current speed (The time tooth 1 was last seen, minus the time it was seen prior to that)
+      } while(sequence != triggerSequence);
       if(degreesOver == 720) { revolutionTime = revolutionTime / 2; }
       tempRPM = (US_IN_MINUTE / revolutionTime); //Calc RPM based on last full revolution time (Faster as /)
       if(tempRPM >= MAX_RPM) { tempRPM = currentStatus.RPM; } //Sanity check
@@ -253,12 +504,65 @@ static inline uint16_t stdGetRPM(uint16_t degreesOver)
   return tempRPM;
 }
 
+/**
+ * Adaptive version of the filter levels in setFilter(). Rather than a percentage of the last gap, the window is placed below the predicted gap to the
+ * next tooth. The prediction follows the change between the last 2 gaps, so the window closes up as the engine accelerates, and it is opened further by
+ * the average error of the previous predictions, so a clean signal keeps the full filter level and a jittery one gets a looser window.
+ * The window is never tighter than the fixed filter level would be and never looser than 25% of the predicted gap.
+ * As with setFilter(), curGap must be a gap between evenly spaced teeth.
+ */
+static inline void setAdaptiveFilter(unsigned long curGap)
+{
+  if(adaptiveFilter.isActive == true)
+  {
+    unsigned long error;
+    if(curGap > adaptiveFilter.predictedGap) { error = curGap - adaptiveFilter.predictedGap; }
+    else { error = adaptiveFilter.predictedGap - curGap; }
+    adaptiveFilter.jitter = adaptiveFilter.jitter - (adaptiveFilter.jitter >> 2) + (error >> 2);
+  }
+  else { adaptiveFilter.jitter = 0; adaptiveFilter.lastGap = curGap; } //First gap since sync, nothing to compare against yet
+
+  //Only an accelerating engine moves the prediction. When the gaps are growing the next one will be at least as long as this one anyway
+  unsigned long predictedGap = curGap;
+  if(curGap < adaptiveFilter.lastGap)
+  {
+    unsigned long change = adaptiveFilter.lastGap - curGap;
+    if(change < (curGap >> 1)) { predictedGap = curGap - change; }
+    else { predictedGap = curGap >> 1; }
+  }
+
+  unsigned long window;
+  if(configPage4.triggerFilter == 1) { window = predictedGap >> 2; }
+  else if(configPage4.triggerFilter == 2) { window = predictedGap >> 1; }
+  else { window = (predictedGap * 3) >> 2; }
+
+  unsigned long margin = adaptiveFilter.jitter << 1;
+  if( (margin < predictedGap) && ((predictedGap - margin) < window) ) { window = predictedGap - margin; }
+  if(window < (predictedGap >> 2)) { window = predictedGap >> 2; }
+
+  triggerFilterTime = window;
+  adaptiveFilter.predictedGap = predictedGap;
+  adaptiveFilter.lastGap = curGap;
+  adaptiveFilter.isActive = true;
+}
+
+/*
+Stops the trigger interrupts enforcing the adaptive filter window until the decoder next calls setFilter(). Called when the decoder is (re)initialised
+*/
+void triggerSetFilterReset()
+{
+  adaptiveFilter.isActive = false;
+}
+
 /**
  * Sets the new filter time based on the current settings.
  * This ONLY works for even spaced decoders.
  */
 static inline void setFilter(unsigned long curGap)
 {
+  if( (configPage4.triggerFilterAdaptive == true) && (configPage4.triggerFilter > 0) ) { setAdaptiveFilter(curGap); return; }
+
+  adaptiveFilter.isActive = false;
   if(configPage4.triggerFilter == 0) { triggerFilterTime = 0; } //trigger filter is turned off.
   else if(configPage4.triggerFilter == 1) { triggerFilterTime = curGap >> 2; } //Lite filter level is 25% of previous gap
   else if(configPage4.triggerFilter == 2) { triggerFilterTime = curGap >> 1; } //Medium filter level is 50% of previous gap
@@ -280,9 +584,9 @@ static inline int crankingGetRPM(byte totalTeeth, uint16_t degreesOver)
   {
     if( (toothLastToothTime > 0) && (toothLastMinusOneToothTime > 0) && (toothLastToothTime > toothLastMinusOneToothTime) )
     {
-      noInterrupts();
-      revolutionTime = (toothLastToothTime - toothLastMinusOneToothTime) * totalTeeth;
-      interrupts();
+      struct triggerSnapshot snapshot;
+      getTriggerSnapshot(snapshot);
+      revolutionTime = (snapshot.toothLastToothTime - snapshot.toothLastMinusOneToothTime) * totalTeeth;
       if(degreesOver == 720) { revolutionTime = revolutionTime / 2; }
       tempRPM = (US_IN_MINUTE / revolutionTime);
       if( tempRPM >= MAX_RPM ) { tempRPM = currentStatus.RPM; } //Sanity check. This can prevent spiking caused by noise on individual teeth. The new RPM should never be above 4x the cranking setting value (Remembering that this function is only called is the current RPM is less than the cranking setting)
@@ -292,6 +596,142 @@ static inline int crankingGetRPM(byte totalTeeth, uint16_t degreesOver)
   return tempRPM;
 }
 
+/*
+The tooth count and angle multiplier from the tune, for the decoders that divide by them. Both are 0 on a blank config, so they are replaced here to avoid a divide by 0
+when starting the decoder. The tune itself is left alone
+*/
+static inline byte getTriggerTeeth() { return (configPage4.triggerTeeth == 0) ? 4 : configPage4.triggerTeeth; }
+static inline byte getTriggerAngleMultiplier() { return (configPage4.TrigAngMul == 0) ? 1 : configPage4.TrigAngMul; }
+
+/*
+Fills toothAngles for a wheel whose teeth are all toothAngle apart, starting from firstAngle at tooth #1. Missing teeth keep their place in the table,
+so the entry for a tooth is always its count from tooth #1. Only the teeth that fit in the table are filled, getToothAngle() works out the rest
+*/
+static void setEvenToothAngles(uint16_t teeth, uint16_t toothAngle, int16_t firstAngle)
+{
+  if(teeth > TOOTH_ANGLES_SIZE) { teeth = TOOTH_ANGLES_SIZE; }
+  int16_t angle = firstAngle;
+  for(uint8_t tooth = 0; tooth < teeth; tooth++)
+  {
+    toothAngles[tooth] = angle;
+    angle += toothAngle;
+  }
+  toothAnglesCount = teeth;
+  toothAnglesRevolution = 0;
+}
+
+/*
+Stores the second revolution of a crank speed wheel (On a 720 degree cycle) in toothAngles after the first teeth entries, 360 degrees on from the first,
+so that every tooth over the cycle is a single table load (See getCycleToothAngle()). If both revolutions don't fit in the table, only the first is kept
+*/
+static void setSecondRevolutionToothAngles(uint8_t teeth)
+{
+  toothAnglesRevolution = 0;
+  if( (teeth * 2) > TOOTH_ANGLES_SIZE ) { return; }
+  for(uint8_t tooth = 0; tooth < teeth; tooth++) { toothAngles[tooth + teeth] = toothAngles[tooth] + 360; }
+  if(toothAnglesCount == teeth) { toothAnglesCount = teeth * 2; }
+  toothAnglesRevolution = teeth;
+}
+
+/*
+The angle of the given tooth (1 based) from the reference point, not including configPage4.triggerAngle. This is a single table load on every tooth that
+setEvenToothAngles() filled. Counts outside the table (Before sync, or wheels with more than TOOTH_ANGLES_SIZE teeth) fall back to the old multiply
+*/
+static inline int16_t getToothAngle(int16_t tooth)
+{
+  if( (tooth > 0) && (tooth <= toothAnglesCount) ) { return toothAngles[tooth - 1]; }
+  return (tooth - 1) * (int16_t)triggerToothAngle;
+}
+
+/*
+The angle from the given tooth (1 based) to the one after it, using getToothAngle(). After lastTooth the next tooth is #1 again, cycleAngle degrees on.
+This is the real gap, so it is right across missing teeth and on uneven wheels where triggerToothAngle is only the gap before the last tooth
+*/
+static inline uint16_t getToothGap(int16_t tooth, int16_t lastTooth, int16_t cycleAngle)
+{
+  int16_t gap = getToothAngle( (tooth >= lastTooth) ? 1 : (tooth + 1) ) - getToothAngle(tooth);
+  if(gap <= 0) { gap += cycleAngle; }
+  return gap;
+}
+
+/*
+As getToothAngle(), over the 720 degree cycle of a crank speed wheel. secondRevolution is revolutionOne (Where the decoder uses it for this).
+Only a wheel too big for setSecondRevolutionToothAngles() to store both revolutions has the 360 added here
+*/
+static inline int16_t getCycleToothAngle(int16_t tooth, bool secondRevolution)
+{
+  if(secondRevolution == false) { return getToothAngle(tooth); }
+  if(toothAnglesRevolution == 0) { return getToothAngle(tooth) + 360; }
+  return getToothAngle(tooth + toothAnglesRevolution);
+}
+
+/*
+As getToothGap(), for the decoders that index toothAngles directly (toothAnglesCount is 0 on these)
+*/
+static inline uint16_t getTableToothGap(uint8_t tooth, uint8_t lastTooth, int16_t cycleAngle)
+{
+  int16_t gap = toothAngles[(tooth >= lastTooth) ? 0 : tooth] - toothAngles[(tooth - 1)];
+  if(gap <= 0) { gap += cycleAngle; }
+  return gap;
+}
+
+/*
+Checks whether any of the settings that the end teeth are calculated from have changed since the last call. If they have, every channel is
+recalculated on this call, otherwise only channels whose end angle has changed need to be
+*/
+static bool endTeethKeyChanged(uint16_t toothAngle, int8_t toothOffset, uint16_t cycleTeeth, uint16_t maxTooth)
+{
+  if( (endTeethCache.isValid == true) && (endTeethCache.toothAngle == toothAngle) && (endTeethCache.triggerAngle == configPage4.triggerAngle) && (endTeethCache.toothOffset == toothOffset) && (endTeethCache.cycleTeeth == cycleTeeth) && (endTeethCache.maxTooth == maxTooth) ) { return false; }
+
+  if( (toothAngle != endTeethCache.toothAngle) && (toothAngle > 0) ) { endTeethCache.reciprocal = (1UL << END_TEETH_RECIPROCAL_SHIFT) / toothAngle + 1; } //The only divide, and only when the tooth angle changes
+  endTeethCache.toothAngle = toothAngle;
+  endTeethCache.triggerAngle = configPage4.triggerAngle;
+  endTeethCache.toothOffset = toothOffset;
+  endTeethCache.cycleTeeth = cycleTeeth;
+  endTeethCache.maxTooth = maxTooth;
+  endTeethCache.isValid = true;
+  return true;
+}
+
+/*
+Forces all the end teeth to be recalculated on the next call to triggerSetEndTeeth(). Called when the decoder is (re)initialised
+*/
+void triggerSetEndTeethReset()
+{
+  endTeethCache.isValid = false;
+}
+
+/*
+Sets the end tooth of each ignition channel on patterns where every tooth is triggerToothAngle apart: The end angle divided by the tooth angle, plus toothOffset,
+wrapped once into 1 to cycleTeeth and then limited to maxTooth (0 for no limit).
+The divide is a multiply by a reciprocal of triggerToothAngle, which is exact for any angle up to 1440 and tooth angles up to 720. The result truncates
+towards 0 for negative angles, the same as a divide would
+*/
+static void setEvenEndTeeth(int8_t toothOffset, uint16_t cycleTeeth, uint16_t maxTooth)
+{
+  bool allChannels = endTeethKeyChanged(triggerToothAngle, toothOffset, cycleTeeth, maxTooth);
+
+  for(uint8_t channel = 0; channel < IGN_CHANNELS; channel++)
+  {
+    int endAngle = *ignitionEndAngles[channel];
+    if( (allChannels == false) && (endAngle == endTeethCache.endAngle[channel]) ) { continue; }
+    endTeethCache.endAngle[channel] = endAngle;
+
+    int16_t angle = endAngle - endTeethCache.triggerAngle;
+    int16_t tempEndTooth;
+    if(angle >= 0) { tempEndTooth = (int16_t)(((uint32_t)angle * endTeethCache.reciprocal) >> END_TEETH_RECIPROCAL_SHIFT); }
+    else { tempEndTooth = -(int16_t)(((uint32_t)(-angle) * endTeethCache.reciprocal) >> END_TEETH_RECIPROCAL_SHIFT); }
+    tempEndTooth += toothOffset;
+
+    if(tempEndTooth > (int16_t)cycleTeeth) { tempEndTooth -= cycleTeeth; }
+    if(tempEndTooth <= 0) { tempEndTooth += cycleTeeth; }
+    if( (maxTooth > 0) && ((uint16_t)tempEndTooth > maxTooth) ) { tempEndTooth = maxTooth; }
+    *ignitionEndTeeth[channel] = tempEndTooth;
+  }
+
+  lastToothCalcAdvance = currentStatus.advance;
+}
+
 /**
 On decoders that are enabled for per tooth based timing adjustments, this function performs the timer compare changes on the schedules themselves
 For each ignition channel, a check is made whether we're at the relevant tooth and whether that ignition schedule is currently running
@@ -305,54 +745,64 @@ static inline void checkPerToothTiming(int16_t crankAngle, uint16_t currentTooth
   {
     if ( (currentTooth == ignition1EndTooth) )
     {
-      if( (ignitionSchedule1.Status == RUNNING) ) { IGN1_COMPARE = IGN1_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition1EndAngle - crankAngle) ) ) ); }
+      if( (ignitionSchedule1.Status == RUNNING) ) { ignitionSchedule1.endCompare = IGN1_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition1EndAngle - crankAngle) ) ) ); IGN1_COMPARE = ignitionSchedule1.endCompare; }
       else if(currentStatus.startRevolutions > MIN_CYCLES_FOR_ENDCOMPARE) { ignitionSchedule1.endCompare = IGN1_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition1EndAngle - crankAngle) ) ) ); ignitionSchedule1.endScheduleSetByDecoder = true; }
     }
     else if ( (currentTooth == ignition2EndTooth) )
     {
-      if( (ignitionSchedule2.Status == RUNNING) ) { IGN2_COMPARE = IGN2_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition2EndAngle - crankAngle) ) ) ); }
+      if( (ignitionSchedule2.Status == RUNNING) ) { ignitionSchedule2.endCompare = IGN2_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition2EndAngle - crankAngle) ) ) ); IGN2_COMPARE = ignitionSchedule2.endCompare; }
       else if(currentStatus.startRevolutions > MIN_CYCLES_FOR_ENDCOMPARE) { ignitionSchedule2.endCompare = IGN2_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition2EndAngle - crankAngle) ) ) ); ignitionSchedule2.endScheduleSetByDecoder = true; }
     }
     else if ( (currentTooth == ignition3EndTooth) )
     {
-      if( (ignitionSchedule3.Status == RUNNING) ) { IGN3_COMPARE = IGN3_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition3EndAngle - crankAngle) ) ) ); }
+      if( (ignitionSchedule3.Status == RUNNING) ) { ignitionSchedule3.endCompare = IGN3_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition3EndAngle - crankAngle) ) ) ); IGN3_COMPARE = ignitionSchedule3.endCompare; }
       else if(currentStatus.startRevolutions > MIN_CYCLES_FOR_ENDCOMPARE) { ignitionSchedule3.endCompare = IGN3_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition3EndAngle - crankAngle) ) ) ); ignitionSchedule3.endScheduleSetByDecoder = true; }
     }
     else if ( (currentTooth == ignition4EndTooth) )
     {
-      if( (ignitionSchedule4.Status == RUNNING) ) { IGN4_COMPARE = IGN4_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition4EndAngle - crankAngle) ) ) ); }
+      if( (ignitionSchedule4.Status == RUNNING) ) { ignitionSchedule4.endCompare = IGN4_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition4EndAngle - crankAngle) ) ) ); IGN4_COMPARE = ignitionSchedule4.endCompare; }
       else if(currentStatus.startRevolutions > MIN_CYCLES_FOR_ENDCOMPARE) { ignitionSchedule4.endCompare = IGN4_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition4EndAngle - crankAngle) ) ) ); ignitionSchedule4.endScheduleSetByDecoder = true; }
     }
 #if IGN_CHANNELS >= 5
     else if ( (currentTooth == ignition5EndTooth) )
     {
-      if( (ignitionSchedule5.Status == RUNNING) ) { IGN5_COMPARE = IGN5_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition5EndAngle - crankAngle) ) ) ); }
+      if( (ignitionSchedule5.Status == RUNNING) ) { ignitionSchedule5.endCompare = IGN5_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition5EndAngle - crankAngle) ) ) ); IGN5_COMPARE = ignitionSchedule5.endCompare; }
       else if(currentStatus.startRevolutions > MIN_CYCLES_FOR_ENDCOMPARE) { ignitionSchedule5.endCompare = IGN5_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition5EndAngle - crankAngle) ) ) ); ignitionSchedule5.endScheduleSetByDecoder = true; }
     }
 #endif
 #if IGN_CHANNELS >= 6
     else if ( (currentTooth == ignition6EndTooth) )
     {
-      if( (ignitionSchedule6.Status == RUNNING) ) { IGN6_COMPARE = IGN6_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition6EndAngle - crankAngle) ) ) ); }
+      if( (ignitionSchedule6.Status == RUNNING) ) { ignitionSchedule6.endCompare = IGN6_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition6EndAngle - crankAngle) ) ) ); IGN6_COMPARE = ignitionSchedule6.endCompare; }
       else if(currentStatus.startRevolutions > MIN_CYCLES_FOR_ENDCOMPARE) { ignitionSchedule6.endCompare = IGN6_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition6EndAngle - crankAngle) ) ) ); ignitionSchedule6.endScheduleSetByDecoder = true; }
     }
 #endif
 #if IGN_CHANNELS >= 7
     else if ( (currentTooth == ignition7EndTooth) )
     {
-      if( (ignitionSchedule7.Status == RUNNING) ) { IGN7_COMPARE = IGN7_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition7EndAngle - crankAngle) ) ) ); }
+      if( (ignitionSchedule7.Status == RUNNING) ) { ignitionSchedule7.endCompare = IGN7_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition7EndAngle - crankAngle) ) ) ); IGN7_COMPARE = ignitionSchedule7.endCompare; }
       else if(currentStatus.startRevolutions > MIN_CYCLES_FOR_ENDCOMPARE) { ignitionSchedule7.endCompare = IGN7_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition7EndAngle - crankAngle) ) ) ); ignitionSchedule7.endScheduleSetByDecoder = true; }
     }
 #endif
 #if IGN_CHANNELS >= 8
     else if ( (currentTooth == ignition8EndTooth) )
     {
-      if( (ignitionSchedule8.Status == RUNNING) ) { IGN8_COMPARE = IGN8_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition8EndAngle - crankAngle) ) ) ); }
+      if( (ignitionSchedule8.Status == RUNNING) ) { ignitionSchedule8.endCompare = IGN8_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition8EndAngle - crankAngle) ) ) ); IGN8_COMPARE = ignitionSchedule8.endCompare; }
       else if(currentStatus.startRevolutions > MIN_CYCLES_FOR_ENDCOMPARE) { ignitionSchedule8.endCompare = IGN8_COUNTER + uS_TO_TIMER_COMPARE( fastDegreesToUS( ignitionLimits( (ignition8EndAngle - crankAngle) ) ) ); ignitionSchedule8.endScheduleSetByDecoder = true; }
     }
 #endif
   }
 }
+
+/*
+Re-targets the start of any fuel or ignition schedule that is due before the next tooth, toothGap degrees after this one (See adjustAngleSchedules() in scheduler.ino).
+Unlike checkPerToothTiming() this does not depend on configPage2.perToothIgn. The decoders only call it on a tooth with sync while angleSchedulesPending is not 0,
+so the crank angle and gap are not worked out on the teeth where there is nothing to do
+*/
+static inline void checkAngleSchedules(int16_t crankAngle, uint16_t toothGap)
+{
+  if(currentStatus.RPM > 0) { adjustAngleSchedules(ignitionLimits(crankAngle), toothGap); }
+}
 /** @} */
   
 /** A (single) multi-tooth wheel with one of more 'missing' teeth.
@@ -361,12 +811,142 @@ static inline void checkPerToothTiming(int16_t crankAngle, uint16_t currentTooth
 * @defgroup dec_miss Missing tooth wheel
 * @{
 */
+
+//Fast re-sync. See missingToothResync() and missingToothSearch()
+#define RESYNC_GAPS         4 //Number of regular tooth gaps kept to measure a wide gap against
+#define RESYNC_MAX_SKIPPED  2 //Most teeth in a row that can fail to register and still be re-synced from
+static unsigned long resyncGaps[RESYNC_GAPS];
+static uint8_t resyncGapIndex;
+static uint8_t resyncGapCount; //Number of gaps in resyncGaps, up to RESYNC_GAPS
+static bool resyncToothOneFromGap; //Whether the last tooth #1 was found from the gap itself, rather than the tooth count running past the end of the wheel
+static unsigned long resyncRevolutionGap; //The average tooth gap over the last revolution between 2 tooth #1s that were both found from the gap, or 0 if there isn't one
+static bool resyncSearch; //Sync was lost and the position is being searched for
+static uint8_t resyncSearchTooth; //The tooth that the last edge was placed at by the search, or 0
+static uint8_t resyncCamTooth; //The primary tooth that the cam pulse has come after on the last 2 cycles, or 0 if it hasn't been the same tooth
+static uint8_t resyncLastCamTooth;
+static volatile bool resyncFromCam; //The cam pulse was seen during the search, so the next primary tooth is resyncCamTooth + 1
+
+/*
+The average of the recent regular tooth gaps, or 0 if they haven't been steady enough to measure against
+*/
+static unsigned long missingToothSteadyGap()
+{
+  if(resyncGapCount < RESYNC_GAPS) { return 0; }
+
+  unsigned long totalGap = 0;
+  unsigned long minGap = resyncGaps[0];
+  unsigned long maxGap = resyncGaps[0];
+  for(uint8_t x = 0; x < RESYNC_GAPS; x++)
+  {
+    totalGap += resyncGaps[x];
+    if(resyncGaps[x] < minGap) { minGap = resyncGaps[x]; }
+    if(resyncGaps[x] > maxGap) { maxGap = resyncGaps[x]; }
+  }
+  unsigned long averageGap = totalGap / RESYNC_GAPS;
+  if( (averageGap == 0) || ((maxGap - minGap) > (averageGap >> 2)) ) { return 0; }
+  return averageGap;
+}
+
+/*
+Places the current edge from the time since the last tooth #1 (Which must have been found from the gap), rather than from the tooth count.
+The tooth is only returned if the edge is within 1/4 of a tooth of it, and if the speed changing by as much as it did over the last revolution could
+not have moved it that far. Otherwise the edge could be one of 2 teeth and 0 is returned. Tooth #1 and the missing teeth are left to the gap detection.
+*/
+static uint16_t missingToothTimeTooth(unsigned long averageGap)
+{
+  if( (averageGap == 0) || (resyncToothOneFromGap == false) || (resyncRevolutionGap == 0) ) { return 0; }
+
+  unsigned long elapsed = curTime - toothOneTime;
+  unsigned long teeth = (elapsed + (averageGap >> 1)) / averageGap;
+  if( (teeth == 0) || (teeth >= triggerActualTeeth) ) { return 0; }
+
+  unsigned long error = (elapsed > (teeth * averageGap)) ? (elapsed - (teeth * averageGap)) : ((teeth * averageGap) - elapsed);
+  unsigned long drift = teeth * ((resyncRevolutionGap > averageGap) ? (resyncRevolutionGap - averageGap) : (averageGap - resyncRevolutionGap));
+  if( (error + drift) > (averageGap >> 2) ) { return 0; }
+  return teeth + 1;
+}
+
+/**
+Called when the missing tooth gap shows up before all the teeth have been counted, which would otherwise drop sync until the next gap (Plus a cam
+pulse when sequential). If the wide gap is the width of a whole number of teeth that didn't register, and the time since tooth #1 puts the edge on the
+same tooth as the count so far plus those teeth, sync is kept. The cam phase (revolutionOne) is carried across rather than having to be found again.
+A couple of dropped teeth near the end of the wheel look the same as the real gap after miscounted teeth. The time since tooth #1 tells these apart,
+and if it doesn't agree with the count (Or can't say) sync is dropped. If it is then dropped, missingToothSearch() looks for the position.
+@param gap - The wide gap that was just seen
+@return The tooth that this edge actually is, or 0 if it can't be placed
+*/
+static uint16_t missingToothResync(unsigned long gap)
+{
+  unsigned long averageGap = missingToothSteadyGap();
+  if( (resyncToothOneFromGap == false) || (averageGap == 0) ) { return 0; }
+
+  //The gap must be close to a whole number of teeth
+  unsigned long teeth = (gap + (averageGap >> 1)) / averageGap;
+  if( (teeth < 2) || (teeth > (RESYNC_MAX_SKIPPED + 1)) ) { return 0; }
+  unsigned long error = (gap > (teeth * averageGap)) ? (gap - (teeth * averageGap)) : ((teeth * averageGap) - gap);
+  if(error > (averageGap >> 2)) { return 0; }
+
+  uint16_t resyncTooth = toothCurrentCount + (teeth - 1);
+  if(resyncTooth != missingToothTimeTooth(averageGap)) { return 0; }
+  return resyncTooth;
+}
+
+/**
+Looks for the position after sync has been lost, so that it isn't only found again at the next gap.
+- When the cam pulse has been after the same tooth on the last 2 cycles (With VVT off, and not close to either tooth edge), the tooth after the cam
+  pulse is that tooth + 1. The cam pulse also sets the phase, so this works whether or not the loss was from the cam phase.
+- Otherwise the edge is placed from the time since the last tooth #1 (See missingToothTimeTooth()). A single edge could be noise, so it must be placed
+  at the tooth after the one that the previous edge was placed at. The cam phase from before the loss is carried across.
+Called for each regular tooth while resyncSearch is set
+*/
+static void missingToothSearch()
+{
+  uint8_t tooth = 0;
+  if(resyncFromCam == true) { tooth = resyncCamTooth + 1; }
+  else
+  {
+    uint8_t timeTooth = missingToothTimeTooth(missingToothSteadyGap());
+    if( (timeTooth > 0) && (timeTooth == (resyncSearchTooth + 1)) ) { tooth = timeTooth; }
+    resyncSearchTooth = timeTooth;
+  }
+  resyncFromCam = false;
+
+  if(tooth > 0)
+  {
+    toothCurrentCount = tooth;
+    resyncSearch = false;
+    currentStatus.hasSync = true;
+    BIT_CLEAR(currentStatus.status3, BIT_STATUS3_HALFSYNC);
+  }
+}
+
+/*
+Called on the cams reference edge. While in sync this learns which tooth the cam pulse comes after, and during a search it flags that the position can
+be taken from the cam
+*/
+static void missingToothCamResync()
+{
+  //The cam pulse must be well clear of both teeth either side of it, or jitter could put it after a different tooth. VVT moves it
+  unsigned long averageGap = missingToothSteadyGap();
+  unsigned long phase = curTime2 - toothLastToothTime;
+  bool isClear = (averageGap > 0) && (phase > (averageGap >> 2)) && (phase < (averageGap - (averageGap >> 2))) && (configPage6.vvtEnabled == 0);
+
+  if(currentStatus.hasSync == true)
+  {
+    uint8_t camTooth = (isClear == true) ? toothCurrentCount : 0;
+    resyncCamTooth = ( (camTooth == resyncLastCamTooth) && (camTooth < triggerActualTeeth) ) ? camTooth : 0;
+    resyncLastCamTooth = camTooth;
+  }
+  else if( (resyncSearch == true) && (resyncCamTooth > 0) && (isClear == true) ) { resyncFromCam = true; }
+}
+
 void triggerSetup_missingTooth()
 {
-  triggerToothAngle = 360 / configPage4.triggerTeeth; //The number of degrees that passes from tooth to tooth
-  if(configPage4.TrigSpeed == CAM_SPEED) { triggerToothAngle = 720 / configPage4.triggerTeeth; } //Account for cam speed missing tooth
-  triggerActualTeeth = configPage4.triggerTeeth - configPage4.triggerMissingTeeth; //The number of physical teeth on the wheel. Doing this here saves us a calculation each time in the interrupt
-  triggerFilterTime = (1000000 / (MAX_RPM / 60 * configPage4.triggerTeeth)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be disgarded as noise
+  byte triggerTeeth = getTriggerTeeth();
+  triggerToothAngle = 360 / triggerTeeth; //The number of degrees that passes from tooth to tooth
+  if(configPage4.TrigSpeed == CAM_SPEED) { triggerToothAngle = 720 / triggerTeeth; } //Account for cam speed missing tooth
+  triggerActualTeeth = triggerTeeth - configPage4.triggerMissingTeeth; //The number of physical teeth on the wheel. Doing this here saves us a calculation each time in the interrupt
+  triggerFilterTime = (1000000 / (MAX_RPM / 60 * triggerTeeth)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be disgarded as noise
   if (configPage4.trigPatternSec == SEC_TRIGGER_4_1)
   {
     triggerSecFilterTime = 1000000 * 60 / MAX_RPM / 4 / 2;
@@ -375,14 +955,23 @@ void triggerSetup_missingTooth()
   {
     triggerSecFilterTime = (1000000 / (MAX_RPM / 60));
   }
-  secondDerivEnabled = false;
+  secondDerivEnabled = true;
   decoderIsSequential = false;
-  checkSyncToothCount = (configPage4.triggerTeeth) >> 1; //50% of the total teeth.
+  checkSyncToothCount = (triggerTeeth) >> 1; //50% of the total teeth.
   toothLastMinusOneToothTime = 0;
   toothCurrentCount = 0;
   secondaryToothCount = 0; 
   toothOneTime = 0;
   toothOneMinusOneTime = 0;
+  resyncGapCount = 0;
+  resyncToothOneFromGap = false;
+  resyncRevolutionGap = 0;
+  resyncSearch = false;
+  resyncCamTooth = 0;
+  resyncLastCamTooth = 0;
+  resyncFromCam = false;
+  setEvenToothAngles(triggerTeeth, triggerToothAngle, 0);
+  if(configPage4.TrigSpeed == CRANK_SPEED) { setSecondRevolutionToothAngles(triggerTeeth); }
   MAX_STALL_TIME = (3333UL * triggerToothAngle * (configPage4.triggerMissingTeeth + 1)); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
 }
 
@@ -420,12 +1009,28 @@ void triggerPri_missingTooth()
           {
             //Missing tooth detected
             isMissingTooth = true;
-            if( (toothCurrentCount < triggerActualTeeth) && (currentStatus.hasSync == true) ) 
+            uint16_t resyncTooth = 0;
+            if( (toothCurrentCount < triggerActualTeeth) && (currentStatus.hasSync == true) ) { resyncTooth = missingToothResync(curGap); }
+
+            if(resyncTooth > 0)
+            {
+                //Teeth that didn't register rather than the gap. Carry on from the tooth this really is
+                toothCurrentCount = resyncTooth;
+                toothLastMinusOneToothTime = toothLastToothTime;
+                toothLastToothTime = curTime;
+                triggerToothAngleIsCorrect = false; //The gap covered more than one tooth
+            }
+            else if( (toothCurrentCount < triggerActualTeeth) && (currentStatus.hasSync == true) ) 
             { 
                 //This occurs when we're at tooth #1, but haven't seen all the other teeth. This indicates a signal issue so we flag lost sync so this will attempt to resync on the next revolution.
                 currentStatus.hasSync = false;
                 BIT_CLEAR(currentStatus.status3, BIT_STATUS3_HALFSYNC); //No sync at all, so also clear HalfSync bit.
-                currentStatus.syncLossCounter++;
+                triggerSyncLoss(SYNC_LOSS_UNEXPECTED_GAP);
+                resyncSearch = true;
+                resyncSearchTooth = 0;
+                //The next gap is measured from this edge, otherwise it would include this wide gap and be taken as the missing tooth
+                toothLastMinusOneToothTime = toothLastToothTime;
+                toothLastToothTime = curTime;
             }
             //This is to handle a special case on startup where sync can be obtained and the system immediately thinks the revs have jumped:
             //else if (currentStatus.hasSync == false && toothCurrentCount < checkSyncToothCount ) { triggerFilterTime = 0; }
@@ -439,6 +1044,11 @@ void triggerPri_missingTooth()
                 else { currentStatus.startRevolutions = 0; }
                 
                 toothCurrentCount = 1;
+                //The revolution can only be measured between 2 tooth #1s that were both found from the gap
+                if( (resyncToothOneFromGap == true) && (curGap > targetGap) ) { resyncRevolutionGap = (curTime - toothOneTime) / getTriggerTeeth(); }
+                else { resyncRevolutionGap = 0; }
+                resyncToothOneFromGap = (curGap > targetGap);
+                resyncSearch = false;
                 if (configPage4.trigPatternSec == SEC_TRIGGER_POLL) // at tooth one check if the cam sensor is high or low in poll level mode
                 {
                   if (configPage4.PollLevelPolarity == READ_SEC_TRIGGER()) { revolutionOne = 1; }
@@ -474,9 +1084,13 @@ void triggerPri_missingTooth()
         {
           //Regular (non-missing) tooth
           setFilter(curGap);
+          resyncGaps[resyncGapIndex] = curGap;
+          resyncGapIndex = (resyncGapIndex + 1) % RESYNC_GAPS;
+          if(resyncGapCount < RESYNC_GAPS) { resyncGapCount++; }
           toothLastMinusOneToothTime = toothLastToothTime;
           toothLastToothTime = curTime;
           triggerToothAngleIsCorrect = true;
+          if(resyncSearch == true) { missingToothSearch(); }
         }
       }
       else
@@ -490,15 +1104,19 @@ void triggerPri_missingTooth()
       //NEW IGNITION MODE
       if( (configPage2.perToothIgn == true) && (!BIT_CHECK(currentStatus.engine, BIT_ENGINE_CRANK)) ) 
       {
-        int16_t crankAngle = ( (toothCurrentCount-1) * triggerToothAngle ) + configPage4.triggerAngle;
-        crankAngle = ignitionLimits(crankAngle);
-        if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) )
-        {
-          crankAngle += 360;
-          checkPerToothTiming(crankAngle, (configPage4.triggerTeeth + toothCurrentCount)); 
-        }
+        bool secondRevolution = (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED);
+        int16_t crankAngle = ignitionLimits( getCycleToothAngle(toothCurrentCount, secondRevolution) + configPage4.triggerAngle );
+        if(secondRevolution == true) { checkPerToothTiming(crankAngle, (configPage4.triggerTeeth + toothCurrentCount)); }
         else{ checkPerToothTiming(crankAngle, toothCurrentCount); }
       }
+
+      //Re-target any schedule that was set with an angle. The gap after the last tooth includes the missing teeth
+      if( (angleSchedulesPending != 0) && (currentStatus.hasSync == true) )
+      {
+        bool secondRevolution = (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED);
+        int16_t crankAngle = getCycleToothAngle(toothCurrentCount, secondRevolution) + configPage4.triggerAngle;
+        checkAngleSchedules(crankAngle, getToothGap(toothCurrentCount, triggerActualTeeth, ((configPage4.TrigSpeed == CAM_SPEED) ? 720 : 360)));
+      }
    }
 }
 
@@ -525,6 +1143,7 @@ void triggerSec_missingTooth()
         secondaryToothCount = 1;
         revolutionOne = 1; //Sequential revolution reset
         triggerSecFilterTime = 0; //This is used to prevent a condition where serious intermitent signals (Eg someone furiously plugging the sensor wire in and out) can leave the filter in an unrecoverable state
+        missingToothCamResync();
       }
       else
       {
@@ -537,6 +1156,7 @@ void triggerSec_missingTooth()
       //Standard single tooth cam trigger
       revolutionOne = 1; //Sequential revolution reset
       triggerSecFilterTime = curGap2 >> 1; //Next secondary filter is half the current gap
+      missingToothCamResync();
       secondaryToothCount++;
     }
     toothLastSecToothTime = curTime2;
@@ -572,12 +1192,12 @@ uint16_t getRPM_missingTooth()
   uint16_t tempRPM = 0;
   if( currentStatus.RPM < currentStatus.crankRPM )
   {
-    if(toothCurrentCount != 1)
+    if( (toothCurrentCount != 1) && (triggerToothAngleIsCorrect == true) )
     {
-      if(configPage4.TrigSpeed == CAM_SPEED) { tempRPM = crankingGetRPM(configPage4.triggerTeeth, 720); } //Account for cam speed
-      else { tempRPM = crankingGetRPM(configPage4.triggerTeeth, 360); }
+      if(configPage4.TrigSpeed == CAM_SPEED) { tempRPM = crankingGetRPM(getTriggerTeeth(), 720); } //Account for cam speed
+      else { tempRPM = crankingGetRPM(getTriggerTeeth(), 360); }
     }
-    else { tempRPM = currentStatus.RPM; } //Can't do per tooth RPM if we're at tooth #1 as the missing tooth messes the calculation
+    else { tempRPM = currentStatus.RPM; } //Can't do per tooth RPM if we're at tooth #1 (Or just after a re-sync) as the missing tooth messes the calculation
   }
   else
   {
@@ -594,20 +1214,19 @@ int getCrankAngle_missingTooth()
     int tempToothCurrentCount;
     bool tempRevolutionOne;
     //Grab some variables that are used in the trigger code and assign them to temp variables.
-    noInterrupts();
-    tempToothCurrentCount = toothCurrentCount;
-    tempRevolutionOne = revolutionOne;
-    tempToothLastToothTime = toothLastToothTime;
-    interrupts();
+    struct triggerSnapshot snapshot;
+    getTriggerSnapshot(snapshot);
+    tempToothCurrentCount = snapshot.toothCurrentCount;
+    tempRevolutionOne = snapshot.revolutionOne;
+    tempToothLastToothTime = snapshot.toothLastToothTime;
 
-    int crankAngle = ((tempToothCurrentCount - 1) * triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
-    
+    //The angle of the last tooth seen, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
     //Sequential check (simply sets whether we're on the first or 2nd revoltuion of the cycle)
-    if ( (tempRevolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) ) { crankAngle += 360; }
+    int crankAngle = getCycleToothAngle(tempToothCurrentCount, ( (tempRevolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) )) + configPage4.triggerAngle;
 
     lastCrankAngleCalc = micros();
     elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
+    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
     if (crankAngle >= 720) { crankAngle -= 720; }
     else if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -621,70 +1240,8 @@ void triggerSetEndTeeth_missingTooth()
   byte toothAdder = 0;
   if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (configPage4.TrigSpeed == CRANK_SPEED) ) { toothAdder = configPage4.triggerTeeth; }
 
-  //Temp variables are used here to avoid potential issues if a trigger interrupt occurs part way through this function
-
-  int16_t tempIgnition1EndTooth;
-  tempIgnition1EndTooth = ( (ignition1EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) ) - 1;
-  if(tempIgnition1EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition1EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition1EndTooth <= 0) { tempIgnition1EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  if((uint16_t)tempIgnition1EndTooth > (triggerActualTeeth + toothAdder)) { tempIgnition1EndTooth = (triggerActualTeeth + toothAdder); }
-  ignition1EndTooth = tempIgnition1EndTooth;
-
-  int16_t tempIgnition2EndTooth;
-  tempIgnition2EndTooth = ( (ignition2EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) ) - 1;
-  if(tempIgnition2EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition2EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition2EndTooth <= 0) { tempIgnition2EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  if((uint16_t)tempIgnition2EndTooth > (triggerActualTeeth + toothAdder)) { tempIgnition2EndTooth = (triggerActualTeeth + toothAdder); }
-  ignition2EndTooth = tempIgnition2EndTooth;
-
-  int16_t tempIgnition3EndTooth;
-  tempIgnition3EndTooth = ( (ignition3EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) ) - 1;
-  if(tempIgnition3EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition3EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition3EndTooth <= 0) { tempIgnition3EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  if((uint16_t)tempIgnition3EndTooth > (triggerActualTeeth + toothAdder)) { tempIgnition3EndTooth = (triggerActualTeeth + toothAdder); }
-  ignition3EndTooth = tempIgnition3EndTooth;
-
-  int16_t tempIgnition4EndTooth;
-  tempIgnition4EndTooth = ( (ignition4EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) ) - 1;
-  if(tempIgnition4EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition4EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition4EndTooth <= 0) { tempIgnition4EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  if((uint16_t)tempIgnition4EndTooth > (triggerActualTeeth + toothAdder)) { tempIgnition4EndTooth = (triggerActualTeeth + toothAdder); }
-  ignition4EndTooth = tempIgnition4EndTooth;
-
-#if IGN_CHANNELS >= 5
-  int16_t tempIgnition5EndTooth;
-  tempIgnition5EndTooth = ( (ignition5EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) ) - 1;
-  if(tempIgnition5EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition5EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition5EndTooth <= 0) { tempIgnition5EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  if((uint16_t)tempIgnition5EndTooth > (triggerActualTeeth + toothAdder)) { tempIgnition5EndTooth = (triggerActualTeeth + toothAdder); }
-  ignition5EndTooth = tempIgnition5EndTooth;
-#endif
-#if IGN_CHANNELS >= 6
-  int16_t tempIgnition6EndTooth;
-  tempIgnition6EndTooth = ( (ignition6EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) ) - 1;
-  if(tempIgnition6EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition6EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition6EndTooth <= 0) { tempIgnition6EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  if((uint16_t)tempIgnition6EndTooth > (triggerActualTeeth + toothAdder)) { tempIgnition6EndTooth = (triggerActualTeeth + toothAdder); }
-  ignition6EndTooth = tempIgnition6EndTooth;
-#endif
-#if IGN_CHANNELS >= 7
-  int16_t tempIgnition7EndTooth;
-  tempIgnition7EndTooth = ( (ignition7EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) ) - 1;
-  if(tempIgnition7EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition7EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition7EndTooth <= 0) { tempIgnition7EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  if((uint16_t)tempIgnition7EndTooth > (triggerActualTeeth + toothAdder)) { tempIgnition7EndTooth = (triggerActualTeeth + toothAdder); }
-  ignition7EndTooth = tempIgnition7EndTooth;
-#endif
-#if IGN_CHANNELS >= 8
-  int16_t tempIgnition8EndTooth;
-  tempIgnition8EndTooth = ( (ignition8EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) ) - 1;
-  if(tempIgnition8EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition8EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition8EndTooth <= 0) { tempIgnition8EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  if((uint16_t)tempIgnition8EndTooth > (triggerActualTeeth + toothAdder)) { tempIgnition8EndTooth = (triggerActualTeeth + toothAdder); }
-  ignition8EndTooth = tempIgnition8EndTooth;
-#endif
-
-  lastToothCalcAdvance = currentStatus.advance;
+  //The end is set from the tooth before the one the angle falls on, and is limited to the last tooth before the gap
+  setEvenEndTeeth(-1, configPage4.triggerTeeth + toothAdder, triggerActualTeeth + toothAdder);
 }
 /** @} */
 
@@ -698,26 +1255,33 @@ Note: There can be no missing teeth on the primary wheel.
  * */
 void triggerSetup_DualWheel()
 {
-  triggerToothAngle = 360 / configPage4.triggerTeeth; //The number of degrees that passes from tooth to tooth
-  if(configPage4.TrigSpeed == 1) { triggerToothAngle = 720 / configPage4.triggerTeeth; } //Account for cam speed
+  triggerToothAngle = 360 / getTriggerTeeth(); //The number of degrees that passes from tooth to tooth
+  if(configPage4.TrigSpeed == 1) { triggerToothAngle = 720 / getTriggerTeeth(); } //Account for cam speed
   toothCurrentCount = 255; //Default value
-  triggerFilterTime = (1000000 / (MAX_RPM / 60 * configPage4.triggerTeeth)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be disgarded as noise
+  triggerFilterTime = (1000000 / (MAX_RPM / 60 * getTriggerTeeth())); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be disgarded as noise
   triggerSecFilterTime = (1000000 / (MAX_RPM / 60 * 2)) / 2; //Same as above, but fixed at 2 teeth on the secondary input and divided by 2 (for cam speed)
-  secondDerivEnabled = false;
+  secondDerivEnabled = true;
   decoderIsSequential = true;
   triggerToothAngleIsCorrect = true; //This is always true for this pattern
+  setEvenToothAngles(getTriggerTeeth(), triggerToothAngle, 0);
+  if(configPage4.TrigSpeed == CRANK_SPEED) { setSecondRevolutionToothAngles(getTriggerTeeth()); }
   MAX_STALL_TIME = (3333UL * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
 }
 
 /** Dual Wheel Primary.
  * 
  * */
-void triggerPri_DualWheel()
+/*
+The primary tooth handling, which the non-360 decoder shares. Returns whether the tooth passed the filter
+*/
+static inline bool dualWheelPrimaryTooth()
 {
+    bool toothValid = false;
     curTime = micros();
     curGap = curTime - toothLastToothTime;
     if ( curGap >= triggerFilterTime )
     {
+      toothValid = true;
       toothCurrentCount++; //Increment the tooth counter
       validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
 
@@ -741,15 +1305,23 @@ void triggerPri_DualWheel()
       //NEW IGNITION MODE
       if( (configPage2.perToothIgn == true) && (!BIT_CHECK(currentStatus.engine, BIT_ENGINE_CRANK)) ) 
       {
-        int16_t crankAngle = ( (toothCurrentCount-1) * triggerToothAngle ) + configPage4.triggerAngle;
-        if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) )
-        {
-          crankAngle += 360;
-          checkPerToothTiming(crankAngle, (configPage4.triggerTeeth + toothCurrentCount)); 
-        }
+        bool secondRevolution = (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED);
+        int16_t crankAngle = getCycleToothAngle(toothCurrentCount, secondRevolution) + configPage4.triggerAngle;
+        if(secondRevolution == true) { checkPerToothTiming(crankAngle, (configPage4.triggerTeeth + toothCurrentCount)); }
         else{ checkPerToothTiming(crankAngle, toothCurrentCount); }
       }
    } //Trigger filter
+   return toothValid;
+}
+
+void triggerPri_DualWheel()
+{
+  if( dualWheelPrimaryTooth() && (angleSchedulesPending != 0) && (currentStatus.hasSync == true) )
+  {
+    bool secondRevolution = (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED);
+    int16_t crankAngle = getCycleToothAngle(toothCurrentCount, secondRevolution) + configPage4.triggerAngle;
+    checkAngleSchedules(crankAngle, getToothGap(toothCurrentCount, getTriggerTeeth(), ((configPage4.TrigSpeed == CAM_SPEED) ? 720 : 360)));
+  }
 }
 /** Dual Wheel Secondary.
  * 
@@ -766,14 +1338,14 @@ void triggerSec_DualWheel()
     if(currentStatus.hasSync == false)
     {
       toothLastToothTime = micros();
-      toothLastMinusOneToothTime = micros() - (6000000 / configPage4.triggerTeeth); //Fixes RPM at 10rpm until a full revolution has taken place
+      toothLastMinusOneToothTime = micros() - (6000000 / getTriggerTeeth()); //Fixes RPM at 10rpm until a full revolution has taken place
       toothCurrentCount = configPage4.triggerTeeth;
 
       currentStatus.hasSync = true;
     }
     else 
     {
-      if ( (toothCurrentCount != configPage4.triggerTeeth) && (currentStatus.startRevolutions > 2)) { currentStatus.syncLossCounter++; } //Indicates likely sync loss.
+      if ( (toothCurrentCount != configPage4.triggerTeeth) && (currentStatus.startRevolutions > 2)) { triggerSyncLoss(SYNC_LOSS_CAM_MISMATCH); } //Indicates likely sync loss.
       if (configPage4.useResync == 1) { toothCurrentCount = configPage4.triggerTeeth; }
     }
 
@@ -792,7 +1364,7 @@ uint16_t getRPM_DualWheel()
   uint16_t tempRPM = 0;
   if( currentStatus.hasSync == true )
   {
-    if(currentStatus.RPM < currentStatus.crankRPM) { tempRPM = crankingGetRPM(configPage4.triggerTeeth, 360); }
+    if(currentStatus.RPM < currentStatus.crankRPM) { tempRPM = crankingGetRPM(getTriggerTeeth(), 360); }
     else { tempRPM = stdGetRPM(360); }
   }
   return tempRPM;
@@ -807,23 +1379,22 @@ int getCrankAngle_DualWheel()
     int tempToothCurrentCount;
     bool tempRevolutionOne;
     //Grab some variables that are used in the trigger code and assign them to temp variables.
-    noInterrupts();
-    tempToothCurrentCount = toothCurrentCount;
-    tempToothLastToothTime = toothLastToothTime;
-    tempRevolutionOne = revolutionOne;
+    struct triggerSnapshot snapshot;
+    getTriggerSnapshot(snapshot);
+    tempToothCurrentCount = snapshot.toothCurrentCount;
+    tempToothLastToothTime = snapshot.toothLastToothTime;
+    tempRevolutionOne = snapshot.revolutionOne;
     lastCrankAngleCalc = micros();
-    interrupts();
 
     //Handle case where the secondary tooth was the last one seen
     if(tempToothCurrentCount == 0) { tempToothCurrentCount = configPage4.triggerTeeth; }
 
-    int crankAngle = ((tempToothCurrentCount - 1) * triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+    //The angle of the last tooth seen, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+    //Sequential check (simply sets whether we're on the first or 2nd revoltuion of the cycle)
+    int crankAngle = getCycleToothAngle(tempToothCurrentCount, tempRevolutionOne) + configPage4.triggerAngle;
 
     elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
-
-    //Sequential check (simply sets whether we're on the first or 2nd revoltuion of the cycle)
-    if (tempRevolutionOne) { crankAngle += 360; }
+    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
     if (crankAngle >= 720) { crankAngle -= 720; }
     if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -840,61 +1411,7 @@ void triggerSetEndTeeth_DualWheel()
   byte toothAdder = 0;
   if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (configPage4.TrigSpeed == CRANK_SPEED) ) { toothAdder = configPage4.triggerTeeth; }
 
-  int16_t tempIgnition1EndTooth;
-  tempIgnition1EndTooth = ( (ignition1EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) );
-  if(tempIgnition1EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition1EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition1EndTooth <= 0) { tempIgnition1EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  ignition1EndTooth = tempIgnition1EndTooth;
-
-  int16_t tempIgnition2EndTooth;
-  tempIgnition2EndTooth = ( (ignition2EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) );
-  if(tempIgnition2EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition2EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition2EndTooth <= 0) { tempIgnition2EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  ignition2EndTooth = tempIgnition2EndTooth;
-
-  int16_t tempIgnition3EndTooth;
-  tempIgnition3EndTooth = ( (ignition3EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) );
-  if(tempIgnition3EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition3EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition3EndTooth <= 0) { tempIgnition3EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  ignition3EndTooth = tempIgnition3EndTooth;
-
-  int16_t tempIgnition4EndTooth;
-  tempIgnition4EndTooth = ( (ignition4EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) );
-  if(tempIgnition4EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition4EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition4EndTooth <= 0) { tempIgnition4EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  ignition4EndTooth = tempIgnition4EndTooth;
-
-#if IGN_CHANNELS >= 5
-  int16_t tempIgnition5EndTooth;
-  tempIgnition5EndTooth = ( (ignition5EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) );
-  if(tempIgnition5EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition5EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition5EndTooth <= 0) { tempIgnition5EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  ignition5EndTooth = tempIgnition5EndTooth;
-#endif
-#if IGN_CHANNELS >= 6
-  int16_t tempIgnition6EndTooth;
-  tempIgnition6EndTooth = ( (ignition6EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) );
-  if(tempIgnition6EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition6EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition6EndTooth <= 0) { tempIgnition6EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  ignition6EndTooth = tempIgnition6EndTooth;
-#endif
-#if IGN_CHANNELS >= 7
-  int16_t tempIgnition7EndTooth;
-  tempIgnition7EndTooth = ( (ignition7EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) );
-  if(tempIgnition7EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition7EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition7EndTooth <= 0) { tempIgnition7EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  ignition7EndTooth = tempIgnition7EndTooth;
-#endif
-#if IGN_CHANNELS >= 8
-  int16_t tempIgnition8EndTooth;
-  tempIgnition8EndTooth = ( (ignition8EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) );
-  if(tempIgnition8EndTooth > (configPage4.triggerTeeth + toothAdder)) { tempIgnition8EndTooth -= (configPage4.triggerTeeth + toothAdder); }
-  if(tempIgnition8EndTooth <= 0) { tempIgnition8EndTooth += (configPage4.triggerTeeth + toothAdder); }
-  ignition8EndTooth = tempIgnition8EndTooth;
-#endif
-
-  lastToothCalcAdvance = currentStatus.advance;
-
+  setEvenEndTeeth(0, configPage4.triggerTeeth + toothAdder, 0);
 }
 /** @} */
 
@@ -910,14 +1427,15 @@ void triggerSetup_BasicDistributor()
   triggerActualTeeth = configPage2.nCylinders;
   if(triggerActualTeeth == 0) { triggerActualTeeth = 1; }
   triggerToothAngle = 720 / triggerActualTeeth; //The number of degrees that passes from tooth to tooth
-  triggerFilterTime = 60000000L / MAX_RPM / configPage2.nCylinders; // Minimum time required between teeth
+  triggerFilterTime = 60000000L / MAX_RPM / triggerActualTeeth; // Minimum time required between teeth
   triggerFilterTime = triggerFilterTime / 2; //Safety margin
   triggerFilterTime = 0;
-  secondDerivEnabled = false;
+  secondDerivEnabled = true;
   decoderIsSequential = false;
   toothCurrentCount = 0; //Default value
   decoderHasFixedCrankingTiming = true;
   triggerToothAngleIsCorrect = true;
+  setEvenToothAngles(triggerActualTeeth, triggerToothAngle, 0);
   if(configPage2.nCylinders <= 4) { MAX_STALL_TIME = (1851UL * triggerToothAngle); }//Minimum 90rpm. (1851uS is the time per degree at 90rpm). This uses 90rpm rather than 50rpm due to the potentially very high stall time on a 4 cylinder if we wait that long.
   else { MAX_STALL_TIME = (3200UL * triggerToothAngle); } //Minimum 50rpm. (3200uS is the time per degree at 50rpm).
 
@@ -949,7 +1467,7 @@ void triggerPri_BasicDistributor()
         //If we have sync here then there's a problem. Throw a sync loss
         if( currentStatus.hasSync == true ) 
         { 
-          currentStatus.syncLossCounter++;
+          triggerSyncLoss(SYNC_LOSS_TOO_MANY_TEETH);
           currentStatus.hasSync = false;
         }
       }
@@ -968,7 +1486,7 @@ void triggerPri_BasicDistributor()
 
     if(configPage2.perToothIgn == true)
     {
-      int16_t crankAngle = ( (toothCurrentCount-1) * triggerToothAngle ) + configPage4.triggerAngle;
+      int16_t crankAngle = getToothAngle(toothCurrentCount) + configPage4.triggerAngle;
       crankAngle = ignitionLimits((crankAngle));
       if(toothCurrentCount > (triggerActualTeeth/2) ) { checkPerToothTiming(crankAngle, (toothCurrentCount - (triggerActualTeeth/2))); }
       else { checkPerToothTiming(crankAngle, toothCurrentCount); }
@@ -976,6 +1494,8 @@ void triggerPri_BasicDistributor()
 
     toothLastMinusOneToothTime = toothLastToothTime;
     toothLastToothTime = curTime;
+
+    if( (angleSchedulesPending != 0) && (currentStatus.hasSync == true) ) { checkAngleSchedules(getToothAngle(toothCurrentCount) + configPage4.triggerAngle, getToothGap(toothCurrentCount, triggerActualTeeth, 720)); }
   } //Trigger filter
 }
 void triggerSec_BasicDistributor() { return; } //Not required
@@ -1001,13 +1521,13 @@ int getCrankAngle_BasicDistributor()
     unsigned long tempToothLastToothTime;
     int tempToothCurrentCount;
     //Grab some variables that are used in the trigger code and assign them to temp variables.
-    noInterrupts();
-    tempToothCurrentCount = toothCurrentCount;
-    tempToothLastToothTime = toothLastToothTime;
-    lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-    interrupts();
+    struct triggerSnapshot snapshot;
+    getTriggerSnapshot(snapshot);
+    tempToothCurrentCount = snapshot.toothCurrentCount;
+    tempToothLastToothTime = snapshot.toothLastToothTime;
+    lastCrankAngleCalc = micros();
 
-    int crankAngle = ((tempToothCurrentCount - 1) * triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+    int crankAngle = getToothAngle(tempToothCurrentCount) + configPage4.triggerAngle; //The angle of the last tooth seen, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
     
     //Estimate the number of degrees travelled since the last tooth}
     elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
@@ -1055,7 +1575,15 @@ void triggerSetEndTeeth_BasicDistributor()
 void triggerSetup_GM7X()
 {
   triggerToothAngle = 360 / 6; //The number of degrees that passes from tooth to tooth
-  secondDerivEnabled = false;
+  toothAngles[0] = 42;  //tooth #1
+  toothAngles[1] = 102; //tooth #2
+  toothAngles[2] = 112; //tooth #3, the extra reference tooth
+  toothAngles[3] = 162; //tooth #4
+  toothAngles[4] = 222; //tooth #5
+  toothAngles[5] = 282; //tooth #6
+  toothAngles[6] = 342; //tooth #7
+  toothAnglesCount = 7;
+  secondDerivEnabled = true;
   decoderIsSequential = false;
   MAX_STALL_TIME = (3333UL * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
 }
@@ -1088,6 +1616,10 @@ void triggerPri_GM7X()
           triggerToothAngleIsCorrect = false;
           currentStatus.startRevolutions++; //Counter
         }
+        else if(toothCurrentCount == 4)
+        {
+          triggerToothAngleIsCorrect = false; //The gap from the extra tooth to tooth #4 is 50 degrees, not triggerToothAngle
+        }
         else
         {
           triggerToothAngleIsCorrect = true;
@@ -1101,15 +1633,7 @@ void triggerPri_GM7X()
       if(toothCurrentCount != 3) //Never do the check on the extra tooth. It's not needed anyway
       {
         //configPage4.triggerAngle must currently be below 48 and above -81
-        int16_t crankAngle;
-        if( toothCurrentCount < 3 )
-        {
-          crankAngle = ((toothCurrentCount - 1) * triggerToothAngle) + 42 + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
-        }
-        else
-        {
-          crankAngle = ((toothCurrentCount - 2) * triggerToothAngle) + 42 + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
-        }
+        int16_t crankAngle = getToothAngle(toothCurrentCount) + configPage4.triggerAngle;
         checkPerToothTiming(crankAngle, toothCurrentCount);
       } 
     }
@@ -1117,6 +1641,9 @@ void triggerPri_GM7X()
     toothLastMinusOneToothTime = toothLastToothTime;
     toothLastToothTime = curTime;
 
+    //Schedules set with an angle can use the extra tooth, as its angle is known
+    if( (angleSchedulesPending != 0) && (currentStatus.hasSync == true) ) { checkAngleSchedules(getToothAngle(toothCurrentCount) + configPage4.triggerAngle, getToothGap(toothCurrentCount, 7, 360)); }
+
 
 }
 void triggerSec_GM7X() { return; } //Not required
@@ -1130,30 +1657,18 @@ int getCrankAngle_GM7X()
     unsigned long tempToothLastToothTime;
     int tempToothCurrentCount;
     //Grab some variables that are used in the trigger code and assign them to temp variables.
-    noInterrupts();
-    tempToothCurrentCount = toothCurrentCount;
-    tempToothLastToothTime = toothLastToothTime;
-    lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-    interrupts();
+    struct triggerSnapshot snapshot;
+    getTriggerSnapshot(snapshot);
+    tempToothCurrentCount = snapshot.toothCurrentCount;
+    tempToothLastToothTime = snapshot.toothLastToothTime;
+    lastCrankAngleCalc = micros();
 
-    //Check if the last tooth seen was the reference tooth (Number 3). All others can be calculated, but tooth 3 has a unique angle
-    int crankAngle;
-    if( tempToothCurrentCount < 3 )
-    {
-      crankAngle = ((tempToothCurrentCount - 1) * triggerToothAngle) + 42 + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
-    }
-    else if( tempToothCurrentCount == 3 )
-    {
-      crankAngle = 112;
-    }
-    else
-    {
-      crankAngle = ((tempToothCurrentCount - 2) * triggerToothAngle) + 42 + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
-    }
+    //The reference tooth (Number 3) has its own entry in the table, so needs no special case here
+    int crankAngle = getToothAngle(tempToothCurrentCount) + configPage4.triggerAngle;
 
     //Estimate the number of degrees travelled since the last tooth}
     elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
+    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
     if (crankAngle >= 720) { crankAngle -= 720; }
     if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -1191,9 +1706,10 @@ Tooth number one is at 355* ATDC.
 */
 void triggerSetup_4G63()
 {
+  toothAnglesCount = 0; //This decoder indexes toothAngles directly, so getToothAngle() must not use it
   triggerToothAngle = 180; //The number of degrees that passes from tooth to tooth (primary)
   toothCurrentCount = 99; //Fake tooth count represents no sync
-  secondDerivEnabled = false;
+  secondDerivEnabled = true;
   decoderIsSequential = true;
   decoderHasFixedCrankingTiming = true;
   triggerToothAngleIsCorrect = true;
@@ -1401,6 +1917,7 @@ void triggerPri_4G63()
           else { checkPerToothTiming(crankAngle, toothCurrentCount); }
         }
       }
+      if(angleSchedulesPending != 0) { checkAngleSchedules(toothAngles[(toothCurrentCount-1)] + configPage4.triggerAngle, getTableToothGap(toothCurrentCount, triggerActualTeeth, 720)); }
     } //Has sync
     else
     {
@@ -1500,7 +2017,7 @@ void triggerSec_4G63()
           { 
             // This should never be true, except when there's noise
             currentStatus.hasSync = false; 
-            currentStatus.syncLossCounter++;
+            triggerSyncLoss(SYNC_LOSS_CAM_MISMATCH);
           } 
           else { toothCurrentCount = 8; } //Why? Just why?
         }
@@ -1524,10 +2041,10 @@ uint16_t getRPM_4G63()
       if( (toothLastToothTime == 0) || (toothLastMinusOneToothTime == 0) ) { tempRPM = 0; }
       else
       {
-        noInterrupts();
-        tempToothAngle = triggerToothAngle;
-        toothTime = (toothLastToothTime - toothLastMinusOneToothTime); //Note that trigger tooth angle changes between 70 and 110 depending on the last tooth that was seen (or 70/50 for 6 cylinders)
-        interrupts();
+        struct triggerSnapshot snapshot;
+        getTriggerSnapshot(snapshot);
+        tempToothAngle = snapshot.triggerToothAngle;
+        toothTime = (snapshot.toothLastToothTime - snapshot.toothLastMinusOneToothTime); //Note that trigger tooth angle changes between 70 and 110 depending on the last tooth that was seen (or 70/50 for 6 cylinders)
         toothTime = toothTime * 36;
         tempRPM = ((unsigned long)tempToothAngle * 6000000UL) / toothTime;
         revolutionTime = (10UL * toothTime) / tempToothAngle;
@@ -1556,11 +2073,11 @@ int getCrankAngle_4G63()
       unsigned long tempToothLastToothTime;
       int tempToothCurrentCount;
       //Grab some variables that are used in the trigger code and assign them to temp variables.
-      noInterrupts();
-      tempToothCurrentCount = toothCurrentCount;
-      tempToothLastToothTime = toothLastToothTime;
-      lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-      interrupts();
+      struct triggerSnapshot snapshot;
+      getTriggerSnapshot(snapshot);
+      tempToothCurrentCount = snapshot.toothCurrentCount;
+      tempToothLastToothTime = snapshot.toothLastToothTime;
+      lastCrankAngleCalc = micros();
 
       crankAngle = toothAngles[(tempToothCurrentCount - 1)] + configPage4.triggerAngle; //Perform a lookup of the fixed toothAngles array to find what the angle of the last tooth passed was.
 
@@ -1629,6 +2146,7 @@ Provided that the cam signal is used, this decoder simply counts the teeth and t
 */
 void triggerSetup_24X()
 {
+  toothAnglesCount = 0; //This decoder indexes toothAngles directly, so getToothAngle() must not use it
   triggerToothAngle = 15; //The number of degrees that passes from tooth to tooth (primary)
   toothAngles[0] = 12;
   toothAngles[1] = 18;
@@ -1654,10 +2172,11 @@ void triggerSetup_24X()
   toothAngles[21] = 327;
   toothAngles[22] = 342;
   toothAngles[23] = 357;
+  setSecondRevolutionToothAngles(24); //The cam sets revolutionOne, so both revolutions are in the table
 
   MAX_STALL_TIME = (3333UL * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
   if(initialisationComplete == false) { toothCurrentCount = 25; toothLastToothTime = micros(); } //Set a startup value here to avoid filter errors when starting. This MUST have the init check to prevent the fuel pump just staying on all the time
-  secondDerivEnabled = false;
+  secondDerivEnabled = true;
   decoderIsSequential = true;
   triggerToothAngleIsCorrect = true;
 }
@@ -1688,9 +2207,15 @@ void triggerPri_24X()
 
     validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
 
+    toothLastMinusOneToothTime = toothLastToothTime; //Keeps the last gap, which the 2nd derivative tooth history needs
     toothLastToothTime = curTime;
 
-
+    //A missed cam tooth leaves the count running past the last tooth, there is no angle for those
+    if( (angleSchedulesPending != 0) && (currentStatus.hasSync == true) && (toothCurrentCount <= 24) )
+    {
+      int16_t crankAngle = toothAngles[(toothCurrentCount-1) + (revolutionOne ? toothAnglesRevolution : 0)] + configPage4.triggerAngle;
+      checkAngleSchedules(crankAngle, getTableToothGap(toothCurrentCount, 24, 360));
+    }
   }
 }
 
@@ -1710,23 +2235,21 @@ int getCrankAngle_24X()
     unsigned long tempToothLastToothTime;
     int tempToothCurrentCount, tempRevolutionOne;
     //Grab some variables that are used in the trigger code and assign them to temp variables.
-    noInterrupts();
-    tempToothCurrentCount = toothCurrentCount;
-    tempToothLastToothTime = toothLastToothTime;
-    tempRevolutionOne = revolutionOne;
-    lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-    interrupts();
+    struct triggerSnapshot snapshot;
+    getTriggerSnapshot(snapshot);
+    tempToothCurrentCount = snapshot.toothCurrentCount;
+    tempToothLastToothTime = snapshot.toothLastToothTime;
+    tempRevolutionOne = snapshot.revolutionOne;
+    lastCrankAngleCalc = micros();
 
+    //Sequential check (simply sets whether we're on the first or 2nd revoltuion of the cycle). The table holds both revolutions
     int crankAngle;
-    if (tempToothCurrentCount == 0) { crankAngle = 0 + configPage4.triggerAngle; } //This is the special case to handle when the 'last tooth' seen was the cam tooth. 0 is the angle at which the crank tooth goes high (Within 360 degrees).
-    else { crankAngle = toothAngles[(tempToothCurrentCount - 1)] + configPage4.triggerAngle;} //Perform a lookup of the fixed toothAngles array to find what the angle of the last tooth passed was.
+    if (tempToothCurrentCount == 0) { crankAngle = ((tempRevolutionOne == 1) ? 360 : 0) + configPage4.triggerAngle; } //This is the special case to handle when the 'last tooth' seen was the cam tooth. 0 is the angle at which the crank tooth goes high (Within 360 degrees).
+    else { crankAngle = toothAngles[(tempToothCurrentCount - 1) + ((tempRevolutionOne == 1) ? toothAnglesRevolution : 0)] + configPage4.triggerAngle;} //Perform a lookup of the fixed toothAngles array to find what the angle of the last tooth passed was.
 
     //Estimate the number of degrees travelled since the last tooth}
     elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
-
-    //Sequential check (simply sets whether we're on the first or 2nd revoltuion of the cycle)
-    if (tempRevolutionOne == 1) { crankAngle += 360; }
+    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
     if (crankAngle >= 720) { crankAngle -= 720; }
     if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -1753,6 +2276,7 @@ void triggerSetEndTeeth_24X()
 */
 void triggerSetup_Jeep2000()
 {
+  toothAnglesCount = 0; //This decoder indexes toothAngles directly, so getToothAngle() must not use it
   triggerToothAngle = 0; //The number of degrees that passes from tooth to tooth (primary)
   toothAngles[0] = 174;
   toothAngles[1] = 194;
@@ -1769,7 +2293,7 @@ void triggerSetup_Jeep2000()
 
   MAX_STALL_TIME = (3333UL * 60); //Minimum 50rpm. (3333uS is the time per degree at 50rpm). Largest gap between teeth is 60 degrees.
   if(initialisationComplete == false) { toothCurrentCount = 13; toothLastToothTime = micros(); } //Set a startup value here to avoid filter errors when starting. This MUST have the initi check to prevent the fuel pump just staying on all the time
-  secondDerivEnabled = false;
+  secondDerivEnabled = true;
   decoderIsSequential = false;
   triggerToothAngleIsCorrect = true;
 }
@@ -1804,6 +2328,11 @@ void triggerPri_Jeep2000()
 
       toothLastMinusOneToothTime = toothLastToothTime;
       toothLastToothTime = curTime;
+
+      if( (angleSchedulesPending != 0) && (currentStatus.hasSync == true) && (toothCurrentCount <= 12) )
+      {
+        checkAngleSchedules(toothAngles[(toothCurrentCount-1)] + configPage4.triggerAngle, getTableToothGap(toothCurrentCount, 12, 360));
+      }
     } //Trigger filter
   } //Sync check
 }
@@ -1823,11 +2352,11 @@ int getCrankAngle_Jeep2000()
     unsigned long tempToothLastToothTime;
     int tempToothCurrentCount;
     //Grab some variables that are used in the trigger code and assign them to temp variables.
-    noInterrupts();
-    tempToothCurrentCount = toothCurrentCount;
-    tempToothLastToothTime = toothLastToothTime;
-    lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-    interrupts();
+    struct triggerSnapshot snapshot;
+    getTriggerSnapshot(snapshot);
+    tempToothCurrentCount = snapshot.toothCurrentCount;
+    tempToothLastToothTime = snapshot.toothLastToothTime;
+    lastCrankAngleCalc = micros();
 
     int crankAngle;
     if (toothCurrentCount == 0) { crankAngle = 146 + configPage4.triggerAngle; } //This is the special case to handle when the 'last tooth' seen was the cam tooth. 146 is the angle at which the crank tooth goes high.
@@ -1835,7 +2364,7 @@ int getCrankAngle_Jeep2000()
 
     //Estimate the number of degrees travelled since the last tooth}
     elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
+    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
     if (crankAngle >= 720) { crankAngle -= 720; }
     if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -1868,6 +2397,8 @@ void triggerSetup_Audi135()
   secondDerivEnabled = false;
   decoderIsSequential = true;
   triggerToothAngleIsCorrect = true;
+  setEvenToothAngles(45, triggerToothAngle, 0);
+  setSecondRevolutionToothAngles(45);
 }
 
 void triggerPri_Audi135()
@@ -1903,6 +2434,11 @@ void triggerPri_Audi135()
 
          toothLastMinusOneToothTime = toothLastToothTime;
          toothLastToothTime = curTime;
+
+         if(angleSchedulesPending != 0)
+         {
+           checkAngleSchedules(getCycleToothAngle(toothCurrentCount, revolutionOne) + configPage4.triggerAngle, getToothGap(toothCurrentCount, 45, 360));
+         }
        } //3rd tooth check
      } // Sync check
    } // Trigger filter
@@ -1940,24 +2476,23 @@ int getCrankAngle_Audi135()
     int tempToothCurrentCount;
     bool tempRevolutionOne;
     //Grab some variables that are used in the trigger code and assign them to temp variables.
-    noInterrupts();
-    tempToothCurrentCount = toothCurrentCount;
-    tempToothLastToothTime = toothLastToothTime;
-    tempRevolutionOne = revolutionOne;
-    lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-    interrupts();
+    struct triggerSnapshot snapshot;
+    getTriggerSnapshot(snapshot);
+    tempToothCurrentCount = snapshot.toothCurrentCount;
+    tempToothLastToothTime = snapshot.toothLastToothTime;
+    tempRevolutionOne = snapshot.revolutionOne;
+    lastCrankAngleCalc = micros();
 
     //Handle case where the secondary tooth was the last one seen
     if(tempToothCurrentCount == 0) { tempToothCurrentCount = 45; }
 
-    int crankAngle = ((tempToothCurrentCount - 1) * triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+    //The angle of the last tooth seen, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+    //Sequential check (simply sets whether we're on the first or 2nd revoltuion of the cycle)
+    int crankAngle = getCycleToothAngle(tempToothCurrentCount, tempRevolutionOne) + configPage4.triggerAngle;
     
     //Estimate the number of degrees travelled since the last tooth}
     elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
-
-    //Sequential check (simply sets whether we're on the first or 2nd revoltuion of the cycle)
-    if (tempRevolutionOne) { crankAngle += 360; }
+    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
     if (crankAngle >= 720) { crankAngle -= 720; }
     else if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -1979,6 +2514,7 @@ void triggerSetEndTeeth_Audi135()
 void triggerSetup_HondaD17()
 {
   triggerToothAngle = 360 / 12; //The number of degrees that passes from tooth to tooth
+  setEvenToothAngles(12, triggerToothAngle, 0); //The 13th tooth isn't in the table, getCrankAngle_HondaD17() uses the 12th in its place
   MAX_STALL_TIME = (3333UL * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
   secondDerivEnabled = false;
   decoderIsSequential = false;
@@ -2024,6 +2560,11 @@ void triggerPri_HondaD17()
      }
    }
 
+   //The 13th tooth (Count 0) is not a timing tooth, so the gap after the 12th runs through to tooth #1
+   if( (angleSchedulesPending != 0) && (currentStatus.hasSync == true) && (toothCurrentCount != 0) && (toothCurrentCount <= 12) )
+   {
+     checkAngleSchedules(getToothAngle(toothCurrentCount) + configPage4.triggerAngle, getToothGap(toothCurrentCount, 12, 360));
+   }
 }
 void triggerSec_HondaD17() { return; } //The 4+1 signal on the cam is yet to be supported
 uint16_t getRPM_HondaD17()
@@ -2036,26 +2577,19 @@ int getCrankAngle_HondaD17()
     unsigned long tempToothLastToothTime;
     int tempToothCurrentCount;
     //Grab some variables that are used in the trigger code and assign them to temp variables.
-    noInterrupts();
-    tempToothCurrentCount = toothCurrentCount;
-    tempToothLastToothTime = toothLastToothTime;
-    lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-    interrupts();
+    struct triggerSnapshot snapshot;
+    getTriggerSnapshot(snapshot);
+    tempToothCurrentCount = snapshot.toothCurrentCount;
+    tempToothLastToothTime = snapshot.toothLastToothTime;
+    lastCrankAngleCalc = micros();
 
-    //Check if the last tooth seen was the reference tooth 13 (Number 0 here). All others can be calculated, but tooth 3 has a unique angle
-    int crankAngle;
-    if( tempToothCurrentCount == 0 )
-    {
-      crankAngle = (11 * triggerToothAngle) + configPage4.triggerAngle; //if temptoothCurrentCount is 0, the last tooth seen was the 13th one. Based on this, ignore the 13th tooth and use the 12th one as the last reference.
-    }
-    else
-    {
-      crankAngle = ((tempToothCurrentCount - 1) * triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
-    }
+    //if temptoothCurrentCount is 0, the last tooth seen was the 13th one. Based on this, ignore the 13th tooth and use the 12th one as the last reference.
+    if( tempToothCurrentCount == 0 ) { tempToothCurrentCount = 12; }
+    int crankAngle = getToothAngle(tempToothCurrentCount) + configPage4.triggerAngle; //The angle of the last tooth seen, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
 
     //Estimate the number of degrees travelled since the last tooth}
     elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
+    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
     if (crankAngle >= 720) { crankAngle -= 720; }
     if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -2081,6 +2615,7 @@ Tooth number one is at 355* ATDC.
 */
 void triggerSetup_Miata9905()
 {
+  toothAnglesCount = 0; //This decoder indexes toothAngles directly, so getToothAngle() must not use it
   triggerToothAngle = 90; //The number of degrees that passes from tooth to tooth (primary)
   toothCurrentCount = 99; //Fake tooth count represents no sync
   secondDerivEnabled = false;
@@ -2188,12 +2723,13 @@ void triggerPri_Miata9905()
           else { checkPerToothTiming(crankAngle, toothCurrentCount); }
         }
       }
-
     } //Has sync
 
     toothLastMinusOneToothTime = toothLastToothTime;
     toothLastToothTime = curTime;
 
+    if( (angleSchedulesPending != 0) && (currentStatus.hasSync == true) ) { checkAngleSchedules(toothAngles[(toothCurrentCount-1)] + configPage4.triggerAngle, getTableToothGap(toothCurrentCount, triggerActualTeeth, 720)); }
+
     //if ( BIT_CHECK(currentStatus.engine, BIT_ENGINE_CRANK) && configPage4.ignCranklock)
     if ( (currentStatus.RPM < (currentStatus.crankRPM + 30)) && (configPage4.ignCranklock) ) //The +30 here is a safety margin. When switching from fixed timing to normal, there can be a situation where a pulse started when fixed and ending when in normal mode causes problems. This prevents that.
     {
@@ -2243,10 +2779,10 @@ uint16_t getRPM_Miata9905()
     {
       int tempToothAngle;
       unsigned long toothTime;
-      noInterrupts();
-      tempToothAngle = triggerToothAngle;
-      toothTime = (toothLastToothTime - toothLastMinusOneToothTime); //Note that trigger tooth angle changes between 70 and 110 depending on the last tooth that was seen
-      interrupts();
+      struct triggerSnapshot snapshot;
+      getTriggerSnapshot(snapshot);
+      tempToothAngle = snapshot.triggerToothAngle;
+      toothTime = (snapshot.toothLastToothTime - snapshot.toothLastMinusOneToothTime); //Note that trigger tooth angle changes between 70 and 110 depending on the last tooth that was seen
       toothTime = toothTime * 36;
       tempRPM = ((unsigned long)tempToothAngle * 6000000UL) / toothTime;
       revolutionTime = (10UL * toothTime) / tempToothAngle;
@@ -2272,17 +2808,17 @@ int getCrankAngle_Miata9905()
       unsigned long tempToothLastToothTime;
       int tempToothCurrentCount;
       //Grab some variables that are used in the trigger code and assign them to temp variables.
-      noInterrupts();
-      tempToothCurrentCount = toothCurrentCount;
-      tempToothLastToothTime = toothLastToothTime;
-      lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-      interrupts();
+      struct triggerSnapshot snapshot;
+      getTriggerSnapshot(snapshot);
+      tempToothCurrentCount = snapshot.toothCurrentCount;
+      tempToothLastToothTime = snapshot.toothLastToothTime;
+      lastCrankAngleCalc = micros();
 
       crankAngle = toothAngles[(tempToothCurrentCount - 1)] + configPage4.triggerAngle; //Perform a lookup of the fixed toothAngles array to find what the angle of the last tooth passed was.
 
       //Estimate the number of degrees travelled since the last tooth}
       elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-      crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
+      crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
       if (crankAngle >= 720) { crankAngle -= 720; }
       if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -2354,6 +2890,7 @@ Tooth number one is at 348* ATDC.
 */
 void triggerSetup_MazdaAU()
 {
+  toothAnglesCount = 0; //This decoder indexes toothAngles directly, so getToothAngle() must not use it
   triggerToothAngle = 108; //The number of degrees that passes from tooth to tooth (primary). This is the maximum gap
   toothCurrentCount = 99; //Fake tooth count represents no sync
   secondaryToothCount = 0; //Needed for the cam tooth tracking
@@ -2404,6 +2941,11 @@ void triggerPri_MazdaAU()
 
       toothLastMinusOneToothTime = toothLastToothTime;
       toothLastToothTime = curTime;
+
+      if( (angleSchedulesPending != 0) && (toothCurrentCount <= 4) )
+      {
+        checkAngleSchedules(toothAngles[(toothCurrentCount-1)] + configPage4.triggerAngle, getTableToothGap(toothCurrentCount, 4, 360));
+      }
     } //Has sync
   } //Filter time
 }
@@ -2451,10 +2993,10 @@ uint16_t getRPM_MazdaAU()
     if(currentStatus.RPM < currentStatus.crankRPM)
     {
       int tempToothAngle;
-      noInterrupts();
-      tempToothAngle = triggerToothAngle;
-      revolutionTime = (toothLastToothTime - toothLastMinusOneToothTime); //Note that trigger tooth angle changes between 72 and 108 depending on the last tooth that was seen
-      interrupts();
+      struct triggerSnapshot snapshot;
+      getTriggerSnapshot(snapshot);
+      tempToothAngle = snapshot.triggerToothAngle;
+      revolutionTime = (snapshot.toothLastToothTime - snapshot.toothLastMinusOneToothTime); //Note that trigger tooth angle changes between 72 and 108 depending on the last tooth that was seen
       revolutionTime = revolutionTime * 36;
       tempRPM = (tempToothAngle * 60000000L) / revolutionTime;
     }
@@ -2472,17 +3014,17 @@ int getCrankAngle_MazdaAU()
       unsigned long tempToothLastToothTime;
       int tempToothCurrentCount;
       //Grab some variables that are used in the trigger code and assign them to temp variables.
-      noInterrupts();
-      tempToothCurrentCount = toothCurrentCount;
-      tempToothLastToothTime = toothLastToothTime;
-      lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-      interrupts();
+      struct triggerSnapshot snapshot;
+      getTriggerSnapshot(snapshot);
+      tempToothCurrentCount = snapshot.toothCurrentCount;
+      tempToothLastToothTime = snapshot.toothLastToothTime;
+      lastCrankAngleCalc = micros();
 
       crankAngle = toothAngles[(tempToothCurrentCount - 1)] + configPage4.triggerAngle; //Perform a lookup of the fixed toothAngles array to find what the angle of the last tooth passed was.
 
       //Estimate the number of degrees travelled since the last tooth}
       elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-      crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
+      crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
       if (crankAngle >= 720) { crankAngle -= 720; }
       if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -2505,9 +3047,12 @@ There can be no missing teeth on the primary wheel.
 */
 void triggerSetup_non360()
 {
-  triggerToothAngle = (360 * configPage4.TrigAngMul) / configPage4.triggerTeeth; //The number of degrees that passes from tooth to tooth multiplied by the additional multiplier
+  triggerToothAngle = (360 * getTriggerAngleMultiplier()) / getTriggerTeeth(); //The number of degrees that passes from tooth to tooth multiplied by the additional multiplier
+  //The table holds actual crank angles, so the divide by the multiplier is done once here rather than on every call to getCrankAngle_non360()
+  setEvenToothAngles(getTriggerTeeth(), triggerToothAngle, 0);
+  for(uint8_t tooth = 0; tooth < toothAnglesCount; tooth++) { toothAngles[tooth] = toothAngles[tooth] / getTriggerAngleMultiplier(); }
   toothCurrentCount = 255; //Default value
-  triggerFilterTime = (1000000 / (MAX_RPM / 60 * configPage4.triggerTeeth)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be disgarded as noise
+  triggerFilterTime = (1000000 / (MAX_RPM / 60 * getTriggerTeeth())); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be disgarded as noise
   triggerSecFilterTime = (1000000 / (MAX_RPM / 60 * 2)) / 2; //Same as above, but fixed at 2 teeth on the secondary input and divided by 2 (for cam speed)
   secondDerivEnabled = false;
   decoderIsSequential = true;
@@ -2515,9 +3060,26 @@ void triggerSetup_non360()
 }
 
 
+/*
+The crank angle of the given tooth (1 based), not including configPage4.triggerAngle. The table holds actual crank angles, but teeth past the end of it
+have to be divided by the multiplier to get back to an actual crank angle
+*/
+static inline int16_t getToothAngle_non360(int16_t tooth)
+{
+  if(tooth <= toothAnglesCount) { return getToothAngle(tooth); }
+  return ((tooth - 1) * (int16_t)triggerToothAngle) / getTriggerAngleMultiplier();
+}
+
 void triggerPri_non360()
 {
-  //This is not used, the trigger is identical to the dual wheel one, so that is used instead.
+  //The teeth are handled the same as the dual wheel decoder, only the crank angle differs
+  if( dualWheelPrimaryTooth() && (angleSchedulesPending != 0) && (currentStatus.hasSync == true) )
+  {
+    uint8_t nextTooth = (toothCurrentCount >= getTriggerTeeth()) ? 1 : (toothCurrentCount + 1);
+    int16_t gap = getToothAngle_non360(nextTooth) - getToothAngle_non360(toothCurrentCount);
+    if(gap <= 0) { gap += 360; }
+    checkAngleSchedules(getToothAngle_non360(toothCurrentCount) + configPage4.triggerAngle, gap);
+  }
 }
 
 void triggerSec_non360()
@@ -2530,7 +3092,7 @@ uint16_t getRPM_non360()
   uint16_t tempRPM = 0;
   if( (currentStatus.hasSync == true) && (toothCurrentCount != 0) )
   {
-    if(currentStatus.RPM < currentStatus.crankRPM) { tempRPM = crankingGetRPM(configPage4.triggerTeeth, 360); }
+    if(currentStatus.RPM < currentStatus.crankRPM) { tempRPM = crankingGetRPM(getTriggerTeeth(), 360); }
     else { tempRPM = stdGetRPM(360); }
   }
   return tempRPM;
@@ -2542,22 +3104,21 @@ int getCrankAngle_non360()
     unsigned long tempToothLastToothTime;
     int tempToothCurrentCount;
     //Grab some variables that are used in the trigger code and assign them to temp variables.
-    noInterrupts();
-    tempToothCurrentCount = toothCurrentCount;
-    tempToothLastToothTime = toothLastToothTime;
-    lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-    interrupts();
+    struct triggerSnapshot snapshot;
+    getTriggerSnapshot(snapshot);
+    tempToothCurrentCount = snapshot.toothCurrentCount;
+    tempToothLastToothTime = snapshot.toothLastToothTime;
+    lastCrankAngleCalc = micros();
 
     //Handle case where the secondary tooth was the last one seen
     if(tempToothCurrentCount == 0) { tempToothCurrentCount = configPage4.triggerTeeth; }
 
-    //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
-    int crankAngle = (tempToothCurrentCount - 1) * triggerToothAngle;
-    crankAngle = (crankAngle / configPage4.TrigAngMul) + configPage4.triggerAngle; //Have to divide by the multiplier to get back to actual crank angle.
+    //The angle of the last tooth seen, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+    int crankAngle = getToothAngle_non360(tempToothCurrentCount) + configPage4.triggerAngle;
 
     //Estimate the number of degrees travelled since the last tooth}
     elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
+    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
     if (crankAngle >= 720) { crankAngle -= 720; }
     if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -2577,6 +3138,17 @@ See http://wiki.r31skylineclub.com/index.php/Crank_Angle_Sensor .
 * @defgroup dec_nissan360 Nissan 360 tooth on cam
 * @{
 */
+static volatile int16_t nissan360ToothAngle; //The angle of toothCurrentCount, kept alongside it by the trigger interrupts rather than tabled for all 360 teeth
+
+/*
+Sets the tooth count when the secondary finds the position, along with its angle
+*/
+static inline void setNissan360Tooth(uint16_t tooth)
+{
+  toothCurrentCount = tooth;
+  nissan360ToothAngle = (tooth - 1) * 2;
+}
+
 void triggerSetup_Nissan360()
 {
   triggerFilterTime = (1000000 / (MAX_RPM / 60 * 360UL)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be disgarded as noise
@@ -2584,7 +3156,7 @@ void triggerSetup_Nissan360()
   secondaryToothCount = 0; //Initially set to 0 prior to calculating the secondary window duration
   secondDerivEnabled = false;
   decoderIsSequential = true;
-  toothCurrentCount = 1;
+  setNissan360Tooth(1);
   triggerToothAngle = 2;
   MAX_STALL_TIME = (3333UL * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
 }
@@ -2596,6 +3168,7 @@ void triggerPri_Nissan360()
    curGap = curTime - toothLastToothTime;
    //if ( curGap < triggerFilterTime ) { return; }
    toothCurrentCount++; //Increment the tooth counter
+   nissan360ToothAngle += 2; //Each tooth is 2 crank degrees
    validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
 
    toothLastMinusOneToothTime = toothLastToothTime;
@@ -2605,7 +3178,7 @@ void triggerPri_Nissan360()
    {
      if ( toothCurrentCount == 361 ) //2 complete crank revolutions
      {
-       toothCurrentCount = 1;
+       setNissan360Tooth(1);
        toothOneMinusOneTime = toothOneTime;
        toothOneTime = curTime;
        currentStatus.startRevolutions++; //Counter
@@ -2616,7 +3189,7 @@ void triggerPri_Nissan360()
      //EXPERIMENTAL!
      if(configPage2.perToothIgn == true)
      {
-        int16_t crankAngle = ( (toothCurrentCount-1) * 2 ) + configPage4.triggerAngle;
+        int16_t crankAngle = nissan360ToothAngle + configPage4.triggerAngle;
         if(crankAngle > CRANK_ANGLE_MAX_IGN) 
         { 
           crankAngle -= CRANK_ANGLE_MAX_IGN;
@@ -2628,6 +3201,7 @@ void triggerPri_Nissan360()
         }
        
      }
+     if(angleSchedulesPending != 0) { checkAngleSchedules(nissan360ToothAngle + configPage4.triggerAngle, 2); }
 
      timePerDegree = curGap >> 1;; //The time per crank degree is simply the time between this tooth and the last one divided by 2
    }
@@ -2662,32 +3236,32 @@ void triggerSec_Nissan360()
         //These equate to 4,8,12,16 teeth spacings
         if( (secondaryDuration >= 15) && (secondaryDuration <= 17) ) //Duration of window = 16 primary teeth
         {
-          toothCurrentCount = 16; //End of first window (The longest) occurs 16 teeth after TDC
+          setNissan360Tooth(16); //End of first window (The longest) occurs 16 teeth after TDC
           currentStatus.hasSync = true;
         }
         else if( (secondaryDuration >= 11) && (secondaryDuration <= 13) ) //Duration of window = 12 primary teeth
         {
-          toothCurrentCount = 102; //End of second window is after 90+12 primary teeth
+          setNissan360Tooth(102); //End of second window is after 90+12 primary teeth
           currentStatus.hasSync = true;
         }
         else if( (secondaryDuration >= 7) && (secondaryDuration <= 9) ) //Duration of window = 8 primary teeth
         {
-          toothCurrentCount = 188; //End of third window is after 90+90+8 primary teeth
+          setNissan360Tooth(188); //End of third window is after 90+90+8 primary teeth
           currentStatus.hasSync = true;
         }
         else if( (secondaryDuration >= 3) && (secondaryDuration <= 5) ) //Duration of window = 4 primary teeth
         {
-          toothCurrentCount = 274; //End of fourth window is after 90+90+90+4 primary teeth
+          setNissan360Tooth(274); //End of fourth window is after 90+90+90+4 primary teeth
           currentStatus.hasSync = true;
         }
-        else { currentStatus.hasSync = false; currentStatus.syncLossCounter++; } //This should really never happen
+        else { currentStatus.hasSync = false; triggerSyncLoss(SYNC_LOSS_CAM_MISMATCH); } //This should really never happen
       }
       else if(configPage2.nCylinders == 6)
       {
         //Pattern on the 6 cylinders is 4-8-12-16-20-24
         if( (secondaryDuration >= 3) && (secondaryDuration <= 5) ) //Duration of window = 4 primary teeth
         {
-          toothCurrentCount = 124; //End of smallest window is after 60+60+4 primary teeth
+          setNissan360Tooth(124); //End of smallest window is after 60+60+4 primary teeth
           currentStatus.hasSync = true;
         }
       }
@@ -2697,7 +3271,7 @@ void triggerSec_Nissan360()
         //Pattern on the 8 cylinders is the same as the 6 cylinder 4-8-12-16-20-24
         if( (secondaryDuration >= 6) && (secondaryDuration <= 8) ) //Duration of window = 16 primary teeth
         {
-          toothCurrentCount = 56; //End of the shortest of the individual windows. Occurs at 102 crank degrees. 
+          setNissan360Tooth(56); //End of the shortest of the individual windows. Occurs at 102 crank degrees. 
           currentStatus.hasSync = true;
         }
       }
@@ -2712,7 +3286,7 @@ void triggerSec_Nissan360()
         {
           if( (secondaryDuration >= 15) && (secondaryDuration <= 17) ) //Duration of window = 16 primary teeth
           {
-            toothCurrentCount = 16; //End of first window (The longest) occurs 16 teeth after TDC
+            setNissan360Tooth(16); //End of first window (The longest) occurs 16 teeth after TDC
           }
         }
         else if(configPage2.nCylinders == 6)
@@ -2735,15 +3309,18 @@ uint16_t getRPM_Nissan360()
   {
     if(currentStatus.startRevolutions < 2)
     {
-      noInterrupts();
-      revolutionTime = (toothLastToothTime - toothLastMinusOneToothTime) * 180; //Each tooth covers 2 crank degrees, so multiply by 180 to get a full revolution time. 
-      interrupts();
+      struct triggerSnapshot snapshot;
+      getTriggerSnapshot(snapshot);
+      revolutionTime = (snapshot.toothLastToothTime - snapshot.toothLastMinusOneToothTime) * 180; //Each tooth covers 2 crank degrees, so multiply by 180 to get a full revolution time. 
     }
     else
     {
-      noInterrupts();
-      revolutionTime = (toothOneTime - toothOneMinusOneTime) >> 1; //The time in uS that one revolution would take at current speed (The time tooth 1 was last seen, minus the time it was seen prior to that)
-      interrupts();
+      uint8_t sequence;
+      do
+      {
+        sequence = triggerSequence;
+        revolutionTime = (toothOneTime - toothOneMinusOneTime) >> 1; //The time in uS that one revolution would take at current speed (The time tooth 1 was last seen, minus the time it was seen prior to that)
+      } while(sequence != triggerSequence);
     }
     tempRPM = (US_IN_MINUTE / revolutionTime); //Calc RPM based on last full revolution time (Faster as /)
     if(tempRPM >= MAX_RPM) { tempRPM = currentStatus.RPM; } //Sanity check
@@ -2760,16 +3337,21 @@ int getCrankAngle_Nissan360()
   int crankAngle = 0;
   int tempToothLastToothTime;
   int tempToothLastMinusOneToothTime;
-  int tempToothCurrentCount;
+  int tempToothAngle;
 
-  noInterrupts();
-  tempToothLastToothTime = toothLastToothTime;
-  tempToothLastMinusOneToothTime = toothLastMinusOneToothTime;
-  tempToothCurrentCount = toothCurrentCount;
-  lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-  interrupts();
-
-  crankAngle = ( (tempToothCurrentCount - 1) * 2) + configPage4.triggerAngle;
+  struct triggerSnapshot snapshot;
+  uint8_t sequence;
+  do
+  {
+    sequence = triggerSequence;
+    getTriggerSnapshot(snapshot);
+    tempToothAngle = nissan360ToothAngle;
+  } while(sequence != triggerSequence);
+  tempToothLastToothTime = snapshot.toothLastToothTime;
+  tempToothLastMinusOneToothTime = snapshot.toothLastMinusOneToothTime;
+  lastCrankAngleCalc = micros();
+
+  crankAngle = tempToothAngle + configPage4.triggerAngle;
   unsigned long halfTooth = (tempToothLastToothTime - tempToothLastMinusOneToothTime) / 2;
   if (elapsedTime > halfTooth)
   {
@@ -2808,6 +3390,7 @@ This seems to be present in late 90's Subaru. In 2001 Subaru moved to 36-2-2-2 (
 */
 void triggerSetup_Subaru67()
 {
+  toothAnglesCount = 0; //This decoder indexes toothAngles directly, so getToothAngle() must not use it
   triggerFilterTime = (1000000 / (MAX_RPM / 60 * 360UL)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be disgarded as noise
   triggerSecFilterTime = 0;
   secondaryToothCount = 0; //Initially set to 0 prior to calculating the secondary window duration
@@ -2881,7 +3464,7 @@ void triggerPri_Subaru67()
           //Almost certainly due to noise or cranking stop/start
           currentStatus.hasSync = false;
           triggerToothAngleIsCorrect = false;
-          currentStatus.syncLossCounter++;
+          triggerSyncLoss(SYNC_LOSS_CAM_MISMATCH);
           secondaryToothCount = 0;
           break;
 
@@ -2927,6 +3510,7 @@ void triggerPri_Subaru67()
         }
         else{ checkPerToothTiming(crankAngle, toothCurrentCount); }
       }
+      if(angleSchedulesPending != 0) { checkAngleSchedules(toothAngles[(toothCurrentCount - 1)] + configPage4.triggerAngle, getTableToothGap(toothCurrentCount, 12, 720)); }
    //Recalc the new filter value
    //setFilter(curGap);
    }
@@ -2989,11 +3573,11 @@ int getCrankAngle_Subaru67()
     unsigned long tempToothLastToothTime;
     int tempToothCurrentCount;
     //Grab some variables that are used in the trigger code and assign them to temp variables.
-    noInterrupts();
-    tempToothCurrentCount = toothCurrentCount;
-    tempToothLastToothTime = toothLastToothTime;
-    lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-    interrupts();
+    struct triggerSnapshot snapshot;
+    getTriggerSnapshot(snapshot);
+    tempToothCurrentCount = snapshot.toothCurrentCount;
+    tempToothLastToothTime = snapshot.toothLastToothTime;
+    lastCrankAngleCalc = micros();
 
     crankAngle = toothAngles[(tempToothCurrentCount - 1)] + configPage4.triggerAngle; //Perform a lookup of the fixed toothAngles array to find what the angle of the last tooth passed was.
 
@@ -3060,9 +3644,10 @@ void triggerSetEndTeeth_Subaru67()
 */
 void triggerSetup_Daihatsu()
 {
+  toothAnglesCount = 0; //This decoder indexes toothAngles directly, so getToothAngle() must not use it
   triggerActualTeeth = configPage2.nCylinders + 1;
   triggerToothAngle = 720 / triggerActualTeeth; //The number of degrees that passes from tooth to tooth
-  triggerFilterTime = 60000000L / MAX_RPM / configPage2.nCylinders; // Minimum time required between teeth
+  triggerFilterTime = 60000000L / MAX_RPM / ((configPage2.nCylinders == 0) ? 1 : configPage2.nCylinders); // Minimum time required between teeth. nCylinders is 0 on a blank config
   triggerFilterTime = triggerFilterTime / 2; //Safety margin
   secondDerivEnabled = false;
   decoderIsSequential = false;
@@ -3153,6 +3738,11 @@ void triggerPri_Daihatsu()
 
     toothLastMinusOneToothTime = toothLastToothTime;
     toothLastToothTime = curTime;
+
+    if( (angleSchedulesPending != 0) && (currentStatus.hasSync == true) )
+    {
+      checkAngleSchedules(toothAngles[(toothCurrentCount-1)] + configPage4.triggerAngle, getTableToothGap(toothCurrentCount, triggerActualTeeth, 720));
+    }
   } //Trigger filter
 }
 void triggerSec_Daihatsu() { return; } //Not required (Should never be called in the first place)
@@ -3169,9 +3759,9 @@ uint16_t getRPM_Daihatsu()
       else if (toothCurrentCount == 3) { tempRPM = currentStatus.RPM; }
       else
       {
-        noInterrupts();
-        revolutionTime = (toothLastToothTime - toothLastMinusOneToothTime) * (triggerActualTeeth-1);
-        interrupts();
+        struct triggerSnapshot snapshot;
+        getTriggerSnapshot(snapshot);
+        revolutionTime = (snapshot.toothLastToothTime - snapshot.toothLastMinusOneToothTime) * (triggerActualTeeth-1);
         tempRPM = (US_IN_MINUTE / revolutionTime);
         if(tempRPM >= MAX_RPM) { tempRPM = currentStatus.RPM; } //Sanity check
       } //is tooth #2
@@ -3191,17 +3781,17 @@ int getCrankAngle_Daihatsu()
     int tempToothCurrentCount;
     int crankAngle;
     //Grab some variables that are used in the trigger code and assign them to temp variables.
-    noInterrupts();
-    tempToothCurrentCount = toothCurrentCount;
-    tempToothLastToothTime = toothLastToothTime;
-    lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-    interrupts();
+    struct triggerSnapshot snapshot;
+    getTriggerSnapshot(snapshot);
+    tempToothCurrentCount = snapshot.toothCurrentCount;
+    tempToothLastToothTime = snapshot.toothLastToothTime;
+    lastCrankAngleCalc = micros();
 
     crankAngle = toothAngles[tempToothCurrentCount-1] + configPage4.triggerAngle; //Crank angle of the last tooth seen
 
     //Estimate the number of degrees travelled since the last tooth}
     elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
+    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
     if (crankAngle >= 720) { crankAngle -= 720; }
     if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -3225,6 +3815,9 @@ Only rising Edge is used for simplicity.The second input is ignored, as it does
 void triggerSetup_Harley()
 {
   triggerToothAngle = 0; // The number of degrees that passes from tooth to tooth, ev. 0. It alternates uneven
+  toothAnglesCount = 0; //This decoder indexes toothAngles directly, so getToothAngle() must not use it
+  toothAngles[0] = 0; //tooth #1
+  toothAngles[1] = 157; //tooth #2
   secondDerivEnabled = false;
   decoderIsSequential = false;
   MAX_STALL_TIME = (3333UL * 60); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
@@ -3263,10 +3856,15 @@ void triggerPri_Harley()
         toothLastMinusOneToothTime = toothLastToothTime;
         toothLastToothTime = curTime;
         currentStatus.startRevolutions++; //Counter
+
+        if( (angleSchedulesPending != 0) && (currentStatus.hasSync == true) )
+        {
+          checkAngleSchedules(toothAngles[(toothCurrentCount-1)] + configPage4.triggerAngle, getTableToothGap(toothCurrentCount, 2, 360));
+        }
     }
     else
     {
-      if (currentStatus.hasSync == true) { currentStatus.syncLossCounter++; }
+      if (currentStatus.hasSync == true) { triggerSyncLoss(SYNC_LOSS_NOISE); }
       currentStatus.hasSync = false;
       toothCurrentCount = 0;
     } //Primary trigger high
@@ -3294,15 +3892,18 @@ uint16_t getRPM_Harley()
       if ( (toothLastToothTime == 0) || (toothLastMinusOneToothTime == 0) ) { tempRPM = 0; }
       else
       {
-        noInterrupts();
-        tempToothAngle = triggerToothAngle;
-        /* High-res mode
-          if(toothCurrentCount == 1) { tempToothAngle = 129; }
-          else { tempToothAngle = toothAngles[toothCurrentCount-1] - toothAngles[toothCurrentCount-2]; }
-        */
-        revolutionTime = (toothOneTime - toothOneMinusOneTime); //The time in uS that one revolution would take at current speed (The time tooth 1 was last seen, minus the time it was seen prior to that)
-        toothTime = (toothLastToothTime - toothLastMinusOneToothTime); //Note that trigger tooth angle changes between 129 and 332 depending on the last tooth that was seen
-        interrupts();
+        uint8_t sequence;
+        do
+        {
+          sequence = triggerSequence;
+          tempToothAngle = triggerToothAngle;
+          /* High-res mode
+            if(toothCurrentCount == 1) { tempToothAngle = 129; }
+            else { tempToothAngle = toothAngles[toothCurrentCount-1] - toothAngles[toothCurrentCount-2]; }
+          */
+          revolutionTime = (toothOneTime - toothOneMinusOneTime); //The time in uS that one revolution would take at current speed (The time tooth 1 was last seen, minus the time it was seen prior to that)
+          toothTime = (toothLastToothTime - toothLastMinusOneToothTime); //Note that trigger tooth angle changes between 129 and 332 depending on the last tooth that was seen
+        } while(sequence != triggerSequence);
         toothTime = toothTime * 36;
         tempRPM = ((unsigned long)tempToothAngle * 6000000UL) / toothTime;
       }
@@ -3321,25 +3922,20 @@ int getCrankAngle_Harley()
   unsigned long tempToothLastToothTime;
   int tempToothCurrentCount;
   //Grab some variables that are used in the trigger code and assign them to temp variables.
-  noInterrupts();
-  tempToothCurrentCount = toothCurrentCount;
-  tempToothLastToothTime = toothLastToothTime;
-  lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-  interrupts();
+  struct triggerSnapshot snapshot;
+  getTriggerSnapshot(snapshot);
+  tempToothCurrentCount = snapshot.toothCurrentCount;
+  tempToothLastToothTime = snapshot.toothLastToothTime;
+  lastCrankAngleCalc = micros();
 
-  //Check if the last tooth seen was the reference tooth (Number 3). All others can be calculated, but tooth 3 has a unique angle
-  int crankAngle;
-  if ( (tempToothCurrentCount == 1) || (tempToothCurrentCount == 3) )
-  {
-    crankAngle = 0 + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
-  }
-  else {
-    crankAngle = 157 + configPage4.triggerAngle;
-  }
+  //The angle of the last tooth seen, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+  //Without sync the count is 0, which is given the angle of tooth #2 as before
+  if(tempToothCurrentCount != 1) { tempToothCurrentCount = 2; }
+  int crankAngle = toothAngles[(tempToothCurrentCount - 1)] + configPage4.triggerAngle;
 
   //Estimate the number of degrees travelled since the last tooth}
   elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-  crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
+  crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
   if (crankAngle >= 720) { crankAngle -= 720; }
   if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -3370,10 +3966,11 @@ void triggerSetup_ThirtySixMinus222()
 {
   triggerToothAngle = 10; //The number of degrees that passes from tooth to tooth
   triggerActualTeeth = 30; //The number of physical teeth on the wheel. Doing this here saves us a calculation each time in the interrupt
-  triggerFilterTime = (int)(1000000 / (MAX_RPM / 60 * configPage4.triggerTeeth)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be disgarded as noise
+  setEvenToothAngles(36, triggerToothAngle, 0);
+  triggerFilterTime = (int)(1000000 / (MAX_RPM / 60 * getTriggerTeeth())); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be disgarded as noise
   secondDerivEnabled = false;
   decoderIsSequential = false;
-  checkSyncToothCount = (configPage4.triggerTeeth) >> 1; //50% of the total teeth.
+  checkSyncToothCount = (getTriggerTeeth()) >> 1; //50% of the total teeth.
   toothLastMinusOneToothTime = 0;
   toothCurrentCount = 0;
   toothOneTime = 0;
@@ -3464,10 +4061,12 @@ void triggerPri_ThirtySixMinus222()
      //EXPERIMENTAL!
      if(configPage2.perToothIgn == true)
      {
-       int16_t crankAngle = ( (toothCurrentCount-1) * triggerToothAngle ) + configPage4.triggerAngle;
+       int16_t crankAngle = getToothAngle(toothCurrentCount) + configPage4.triggerAngle;
        crankAngle = ignitionLimits(crankAngle);
        checkPerToothTiming(crankAngle, toothCurrentCount);
      }
+     //Which gap follows a tooth isn't tracked here, so the regular tooth angle is used. A schedule due within a missing tooth gap is left to its time based start
+     if( (angleSchedulesPending != 0) && (currentStatus.hasSync == true) ) { checkAngleSchedules(getToothAngle(toothCurrentCount) + configPage4.triggerAngle, triggerToothAngle); }
 
    }
 }
@@ -3545,131 +4144,13 @@ void triggerSetEndTeeth_ThirtySixMinus222()
 //************************************************************************************************************************
 
 /** 36-2-1 / Mistsubishi 4B11 - A crank based trigger with a nominal 36 teeth, but with 1 single and 1 double missing tooth.
+* Tooth #1 is the first tooth after the double gap and the single gap is where tooth #19 would be. This runs on the generic decoder (See dec_generic).
 * @defgroup dec_36_2_1 36-2-1 For Mistsubishi 4B11
 * @{
 */
-void triggerSetup_ThirtySixMinus21()
-{
-  triggerToothAngle = 10; //The number of degrees that passes from tooth to tooth
-  triggerActualTeeth = 33; //The number of physical teeth on the wheel. Doing this here saves us a calculation each time in the interrupt. Not Used
-  triggerFilterTime = (1000000 / (MAX_RPM / 60 * configPage4.triggerTeeth)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be disgarded as noise
-  secondDerivEnabled = false;
-  decoderIsSequential = false;
-  checkSyncToothCount = (configPage4.triggerTeeth) >> 1; //50% of the total teeth.
-  toothLastMinusOneToothTime = 0;
-  toothCurrentCount = 0;
-  toothOneTime = 0;
-  toothOneMinusOneTime = 0;
-  MAX_STALL_TIME = (3333UL * triggerToothAngle * 2 ); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
-}
-
-void triggerPri_ThirtySixMinus21()
-{
-   curTime = micros();
-   curGap = curTime - toothLastToothTime;
-   if ( curGap >= triggerFilterTime ) //Pulses should never be less than triggerFilterTime, so if they are it means a false trigger. (A 36-1 wheel at 8000pm will have triggers approx. every 200uS)
-   {
-     toothCurrentCount++; //Increment the tooth counter
-     validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
-
-     //Begin the missing tooth detection
-     //If the time between the current tooth and the last is greater than 2x the time between the last tooth and the tooth before that, we make the assertion that we must be at the first tooth after a gap
-    
-     targetGap2 = (3 * (toothLastToothTime - toothLastMinusOneToothTime)) ; //Multiply by 3 (Checks for a gap 3x greater than the last one)
-     targetGap = targetGap2 >> 1;  //Multiply by 1.5 (Checks for a gap 1.5x greater than the last one) (Uses bitshift to divide by 2 as in the missing tooth deocder)
-
-     if( (toothLastToothTime == 0) || (toothLastMinusOneToothTime == 0) ) { curGap = 0; }
-
-     if ( (curGap > targetGap) )
-     {
-      if ( (curGap < targetGap2))
-       {
-           //we are at the tooth after the single gap
-           toothCurrentCount = 20; //it's either 19 or 20, need to clarify engine direction!
-           currentStatus.hasSync = true;
-        }
-        else 
-        {
-          //we are at the tooth after the double gap
-          toothCurrentCount = 1; 
-          currentStatus.hasSync = true;
-        }
- 
-         triggerToothAngleIsCorrect = false; //The tooth angle is double at this point
-         triggerFilterTime = 0; //This is used to prevent a condition where serious intermitent signals (Eg someone furiously plugging the sensor wire in and out) can leave the filter in an unrecoverable state
-       }
-     }
-     else
-     {
-       if(  (toothCurrentCount > 36) || ( toothCurrentCount==1)  )
-       {
-         //Means a complete rotation has occured.
-         toothCurrentCount = 1;
-         revolutionOne = !revolutionOne; //Flip sequential revolution tracker
-         toothOneMinusOneTime = toothOneTime;
-         toothOneTime = curTime;
-         currentStatus.startRevolutions++; //Counter
-
-       }
-
-       //Filter can only be recalc'd for the regular teeth, not the missing one.
-       setFilter(curGap);
-
-       triggerToothAngleIsCorrect = true;
-
-     }
-
-     toothLastMinusOneToothTime = toothLastToothTime;
-     toothLastToothTime = curTime;
-
-     //EXPERIMENTAL!
-     if(configPage2.perToothIgn == true)
-     {
-       int16_t crankAngle = ( (toothCurrentCount-1) * triggerToothAngle ) + configPage4.triggerAngle;
-       crankAngle = ignitionLimits(crankAngle);
-       checkPerToothTiming(crankAngle, toothCurrentCount);
-     }
-
-   
-}
-
-void triggerSec_ThirtySixMinus21()
-{
-  //NOT USED - This pattern uses the missing tooth version of this function
-}
-
-uint16_t getRPM_ThirtySixMinus21()
-{
-  uint16_t tempRPM = 0;
-  if( currentStatus.RPM < currentStatus.crankRPM)
-  {
-    if( (toothCurrentCount != 20) && (triggerToothAngleIsCorrect == true) )
-    {
-      tempRPM = crankingGetRPM(36, 360);
-    }
-    else { tempRPM = currentStatus.RPM; } //Can't do per tooth RPM if we're at tooth #1 as the missing tooth messes the calculation
-  }
-  else
-  {
-    tempRPM = stdGetRPM(360);
-  }
-  return tempRPM;
-}
-
-int getCrankAngle_ThirtySixMinus21()
-{
-    //NOT USED - This pattern uses the missing tooth version of this function
-    return 0;
-}
-
-void triggerSetEndTeeth_ThirtySixMinus21()
-{
-  ignition1EndTooth = 10; 
-  ignition2EndTooth = 28; // Arbritrarilly picked  at 180°.
- 
-
-  lastToothCalcAdvance = currentStatus.advance;
-}
+static const uint16_t toothAngles36_2_1[] = { 0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 110, 120, 130, 140, 150, 160, 170,
+                                              190, 200, 210, 220, 230, 240, 250, 260, 270, 280, 290, 300, 310, 320, 330 };
+const triggerPatternDescriptor triggerPattern36_2_1 = { 360, 360, sizeof(toothAngles36_2_1) / sizeof(toothAngles36_2_1[0]), toothAngles36_2_1, NULL };
 /** @} */
 
 //************************************************************************************************************************
@@ -3683,6 +4164,7 @@ void triggerSetEndTeeth_ThirtySixMinus21()
 */
 void triggerSetup_420a()
 {
+  toothAnglesCount = 0; //This decoder indexes toothAngles directly, so getToothAngle() must not use it
   triggerFilterTime = (1000000 / (MAX_RPM / 60 * 360UL)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be disgarded as noise
   triggerSecFilterTime = 0;
   secondaryToothCount = 0; //Initially set to 0 prior to calculating the secondary window duration
@@ -3748,6 +4230,7 @@ void triggerPri_420a()
       crankAngle = ignitionLimits(crankAngle);
       checkPerToothTiming(crankAngle, toothCurrentCount);
     }
+    if( (angleSchedulesPending != 0) && (currentStatus.hasSync == true) ) { checkAngleSchedules(toothAngles[(toothCurrentCount-1)] + configPage4.triggerAngle, getTableToothGap(toothCurrentCount, 16, 720)); }
   }
 }
 
@@ -3769,7 +4252,7 @@ void triggerSec_420a()
       //If we DO have sync, then check that the tooth count matches what we expect
       if(toothCurrentCount != 13)
       {
-        currentStatus.syncLossCounter++;
+        triggerSyncLoss(SYNC_LOSS_CAM_MISMATCH);
         toothCurrentCount = 13;
       }
     }
@@ -3789,7 +4272,7 @@ void triggerSec_420a()
       //If we DO have sync, then check that the tooth count matches what we expect
       if(toothCurrentCount != 5)
       {
-        currentStatus.syncLossCounter++;
+        triggerSyncLoss(SYNC_LOSS_CAM_MISMATCH);
         toothCurrentCount = 5;
       }
     }
@@ -3817,18 +4300,18 @@ int getCrankAngle_420a()
   unsigned long tempToothLastToothTime;
   int tempToothCurrentCount;
   //Grab some variables that are used in the trigger code and assign them to temp variables.
-  noInterrupts();
-  tempToothCurrentCount = toothCurrentCount;
-  tempToothLastToothTime = toothLastToothTime;
-  lastCrankAngleCalc = micros(); //micros() is no longer interrupt safe
-  interrupts();
+  struct triggerSnapshot snapshot;
+  getTriggerSnapshot(snapshot);
+  tempToothCurrentCount = snapshot.toothCurrentCount;
+  tempToothLastToothTime = snapshot.toothLastToothTime;
+  lastCrankAngleCalc = micros();
 
   int crankAngle;
   crankAngle = toothAngles[(tempToothCurrentCount - 1)] + configPage4.triggerAngle; //Perform a lookup of the fixed toothAngles array to find what the angle of the last tooth passed was.
 
   //Estimate the number of degrees travelled since the last tooth}
   elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-  crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
+  crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
   if (crankAngle >= 720) { crankAngle -= 720; }
   if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -3903,14 +4386,18 @@ void triggerPri_Webber()
     //NEW IGNITION MODE
     if( (configPage2.perToothIgn == true) && (!BIT_CHECK(currentStatus.engine, BIT_ENGINE_CRANK)) ) 
     {
-      int16_t crankAngle = ( (toothCurrentCount-1) * triggerToothAngle ) + configPage4.triggerAngle;
-      if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) )
-      {
-        crankAngle += 360;
-        checkPerToothTiming(crankAngle, (configPage4.triggerTeeth + toothCurrentCount)); 
-      }
+      bool secondRevolution = (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED);
+      int16_t crankAngle = getCycleToothAngle(toothCurrentCount, secondRevolution) + configPage4.triggerAngle;
+      if(secondRevolution == true) { checkPerToothTiming(crankAngle, (configPage4.triggerTeeth + toothCurrentCount)); }
       else{ checkPerToothTiming(crankAngle, toothCurrentCount); }
     }
+
+    if( (angleSchedulesPending != 0) && (currentStatus.hasSync == true) )
+    {
+      bool secondRevolution = (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED);
+      int16_t crankAngle = getCycleToothAngle(toothCurrentCount, secondRevolution) + configPage4.triggerAngle;
+      checkAngleSchedules(crankAngle, getToothGap(toothCurrentCount, configPage4.triggerTeeth, ((configPage4.TrigSpeed == CAM_SPEED) ? 720 : 360)));
+    }
   } //Trigger filter
 }
 
@@ -3935,7 +4422,7 @@ void triggerSec_Webber()
       }
       else
       {
-        if ( (toothCurrentCount != (configPage4.triggerTeeth-1U)) && (currentStatus.startRevolutions > 2U)) { currentStatus.syncLossCounter++; } //Indicates likely sync loss.
+        if ( (toothCurrentCount != (configPage4.triggerTeeth-1U)) && (currentStatus.startRevolutions > 2U)) { triggerSyncLoss(SYNC_LOSS_CAM_MISMATCH); } //Indicates likely sync loss.
         if (configPage4.useResync == 1) { toothCurrentCount = configPage4.triggerTeeth-1; }
       }
       revolutionOne = 1; //Sequential revolution reset
@@ -3987,6 +4474,8 @@ void triggerSetup_FordST170()
   secondDerivEnabled = false;
   decoderIsSequential = true;
   checkSyncToothCount = (36) >> 1; //50% of the total teeth.
+  setEvenToothAngles(configPage4.triggerTeeth, triggerToothAngle, 0);
+  setSecondRevolutionToothAngles(configPage4.triggerTeeth);
   toothLastMinusOneToothTime = 0;
   toothCurrentCount = 0;
   secondaryToothCount = 0; 
@@ -4067,20 +4556,19 @@ int getCrankAngle_FordST170()
     int tempToothCurrentCount;
     bool tempRevolutionOne;
     //Grab some variables that are used in the trigger code and assign them to temp variables.
-    noInterrupts();
-    tempToothCurrentCount = toothCurrentCount;
-    tempRevolutionOne = revolutionOne;
-    tempToothLastToothTime = toothLastToothTime;
-    interrupts();
+    struct triggerSnapshot snapshot;
+    getTriggerSnapshot(snapshot);
+    tempToothCurrentCount = snapshot.toothCurrentCount;
+    tempRevolutionOne = snapshot.revolutionOne;
+    tempToothLastToothTime = snapshot.toothLastToothTime;
 
-    int crankAngle = ((tempToothCurrentCount - 1) * triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
-    
+    //The angle of the last tooth seen, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
     //Sequential check (simply sets whether we're on the first or 2nd revoltuion of the cycle)
-    if ( (tempRevolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) ) { crankAngle += 360; }
+    int crankAngle = getCycleToothAngle(tempToothCurrentCount, ( (tempRevolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) )) + configPage4.triggerAngle;
 
     lastCrankAngleCalc = micros();
     elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
-    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_REV);
+    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_DEFAULT);
 
     if (crankAngle >= 720) { crankAngle -= 720; }
     else if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
@@ -4092,40 +4580,355 @@ int getCrankAngle_FordST170()
 void triggerSetEndTeeth_FordST170()
 {
   byte toothAdder = 0;
-   if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (configPage4.TrigSpeed == CRANK_SPEED) ) { toothAdder = 36; }
-
-  //Temp variables are used here to avoid potential issues if a trigger interrupt occurs part way through this function
-
-  int16_t tempIgnition1EndTooth;
-  tempIgnition1EndTooth = ( (ignition1EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) ) - 1;
-  if(tempIgnition1EndTooth > (36 + toothAdder)) { tempIgnition1EndTooth -= (36 + toothAdder); }
-  if(tempIgnition1EndTooth <= 0) { tempIgnition1EndTooth += (36 + toothAdder); }
-  if((uint16_t)tempIgnition1EndTooth > (triggerActualTeeth + toothAdder)) { tempIgnition1EndTooth = (triggerActualTeeth + toothAdder); }
-  ignition1EndTooth = tempIgnition1EndTooth;
-
-  int16_t tempIgnition2EndTooth;
-  tempIgnition2EndTooth = ( (ignition2EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) ) - 1;
-  if(tempIgnition2EndTooth > (36 + toothAdder)) { tempIgnition2EndTooth -= (36 + toothAdder); }
-  if(tempIgnition2EndTooth <= 0) { tempIgnition2EndTooth += (36 + toothAdder); }
-  if((uint16_t)tempIgnition2EndTooth > (triggerActualTeeth + toothAdder)) { tempIgnition2EndTooth = (triggerActualTeeth + toothAdder); }
-  ignition2EndTooth = tempIgnition2EndTooth;
-
-  int16_t tempIgnition3EndTooth;
-  tempIgnition3EndTooth = ( (ignition3EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) ) - 1;
-  if(tempIgnition3EndTooth > (36 + toothAdder)) { tempIgnition3EndTooth -= (36 + toothAdder); }
-  if(tempIgnition3EndTooth <= 0) { tempIgnition3EndTooth += (36 + toothAdder); }
-  if((uint16_t)tempIgnition3EndTooth > (triggerActualTeeth + toothAdder)) { tempIgnition3EndTooth = (triggerActualTeeth + toothAdder); }
-  ignition3EndTooth = tempIgnition3EndTooth;
-
-  int16_t tempIgnition4EndTooth;
-  tempIgnition4EndTooth = ( (ignition4EndAngle - configPage4.triggerAngle) / (int16_t)(triggerToothAngle) ) - 1;
-  if(tempIgnition4EndTooth > (36 + toothAdder)) { tempIgnition4EndTooth -= (36 + toothAdder); }
-  if(tempIgnition4EndTooth <= 0) { tempIgnition4EndTooth += (36 + toothAdder); }
-  if((uint16_t)tempIgnition4EndTooth > (triggerActualTeeth + toothAdder)) { tempIgnition4EndTooth = (triggerActualTeeth + toothAdder); }
-  ignition4EndTooth = tempIgnition4EndTooth;
-  // Removed ign channels >4 as an ST170 engine is a 4 cylinder
+  if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (configPage4.TrigSpeed == CRANK_SPEED) ) { toothAdder = 36; }
 
-  lastToothCalcAdvance = currentStatus.advance;
+  //Channels above 4 are set as well, but an ST170 engine is a 4 cylinder so they are never used
+  setEvenEndTeeth(-1, 36 + toothAdder, triggerActualTeeth + toothAdder);
 }
 /** @} */
 
+
+//************************************************************************************************************************
+
+/** Generic table driven decoder.
+* The wheel is described by a triggerPatternDescriptor (See decoders.h). triggerSetup_Generic() turns that into a table of flags per tooth (The class of
+* gap expected before it, whether it starts a repeat of the pattern etc) and a table of which tooth each sequence of gap classes identifies. The
+* interrupt then only ever has to classify the latest gap and do table lookups, whatever the pattern.
+* @defgroup dec_generic Generic
+* @{
+*/
+#define GENERIC_FLAG_CLASS      0x03 //Class of the gap before this tooth compared to the one before it (See genericGapClass())
+#define GENERIC_FLAG_FILTER     0x04 //The gap after this tooth is no shorter than the one before it, so the trigger filter can be set from it
+#define GENERIC_FLAG_FIRST      0x08 //First tooth of the pattern
+
+/*
+* Classes the ratio of a gap to the one before it: 0 = Less than 0.75, 1 = 0.75 to 1.5, 2 = 1.5 to 2.5, 3 = 2.5 or more
+* The same function is used with times in the interrupt and with angles when building the tables
+*/
+static inline uint8_t genericGapClass(unsigned long gap, unsigned long lastGap)
+{
+  unsigned long gapx4 = gap << 2;
+  if(gapx4 < (lastGap * 3)) { return 0; }
+  if(gapx4 < (lastGap * 6)) { return 1; }
+  if(gapx4 < (lastGap * 10)) { return 2; }
+  return 3;
+}
+
+//Angle of the gap before the given tooth in the pattern
+static uint16_t genericGapAngle(const triggerPatternDescriptor &pattern, uint8_t tooth)
+{
+  if(tooth == 0) { return (pattern.angles[0] + pattern.patternAngle) - pattern.angles[pattern.teeth - 1]; }
+  return pattern.angles[tooth] - pattern.angles[tooth - 1];
+}
+
+static void genericResetSync()
+{
+  genericPatternSync = false;
+  genericSyncKey = 0;
+  genericKeyGaps = 0;
+  genericSecondaryCountValid = false;
+  toothCurrentCount = 0;
+  triggerToothAngleIsCorrect = false;
+  triggerFilterTime = 0;
+}
+
+void triggerSetup_Generic(const triggerPatternDescriptor &pattern)
+{
+  genericPattern = &pattern;
+  genericRepeats = pattern.cycleAngle / pattern.patternAngle;
+  triggerActualTeeth = pattern.teeth * genericRepeats;
+  triggerSecFilterTime = 0;
+  secondDerivEnabled = true;
+  decoderIsSequential = (pattern.cycleAngle == 720);
+  decoderHasSecondary = (pattern.secondaryCounts != NULL);
+  toothLastToothTime = 0;
+  toothLastMinusOneToothTime = 0;
+  toothOneTime = 0;
+  toothOneMinusOneTime = 0;
+  genericRepeat = 0;
+  genericRepeatAngle = 0;
+  genericToothIndex = 0;
+  genericResetSync();
+
+  uint16_t maxGap = 0;
+  genericTeethPer360 = 0;
+  memset(decoderTables.generic.keyTooth, 0, sizeof(decoderTables.generic.keyTooth));
+  for(uint8_t tooth = 0; tooth < pattern.teeth; tooth++)
+  {
+    uint8_t lastTooth = (tooth == 0) ? (pattern.teeth - 1) : (tooth - 1);
+    uint8_t nextTooth = (tooth == (pattern.teeth - 1)) ? 0 : (tooth + 1);
+    uint16_t gap = genericGapAngle(pattern, tooth);
+    maxGap = max(maxGap, gap);
+
+    decoderTables.generic.toothFlags[tooth] = genericGapClass(gap, genericGapAngle(pattern, lastTooth));
+    if(genericGapAngle(pattern, nextTooth) >= gap) { decoderTables.generic.toothFlags[tooth] |= GENERIC_FLAG_FILTER; }
+    if(tooth == 0) { decoderTables.generic.toothFlags[tooth] |= GENERIC_FLAG_FIRST; }
+
+    for(uint8_t repeat = 0; repeat < genericRepeats; repeat++)
+    {
+      if( (pattern.angles[tooth] + (repeat * pattern.patternAngle)) < 360 ) { genericTeethPer360++; }
+    }
+  }
+
+  //The sync key of each tooth is the classes of the last GENERIC_KEY_GAPS gaps. Only the keys that appear once in the pattern can be used for sync
+  for(uint8_t tooth = 0; tooth < pattern.teeth; tooth++)
+  {
+    uint8_t key = 0;
+    uint8_t keyTooth = (tooth + pattern.teeth - (GENERIC_KEY_GAPS - 1)) % pattern.teeth;
+    for(uint8_t gap = 0; gap < GENERIC_KEY_GAPS; gap++)
+    {
+      key = (key << 2) | (decoderTables.generic.toothFlags[keyTooth] & GENERIC_FLAG_CLASS);
+      keyTooth = (keyTooth == (pattern.teeth - 1)) ? 0 : (keyTooth + 1);
+    }
+    if(decoderTables.generic.keyTooth[key] == 0) { decoderTables.generic.keyTooth[key] = tooth + 1; }
+    else { decoderTables.generic.keyTooth[key] = 0xFF; } //Seen more than once
+  }
+  for(uint8_t key = 0; key < GENERIC_KEY_SIZE; key++)
+  {
+    if(decoderTables.generic.keyTooth[key] == 0xFF) { decoderTables.generic.keyTooth[key] = 0; }
+  }
+
+  triggerToothAngle = maxGap;
+  MAX_STALL_TIME = (3333UL * maxGap); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+}
+
+/*
+* Called on the first tooth of each repeat of the pattern once the position within the pattern is known.
+* Uses the number of secondary edges since the last repeat to find (Or check) which repeat this is
+*/
+static inline void genericCheckPhase()
+{
+  if(genericPattern->secondaryCounts == NULL) { currentStatus.hasSync = true; return; }
+
+  uint8_t count = genericSecondaryCount;
+  bool countValid = genericSecondaryCountValid;
+  genericSecondaryCount = 0;
+  genericSecondaryCountValid = true;
+  if(countValid == false) { return; } //The first repeat after the pattern is found may not have seen all of its secondary edges
+
+  uint8_t matchRepeat = 0;
+  uint8_t matches = 0;
+  for(uint8_t repeat = 0; repeat < genericRepeats; repeat++)
+  {
+    if(genericPattern->secondaryCounts[repeat] == count) { matchRepeat = repeat; matches++; }
+  }
+
+  if(matches == 1)
+  {
+    if( (currentStatus.hasSync == true) && (matchRepeat != genericRepeat) ) { triggerSyncLoss(SYNC_LOSS_CAM_MISMATCH); }
+    genericRepeat = matchRepeat;
+    genericRepeatAngle = matchRepeat * genericPattern->patternAngle;
+    currentStatus.hasSync = true;
+    BIT_CLEAR(currentStatus.status3, BIT_STATUS3_HALFSYNC);
+  }
+  else if( (matches == 0) || (genericPattern->secondaryCounts[genericRepeat] != count) )
+  {
+    //The count doesn't fit the repeat we think this is
+    if(currentStatus.hasSync == true) { triggerSyncLoss(SYNC_LOSS_CAM_MISMATCH); }
+    currentStatus.hasSync = false;
+    BIT_SET(currentStatus.status3, BIT_STATUS3_HALFSYNC);
+  }
+}
+
+void triggerPri_Generic()
+{
+  curTime = micros();
+  curGap = curTime - toothLastToothTime;
+  if ( curGap >= triggerFilterTime )
+  {
+    validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+    if( (toothLastToothTime > 0) && (toothLastMinusOneToothTime > 0) )
+    {
+      uint8_t gapClass = genericGapClass(curGap, (toothLastToothTime - toothLastMinusOneToothTime));
+      genericSyncKey = ((genericSyncKey << 2) | gapClass) & (GENERIC_KEY_SIZE - 1);
+      if(genericKeyGaps < GENERIC_KEY_GAPS) { genericKeyGaps++; }
+
+      if(genericPatternSync == true)
+      {
+        genericToothIndex++;
+        if(genericToothIndex >= genericPattern->teeth)
+        {
+          genericToothIndex = 0;
+          genericRepeat++;
+          if(genericRepeat >= genericRepeats) { genericRepeat = 0; }
+          genericRepeatAngle = genericRepeat * genericPattern->patternAngle;
+        }
+
+        //Allow one class either side of the expected one, as the speed can change a lot between 2 gaps when cranking
+        int8_t classError = (int8_t)gapClass - (int8_t)(decoderTables.generic.toothFlags[genericToothIndex] & GENERIC_FLAG_CLASS);
+        if( (classError > 1) || (classError < -1) )
+        {
+          if(currentStatus.hasSync == true) { triggerSyncLoss(SYNC_LOSS_UNEXPECTED_GAP); }
+          currentStatus.hasSync = false;
+          BIT_CLEAR(currentStatus.status3, BIT_STATUS3_HALFSYNC);
+          genericResetSync();
+        }
+      }
+      else if(genericKeyGaps >= GENERIC_KEY_GAPS)
+      {
+        uint8_t tooth = decoderTables.generic.keyTooth[genericSyncKey];
+        if(tooth > 0)
+        {
+          //Found the position in the pattern. If the pattern repeats, which repeat this is isn't known until the secondary has been checked
+          genericPatternSync = true;
+          genericToothIndex = tooth - 1;
+          genericRepeat = 0;
+          genericRepeatAngle = 0;
+          genericSecondaryCountValid = false;
+          if(genericPattern->secondaryCounts == NULL) { currentStatus.hasSync = true; } //Nothing else to check
+          else { BIT_SET(currentStatus.status3, BIT_STATUS3_HALFSYNC); }
+        }
+      }
+
+      if(genericPatternSync == true)
+      {
+        uint8_t flags = decoderTables.generic.toothFlags[genericToothIndex];
+        if( (flags & GENERIC_FLAG_FIRST) != 0 )
+        {
+          genericCheckPhase();
+          if(genericRepeat == 0)
+          {
+            if(currentStatus.hasSync == true) { currentStatus.startRevolutions += (genericPattern->cycleAngle == 720) ? 2 : 1; }
+            else { currentStatus.startRevolutions = 0; }
+            toothOneMinusOneTime = toothOneTime;
+            toothOneTime = curTime;
+          }
+        }
+        toothCurrentCount = (genericRepeat * genericPattern->teeth) + genericToothIndex + 1;
+        triggerToothAngle = genericGapAngle(*genericPattern, genericToothIndex);
+        triggerToothAngleIsCorrect = true;
+
+        if( (flags & GENERIC_FLAG_FILTER) != 0 ) { setFilter(curGap); }
+        else { triggerFilterTime = 0; }
+      }
+    }
+
+    toothLastMinusOneToothTime = toothLastToothTime;
+    toothLastToothTime = curTime;
+
+    if( (currentStatus.hasSync == true) && (configPage2.perToothIgn == true) && (!BIT_CHECK(currentStatus.engine, BIT_ENGINE_CRANK)) )
+    {
+      int16_t crankAngle = genericPattern->angles[genericToothIndex] + genericRepeatAngle + configPage4.triggerAngle;
+      uint16_t tooth = toothCurrentCount;
+      if( (CRANK_ANGLE_MAX_IGN == 360) && (tooth > genericTeethPer360) ) { tooth -= genericTeethPer360; } //Wasted spark on a 720 degree pattern. The 2nd revolution uses the same end teeth as the first
+      crankAngle = ignitionLimits(crankAngle);
+      checkPerToothTiming(crankAngle, tooth);
+    }
+    if( (angleSchedulesPending != 0) && (currentStatus.hasSync == true) )
+    {
+      uint8_t nextIndex = genericToothIndex + 1;
+      if(nextIndex >= genericPattern->teeth) { nextIndex = 0; }
+      checkAngleSchedules(genericPattern->angles[genericToothIndex] + genericRepeatAngle + configPage4.triggerAngle, genericGapAngle(*genericPattern, nextIndex));
+    }
+  }
+}
+
+void triggerSec_Generic()
+{
+  curTime2 = micros();
+  curGap2 = curTime2 - toothLastSecToothTime;
+  if ( curGap2 >= triggerSecFilterTime )
+  {
+    toothLastSecToothTime = curTime2;
+    if(genericSecondaryCount < 255) { genericSecondaryCount++; }
+  }
+}
+
+uint16_t getRPM_Generic()
+{
+  uint16_t tempRPM = 0;
+  if( currentStatus.RPM < currentStatus.crankRPM )
+  {
+    //Per tooth RPM while cranking. The angle of every gap is known once there is sync, so this works on uneven patterns as well
+    if( (currentStatus.startRevolutions >= configPage4.StgCycles) && (currentStatus.hasSync == true) && (triggerToothAngleIsCorrect == true) )
+    {
+      struct triggerSnapshot snapshot;
+      getTriggerSnapshot(snapshot);
+      unsigned long gap = snapshot.toothLastToothTime - snapshot.toothLastMinusOneToothTime;
+      uint16_t gapAngle = snapshot.triggerToothAngle;
+      if( (gap > 0) && (gapAngle > 0) )
+      {
+        revolutionTime = (gap * 360UL) / gapAngle;
+        tempRPM = (US_IN_MINUTE / revolutionTime);
+        if( tempRPM >= MAX_RPM ) { tempRPM = currentStatus.RPM; } //Sanity check
+      }
+    }
+  }
+  else { tempRPM = stdGetRPM(genericPattern->cycleAngle); }
+  return tempRPM;
+}
+
+int getCrankAngle_Generic()
+{
+    //Grab some variables that are used in the trigger code and assign them to temp variables.
+    uint8_t tempToothIndex;
+    uint16_t tempRepeatAngle;
+    unsigned long tempToothLastToothTime;
+    uint8_t sequence;
+    do
+    {
+      sequence = triggerSequence;
+      tempToothIndex = genericToothIndex;
+      tempRepeatAngle = genericRepeatAngle;
+      tempToothLastToothTime = toothLastToothTime;
+    } while(sequence != triggerSequence);
+
+    int crankAngle = genericPattern->angles[tempToothIndex] + tempRepeatAngle + configPage4.triggerAngle; //The angle of the last tooth is a single lookup, whatever the pattern
+
+    //The angle of the last gap is always known once there is sync, so the time since the last tooth can be converted using that gap, even on uneven patterns
+    lastCrankAngleCalc = micros();
+    elapsedTime = (lastCrankAngleCalc - tempToothLastToothTime);
+    crankAngle += timeToAngle(elapsedTime, CRANKMATH_METHOD_INTERVAL_TOOTH);
+
+    if (crankAngle >= 720) { crankAngle -= 720; }
+    if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
+    if (crankAngle < 0) { crankAngle += CRANK_ANGLE_MAX; }
+
+    return crankAngle;
+}
+
+/*
+* Returns the tooth (As counted by toothCurrentCount) that the end of an ignition event should be set from. This is the tooth before the last one
+* ahead of the end angle, the same as the missing tooth decoder uses
+*/
+static uint16_t genericEndTooth(int16_t endAngle)
+{
+  uint16_t teeth = triggerActualTeeth;
+  if(CRANK_ANGLE_MAX_IGN == 360) { teeth = genericTeethPer360; } //Only the first 360 degrees of the pattern is used for wasted spark
+
+  int16_t angle = endAngle - configPage4.triggerAngle;
+  while(angle < 0) { angle += CRANK_ANGLE_MAX_IGN; }
+  while(angle >= CRANK_ANGLE_MAX_IGN) { angle -= CRANK_ANGLE_MAX_IGN; }
+
+  uint16_t lastTooth = teeth; //If the angle is before the first tooth, the last tooth of the cycle is the one before it
+  uint16_t repeatAngle = 0;
+  uint8_t index = 0;
+  for(uint16_t tooth = 1; tooth <= teeth; tooth++)
+  {
+    if( (int16_t)(genericPattern->angles[index] + repeatAngle) >= angle ) { break; }
+    lastTooth = tooth;
+    index++;
+    if(index >= genericPattern->teeth) { index = 0; repeatAngle += genericPattern->patternAngle; }
+  }
+
+  return (lastTooth > 1) ? (lastTooth - 1) : teeth;
+}
+
+void triggerSetEndTeeth_Generic()
+{
+  uint16_t teeth = triggerActualTeeth;
+  if(CRANK_ANGLE_MAX_IGN == 360) { teeth = genericTeethPer360; }
+  bool allChannels = endTeethKeyChanged(0, 0, teeth, CRANK_ANGLE_MAX_IGN); //There is no tooth limit, but the wrap angle changes the end teeth so is part of the key
+
+  for(uint8_t channel = 0; channel < IGN_CHANNELS; channel++)
+  {
+    int endAngle = *ignitionEndAngles[channel];
+    if( (allChannels == false) && (endAngle == endTeethCache.endAngle[channel]) ) { continue; } //The tooth search is a loop, so only channels that have moved are searched
+    endTeethCache.endAngle[channel] = endAngle;
+    *ignitionEndTeeth[channel] = genericEndTooth(endAngle);
+  }
+
+  lastToothCalcAdvance = currentStatus.advance;
+}
+/** @} */
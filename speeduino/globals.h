@@ -142,6 +142,15 @@
   #define CORE_SAM
   #define INJ_CHANNELS 8
   #define IGN_CHANNELS 8
+#elif defined(NATIVE_BOARD)
+  //Host build, used for unit tests and benchmarks only. See board_native.h
+  #define BOARD_H "board_native.h"
+  #define CORE_NATIVE
+  #define BOARD_MAX_DIGITAL_PINS 54 //digital pins +1
+  #define BOARD_MAX_IO_PINS 70 //digital pins + analog channels + 1
+  #define BOARD_MAX_ADC_PINS  15 //Number of analog pins
+  #define INJ_CHANNELS 8
+  #define IGN_CHANNELS 8
 #else
   #error Incorrect board selected. Please select the correct board (Usually Mega 2560) and upload again
 #endif
@@ -232,12 +241,14 @@
 #define VALID_MAP_MIN 2 //The smallest ADC value that is valid for the MAP sensor
 
 #ifndef UNIT_TEST 
-#define TOOTH_LOG_SIZE      127
-#define TOOTH_LOG_BUFFER    128 //256
+#define TOOTH_LOG_SIZE      127 //Entries sent to TunerStudio for each log request
 #else
 #define TOOTH_LOG_SIZE      1
-#define TOOTH_LOG_BUFFER    1 //256
 #endif
+#define TOOTH_LOG_BUFFER    (2 * TOOTH_LOG_SIZE) //2 buffers of TOOTH_LOG_SIZE entries. The trigger interrupt fills one while the other is sent
+#define TOOTH_LOG_LONG_GAP  0x8000U //Log entries are 16 bit. Gaps of 32768uS or more have this bit set and are stored in 16uS steps, up to 524mS
+#define TOOTH_LOG_LONG_SHIFT 4
+#define COMPOSITE_LOG_BUFFER ((TOOTH_LOG_BUFFER + 1) / 2) //The composite status only uses 4 bits, so 2 entries are packed into each byte (The odd entry in the high nibble)
 
 #define COMPOSITE_LOG_PRI   0
 #define COMPOSITE_LOG_SEC   1
@@ -280,9 +291,6 @@
 #define HARD_CUT_FULL       0
 #define HARD_CUT_ROLLING    1
 
-#define SIZE_BYTE           8
-#define SIZE_INT            16
-
 #define EVEN_FIRE           0
 #define ODD_FIRE            1
 
@@ -413,50 +421,52 @@ extern const char TSfirmwareVersion[] PROGMEM;
 
 extern const byte data_structure_version; //This identifies the data structure when reading / writing. Now in use: CURRENT_DATA_VERSION (migration on-the fly) ?
 
-extern struct table3D fuelTable; //16x16 fuel map
-extern struct table3D fuelTable2; //16x16 fuel map
-extern struct table3D ignitionTable; //16x16 ignition map
-extern struct table3D ignitionTable2; //16x16 ignition map
-extern struct table3D afrTable; //16x16 afr target map
-extern struct table3D stagingTable; //8x8 fuel staging table
-extern struct table3D boostTable; //8x8 boost map
-extern struct table3D vvtTable; //8x8 vvt map
-extern struct table3D vvt2Table; //8x8 vvt2 map
-extern struct table3D wmiTable; //8x8 wmi map
-extern struct table3D trim1Table; //6x6 Fuel trim 1 map
-extern struct table3D trim2Table; //6x6 Fuel trim 2 map
-extern struct table3D trim3Table; //6x6 Fuel trim 3 map
-extern struct table3D trim4Table; //6x6 Fuel trim 4 map
-extern struct table3D trim5Table; //6x6 Fuel trim 5 map
-extern struct table3D trim6Table; //6x6 Fuel trim 6 map
-extern struct table3D trim7Table; //6x6 Fuel trim 7 map
-extern struct table3D trim8Table; //6x6 Fuel trim 8 map
-extern struct table3D dwellTable; //4x4 Dwell map
-extern struct table2D taeTable; //4 bin TPS Acceleration Enrichment map (2D)
-extern struct table2D maeTable;
-extern struct table2D WUETable; //10 bin Warm Up Enrichment map (2D)
-extern struct table2D ASETable; //4 bin After Start Enrichment map (2D)
-extern struct table2D ASECountTable; //4 bin After Start duration map (2D)
-extern struct table2D PrimingPulseTable; //4 bin Priming pulsewidth map (2D)
-extern struct table2D crankingEnrichTable; //4 bin cranking Enrichment map (2D)
-extern struct table2D dwellVCorrectionTable; //6 bin dwell voltage correction (2D)
-extern struct table2D injectorVCorrectionTable; //6 bin injector voltage correction (2D)
-extern struct table2D injectorAngleTable; //4 bin injector timing curve (2D)
-extern struct table2D IATDensityCorrectionTable; //9 bin inlet air temperature density correction (2D)
-extern struct table2D baroFuelTable; //8 bin baro correction curve (2D)
-extern struct table2D IATRetardTable; //6 bin ignition adjustment based on inlet air temperature  (2D)
-extern struct table2D idleTargetTable; //10 bin idle target table for idle timing (2D)
-extern struct table2D idleAdvanceTable; //6 bin idle advance adjustment table based on RPM difference  (2D)
-extern struct table2D CLTAdvanceTable; //6 bin ignition adjustment based on coolant temperature  (2D)
-extern struct table2D rotarySplitTable; //8 bin ignition split curve for rotary leading/trailing  (2D)
-extern struct table2D flexFuelTable;  //6 bin flex fuel correction table for fuel adjustments (2D)
-extern struct table2D flexAdvTable;   //6 bin flex fuel correction table for timing advance (2D)
-extern struct table2D flexBoostTable; //6 bin flex fuel correction table for boost adjustments (2D)
-extern struct table2D fuelTempTable;  //6 bin fuel temperature correction table for fuel adjustments (2D)
-extern struct table2D knockWindowStartTable;
-extern struct table2D knockWindowDurationTable;
-extern struct table2D oilPressureProtectTable;
-extern struct table2D wmiAdvTable; //6 bin wmi correction table for timing advance (2D)
+extern Table3D<16> fuelTable; //16x16 fuel map
+extern Table3D<16> fuelTable2; //16x16 fuel map
+extern Table3D<16> ignitionTable; //16x16 ignition map
+extern Table3D<16> ignitionTable2; //16x16 ignition map
+extern Table3D<16> afrTable; //16x16 afr target map
+extern Table3D<8> stagingTable; //8x8 fuel staging table
+extern Table3D<8> boostTable; //8x8 boost map
+extern Table3D<8> vvtTable; //8x8 vvt map
+extern Table3D<8> vvt2Table; //8x8 vvt2 map
+extern Table3D<8> wmiTable; //8x8 wmi map
+extern Table3D<6> trim1Table; //6x6 Fuel trim 1 map
+extern Table3D<6> trim2Table; //6x6 Fuel trim 2 map
+extern Table3D<6> trim3Table; //6x6 Fuel trim 3 map
+extern Table3D<6> trim4Table; //6x6 Fuel trim 4 map
+extern Table3D<6> trim5Table; //6x6 Fuel trim 5 map
+extern Table3D<6> trim6Table; //6x6 Fuel trim 6 map
+extern Table3D<6> trim7Table; //6x6 Fuel trim 7 map
+extern Table3D<6> trim8Table; //6x6 Fuel trim 8 map
+extern Table3D<4> dwellTable; //4x4 Dwell map
+extern struct table3DAxisContext fuelAxisContext; //Shared bin search for the RPM vs fuel load tables (fuel, fuel2, afr and staging)
+extern struct table3DAxisContext ignitionAxisContext; //Shared bin search for the RPM vs ignition load tables (ignition and ignition2)
+extern Table2D<4, uint8_t> taeTable; //4 bin TPS Acceleration Enrichment map (2D)
+extern Table2D<4, uint8_t> maeTable;
+extern Table2D<10, uint8_t> WUETable; //10 bin Warm Up Enrichment map (2D)
+extern Table2D<4, uint8_t> ASETable; //4 bin After Start Enrichment map (2D)
+extern Table2D<4, uint8_t> ASECountTable; //4 bin After Start duration map (2D)
+extern Table2D<4, uint8_t> PrimingPulseTable; //4 bin Priming pulsewidth map (2D)
+extern Table2D<4, uint8_t> crankingEnrichTable; //4 bin cranking Enrichment map (2D)
+extern Table2D<6, uint8_t> dwellVCorrectionTable; //6 bin dwell voltage correction (2D)
+extern Table2D<6, uint8_t> injectorVCorrectionTable; //6 bin injector voltage correction (2D)
+extern Table2D<4, int16_t, uint8_t> injectorAngleTable; //4 bin injector timing curve (2D)
+extern Table2D<9, uint8_t> IATDensityCorrectionTable; //9 bin inlet air temperature density correction (2D)
+extern Table2D<8, uint8_t> baroFuelTable; //8 bin baro correction curve (2D)
+extern Table2D<6, uint8_t> IATRetardTable; //6 bin ignition adjustment based on inlet air temperature  (2D)
+extern Table2D<10, uint8_t> idleTargetTable; //10 bin idle target table for idle timing (2D)
+extern Table2D<6, uint8_t> idleAdvanceTable; //6 bin idle advance adjustment table based on RPM difference  (2D)
+extern Table2D<6, uint8_t> CLTAdvanceTable; //6 bin ignition adjustment based on coolant temperature  (2D)
+extern Table2D<8, uint8_t> rotarySplitTable; //8 bin ignition split curve for rotary leading/trailing  (2D)
+extern Table2D<6, uint8_t> flexFuelTable;  //6 bin flex fuel correction table for fuel adjustments (2D)
+extern Table2D<6, uint8_t> flexAdvTable;   //6 bin flex fuel correction table for timing advance (2D)
+extern Table2D<6, int16_t, uint8_t> flexBoostTable; //6 bin flex fuel correction table for boost adjustments (2D)
+extern Table2D<6, uint8_t> fuelTempTable;  //6 bin fuel temperature correction table for fuel adjustments (2D)
+extern Table2D<6, uint8_t> knockWindowStartTable;
+extern Table2D<6, uint8_t> knockWindowDurationTable;
+extern Table2D<4, uint8_t> oilPressureProtectTable;
+extern Table2D<6, uint8_t> wmiAdvTable; //6 bin wmi correction table for timing advance (2D)
 
 //These are for the direct port manipulation of the injectors, coils and aux outputs
 extern volatile PORT_TYPE *inj1_pin_port;
@@ -535,7 +545,6 @@ extern int ignition7StartAngle;
 extern int ignition8StartAngle;
 
 //These are variables used across multiple files
-extern const byte PROGMEM fsIntIndex[34];
 extern bool initialisationComplete; //Tracks whether the setup() function has run completely
 extern byte fpPrimeTime; //The time (in seconds, based on currentStatus.secl) that the fuel pump started priming
 extern volatile uint16_t mainLoopCount;
@@ -545,12 +554,13 @@ extern volatile unsigned long ms_counter; //A counter that increments once per m
 extern uint16_t fixedCrankingOverride;
 extern bool clutchTrigger;
 extern bool previousClutchTrigger;
-extern volatile uint32_t toothHistory[TOOTH_LOG_BUFFER];
-extern volatile uint8_t compositeLogHistory[TOOTH_LOG_BUFFER];
+extern volatile uint16_t toothHistory[TOOTH_LOG_BUFFER];
+extern volatile uint8_t compositeLogHistory[COMPOSITE_LOG_BUFFER];
 extern volatile bool fpPrimed; //Tracks whether or not the fuel pump priming has been completed yet
 extern volatile bool injPrimed; //Tracks whether or not the injector priming has been completed yet
 extern volatile unsigned int toothHistoryIndex;
-extern volatile byte toothHistorySerialIndex;
+extern volatile byte toothHistoryFillBuffer;
+extern volatile byte toothHistorySendBuffer;
 extern unsigned long currentLoopTime; /**< The time (in uS) that the current mainloop started */
 extern unsigned long previousLoopTime; /**< The time (in uS) that the previous mainloop started */
 extern volatile uint16_t ignitionCount; /**< The count of ignition events that have taken place since the engine started */
@@ -709,6 +719,8 @@ struct statuses {
   long vvt2Duty; //Has to be a long for PID calcs (CL VVT control)
   byte outputsStatus;
   byte TS_SD_Status; //TunerStudios SD card status
+  volatile uint16_t priTriggerNoise; ///< Number of primary trigger edges rejected by the adaptive trigger filter (See @ref config4.triggerFilterAdaptive)
+  volatile uint16_t secTriggerNoise; ///< As priTriggerNoise, for the secondary trigger
 };
 
 /** Page 2 of the config - mostly variables that are required for fuel.
@@ -969,7 +981,9 @@ struct config4 {
 
   int16_t vvt2CL0DutyAng;
   byte vvt2PWMdir : 1;
-  byte unusedBits4 : 7;
+  byte triggerFilterAdaptive : 1; ///< Place the trigger filter window from the predicted time of the next tooth rather than as a fixed percentage of the last gap
+  byte crankMathMethod : 2; ///< How the crank angle is projected forward from the last tooth. The CRANKMATH_METHOD_ values from CRANKMATH_METHOD_INTERVAL_REV, less 1. Loaded into crankMathDefaultMethod by initialiseTriggers()
+  byte unusedBits4 : 4;
   byte ANGLEFILTER_VVT;
 
   byte unused4_124[3];
@@ -1478,8 +1492,8 @@ extern uint16_t iatCalibration_bins[32];
 extern uint16_t iatCalibration_values[32];
 extern uint16_t o2Calibration_bins[32];
 extern uint8_t  o2Calibration_values[32]; // Note 8-bit values
-extern struct table2D cltCalibrationTable; /**< A 32 bin array containing the coolant temperature sensor calibration values */
-extern struct table2D iatCalibrationTable; /**< A 32 bin array containing the inlet air temperature sensor calibration values */
-extern struct table2D o2CalibrationTable; /**< A 32 bin array containing the O2 sensor calibration values */
+extern Table2D<32, int16_t> cltCalibrationTable; /**< A 32 bin array containing the coolant temperature sensor calibration values */
+extern Table2D<32, int16_t> iatCalibrationTable; /**< A 32 bin array containing the inlet air temperature sensor calibration values */
+extern Table2D<32, uint8_t, int16_t> o2CalibrationTable; /**< A 32 bin array containing the O2 sensor calibration values */
 
 #endif // GLOBALS_H
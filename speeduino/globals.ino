@@ -7,50 +7,52 @@ const char TSfirmwareVersion[] PROGMEM = "Speeduino";
 
 const byte data_structure_version = 2; //This identifies the data structure when reading / writing. (outdated ?)
 
-struct table3D fuelTable; ///< 16x16 fuel map
-struct table3D fuelTable2; ///< 16x16 fuel map
-struct table3D ignitionTable; ///< 16x16 ignition map
-struct table3D ignitionTable2; ///< 16x16 ignition map
-struct table3D afrTable; ///< 16x16 afr target map
-struct table3D stagingTable; ///< 8x8 fuel staging table
-struct table3D boostTable; ///< 8x8 boost map
-struct table3D vvtTable; ///< 8x8 vvt map
-struct table3D vvt2Table; ///< 8x8 vvt2 map
-struct table3D wmiTable; ///< 8x8 wmi map
-struct table3D trim1Table; ///< 6x6 Fuel trim 1 map
-struct table3D trim2Table; ///< 6x6 Fuel trim 2 map
-struct table3D trim3Table; ///< 6x6 Fuel trim 3 map
-struct table3D trim4Table; ///< 6x6 Fuel trim 4 map
-struct table3D trim5Table; ///< 6x6 Fuel trim 5 map
-struct table3D trim6Table; ///< 6x6 Fuel trim 6 map
-struct table3D trim7Table; ///< 6x6 Fuel trim 7 map
-struct table3D trim8Table; ///< 6x6 Fuel trim 8 map
-struct table3D dwellTable; ///< 4x4 Dwell map
-struct table2D taeTable; ///< 4 bin TPS Acceleration Enrichment map (2D)
-struct table2D maeTable;
-struct table2D WUETable; ///< 10 bin Warm Up Enrichment map (2D)
-struct table2D ASETable; ///< 4 bin After Start Enrichment map (2D)
-struct table2D ASECountTable; ///< 4 bin After Start duration map (2D)
-struct table2D PrimingPulseTable; ///< 4 bin Priming pulsewidth map (2D)
-struct table2D crankingEnrichTable; ///< 4 bin cranking Enrichment map (2D)
-struct table2D dwellVCorrectionTable; ///< 6 bin dwell voltage correction (2D)
-struct table2D injectorVCorrectionTable; ///< 6 bin injector voltage correction (2D)
-struct table2D injectorAngleTable; ///< 4 bin injector angle curve (2D)
-struct table2D IATDensityCorrectionTable; ///< 9 bin inlet air temperature density correction (2D)
-struct table2D baroFuelTable; ///< 8 bin baro correction curve (2D)
-struct table2D IATRetardTable; ///< 6 bin ignition adjustment based on inlet air temperature  (2D)
-struct table2D idleTargetTable; ///< 10 bin idle target table for idle timing (2D)
-struct table2D idleAdvanceTable; ///< 6 bin idle advance adjustment table based on RPM difference  (2D)
-struct table2D CLTAdvanceTable; ///< 6 bin ignition adjustment based on coolant temperature  (2D)
-struct table2D rotarySplitTable; ///< 8 bin ignition split curve for rotary leading/trailing  (2D)
-struct table2D flexFuelTable;  ///< 6 bin flex fuel correction table for fuel adjustments (2D)
-struct table2D flexAdvTable;   ///< 6 bin flex fuel correction table for timing advance (2D)
-struct table2D flexBoostTable; ///< 6 bin flex fuel correction table for boost adjustments (2D)
-struct table2D fuelTempTable;  ///< 6 bin flex fuel correction table for fuel adjustments (2D)
-struct table2D knockWindowStartTable;
-struct table2D knockWindowDurationTable;
-struct table2D oilPressureProtectTable;
-struct table2D wmiAdvTable; ///< 6 bin wmi correction table for timing advance (2D)
+Table3D<16> fuelTable; ///< 16x16 fuel map
+Table3D<16> fuelTable2; ///< 16x16 fuel map
+Table3D<16> ignitionTable; ///< 16x16 ignition map
+Table3D<16> ignitionTable2; ///< 16x16 ignition map
+Table3D<16> afrTable; ///< 16x16 afr target map
+Table3D<8> stagingTable; ///< 8x8 fuel staging table
+Table3D<8> boostTable; ///< 8x8 boost map
+Table3D<8> vvtTable; ///< 8x8 vvt map
+Table3D<8> vvt2Table; ///< 8x8 vvt2 map
+Table3D<8> wmiTable; ///< 8x8 wmi map
+Table3D<6> trim1Table; ///< 6x6 Fuel trim 1 map
+Table3D<6> trim2Table; ///< 6x6 Fuel trim 2 map
+Table3D<6> trim3Table; ///< 6x6 Fuel trim 3 map
+Table3D<6> trim4Table; ///< 6x6 Fuel trim 4 map
+Table3D<6> trim5Table; ///< 6x6 Fuel trim 5 map
+Table3D<6> trim6Table; ///< 6x6 Fuel trim 6 map
+Table3D<6> trim7Table; ///< 6x6 Fuel trim 7 map
+Table3D<6> trim8Table; ///< 6x6 Fuel trim 8 map
+Table3D<4> dwellTable; ///< 4x4 Dwell map
+struct table3DAxisContext fuelAxisContext; ///< Shared bin search for the RPM vs fuel load tables (fuel, fuel2, afr and staging)
+struct table3DAxisContext ignitionAxisContext; ///< Shared bin search for the RPM vs ignition load tables (ignition and ignition2)
+Table2D<4, uint8_t> taeTable; ///< 4 bin TPS Acceleration Enrichment map (2D)
+Table2D<4, uint8_t> maeTable;
+Table2D<10, uint8_t> WUETable; ///< 10 bin Warm Up Enrichment map (2D)
+Table2D<4, uint8_t> ASETable; ///< 4 bin After Start Enrichment map (2D)
+Table2D<4, uint8_t> ASECountTable; ///< 4 bin After Start duration map (2D)
+Table2D<4, uint8_t> PrimingPulseTable; ///< 4 bin Priming pulsewidth map (2D)
+Table2D<4, uint8_t> crankingEnrichTable; ///< 4 bin cranking Enrichment map (2D)
+Table2D<6, uint8_t> dwellVCorrectionTable; ///< 6 bin dwell voltage correction (2D)
+Table2D<6, uint8_t> injectorVCorrectionTable; ///< 6 bin injector voltage correction (2D)
+Table2D<4, int16_t, uint8_t> injectorAngleTable; ///< 4 bin injector angle curve (2D)
+Table2D<9, uint8_t> IATDensityCorrectionTable; ///< 9 bin inlet air temperature density correction (2D)
+Table2D<8, uint8_t> baroFuelTable; ///< 8 bin baro correction curve (2D)
+Table2D<6, uint8_t> IATRetardTable; ///< 6 bin ignition adjustment based on inlet air temperature  (2D)
+Table2D<10, uint8_t> idleTargetTable; ///< 10 bin idle target table for idle timing (2D)
+Table2D<6, uint8_t> idleAdvanceTable; ///< 6 bin idle advance adjustment table based on RPM difference  (2D)
+Table2D<6, uint8_t> CLTAdvanceTable; ///< 6 bin ignition adjustment based on coolant temperature  (2D)
+Table2D<8, uint8_t> rotarySplitTable; ///< 8 bin ignition split curve for rotary leading/trailing  (2D)
+Table2D<6, uint8_t> flexFuelTable;  ///< 6 bin flex fuel correction table for fuel adjustments (2D)
+Table2D<6, uint8_t> flexAdvTable;   ///< 6 bin flex fuel correction table for timing advance (2D)
+Table2D<6, int16_t, uint8_t> flexBoostTable; ///< 6 bin flex fuel correction table for boost adjustments (2D)
+Table2D<6, uint8_t> fuelTempTable;  ///< 6 bin flex fuel correction table for fuel adjustments (2D)
+Table2D<6, uint8_t> knockWindowStartTable;
+Table2D<6, uint8_t> knockWindowDurationTable;
+Table2D<4, uint8_t> oilPressureProtectTable;
+Table2D<6, uint8_t> wmiAdvTable; ///< 6 bin wmi correction table for timing advance (2D)
 
 /// volatile inj*_pin_port and  inj*_pin_mask vars are for the direct port manipulation of the injectors, coils and aux outputs.
 volatile PORT_TYPE *inj1_pin_port;
@@ -120,8 +122,6 @@ int ignition7EndAngle = 0;
 int ignition8EndAngle = 0;
 
 //These are variables used across multiple files
-/// int (member) indexes in fullStatus array
-const byte PROGMEM fsIntIndex[34] = {4, 14, 17, 25, 27, 32, 41, 43, 45, 47, 49, 51, 53, 55, 57, 59, 61, 63, 65, 67, 69, 71, 75, 77, 79, 81, 85, 87, 89, 93, 97, 102, 190 };
 bool initialisationComplete = false; ///< Tracks whether the setup() function has run completely (true = has run)
 byte fpPrimeTime = 0; ///< The time (in seconds, based on @ref statuses.secl) that the fuel pump started priming
 volatile uint16_t mainLoopCount; //Main loop counter (incremented at each main loop rev., used for maintaining currentStatus.loopsPerSecond)
@@ -131,12 +131,13 @@ volatile unsigned long ms_counter = 0; //A counter that increments once per ms
 uint16_t fixedCrankingOverride = 0;
 bool clutchTrigger;
 bool previousClutchTrigger;
-volatile uint32_t toothHistory[TOOTH_LOG_BUFFER]; ///< Tooth trigger history - delta time (in uS) from last tooth (Indexed by @ref toothHistoryIndex)
-volatile uint8_t compositeLogHistory[TOOTH_LOG_BUFFER];
+volatile uint16_t toothHistory[TOOTH_LOG_BUFFER]; ///< Tooth trigger history - delta time from last tooth, encoded as described at TOOTH_LOG_LONG_GAP (Indexed by @ref toothHistoryIndex within @ref toothHistoryFillBuffer)
+volatile uint8_t compositeLogHistory[COMPOSITE_LOG_BUFFER]; ///< Composite log status bits, 2 entries per byte. See COMPOSITE_LOG_BUFFER
 volatile bool fpPrimed = false; ///< Tracks whether or not the fuel pump priming has been completed yet
 volatile bool injPrimed = false; ///< Tracks whether or not the injectors priming has been completed yet
-volatile unsigned int toothHistoryIndex = 0; ///< Current index to @ref toothHistory array
-volatile byte toothHistorySerialIndex = 0;
+volatile unsigned int toothHistoryIndex = 0; ///< Next entry to be written in the @ref toothHistory buffer being filled
+volatile byte toothHistoryFillBuffer = 0; ///< Which half of @ref toothHistory the trigger interrupt is filling
+volatile byte toothHistorySendBuffer = 1; ///< Which half of @ref toothHistory is sent when BIT_STATUS1_TOOTHLOG1READY is set
 unsigned long currentLoopTime; /**< The time (in uS) that the current mainloop started */
 unsigned long previousLoopTime; /**< The time (in uS) that the previous mainloop started */
 volatile uint16_t ignitionCount; /**< The count of ignition events that have taken place since the engine started */
@@ -262,10 +263,10 @@ struct config13 configPage13;
 
 uint16_t cltCalibration_bins[32];
 uint16_t cltCalibration_values[32];
-struct table2D cltCalibrationTable;
+Table2D<32, int16_t> cltCalibrationTable;
 uint16_t iatCalibration_bins[32];
 uint16_t iatCalibration_values[32];
-struct table2D iatCalibrationTable;
+Table2D<32, int16_t> iatCalibrationTable;
 uint16_t o2Calibration_bins[32];
 uint8_t o2Calibration_values[32];
-struct table2D o2CalibrationTable; 
+Table2D<32, uint8_t, int16_t> o2CalibrationTable; 
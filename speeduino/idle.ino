@@ -6,6 +6,8 @@ A full copy of the license may be found in the projects root directory
 #include "idle.h"
 #include "maths.h"
 #include "timers.h"
+#include "pages.h"
+#include "page_crc.h"
 #include "src/PID_v1/PID_v1.h"
 
 /*
@@ -176,6 +178,7 @@ void initialiseIdle()
         idleStepper.moreAirDirection = STEPPER_BACKWARD;
       }
       configPage6.iacPWMrun = false; // just in case. This needs to be false with stepper idle
+      invalidatePageCRC(afrSetPage);
       break;
 
     case IAC_ALGORITHM_STEP_CL:
@@ -215,6 +218,7 @@ void initialiseIdle()
       idlePID.SetTunings(configPage6.idleKP, configPage6.idleKI, configPage6.idleKD);
       idlePID.SetMode(AUTOMATIC); //Turn PID on
       configPage6.iacPWMrun = false; // just in case. This needs to be false with stepper idle
+      invalidatePageCRC(afrSetPage);
       break;
 
     default:
@@ -52,25 +52,6 @@ void initialiseAll()
 
     pinMode(LED_BUILTIN, OUTPUT);
     digitalWrite(LED_BUILTIN, LOW);
-    table3D_setSize(&fuelTable, 16);
-    table3D_setSize(&fuelTable2, 16);
-    table3D_setSize(&ignitionTable, 16);
-    table3D_setSize(&ignitionTable2, 16);
-    table3D_setSize(&afrTable, 16);
-    table3D_setSize(&stagingTable, 8);
-    table3D_setSize(&boostTable, 8);
-    table3D_setSize(&vvtTable, 8);
-    table3D_setSize(&vvt2Table, 8);
-    table3D_setSize(&wmiTable, 8);
-    table3D_setSize(&trim1Table, 6);
-    table3D_setSize(&trim2Table, 6);
-    table3D_setSize(&trim3Table, 6);
-    table3D_setSize(&trim4Table, 6);
-    table3D_setSize(&trim5Table, 6);
-    table3D_setSize(&trim6Table, 6);
-    table3D_setSize(&trim7Table, 6);
-    table3D_setSize(&trim8Table, 6);
-    table3D_setSize(&dwellTable, 4);
 
     #if defined(CORE_STM32)
     configPage9.intcan_available = 1;   // device has internal canbus
@@ -96,153 +77,69 @@ void initialiseAll()
       if (configPage9.enable_secondarySerial == 1) { CANSerial.begin(115200); }
     #endif
 
-    //Repoint the 2D table structs to the config pages that were just loaded
-    taeTable.valueSize = SIZE_BYTE; //Set this table to use byte values
-    taeTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    taeTable.xSize = 4;
+    //Repoint the 2D table structs to the config pages that were just loaded (The sizes and types are set by their Table2D declarations in globals.h)
     taeTable.values = configPage4.taeValues;
     taeTable.axisX = configPage4.taeBins;
-    maeTable.valueSize = SIZE_BYTE; //Set this table to use byte values
-    maeTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    maeTable.xSize = 4;
     maeTable.values = configPage4.maeRates;
     maeTable.axisX = configPage4.maeBins;
-    WUETable.valueSize = SIZE_BYTE; //Set this table to use byte values
-    WUETable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    WUETable.xSize = 10;
     WUETable.values = configPage2.wueValues;
     WUETable.axisX = configPage4.wueBins;
-    ASETable.valueSize = SIZE_BYTE;
-    ASETable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    ASETable.xSize = 4;
     ASETable.values = configPage2.asePct;
     ASETable.axisX = configPage2.aseBins;
-    ASECountTable.valueSize = SIZE_BYTE;
-    ASECountTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    ASECountTable.xSize = 4;
     ASECountTable.values = configPage2.aseCount;
     ASECountTable.axisX = configPage2.aseBins;
-    PrimingPulseTable.valueSize = SIZE_BYTE;
-    PrimingPulseTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    PrimingPulseTable.xSize = 4;
     PrimingPulseTable.values = configPage2.primePulse;
     PrimingPulseTable.axisX = configPage2.primeBins;
-    crankingEnrichTable.valueSize = SIZE_BYTE;
-    crankingEnrichTable.axisSize = SIZE_BYTE;
-    crankingEnrichTable.xSize = 4;
     crankingEnrichTable.values = configPage10.crankingEnrichValues;
     crankingEnrichTable.axisX = configPage10.crankingEnrichBins;
 
-    dwellVCorrectionTable.valueSize = SIZE_BYTE;
-    dwellVCorrectionTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    dwellVCorrectionTable.xSize = 6;
     dwellVCorrectionTable.values = configPage4.dwellCorrectionValues;
     dwellVCorrectionTable.axisX = configPage6.voltageCorrectionBins;
-    injectorVCorrectionTable.valueSize = SIZE_BYTE;
-    injectorVCorrectionTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    injectorVCorrectionTable.xSize = 6;
     injectorVCorrectionTable.values = configPage6.injVoltageCorrectionValues;
     injectorVCorrectionTable.axisX = configPage6.voltageCorrectionBins;
-    injectorAngleTable.valueSize = SIZE_INT;
-    injectorAngleTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    injectorAngleTable.xSize = 4;
     injectorAngleTable.values = configPage2.injAng;
     injectorAngleTable.axisX = configPage2.injAngRPM;
-    IATDensityCorrectionTable.valueSize = SIZE_BYTE;
-    IATDensityCorrectionTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    IATDensityCorrectionTable.xSize = 9;
     IATDensityCorrectionTable.values = configPage6.airDenRates;
     IATDensityCorrectionTable.axisX = configPage6.airDenBins;
-    baroFuelTable.valueSize = SIZE_BYTE;
-    baroFuelTable.axisSize = SIZE_BYTE;
-    baroFuelTable.xSize = 8;
     baroFuelTable.values = configPage4.baroFuelValues;
     baroFuelTable.axisX = configPage4.baroFuelBins;
-    IATRetardTable.valueSize = SIZE_BYTE;
-    IATRetardTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    IATRetardTable.xSize = 6;
     IATRetardTable.values = configPage4.iatRetValues;
     IATRetardTable.axisX = configPage4.iatRetBins;
-    CLTAdvanceTable.valueSize = SIZE_BYTE;
-    CLTAdvanceTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    CLTAdvanceTable.xSize = 6;
     CLTAdvanceTable.values = (byte*)configPage4.cltAdvValues;
     CLTAdvanceTable.axisX = configPage4.cltAdvBins;
-    idleTargetTable.valueSize = SIZE_BYTE;
-    idleTargetTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    idleTargetTable.xSize = 10;
     idleTargetTable.values = configPage6.iacCLValues;
     idleTargetTable.axisX = configPage6.iacBins;
-    idleAdvanceTable.valueSize = SIZE_BYTE;
-    idleAdvanceTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    idleAdvanceTable.xSize = 6;
     idleAdvanceTable.values = (byte*)configPage4.idleAdvValues;
     idleAdvanceTable.axisX = configPage4.idleAdvBins;
-    rotarySplitTable.valueSize = SIZE_BYTE;
-    rotarySplitTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    rotarySplitTable.xSize = 8;
     rotarySplitTable.values = configPage10.rotarySplitValues;
     rotarySplitTable.axisX = configPage10.rotarySplitBins;
 
-    flexFuelTable.valueSize = SIZE_BYTE;
-    flexFuelTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    flexFuelTable.xSize = 6;
     flexFuelTable.values = configPage10.flexFuelAdj;
     flexFuelTable.axisX = configPage10.flexFuelBins;
-    flexAdvTable.valueSize = SIZE_BYTE;
-    flexAdvTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    flexAdvTable.xSize = 6;
     flexAdvTable.values = configPage10.flexAdvAdj;
     flexAdvTable.axisX = configPage10.flexAdvBins;
-    flexBoostTable.valueSize = SIZE_INT;
-    flexBoostTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins (NOTE THIS IS DIFFERENT TO THE VALUES!!)
-    flexBoostTable.xSize = 6;
     flexBoostTable.values = configPage10.flexBoostAdj;
     flexBoostTable.axisX = configPage10.flexBoostBins;
-    fuelTempTable.valueSize = SIZE_BYTE;
-    fuelTempTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    fuelTempTable.xSize = 6;
     fuelTempTable.values = configPage10.fuelTempValues;
     fuelTempTable.axisX = configPage10.fuelTempBins;
 
-    knockWindowStartTable.valueSize = SIZE_BYTE;
-    knockWindowStartTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    knockWindowStartTable.xSize = 6;
     knockWindowStartTable.values = configPage10.knock_window_angle;
     knockWindowStartTable.axisX = configPage10.knock_window_rpms;
-    knockWindowDurationTable.valueSize = SIZE_BYTE;
-    knockWindowDurationTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    knockWindowDurationTable.xSize = 6;
     knockWindowDurationTable.values = configPage10.knock_window_dur;
     knockWindowDurationTable.axisX = configPage10.knock_window_rpms;
 
-    oilPressureProtectTable.valueSize = SIZE_BYTE;
-    oilPressureProtectTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    oilPressureProtectTable.xSize = 4;
     oilPressureProtectTable.values = configPage10.oilPressureProtMins;
     oilPressureProtectTable.axisX = configPage10.oilPressureProtRPM;
 
-    wmiAdvTable.valueSize = SIZE_BYTE;
-    wmiAdvTable.axisSize = SIZE_BYTE; //Set this table to use byte axis bins
-    wmiAdvTable.xSize = 6;
     wmiAdvTable.values = configPage10.wmiAdvAdj;
     wmiAdvTable.axisX = configPage10.wmiAdvBins;
 
-    cltCalibrationTable.valueSize = SIZE_INT;
-    cltCalibrationTable.axisSize = SIZE_INT;
-    cltCalibrationTable.xSize = 32;
     cltCalibrationTable.values = cltCalibration_values;
     cltCalibrationTable.axisX = cltCalibration_bins;
 
-    iatCalibrationTable.valueSize = SIZE_INT;
-    iatCalibrationTable.axisSize = SIZE_INT;
-    iatCalibrationTable.xSize = 32;
     iatCalibrationTable.values = iatCalibration_values;
     iatCalibrationTable.axisX = iatCalibration_bins;
 
-    o2CalibrationTable.valueSize = SIZE_BYTE;
-    o2CalibrationTable.axisSize = SIZE_INT;
-    o2CalibrationTable.xSize = 32;
     o2CalibrationTable.values = o2Calibration_values;
     o2CalibrationTable.axisX = o2Calibration_bins;
 
@@ -400,6 +297,8 @@ void initialiseAll()
     //currentStatus.seclx10 = 0;
     currentStatus.startRevolutions = 0;
     currentStatus.syncLossCounter = 0;
+    currentStatus.priTriggerNoise = 0;
+    currentStatus.secTriggerNoise = 0;
     currentStatus.flatShiftingHard = false;
     currentStatus.launchingHard = false;
     currentStatus.crankRPM = ((unsigned int)configPage4.crankRPM * 10); //Crank RPM limit (Saves us calculating this over and over again. It's updated once per second in timers.ino)
@@ -412,8 +311,7 @@ void initialiseAll()
     ms_counter = 0;
     fixedCrankingOverride = 0;
     timer5_overflow_count = 0;
-    toothHistoryIndex = 0;
-    toothHistorySerialIndex = 0;
+    resetToothLog();
     
     noInterrupts();
     initialiseTriggers();
@@ -430,7 +328,8 @@ void initialiseAll()
     currentLoopTime = micros_safe();
     mainLoopCount = 0;
 
-    currentStatus.nSquirts = configPage2.nCylinders / configPage2.divider; //The number of squirts being requested. This is manaully overriden below for sequential setups (Due to TS req_fuel calc limitations)
+    if(configPage2.divider == 0) { currentStatus.nSquirts = 0; } //Blank config. Picked up by the safety check below
+    else { currentStatus.nSquirts = configPage2.nCylinders / configPage2.divider; } //The number of squirts being requested. This is manaully overriden below for sequential setups (Due to TS req_fuel calc limitations)
     if(currentStatus.nSquirts == 0) { currentStatus.nSquirts = 1; } //Safety check. Should never happen as TS will give an error, but leave incase tune is manually altered etc. 
 
     //Calculate the number of degrees between cylinders
@@ -893,106 +792,120 @@ void initialiseAll()
     {
     case INJ_PAIRED:
         //Paired injection
-        inj1StartFunction = openInjector1;
-        inj1EndFunction = closeInjector1;
-        inj2StartFunction = openInjector2;
-        inj2EndFunction = closeInjector2;
-        inj3StartFunction = openInjector3;
-        inj3EndFunction = closeInjector3;
-        inj4StartFunction = openInjector4;
-        inj4EndFunction = closeInjector4;
-        inj5StartFunction = openInjector5;
-        inj5EndFunction = closeInjector5;
+        fuelSchedule1.StartCallback = openInjector1;
+        fuelSchedule1.EndCallback = closeInjector1;
+        fuelSchedule2.StartCallback = openInjector2;
+        fuelSchedule2.EndCallback = closeInjector2;
+        fuelSchedule3.StartCallback = openInjector3;
+        fuelSchedule3.EndCallback = closeInjector3;
+        fuelSchedule4.StartCallback = openInjector4;
+        fuelSchedule4.EndCallback = closeInjector4;
+        #if INJ_CHANNELS >= 5
+        fuelSchedule5.StartCallback = openInjector5;
+        fuelSchedule5.EndCallback = closeInjector5;
+        #endif
         break;
 
     case INJ_SEMISEQUENTIAL:
         //Semi-Sequential injection. Currently possible with 4, 6 and 8 cylinders. 5 cylinder is a special case
         if( configPage2.nCylinders == 4 )
         {
-          inj1StartFunction = openInjector1and4;
-          inj1EndFunction = closeInjector1and4;
-          inj2StartFunction = openInjector2and3;
-          inj2EndFunction = closeInjector2and3;
+          fuelSchedule1.StartCallback = openInjector1and4;
+          fuelSchedule1.EndCallback = closeInjector1and4;
+          fuelSchedule2.StartCallback = openInjector2and3;
+          fuelSchedule2.EndCallback = closeInjector2and3;
         }
         else if( configPage2.nCylinders == 5 ) //This is similar to the paired injection but uses five injector outputs instead of four
         {
-          inj1StartFunction = openInjector1;
-          inj1EndFunction = closeInjector1;
-          inj2StartFunction = openInjector2;
-          inj2EndFunction = closeInjector2;
-          inj3StartFunction = openInjector3and5;
-          inj3EndFunction = closeInjector3and5;
-          inj4StartFunction = openInjector4;
-          inj4EndFunction = closeInjector4;
+          fuelSchedule1.StartCallback = openInjector1;
+          fuelSchedule1.EndCallback = closeInjector1;
+          fuelSchedule2.StartCallback = openInjector2;
+          fuelSchedule2.EndCallback = closeInjector2;
+          fuelSchedule3.StartCallback = openInjector3and5;
+          fuelSchedule3.EndCallback = closeInjector3and5;
+          fuelSchedule4.StartCallback = openInjector4;
+          fuelSchedule4.EndCallback = closeInjector4;
         }
         else if( configPage2.nCylinders == 6 )
         {
-          inj1StartFunction = openInjector1and4;
-          inj1EndFunction = closeInjector1and4;
-          inj2StartFunction = openInjector2and5;
-          inj2EndFunction = closeInjector2and5;
-          inj3StartFunction = openInjector3and6;
-          inj3EndFunction = closeInjector3and6;
+          fuelSchedule1.StartCallback = openInjector1and4;
+          fuelSchedule1.EndCallback = closeInjector1and4;
+          fuelSchedule2.StartCallback = openInjector2and5;
+          fuelSchedule2.EndCallback = closeInjector2and5;
+          fuelSchedule3.StartCallback = openInjector3and6;
+          fuelSchedule3.EndCallback = closeInjector3and6;
         }
         else if( configPage2.nCylinders == 8 )
         {
-          inj1StartFunction = openInjector1and5;
-          inj1EndFunction = closeInjector1and5;
-          inj2StartFunction = openInjector2and6;
-          inj2EndFunction = closeInjector2and6;
-          inj3StartFunction = openInjector3and7;
-          inj3EndFunction = closeInjector3and7;
-          inj4StartFunction = openInjector4and8;
-          inj4EndFunction = closeInjector4and8;
+          fuelSchedule1.StartCallback = openInjector1and5;
+          fuelSchedule1.EndCallback = closeInjector1and5;
+          fuelSchedule2.StartCallback = openInjector2and6;
+          fuelSchedule2.EndCallback = closeInjector2and6;
+          fuelSchedule3.StartCallback = openInjector3and7;
+          fuelSchedule3.EndCallback = closeInjector3and7;
+          fuelSchedule4.StartCallback = openInjector4and8;
+          fuelSchedule4.EndCallback = closeInjector4and8;
         }
         else
         {
           //Fall back to paired injection
-          inj1StartFunction = openInjector1;
-          inj1EndFunction = closeInjector1;
-          inj2StartFunction = openInjector2;
-          inj2EndFunction = closeInjector2;
-          inj3StartFunction = openInjector3;
-          inj3EndFunction = closeInjector3;
-          inj4StartFunction = openInjector4;
-          inj4EndFunction = closeInjector4;
-          inj5StartFunction = openInjector5;
-          inj5EndFunction = closeInjector5;
+          fuelSchedule1.StartCallback = openInjector1;
+          fuelSchedule1.EndCallback = closeInjector1;
+          fuelSchedule2.StartCallback = openInjector2;
+          fuelSchedule2.EndCallback = closeInjector2;
+          fuelSchedule3.StartCallback = openInjector3;
+          fuelSchedule3.EndCallback = closeInjector3;
+          fuelSchedule4.StartCallback = openInjector4;
+          fuelSchedule4.EndCallback = closeInjector4;
+          #if INJ_CHANNELS >= 5
+          fuelSchedule5.StartCallback = openInjector5;
+          fuelSchedule5.EndCallback = closeInjector5;
+          #endif
         }
         break;
 
     case INJ_SEQUENTIAL:
         //Sequential injection
-        inj1StartFunction = openInjector1;
-        inj1EndFunction = closeInjector1;
-        inj2StartFunction = openInjector2;
-        inj2EndFunction = closeInjector2;
-        inj3StartFunction = openInjector3;
-        inj3EndFunction = closeInjector3;
-        inj4StartFunction = openInjector4;
-        inj4EndFunction = closeInjector4;
-        inj5StartFunction = openInjector5;
-        inj5EndFunction = closeInjector5;
-        inj6StartFunction = openInjector6;
-        inj6EndFunction = closeInjector6;
-        inj7StartFunction = openInjector7;
-        inj7EndFunction = closeInjector7;
-        inj8StartFunction = openInjector8;
-        inj8EndFunction = closeInjector8;
+        fuelSchedule1.StartCallback = openInjector1;
+        fuelSchedule1.EndCallback = closeInjector1;
+        fuelSchedule2.StartCallback = openInjector2;
+        fuelSchedule2.EndCallback = closeInjector2;
+        fuelSchedule3.StartCallback = openInjector3;
+        fuelSchedule3.EndCallback = closeInjector3;
+        fuelSchedule4.StartCallback = openInjector4;
+        fuelSchedule4.EndCallback = closeInjector4;
+        #if INJ_CHANNELS >= 5
+        fuelSchedule5.StartCallback = openInjector5;
+        fuelSchedule5.EndCallback = closeInjector5;
+        #endif
+        #if INJ_CHANNELS >= 6
+        fuelSchedule6.StartCallback = openInjector6;
+        fuelSchedule6.EndCallback = closeInjector6;
+        #endif
+        #if INJ_CHANNELS >= 7
+        fuelSchedule7.StartCallback = openInjector7;
+        fuelSchedule7.EndCallback = closeInjector7;
+        #endif
+        #if INJ_CHANNELS >= 8
+        fuelSchedule8.StartCallback = openInjector8;
+        fuelSchedule8.EndCallback = closeInjector8;
+        #endif
         break;
 
     default:
         //Paired injection
-        inj1StartFunction = openInjector1;
-        inj1EndFunction = closeInjector1;
-        inj2StartFunction = openInjector2;
-        inj2EndFunction = closeInjector2;
-        inj3StartFunction = openInjector3;
-        inj3EndFunction = closeInjector3;
-        inj4StartFunction = openInjector4;
-        inj4EndFunction = closeInjector4;
-        inj5StartFunction = openInjector5;
-        inj5EndFunction = closeInjector5;
+        fuelSchedule1.StartCallback = openInjector1;
+        fuelSchedule1.EndCallback = closeInjector1;
+        fuelSchedule2.StartCallback = openInjector2;
+        fuelSchedule2.EndCallback = closeInjector2;
+        fuelSchedule3.StartCallback = openInjector3;
+        fuelSchedule3.EndCallback = closeInjector3;
+        fuelSchedule4.StartCallback = openInjector4;
+        fuelSchedule4.EndCallback = closeInjector4;
+        #if INJ_CHANNELS >= 5
+        fuelSchedule5.StartCallback = openInjector5;
+        fuelSchedule5.EndCallback = closeInjector5;
+        #endif
         break;
     }
 
@@ -2734,6 +2647,14 @@ void initialiseTriggers()
   byte triggerInterrupt2 = 1;
   byte triggerInterrupt3 = 2;
 
+  crankMathDefaultMethod = CRANKMATH_METHOD_INTERVAL_REV + configPage4.crankMathMethod;
+
+  //The alpha-beta filter and 2nd derivative tooth history must not carry over any teeth from a previous pattern
+  crankSpeedFilterReset();
+  crankToothHistoryReset();
+  triggerSetEndTeethReset(); //End teeth from the previous pattern are stale even if the new one is set up the same way
+  triggerSetFilterReset();
+
   #if defined(CORE_AVR)
     switch (pinTrigger) {
       //Arduino Mega 2560 mapping
@@ -2833,13 +2754,13 @@ void initialiseTriggers()
       if(configPage10.TrigEdgeThrd == 0) { tertiaryTriggerEdge = RISING; }
       else { tertiaryTriggerEdge = FALLING; }
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       if(configPage10.vvt2Enabled > 0) { attachInterrupt(triggerInterrupt3, triggerTertiaryHandler, tertiaryTriggerEdge); } // we only need this for vvt2, so not really needed if it's not used
 
       /*
-      if(configPage4.TrigEdge == 0) { attachInterrupt(triggerInterrupt, triggerHandler, RISING); }
-      else { attachInterrupt(triggerInterrupt, triggerHandler, FALLING); }
+      if(configPage4.TrigEdge == 0) { attachInterrupt(triggerInterrupt, triggerPrimaryISR, RISING); }
+      else { attachInterrupt(triggerInterrupt, triggerPrimaryISR, FALLING); }
       if(configPage4.TrigEdgeSec == 0) { attachInterrupt(triggerInterrupt2, triggerSec_missingTooth, RISING); }
       else { attachInterrupt(triggerInterrupt2, triggerSec_missingTooth, FALLING); }
       */
@@ -2856,7 +2777,7 @@ void initialiseTriggers()
       if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
       else { primaryTriggerEdge = FALLING; }
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
       break;
 
     case 2:
@@ -2873,8 +2794,8 @@ void initialiseTriggers()
       if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
       else { secondaryTriggerEdge = FALLING; }
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_GM7X:
@@ -2884,13 +2805,13 @@ void initialiseTriggers()
       getCrankAngle = getCrankAngle_GM7X;
       triggerSetEndTeeth = triggerSetEndTeeth_GM7X;
 
-      if(configPage4.TrigEdge == 0) { attachInterrupt(triggerInterrupt, triggerHandler, RISING); } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
-      else { attachInterrupt(triggerInterrupt, triggerHandler, FALLING); }
+      if(configPage4.TrigEdge == 0) { attachInterrupt(triggerInterrupt, triggerPrimaryISR, RISING); } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { attachInterrupt(triggerInterrupt, triggerPrimaryISR, FALLING); }
 
       if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
       else { primaryTriggerEdge = FALLING; }
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
       break;
 
     case DECODER_4G63:
@@ -2905,8 +2826,8 @@ void initialiseTriggers()
       primaryTriggerEdge = CHANGE;
       secondaryTriggerEdge = FALLING;
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_24X:
@@ -2922,8 +2843,8 @@ void initialiseTriggers()
       else { primaryTriggerEdge = FALLING; }
       secondaryTriggerEdge = CHANGE; //Secondary is always on every change
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_JEEP2000:
@@ -2939,8 +2860,8 @@ void initialiseTriggers()
       else { primaryTriggerEdge = FALLING; }
       secondaryTriggerEdge = CHANGE;
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_AUDI135:
@@ -2956,8 +2877,8 @@ void initialiseTriggers()
       else { primaryTriggerEdge = FALLING; }
       secondaryTriggerEdge = RISING; //always rising for this trigger
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_HONDA_D17:
@@ -2973,8 +2894,8 @@ void initialiseTriggers()
       else { primaryTriggerEdge = FALLING; }
       secondaryTriggerEdge = CHANGE;
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_MIATA_9905:
@@ -2992,8 +2913,8 @@ void initialiseTriggers()
       if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
       else { secondaryTriggerEdge = FALLING; }
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_MAZDA_AU:
@@ -3009,13 +2930,13 @@ void initialiseTriggers()
       else { primaryTriggerEdge = FALLING; }
       secondaryTriggerEdge = FALLING;
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_NON360:
       triggerSetup_non360();
-      triggerHandler = triggerPri_DualWheel; //Is identical to the dual wheel decoder, so that is used. Same goes for the secondary below
+      triggerHandler = triggerPri_non360; //Shares the dual wheel tooth handling, but has its own crank angle for the angle schedules
       triggerSecondaryHandler = triggerSec_DualWheel; //Note the use of the Dual Wheel trigger function here. No point in having the same code in twice.
       decoderHasSecondary = true;
       getRPM = getRPM_non360;
@@ -3026,8 +2947,8 @@ void initialiseTriggers()
       else { primaryTriggerEdge = FALLING; }
       secondaryTriggerEdge = FALLING;
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_NISSAN_360:
@@ -3043,8 +2964,8 @@ void initialiseTriggers()
       else { primaryTriggerEdge = FALLING; }
       secondaryTriggerEdge = CHANGE;
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_SUBARU_67:
@@ -3060,8 +2981,8 @@ void initialiseTriggers()
       else { primaryTriggerEdge = FALLING; }
       secondaryTriggerEdge = FALLING;
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_DAIHATSU_PLUS1:
@@ -3075,7 +2996,7 @@ void initialiseTriggers()
       if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
       else { primaryTriggerEdge = FALLING; }
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
       break;
 
     case DECODER_HARLEY:
@@ -3087,7 +3008,7 @@ void initialiseTriggers()
       triggerSetEndTeeth = triggerSetEndTeeth_Harley;
 
       primaryTriggerEdge = RISING; //Always rising
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
       break;
 
     case DECODER_36_2_2_2:
@@ -3105,12 +3026,26 @@ void initialiseTriggers()
       if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
       else { secondaryTriggerEdge = FALLING; }
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_36_2_1:
       //36-2-1
+      triggerSetup_Generic(triggerPattern36_2_1);
+      triggerHandler = triggerPri_Generic;
+      triggerSecondaryHandler = triggerSec_Generic;
+      getRPM = getRPM_Generic;
+      getCrankAngle = getCrankAngle_Generic;
+      triggerSetEndTeeth = triggerSetEndTeeth_Generic;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
+      else { secondaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      if(decoderHasSecondary == true) { attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge); }
       break;
 
     case DECODER_420A:
@@ -3127,8 +3062,8 @@ void initialiseTriggers()
       else { primaryTriggerEdge = FALLING; }
       secondaryTriggerEdge = FALLING; //Always falling edge
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_WEBER:
@@ -3146,8 +3081,8 @@ void initialiseTriggers()
       if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
       else { secondaryTriggerEdge = FALLING; }
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
       break;
 
     case DECODER_ST170:
@@ -3165,8 +3100,8 @@ void initialiseTriggers()
       if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
       else { secondaryTriggerEdge = FALLING; }
 
-      attachInterrupt(triggerInterrupt, triggerHandler, primaryTriggerEdge);
-      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      attachInterrupt(triggerInterrupt, triggerPrimaryISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryISR, secondaryTriggerEdge);
 
       break;
 
@@ -3175,8 +3110,8 @@ void initialiseTriggers()
       getRPM = getRPM_missingTooth;
       getCrankAngle = getCrankAngle_missingTooth;
 
-      if(configPage4.TrigEdge == 0) { attachInterrupt(triggerInterrupt, triggerHandler, RISING); } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
-      else { attachInterrupt(triggerInterrupt, triggerHandler, FALLING); }
+      if(configPage4.TrigEdge == 0) { attachInterrupt(triggerInterrupt, triggerPrimaryISR, RISING); } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { attachInterrupt(triggerInterrupt, triggerPrimaryISR, FALLING); }
       break;
   }
 }
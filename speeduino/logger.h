@@ -10,14 +10,31 @@
 #define LOGGER_H
 
 #ifndef UNIT_TEST // Scope guard for unit testing
-  #define LOG_ENTRY_SIZE      121 /**< The size of the live data packet. This MUST match ochBlockSize setting in the ini file */
-  #define SD_LOG_ENTRY_SIZE   121 /**< The size of the live data packet used by the SD car.*/
+  #define LOG_ENTRY_SIZE      125 /**< The size of the live data packet. This MUST match ochBlockSize setting in the ini file */
+  #define SD_LOG_ENTRY_SIZE   125 /**< The size of the live data packet used by the SD car.*/
 #else
   #define LOG_ENTRY_SIZE      1 /**< The size of the live data packet. This MUST match ochBlockSize setting in the ini file */
   #define SD_LOG_ENTRY_SIZE   1 /**< The size of the live data packet used by the SD car.*/
 #endif
 
-void createLog(uint8_t *array);
+//How a field in currentStatus is turned into its bytes of the log entry. See logEntryFields in logger.ino
+#define LOG_TRANSFORM_NONE        0
+#define LOG_TRANSFORM_TEMPERATURE 1 /**< Add CALIBRATION_TEMPERATURE_OFFSET so that negative temperatures fit in a byte */
+#define LOG_TRANSFORM_HALF        2 /**< Divide by 2 to fit in a byte */
+#define LOG_TRANSFORM_DIV100      3 /**< Divide by 100 to fit in a byte */
+#define LOG_TRANSFORM_ERROR       4 /**< Not a currentStatus field, the next error from getNextError() */
+
+/** Describes one field of the live data packet. The fields are sent in the order they are listed, so each one starts where the previous one ended */
+struct logEntryField
+{
+  uint16_t offset;   ///< offsetof() the field in currentStatus
+  uint8_t size;      ///< sizeof() the field in currentStatus
+  uint8_t width;     ///< Bytes the field takes in the log entry (1 or 2). 2 byte fields are sent low byte first
+  uint8_t transform; ///< One of the LOG_TRANSFORM_* values
+};
+
+void createLog(uint8_t *logBuffer, uint16_t offset, uint16_t length);
+int16_t getLogEntryField(uint16_t byteNum);
 void createSDLog(uint8_t *array);
 
 #endif
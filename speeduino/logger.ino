@@ -1,138 +1,193 @@
 #include "globals.h"
 #include "errors.h"
+#include <stddef.h>
 
-void createLog(uint8_t *logBuffer)
-{
-    currentStatus.spark ^= (-currentStatus.hasSync ^ currentStatus.spark) & (1U << BIT_SPARK_SYNC); //Set the sync bit of the Spark variable to match the hasSync variable
-
-    logBuffer[0] = currentStatus.secl; //secl is simply a counter that increments each second. Used to track unexpected resets (Which will reset this count to 0)
-    logBuffer[1] = currentStatus.status1; //status1 Bitfield
-    logBuffer[2] = currentStatus.engine; //Engine Status Bitfield
-    logBuffer[3] = currentStatus.syncLossCounter;
-    logBuffer[4] = lowByte(currentStatus.MAP); //2 bytes for MAP
-    logBuffer[5] = highByte(currentStatus.MAP);
-    logBuffer[6] = (byte)(currentStatus.IAT + CALIBRATION_TEMPERATURE_OFFSET); //mat
-    logBuffer[7] = (byte)(currentStatus.coolant + CALIBRATION_TEMPERATURE_OFFSET); //Coolant ADC
-    logBuffer[8] = currentStatus.batCorrection; //Battery voltage correction (%)
-    logBuffer[9] = currentStatus.battery10; //battery voltage
-    logBuffer[10] = currentStatus.O2; //O2
-    logBuffer[11] = currentStatus.egoCorrection; //Exhaust gas correction (%)
-    logBuffer[12] = currentStatus.iatCorrection; //Air temperature Correction (%)
-    logBuffer[13] = currentStatus.wueCorrection; //Warmup enrichment (%)
-    logBuffer[14] = lowByte(currentStatus.RPM); //rpm HB
-    logBuffer[15] = highByte(currentStatus.RPM); //rpm LB
-    logBuffer[16] = (byte)(currentStatus.AEamount >> 1); //TPS acceleration enrichment (%) divided by 2 (Can exceed 255)
-    logBuffer[17] = currentStatus.corrections; //Total GammaE (%)
-    logBuffer[18] = currentStatus.VE; //Current VE (%). Can be equal to VE1 or VE2 or a calculated value from both of them
-    logBuffer[19] = currentStatus.VE1; //VE 1 (%)
-    logBuffer[20] = currentStatus.VE2; //VE 2 (%)
-    logBuffer[21] = currentStatus.afrTarget;
-    logBuffer[22] = currentStatus.tpsDOT; //TPS DOT
-    logBuffer[23] = currentStatus.advance;
-    logBuffer[24] = currentStatus.TPS; // TPS (0% to 100%)
-    //Need to split the int loopsPerSecond value into 2 bytes
-    if(currentStatus.loopsPerSecond > 60000) { currentStatus.loopsPerSecond = 60000;}
-    logBuffer[25] = lowByte(currentStatus.loopsPerSecond);
-    logBuffer[26] = highByte(currentStatus.loopsPerSecond);
-
-    //The following can be used to show the amount of free memory
-    currentStatus.freeRAM = freeRam();
-    logBuffer[27] = lowByte(currentStatus.freeRAM); //(byte)((currentStatus.loopsPerSecond >> 8) & 0xFF);
-    logBuffer[28] = highByte(currentStatus.freeRAM);
-
-    logBuffer[29] = (byte)(currentStatus.boostTarget >> 1); //Divide boost target by 2 to fit in a byte
-    logBuffer[30] = (byte)(currentStatus.boostDuty / 100);
-    logBuffer[31] = currentStatus.spark; //Spark related bitfield
-
-    //rpmDOT must be sent as a signed integer
-    logBuffer[32] = lowByte(currentStatus.rpmDOT);
-    logBuffer[33] = highByte(currentStatus.rpmDOT);
+#define LOG_FIELD(field, width, transform) { offsetof(struct statuses, field), sizeof(currentStatus.field), width, transform }
+#define LOG_BYTE(field) LOG_FIELD(field, 1, LOG_TRANSFORM_NONE)
+#define LOG_WORD(field) LOG_FIELD(field, 2, LOG_TRANSFORM_NONE)
 
-    logBuffer[34] = currentStatus.ethanolPct; //Flex sensor value (or 0 if not used)
-    logBuffer[35] = currentStatus.flexCorrection; //Flex fuel correction (% above or below 100)
-    logBuffer[36] = currentStatus.flexIgnCorrection; //Ignition correction (Increased degrees of advance) for flex fuel
+/*
+The live data packet, in the order it is sent. The byte each field starts at is given in the comments.
+Each new field added here needs to be added to the [OutputChannels] section of speeduino.ini at the same offset and LOG_ENTRY_SIZE / ochBlockSize increased to match
+*/
+static constexpr struct logEntryField logEntryFields[] PROGMEM = {
+  LOG_BYTE(secl), //0 - secl is simply a counter that increments each second. Used to track unexpected resets (Which will reset this count to 0)
+  LOG_BYTE(status1), //1 - status1 Bitfield
+  LOG_BYTE(engine), //2 - Engine Status Bitfield
+  LOG_BYTE(syncLossCounter), //3
+  LOG_WORD(MAP), //4
+  LOG_FIELD(IAT, 1, LOG_TRANSFORM_TEMPERATURE), //6 - mat
+  LOG_FIELD(coolant, 1, LOG_TRANSFORM_TEMPERATURE), //7
+  LOG_BYTE(batCorrection), //8 - Battery voltage correction (%)
+  LOG_BYTE(battery10), //9 - battery voltage
+  LOG_BYTE(O2), //10
+  LOG_BYTE(egoCorrection), //11 - Exhaust gas correction (%)
+  LOG_BYTE(iatCorrection), //12 - Air temperature Correction (%)
+  LOG_BYTE(wueCorrection), //13 - Warmup enrichment (%)
+  LOG_WORD(RPM), //14
+  LOG_FIELD(AEamount, 1, LOG_TRANSFORM_HALF), //16 - TPS acceleration enrichment (%) divided by 2 (Can exceed 255)
+  LOG_WORD(corrections), //17 - Total GammaE (%)
+  LOG_BYTE(VE1), //19 - VE 1 (%)
+  LOG_BYTE(VE2), //20 - VE 2 (%)
+  LOG_BYTE(afrTarget), //21
+  LOG_BYTE(tpsDOT), //22
+  LOG_BYTE(advance), //23
+  LOG_BYTE(TPS), //24 - TPS (0% to 100%)
+  LOG_WORD(loopsPerSecond), //25 - Limited to 60000 by createLog()
+  LOG_WORD(freeRAM), //27 - Updated by createLog()
+  LOG_FIELD(boostTarget, 1, LOG_TRANSFORM_HALF), //29 - Divide boost target by 2 to fit in a byte
+  LOG_FIELD(boostDuty, 1, LOG_TRANSFORM_DIV100), //30
+  LOG_BYTE(spark), //31 - Spark related bitfield. The sync bit is set by createLog()
+  LOG_WORD(rpmDOT), //32 - Signed
+  LOG_BYTE(ethanolPct), //34 - Flex sensor value (or 0 if not used)
+  LOG_BYTE(flexCorrection), //35 - Flex fuel correction (% above or below 100)
+  LOG_BYTE(flexIgnCorrection), //36 - Ignition correction (Increased degrees of advance) for flex fuel
+  LOG_BYTE(idleLoad), //37
+  LOG_BYTE(testOutputs), //38
+  LOG_BYTE(O2_2), //39
+  LOG_BYTE(baro), //40 - Barometer value
+  LOG_WORD(canin[0]), //41
+  LOG_WORD(canin[1]), //43
+  LOG_WORD(canin[2]), //45
+  LOG_WORD(canin[3]), //47
+  LOG_WORD(canin[4]), //49
+  LOG_WORD(canin[5]), //51
+  LOG_WORD(canin[6]), //53
+  LOG_WORD(canin[7]), //55
+  LOG_WORD(canin[8]), //57
+  LOG_WORD(canin[9]), //59
+  LOG_WORD(canin[10]), //61
+  LOG_WORD(canin[11]), //63
+  LOG_WORD(canin[12]), //65
+  LOG_WORD(canin[13]), //67
+  LOG_WORD(canin[14]), //69
+  LOG_WORD(canin[15]), //71
+  LOG_BYTE(tpsADC), //73
+  { 0, 0, 1, LOG_TRANSFORM_ERROR }, //74
+  LOG_WORD(PW1), //75 - Pulsewidth 1 in uS
+  LOG_WORD(PW2), //77
+  LOG_WORD(PW3), //79
+  LOG_WORD(PW4), //81
+  LOG_BYTE(status3), //83
+  LOG_BYTE(engineProtectStatus), //84
+  LOG_WORD(fuelLoad), //85
+  LOG_WORD(ignLoad), //87
+  LOG_WORD(dwell), //89
+  LOG_BYTE(CLIdleTarget), //91
+  LOG_BYTE(mapDOT), //92
+  LOG_WORD(vvt1Angle), //93
+  LOG_BYTE(vvt1TargetAngle), //95
+  LOG_BYTE(vvt1Duty), //96
+  LOG_WORD(flexBoostCorrection), //97
+  LOG_BYTE(baroCorrection), //99
+  LOG_BYTE(VE), //100 - Current VE (%). Can be equal to VE1 or VE2 or a calculated value from both of them
+  LOG_BYTE(ASEValue), //101 - Current ASE (%)
+  LOG_WORD(vss), //102
+  LOG_BYTE(gear), //104
+  LOG_BYTE(fuelPressure), //105
+  LOG_BYTE(oilPressure), //106
+  LOG_BYTE(wmiPW), //107
+  LOG_BYTE(status4), //108
+  LOG_WORD(vvt2Angle), //109
+  LOG_BYTE(vvt2TargetAngle), //111
+  LOG_BYTE(vvt2Duty), //112
+  LOG_BYTE(outputsStatus), //113
+  LOG_FIELD(fuelTemp, 1, LOG_TRANSFORM_TEMPERATURE), //114 - Fuel temperature from flex sensor
+  LOG_BYTE(fuelTempCorrection), //115 - Fuel temperature Correction (%)
+  LOG_BYTE(advance1), //116 - advance 1 (%)
+  LOG_BYTE(advance2), //117 - advance 2 (%)
+  LOG_BYTE(TS_SD_Status), //118 - SD card status
+  LOG_WORD(EMAP), //119
+  LOG_WORD(priTriggerNoise), //121 - Primary trigger edges rejected by the adaptive filter
+  LOG_WORD(secTriggerNoise), //123 - As above, for the secondary trigger
+};
+#define LOG_ENTRY_FIELDS (sizeof(logEntryFields) / sizeof(logEntryFields[0]))
 
-    logBuffer[37] = currentStatus.idleLoad;
-    logBuffer[38] = currentStatus.testOutputs;
+#ifndef UNIT_TEST
+static constexpr uint16_t logEntryFieldsWidth(uint8_t fields) { return (fields == 0) ? 0 : logEntryFields[fields - 1].width + logEntryFieldsWidth(fields - 1); }
+static_assert(logEntryFieldsWidth(LOG_ENTRY_FIELDS) == LOG_ENTRY_SIZE, "logEntryFields must cover exactly LOG_ENTRY_SIZE bytes");
+#endif
 
-    logBuffer[39] = currentStatus.O2_2; //O2
-    logBuffer[40] = currentStatus.baro; //Barometer value
-
-    logBuffer[41] = lowByte(currentStatus.canin[0]);
-    logBuffer[42] = highByte(currentStatus.canin[0]);
-    logBuffer[43] = lowByte(currentStatus.canin[1]);
-    logBuffer[44] = highByte(currentStatus.canin[1]);
-    logBuffer[45] = lowByte(currentStatus.canin[2]);
-    logBuffer[46] = highByte(currentStatus.canin[2]);
-    logBuffer[47] = lowByte(currentStatus.canin[3]);
-    logBuffer[48] = highByte(currentStatus.canin[3]);
-    logBuffer[49] = lowByte(currentStatus.canin[4]);
-    logBuffer[50] = highByte(currentStatus.canin[4]);
-    logBuffer[51] = lowByte(currentStatus.canin[5]);
-    logBuffer[52] = highByte(currentStatus.canin[5]);
-    logBuffer[53] = lowByte(currentStatus.canin[6]);
-    logBuffer[54] = highByte(currentStatus.canin[6]);
-    logBuffer[55] = lowByte(currentStatus.canin[7]);
-    logBuffer[56] = highByte(currentStatus.canin[7]);
-    logBuffer[57] = lowByte(currentStatus.canin[8]);
-    logBuffer[58] = highByte(currentStatus.canin[8]);
-    logBuffer[59] = lowByte(currentStatus.canin[9]);
-    logBuffer[60] = highByte(currentStatus.canin[9]);
-    logBuffer[61] = lowByte(currentStatus.canin[10]);
-    logBuffer[62] = highByte(currentStatus.canin[10]);
-    logBuffer[63] = lowByte(currentStatus.canin[11]);
-    logBuffer[64] = highByte(currentStatus.canin[11]);
-    logBuffer[65] = lowByte(currentStatus.canin[12]);
-    logBuffer[66] = highByte(currentStatus.canin[12]);
-    logBuffer[67] = lowByte(currentStatus.canin[13]);
-    logBuffer[68] = highByte(currentStatus.canin[13]);
-    logBuffer[69] = lowByte(currentStatus.canin[14]);
-    logBuffer[70] = highByte(currentStatus.canin[14]);
-    logBuffer[71] = lowByte(currentStatus.canin[15]);
-    logBuffer[72] = highByte(currentStatus.canin[15]);
+/*
+Reads a field from currentStatus at whatever size it is stored as and applies its transform. Only the low 16 bits are ever sent
+*/
+static uint16_t readLogField(const struct logEntryField &field)
+{
+  if(field.transform == LOG_TRANSFORM_ERROR) { return getNextError(); }
 
-    logBuffer[73] = currentStatus.tpsADC;
-    logBuffer[74] = getNextError();
+  const uint8_t *source = (const uint8_t *)&currentStatus + field.offset;
+  uint32_t value;
+  switch(field.size)
+  {
+    case 1: value = *source; break;
+    case 2: { uint16_t value16; memcpy(&value16, source, 2); value = value16; break; }
+    case 4: memcpy(&value, source, 4); break;
+    default: { uint64_t value64; memcpy(&value64, source, 8); value = (uint32_t)value64; break; } //long on 64 bit hosts
+  }
 
-    logBuffer[75] = lowByte(currentStatus.PW1); //Pulsewidth 1 multiplied by 10 in ms. Have to convert from uS to mS.
-    logBuffer[76] = highByte(currentStatus.PW1); //Pulsewidth 1 multiplied by 10 in ms. Have to convert from uS to mS.
-    logBuffer[77] = lowByte(currentStatus.PW2); //Pulsewidth 2 multiplied by 10 in ms. Have to convert from uS to mS.
-    logBuffer[78] = highByte(currentStatus.PW2); //Pulsewidth 2 multiplied by 10 in ms. Have to convert from uS to mS.
-    logBuffer[79] = lowByte(currentStatus.PW3); //Pulsewidth 3 multiplied by 10 in ms. Have to convert from uS to mS.
-    logBuffer[80] = highByte(currentStatus.PW3); //Pulsewidth 3 multiplied by 10 in ms. Have to convert from uS to mS.
-    logBuffer[81] = lowByte(currentStatus.PW4); //Pulsewidth 4 multiplied by 10 in ms. Have to convert from uS to mS.
-    logBuffer[82] = highByte(currentStatus.PW4); //Pulsewidth 4 multiplied by 10 in ms. Have to convert from uS to mS.
+  switch(field.transform)
+  {
+    case LOG_TRANSFORM_TEMPERATURE: value += CALIBRATION_TEMPERATURE_OFFSET; break;
+    case LOG_TRANSFORM_HALF: value >>= 1; break;
+    case LOG_TRANSFORM_DIV100: value /= 100; break;
+    default: break;
+  }
+  return (uint16_t)value;
+}
 
-    logBuffer[83] = currentStatus.status3;
+/** Fills logBuffer with length bytes of the live data packet, starting at byte offset of the packet.
+ * This is a single pass over logEntryFields. Fields before offset are skipped without being read and bytes past the end of the packet are 0.
+ * @param logBuffer - Buffer to fill, must be at least length bytes
+ * @param offset - First byte of the packet to fill logBuffer from
+ * @param length - Number of bytes to fill
+ */
+void createLog(uint8_t *logBuffer, uint16_t offset, uint16_t length)
+{
+  //Fields that are only brought up to date when they're sent
+  currentStatus.spark ^= (-currentStatus.hasSync ^ currentStatus.spark) & (1U << BIT_SPARK_SYNC); //Set the sync bit of the Spark variable to match the hasSync variable
+  if(currentStatus.loopsPerSecond > 60000) { currentStatus.loopsPerSecond = 60000;}
+  currentStatus.freeRAM = freeRam();
 
-    logBuffer[84] = currentStatus.nChannels;
-    logBuffer[85] = lowByte(currentStatus.fuelLoad);
-    logBuffer[86] = highByte(currentStatus.fuelLoad);
-    logBuffer[87] = lowByte(currentStatus.ignLoad);
-    logBuffer[88] = highByte(currentStatus.ignLoad);
-    logBuffer[89] = lowByte(currentStatus.dwell);
-    logBuffer[90] = highByte(currentStatus.dwell);
-    logBuffer[91] = currentStatus.CLIdleTarget;
-    logBuffer[92] = currentStatus.mapDOT;
-    logBuffer[93] = currentStatus.vvt1Angle;
-    logBuffer[94] = currentStatus.vvt1TargetAngle;
-    logBuffer[95] = (byte) currentStatus.vvt1Duty;
-    logBuffer[96] = lowByte(currentStatus.flexBoostCorrection);
-    logBuffer[97] = highByte(currentStatus.flexBoostCorrection);
-    logBuffer[98] = currentStatus.baroCorrection;
-    logBuffer[99] = currentStatus.VE; //Current VE (%). Can be equal to VE1 or VE2 or a calculated value from both of them
-    logBuffer[100] = currentStatus.ASEValue; //Current ASE (%)
-    logBuffer[101] = lowByte(currentStatus.vss);
-    logBuffer[102] = highByte(currentStatus.vss);
-    logBuffer[103] = currentStatus.gear;
-    logBuffer[104] = currentStatus.fuelPressure;
-    logBuffer[105] = currentStatus.oilPressure;
-    logBuffer[106] = currentStatus.wmiPW;
-    logBuffer[107] = currentStatus.status4;
-    logBuffer[108] = currentStatus.vvt2Angle;
-    logBuffer[109] = currentStatus.vvt2TargetAngle;
-    logBuffer[110] = (byte) currentStatus.vvt2Duty;
-    logBuffer[111] = currentStatus.advance1;
-    logBuffer[112] = currentStatus.advance2;
+  uint16_t end = offset + length;
+  uint16_t position = 0;
+  for(uint8_t index = 0; (index < LOG_ENTRY_FIELDS) && (position < end); index++)
+  {
+    struct logEntryField field;
+    memcpy_P(&field, &logEntryFields[index], sizeof(field));
+    if( (position + field.width) > offset )
+    {
+      uint16_t value = readLogField(field);
+      if(position >= offset) { logBuffer[position - offset] = lowByte(value); }
+      if( (field.width == 2) && ((position + 1) < end) ) { logBuffer[position + 1 - offset] = highByte(value); }
+    }
+    position += field.width;
+  }
+  for(; position < end; position++)
+  {
+    if(position >= offset) { logBuffer[position - offset] = 0; }
+  }
+}
 
-}
\ No newline at end of file
+/** Returns the value TunerStudio reads for the field at byteNum of the live data packet.
+ * 2 byte fields are returned as a signed 16 bit value, as long as byteNum is the first (low) byte. Any other byte is returned on its own.
+ * @param byteNum - Byte of the live data packet
+ * @return The field value, or 0 if byteNum is past the end of the packet
+ */
+int16_t getLogEntryField(uint16_t byteNum)
+{
+  uint16_t position = 0;
+  for(uint8_t index = 0; index < LOG_ENTRY_FIELDS; index++)
+  {
+    struct logEntryField field;
+    memcpy_P(&field, &logEntryFields[index], sizeof(field));
+    if(byteNum < (position + field.width))
+    {
+      uint16_t value = readLogField(field);
+      if(field.width == 1) { return lowByte(value); }
+      if(byteNum == position) { return (int16_t)value; }
+      return highByte(value);
+    }
+    position += field.width;
+  }
+  return 0;
+}
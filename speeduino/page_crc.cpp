@@ -5,6 +5,12 @@
 
 static FastCRC32 CRC32;
 
+// The CRC of each page is kept until the page is changed, as TS requests the
+// CRC of every page each time it connects. One bit per page in pageCRCValid
+#define CRC_CACHE_PAGES 16
+static uint32_t pageCRCs[CRC_CACHE_PAGES];
+static uint16_t pageCRCValid = 0;
+
 typedef uint32_t (FastCRC32::*pCrcCalc)(const uint8_t *, const uint16_t, bool);
 
 static inline uint32_t compute_raw_crc(const page_iterator_t &entity, pCrcCalc calcFunc)
@@ -81,6 +87,9 @@ static inline uint32_t compute_crc(page_iterator_t &entity, pCrcCalc calcFunc)
 
 uint32_t calculateCRC32(byte pageNum)
 {
+  bool cached = pageNum < CRC_CACHE_PAGES;
+  if (cached && (pageCRCValid & (1U << pageNum))) { return pageCRCs[pageNum]; }
+
   page_iterator_t entity = page_begin(pageNum);
   // Initial CRC calc
   uint32_t crc = compute_crc(entity, &FastCRC32::crc32);
@@ -91,5 +100,17 @@ uint32_t calculateCRC32(byte pageNum)
     crc = compute_crc(entity, &FastCRC32::crc32_upd /* Note that we are *updating* */);
     entity = advance(entity);
   }
-  return ~pad_crc(getPageSize(pageNum) - entity.size, crc);
-}
\ No newline at end of file
+  crc = ~pad_crc(getPageSize(pageNum) - entity.size, crc);
+
+  if (cached)
+  {
+    pageCRCs[pageNum] = crc;
+    pageCRCValid |= (1U << pageNum);
+  }
+  return crc;
+}
+
+void invalidatePageCRC(byte pageNum)
+{
+  if (pageNum < CRC_CACHE_PAGES) { pageCRCValid &= ~(1U << pageNum); }
+}
@@ -3,5 +3,12 @@
 
 /*
  * Calculates and returns the CRC32 value of a given page of memory
+ * The value is cached, so the page is only read again if it has been marked as changed by invalidatePageCRC()
  */
-uint32_t calculateCRC32(byte pageNum /**< [in] The page number to compute CRC for. */);
\ No newline at end of file
+uint32_t calculateCRC32(byte pageNum /**< [in] The page number to compute CRC for. */);
+
+/*
+ * Marks a page as changed, so that its CRC is recalculated the next time it is requested.
+ * Must be called whenever a page is changed by anything other than setPageValue()/setPageValues(), which call it themselves
+ */
+void invalidatePageCRC(byte pageNum /**< [in] The page number that has changed. */);
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "globals.h"
 #include "utilities.h"
 #include "table_iterator.h"
+#include "page_crc.h"
 
 // This namespace maps from virtual page "addresses" to addresses/bytes of real in memory entities
 //
@@ -253,7 +254,7 @@ static inline byte get_table_value(const table_entity_t &table)
   switch (table.section)
   {
     case Value: 
-      return table.pTable->values[table.yIndex][table.xIndex];
+      return table3D_getRow(table.pTable, table.yIndex)[table.xIndex];
 
     case axisX:
       return (byte)(table.pTable->axisX[table.xIndex] / getTableXAxisFactor(table.pTable)); 
@@ -266,20 +267,22 @@ static inline byte get_table_value(const table_entity_t &table)
   return 0U;
 }
 
-static inline void set_table_value(const table_entity_t &table, int8_t value)
+static inline void set_table_value(const table_entity_t &table, byte value)
 {
   switch (table.section)
   {
     case Value: 
-      table.pTable->values[table.yIndex][table.xIndex] = value;
+      table3D_getRow(table.pTable, table.yIndex)[table.xIndex] = value;
       break;
 
     case axisX:
       table.pTable->axisX[table.xIndex] = (int16_t)(value) * getTableXAxisFactor(table.pTable); 
+      table3D_axisChanged(table.pTable);
       break;
     
     case axisY:
       table.pTable->axisY[table.yIndex]= (int16_t)(value) * getTableYAxisFactor(table.pTable);
+      table3D_axisChanged(table.pTable);
       break;
     
     default: ; // no-op
@@ -309,6 +312,102 @@ static inline page_iterator_t to_page_entity(entity_t mapped)
           .page=mapped.page, .start = mapped.start, .size = mapped.size, .type = mapped.type };
 }
 
+// ============================ Block access support ======================
+
+// A block can start and end part way through a table, so each section of the
+// table is walked with its iterator, skipping elements until offset reaches 0.
+// offset, buffer and length are updated as the block is processed so that the 
+// next section (or entity) carries on from where this one finished.
+//
+// Sections are in TS page order: values (last row first), X axis, Y axis
+
+static inline void read_table_rows(table_row_iterator_t it, uint16_t &offset, byte *&buffer, uint16_t &length)
+{
+  while (!at_end(it) && length>0)
+  {
+    table_row_t row = get_row(it);
+    uint16_t width = row.pEnd-row.pValue;
+    if (offset<width)
+    {
+      uint16_t count = min((uint16_t)(width-offset), length);
+      memcpy(buffer, row.pValue+offset, count);
+      buffer += count;
+      length -= count;
+      offset = 0;
+    }
+    else { offset -= width; }
+    advance_row(it);
+  }
+}
+
+static inline void write_table_rows(table_row_iterator_t it, uint16_t &offset, const byte *&buffer, uint16_t &length)
+{
+  while (!at_end(it) && length>0)
+  {
+    table_row_t row = get_row(it);
+    uint16_t width = row.pEnd-row.pValue;
+    if (offset<width)
+    {
+      uint16_t count = min((uint16_t)(width-offset), length);
+      memcpy(row.pValue+offset, buffer, count);
+      buffer += count;
+      length -= count;
+      offset = 0;
+    }
+    else { offset -= width; }
+    advance_row(it);
+  }
+}
+
+static inline void read_table_axis(table_axis_iterator_t it, uint16_t &offset, byte *&buffer, uint16_t &length)
+{
+  while (!at_end(it) && length>0)
+  {
+    if (offset>0) { --offset; }
+    else
+    {
+      *buffer++ = get_value(it);
+      --length;
+    }
+    advance_axis(it);
+  }
+}
+
+// Returns true if any axis value was written
+static inline bool write_table_axis(table_axis_iterator_t it, uint16_t &offset, const byte *&buffer, uint16_t &length)
+{
+  bool changed = false;
+  while (!at_end(it) && length>0)
+  {
+    if (offset>0) { --offset; }
+    else
+    {
+      set_value(it, *buffer++);
+      --length;
+      changed = true;
+    }
+    advance_axis(it);
+  }
+  return changed;
+}
+
+static void read_table(const table3D *pTable, uint16_t offset, byte *buffer, uint16_t length)
+{
+  read_table_rows(rows_begin(pTable), offset, buffer, length);
+  read_table_axis(x_begin(pTable), offset, buffer, length);
+  read_table_axis(y_begin(pTable), offset, buffer, length);
+}
+
+static void write_table(table3D *pTable, uint16_t offset, const byte *buffer, uint16_t length)
+{
+  write_table_rows(rows_begin(pTable), offset, buffer, length);
+  bool axisChanged = write_table_axis(x_begin(pTable), offset, buffer, length);
+  axisChanged = write_table_axis(y_begin(pTable), offset, buffer, length) || axisChanged;
+  
+  if (axisChanged) { table3D_axisChanged(pTable); }
+  pTable->cacheIsValid = false; //Invalid the tables cache to ensure a lookup of new values
+}
+
 // ====================================== External functions  ====================================
 
 uint8_t getPageCount()
@@ -323,6 +422,8 @@ uint16_t getPageSize(byte pageNum)
 
 void setPageValue(byte pageNum, uint16_t offset, byte value)
 {
+  invalidatePageCRC(pageNum);
+
   entity_t entity = map_page_offset_to_entity_inline(pageNum, offset);
 
   switch (entity.type)
@@ -369,4 +470,64 @@ page_iterator_t page_begin(byte pageNum)
 page_iterator_t advance(const page_iterator_t &it)
 {
     return to_page_entity(map_page_offset_to_entity(it.page, it.start+it.size));
-}
\ No newline at end of file
+}
+
+void getPageValues(byte pageNum, uint16_t offset, byte *buffer, uint16_t length)
+{
+  page_iterator_t entity = to_page_entity(map_page_offset_to_entity(pageNum, offset));
+
+  while (entity.type!=End && length>0)
+  {
+    uint16_t entityOffset = offset-entity.start;
+    uint16_t count = min((uint16_t)(entity.size-entityOffset), length);
+    switch (entity.type)
+    {
+      case Table:
+        read_table(entity.pTable, entityOffset, buffer, count);
+        break;
+
+      case Raw:
+        memcpy(buffer, (byte*)entity.pData + entityOffset, count);
+        break;
+
+      default:
+        memset(buffer, 0, count);
+        break;
+    }
+    buffer += count;
+    offset += count;
+    length -= count;
+    entity = advance(entity);
+  }
+  memset(buffer, 0, length);
+}
+
+void setPageValues(byte pageNum, uint16_t offset, const byte *buffer, uint16_t length)
+{
+  invalidatePageCRC(pageNum);
+
+  page_iterator_t entity = to_page_entity(map_page_offset_to_entity(pageNum, offset));
+
+  while (entity.type!=End && length>0)
+  {
+    uint16_t entityOffset = offset-entity.start;
+    uint16_t count = min((uint16_t)(entity.size-entityOffset), length);
+    switch (entity.type)
+    {
+      case Table:
+        write_table(entity.pTable, entityOffset, buffer, count);
+        break;
+
+      case Raw:
+        memcpy((byte*)entity.pData + entityOffset, buffer, count);
+        break;
+
+      default:
+        break;
+    }
+    buffer += count;
+    offset += count;
+    length -= count;
+    entity = advance(entity);
+  }
+}
@@ -43,6 +43,26 @@ void setPageValue(  byte pageNum,       /**< [in] The page number to retrieve da
                     uint16_t offset,    /**< [in] The address in the page that should be returned. This is as per the page definition in the ini. */
                     byte value);        /**< [in] The new value */
 
+// ============================== Block page access ==========================
+
+/**
+ * Gets a block of values from a page, with data aligned as per the ini file.
+ * This is the same as calling getPageValue() for each byte, but each entity on the page is only looked up once.
+ */
+void getPageValues( byte pageNum,       /**< [in] The page number to retrieve data from. */
+                    uint16_t offset,    /**< [in] The address in the page of the first value. This is as per the page definition in the ini. */
+                    byte *buffer,       /**< [out] Receives the values. Bytes past the end of the page are set to 0 */
+                    uint16_t length);   /**< [in] The number of values */
+
+/**
+ * Sets a block of values on a page, with data aligned as per the ini file.
+ * This is the same as calling setPageValue() for each byte, but each entity on the page is only looked up once.
+ */
+void setPageValues( byte pageNum,       /**< [in] The page number to set data on. */
+                    uint16_t offset,    /**< [in] The address in the page of the first value. This is as per the page definition in the ini. */
+                    const byte *buffer, /**< [in] The new values */
+                    uint16_t length);   /**< [in] The number of values */
+
 // ============================== Page Iteration ==========================
 
 // A logical TS page is actually multiple in memory entities. Allow iteration
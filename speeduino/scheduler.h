@@ -46,23 +46,6 @@ See page 136 of the processors datasheet: http://www.atmel.com/Images/doc2549.pd
 #define USE_IGN_REFRESH
 #define IGNITION_REFRESH_THRESHOLD  30 //Time in uS that the refresh functions will check to ensure there is enough time before changing the end compare
 
-extern void (*inj1StartFunction)();
-extern void (*inj1EndFunction)();
-extern void (*inj2StartFunction)();
-extern void (*inj2EndFunction)();
-extern void (*inj3StartFunction)();
-extern void (*inj3EndFunction)();
-extern void (*inj4StartFunction)();
-extern void (*inj4EndFunction)();
-extern void (*inj5StartFunction)();
-extern void (*inj5EndFunction)();
-extern void (*inj6StartFunction)();
-extern void (*inj6EndFunction)();
-extern void (*inj7StartFunction)();
-extern void (*inj7EndFunction)();
-extern void (*inj8StartFunction)();
-extern void (*inj8EndFunction)();
-
 /** @name IgnitionCallbacks
  * These are the (global) function pointers that get called to begin and end the ignition coil charging.
  * They are required for the various spark output modes.
@@ -86,71 +69,6 @@ extern void (*ign8StartFunction)();
 extern void (*ign8EndFunction)();
 /** @} */
 
-void initialiseSchedulers();
-void beginInjectorPriming();
-void setFuelSchedule1(unsigned long timeout, unsigned long duration);
-void setFuelSchedule2(unsigned long timeout, unsigned long duration);
-void setFuelSchedule3(unsigned long timeout, unsigned long duration);
-void setFuelSchedule4(unsigned long timeout, unsigned long duration);
-//void setFuelSchedule5(void (*startCallback)(), unsigned long timeout, unsigned long duration, void(*endCallback)()); //Schedule 5 remains a special case for now due to the way it's implemented 
-void setFuelSchedule5(unsigned long timeout, unsigned long duration);
-void setFuelSchedule6(unsigned long timeout, unsigned long duration);
-void setFuelSchedule7(unsigned long timeout, unsigned long duration);
-void setFuelSchedule8(unsigned long timeout, unsigned long duration);
-void setIgnitionSchedule1(void (*startCallback)(), unsigned long timeout, unsigned long duration, void(*endCallback)());
-void setIgnitionSchedule2(void (*startCallback)(), unsigned long timeout, unsigned long duration, void(*endCallback)());
-void setIgnitionSchedule3(void (*startCallback)(), unsigned long timeout, unsigned long duration, void(*endCallback)());
-void setIgnitionSchedule4(void (*startCallback)(), unsigned long timeout, unsigned long duration, void(*endCallback)());
-void setIgnitionSchedule5(void (*startCallback)(), unsigned long timeout, unsigned long duration, void(*endCallback)());
-void setIgnitionSchedule6(void (*startCallback)(), unsigned long timeout, unsigned long duration, void(*endCallback)());
-void setIgnitionSchedule7(void (*startCallback)(), unsigned long timeout, unsigned long duration, void(*endCallback)());
-void setIgnitionSchedule8(void (*startCallback)(), unsigned long timeout, unsigned long duration, void(*endCallback)());
-
-inline void refreshIgnitionSchedule1(unsigned long timeToEnd) __attribute__((always_inline));
-
-//The ARM cores use seprate functions for their ISRs
-#if defined(ARDUINO_ARCH_STM32) || defined(CORE_TEENSY)
-  static inline void fuelSchedule1Interrupt();
-  static inline void fuelSchedule2Interrupt();
-  static inline void fuelSchedule3Interrupt();
-  static inline void fuelSchedule4Interrupt();
-#if (INJ_CHANNELS >= 5)
-  static inline void fuelSchedule5Interrupt();
-#endif
-#if (INJ_CHANNELS >= 6)
-  static inline void fuelSchedule6Interrupt();
-#endif
-#if (INJ_CHANNELS >= 7)
-  static inline void fuelSchedule7Interrupt();
-#endif
-#if (INJ_CHANNELS >= 8)
-  static inline void fuelSchedule8Interrupt();
-#endif
-#if (IGN_CHANNELS >= 1)
-  static inline void ignitionSchedule1Interrupt();
-#endif
-#if (IGN_CHANNELS >= 2)
-  static inline void ignitionSchedule2Interrupt();
-#endif
-#if (IGN_CHANNELS >= 3)
-  static inline void ignitionSchedule3Interrupt();
-#endif
-#if (IGN_CHANNELS >= 4)
-  static inline void ignitionSchedule4Interrupt();
-#endif
-#if (IGN_CHANNELS >= 5)
-  static inline void ignitionSchedule5Interrupt();
-#endif
-#if (IGN_CHANNELS >= 6)
-  static inline void ignitionSchedule6Interrupt();
-#endif
-#if (IGN_CHANNELS >= 7)
-  static inline void ignitionSchedule7Interrupt();
-#endif
-#if (IGN_CHANNELS >= 8)
-  static inline void ignitionSchedule8Interrupt();
-#endif
-#endif
 /** Schedule statuses.
  * - OFF - Schedule turned off and there is no scheduled plan
  * - PENDING - There's a scheduled plan, but is has not started to run yet
@@ -158,6 +76,63 @@ inline void refreshIgnitionSchedule1(unsigned long timeToEnd) __attribute__((alw
  * - RUNNING - Schedule is currently running
  */
 enum ScheduleStatus {OFF, PENDING, STAGED, RUNNING}; //The statuses that a schedule can have
+
+/** The timer compare unit that a schedule runs on.
+ * Each fuel and ignition channel has a class (fuelTimer<1>, ignitionTimer<1> etc, see SCHEDULE_TIMER() in scheduler.ino) built from the boards FUELn_* / IGNn_* macros, with these static functions:
+ * - COUNTER_TYPE counter() - Returns the current value of the timers counter
+ * - void setCompare(COMPARE_TYPE value) - Sets the compare register. The timers interrupt fires when the counter reaches this
+ * - void enable() - Turns on the compare interrupt
+ * - void disable() - Turns off the compare interrupt
+ *
+ * The schedule functions below are templates on this class, so the timer is resolved at compile time and each channels interrupt reads and writes its registers directly.
+ * This is the only part of a schedule that differs between channels.
+ */
+
+/** Number of events that can be queued on each schedule, in addition to the one in progress. Must be a power of 2.
+ * Each queued event is 2 compare values, so this is kept small on the AVR to save RAM.
+ */
+#if defined(CORE_AVR)
+  #define SCHEDULE_QUEUE_SIZE 2
+#else
+  #define SCHEDULE_QUEUE_SIZE 4
+#endif
+#define SCHEDULE_QUEUE_MASK (SCHEDULE_QUEUE_SIZE - 1)
+
+/** A queued schedule event, as the timer compare values it will start and end at.
+ * sequence identifies which pulse on the channel the event is. Setting the same pulse again keeps its sequence and replaces the event, the next pulse gets the next sequence (See scheduleQueuePush()).
+ */
+struct scheduleEvent {
+  COMPARE_TYPE startCompare;
+  COMPARE_TYPE endCompare;
+  uint8_t sequence;
+};
+
+/** The events waiting to run on a schedule once the current one has finished.
+ * This is a ring with a single producer (The main loop, via setFuelSchedule()/setIgnitionSchedule()) and a single consumer (The schedules ISR).
+ * Only the loop writes tail and only the ISR writes head, so neither needs interrupts to be disabled to add or take an event (See scheduleQueuePush() / scheduleQueuePop()).
+ * Both are free running and are masked with SCHEDULE_QUEUE_MASK when used as an index.
+ */
+struct scheduleQueue {
+  struct scheduleEvent events[SCHEDULE_QUEUE_SIZE];
+  volatile uint8_t head; ///< The next event for the ISR to take
+  volatile uint8_t tail; ///< Where the loop will add the next event
+};
+
+#define ANGLE_SCHEDULE_NONE         -1 ///< startAngle value when the schedule is not being re-targeted by angle
+#define ANGLE_SCHEDULE_MIN_TIMEOUT  16 ///< Shortest timeout (uS) that adjustAngleSchedules() will set, so that the compare is never set to a counter value that has already passed
+
+/** How late each schedule interrupt ran, compared to the time it was set for.
+ * Bin 0 counts interrupts that were on time, bin 1 those 1 timer tick late, then 2-3 ticks, 4-7 ticks etc. The last bin holds everything later than that.
+ * Start and end interrupts are counted together. The counts stop at 65535 (See getScheduleAccuracy() to read and reset them).
+ * The histograms are only kept when SCHEDULE_ACCURACY is defined (Add -DSCHEDULE_ACCURACY to build_flags). They cost 18 bytes of RAM per schedule on the AVR (288 bytes for all 16)
+ * and 2 more counter reads in every schedule interrupt, so they are left out of normal builds.
+ */
+#define SCHEDULE_ACCURACY_BINS 8
+struct scheduleAccuracy {
+  uint16_t lateCount[SCHEDULE_ACCURACY_BINS];
+  COMPARE_TYPE maxLate; ///< The latest interrupt, in timer ticks
+};
+
 /** Ignition schedule.
  */
 struct Schedule {
@@ -169,121 +144,364 @@ struct Schedule {
   volatile unsigned long startTime; /**< The system time (in uS) that the schedule started, used by the overdwell protection in timers.ino */
   volatile COMPARE_TYPE startCompare; ///< The counter value of the timer when this will start
   volatile COMPARE_TYPE endCompare;   ///< The counter value of the timer when this will end
+  volatile int16_t startAngle;        ///< The crank angle this is due to start at, or ANGLE_SCHEDULE_NONE (See setIgnitionScheduleAngle())
 
-  unsigned int nextStartCompare;      ///< Planned start of next schedule (when current schedule is RUNNING)
-  unsigned int nextEndCompare;        ///< Planned end of next schedule (when current schedule is RUNNING)
-  volatile bool hasNextSchedule = false; ///< Enable flag for planned next schedule (when current schedule is RUNNING)
+  struct scheduleQueue queue;         ///< Planned schedules to run after the current one (when current schedule is RUNNING)
+#if defined(SCHEDULE_ACCURACY)
+  struct scheduleAccuracy accuracy;   ///< Timing of the interrupts on this schedule
+#endif
   volatile bool endScheduleSetByDecoder = false;
 };
 /** Fuel injection schedule.
-* Fuel schedules don't use the callback pointers, or the startTime/endScheduleSetByDecoder variables.
+* Fuel schedules don't use the startTime/endScheduleSetByDecoder variables.
 * They are removed in this struct to save RAM.
+* The callbacks are set once at startup (See initialiseAll()) rather than each time the schedule is set.
 */
 struct FuelSchedule {
   volatile unsigned long duration;///< Scheduled duration (uS ?)
   volatile ScheduleStatus Status; ///< Schedule status: OFF, PENDING, STAGED, RUNNING
   volatile byte schedulesSet; ///< A counter of how many times the schedule has been set
+  void (*StartCallback)();    ///< Opens the injector(s) for this channel
+  void (*EndCallback)();      ///< Closes the injector(s) for this channel
   volatile COMPARE_TYPE startCompare; ///< The counter value of the timer when this will start
   volatile COMPARE_TYPE endCompare;   ///< The counter value of the timer when this will end
+  volatile int16_t startAngle;        ///< The crank angle this is due to start at, or ANGLE_SCHEDULE_NONE (See setFuelScheduleAngle())
 
-  unsigned int nextStartCompare;
-  unsigned int nextEndCompare;
-  volatile bool hasNextSchedule = false;
+  struct scheduleQueue queue;         ///< Planned schedules to run after the current one (when current schedule is RUNNING)
+#if defined(SCHEDULE_ACCURACY)
+  struct scheduleAccuracy accuracy;   ///< Timing of the interrupts on this schedule
+#endif
 };
 
-//volatile Schedule *timer3Aqueue[4];
-//Schedule *timer3Bqueue[4];
-//Schedule *timer3Cqueue[4];
-
-extern FuelSchedule fuelSchedule1;
-extern FuelSchedule fuelSchedule2;
-extern FuelSchedule fuelSchedule3;
-extern FuelSchedule fuelSchedule4;
-extern FuelSchedule fuelSchedule5;
-extern FuelSchedule fuelSchedule6;
-extern FuelSchedule fuelSchedule7;
-extern FuelSchedule fuelSchedule8;
-
-extern Schedule ignitionSchedule1;
-extern Schedule ignitionSchedule2;
-extern Schedule ignitionSchedule3;
-extern Schedule ignitionSchedule4;
-extern Schedule ignitionSchedule5;
-extern Schedule ignitionSchedule6;
-extern Schedule ignitionSchedule7;
-extern Schedule ignitionSchedule8;
-
-//IgnitionSchedule nullSchedule; //This is placed at the end of the queue. It's status will always be set to OFF and hence will never perform any action within an ISR
-
-static inline unsigned int setQueue(volatile Schedule *queue[], Schedule *schedule1, Schedule *schedule2, unsigned int CNT)
-{
-  //Create an array of all the upcoming targets, relative to the current count on the timer
-  unsigned int tmpQueue[4];
+/** Expands M(n) for each channel n from 1 to count. count must be a plain number, as INJ_CHANNELS and IGN_CHANNELS are.
+ * Everything that is per channel (The timer classes, setFuelSchedulen() / setIgnitionSchedulen() and the interrupts) is generated from INJ_CHANNELS / IGN_CHANNELS with this
+ */
+#define SCHEDULE_CHANNELS_1(M) M(1)
+#define SCHEDULE_CHANNELS_2(M) SCHEDULE_CHANNELS_1(M) M(2)
+#define SCHEDULE_CHANNELS_3(M) SCHEDULE_CHANNELS_2(M) M(3)
+#define SCHEDULE_CHANNELS_4(M) SCHEDULE_CHANNELS_3(M) M(4)
+#define SCHEDULE_CHANNELS_5(M) SCHEDULE_CHANNELS_4(M) M(5)
+#define SCHEDULE_CHANNELS_6(M) SCHEDULE_CHANNELS_5(M) M(6)
+#define SCHEDULE_CHANNELS_7(M) SCHEDULE_CHANNELS_6(M) M(7)
+#define SCHEDULE_CHANNELS_8(M) SCHEDULE_CHANNELS_7(M) M(8)
+#define SCHEDULE_CHANNELS_EXPAND(count, M) SCHEDULE_CHANNELS_##count(M)
+#define SCHEDULE_CHANNELS(count, M) SCHEDULE_CHANNELS_EXPAND(count, M)
+
+/** The schedule of each channel, channel n is at [n-1]. Only the channels that the board has exist */
+extern FuelSchedule fuelSchedules[INJ_CHANNELS];
+extern Schedule ignitionSchedules[IGN_CHANNELS];
+
+//Each channels schedule by name
+#define fuelSchedule1 (fuelSchedules[0])
+#define fuelSchedule2 (fuelSchedules[1])
+#define fuelSchedule3 (fuelSchedules[2])
+#define fuelSchedule4 (fuelSchedules[3])
+#if (INJ_CHANNELS >= 5)
+#define fuelSchedule5 (fuelSchedules[4])
+#endif
+#if (INJ_CHANNELS >= 6)
+#define fuelSchedule6 (fuelSchedules[5])
+#endif
+#if (INJ_CHANNELS >= 7)
+#define fuelSchedule7 (fuelSchedules[6])
+#endif
+#if (INJ_CHANNELS >= 8)
+#define fuelSchedule8 (fuelSchedules[7])
+#endif
 
-  //Set the initial queue state. This order matches the tmpQueue order
-  if(schedule1->Status == OFF)
-  {
-    queue[0] = schedule2;
-    queue[1] = schedule2;
-    tmpQueue[0] = schedule2->startCompare - CNT;
-    tmpQueue[1] = schedule2->endCompare - CNT;
-  }
-  else
-  {
-    queue[0] = schedule1;
-    queue[1] = schedule1;
-    tmpQueue[0] = schedule1->startCompare - CNT;
-    tmpQueue[1] = schedule1->endCompare - CNT;
-  }
+#define ignitionSchedule1 (ignitionSchedules[0])
+#define ignitionSchedule2 (ignitionSchedules[1])
+#define ignitionSchedule3 (ignitionSchedules[2])
+#define ignitionSchedule4 (ignitionSchedules[3])
+#if (IGN_CHANNELS >= 5)
+#define ignitionSchedule5 (ignitionSchedules[4])
+#endif
+#if (IGN_CHANNELS >= 6)
+#define ignitionSchedule6 (ignitionSchedules[5])
+#endif
+#if (IGN_CHANNELS >= 7)
+#define ignitionSchedule7 (ignitionSchedules[6])
+#endif
+#if (IGN_CHANNELS >= 8)
+#define ignitionSchedule8 (ignitionSchedules[7])
+#endif
 
-  if(schedule2->Status == OFF)
-  {
-    queue[2] = schedule1;
-    queue[3] = schedule1;
-    tmpQueue[2] = schedule1->startCompare - CNT;
-    tmpQueue[3] = schedule1->endCompare - CNT;
-  }
-  else
+void initialiseSchedulers();
+void beginInjectorPriming();
+void setFuelScheduleAngle(uint8_t channel, int16_t startAngle);
+void setIgnitionScheduleAngle(uint8_t channel, int16_t startAngle);
+void adjustAngleSchedules(int16_t crankAngle, uint16_t toothGap);
+extern volatile uint16_t angleSchedulesPending; ///< The channels that have a start angle for adjustAngleSchedules() to track. Fuel 1-8 are bits 0-7, ignition 1-8 are bits 8-15
+bool getScheduleAccuracy(uint8_t channel, struct scheduleAccuracy &accuracy, bool reset);
+
+#define SET_FUEL_SCHEDULE_PROTOTYPE(n) void setFuelSchedule##n(unsigned long timeout, unsigned long duration);
+#define SET_IGNITION_SCHEDULE_PROTOTYPE(n) void setIgnitionSchedule##n(void (*startCallback)(), unsigned long timeout, unsigned long duration, void(*endCallback)());
+SCHEDULE_CHANNELS(INJ_CHANNELS, SET_FUEL_SCHEDULE_PROTOTYPE)
+SCHEDULE_CHANNELS(IGN_CHANNELS, SET_IGNITION_SCHEDULE_PROTOTYPE)
+
+inline void refreshIgnitionSchedule1(unsigned long timeToEnd) __attribute__((always_inline));
+
+//The ARM cores (And the native host build) use seprate functions for their ISRs. These are called from the board files, so are not static
+#if defined(ARDUINO_ARCH_STM32) || defined(CORE_TEENSY) || defined(CORE_NATIVE)
+  #define FUEL_INTERRUPT_PROTOTYPE(n) void fuelSchedule##n##Interrupt();
+  #define IGNITION_INTERRUPT_PROTOTYPE(n) void ignitionSchedule##n##Interrupt();
+  SCHEDULE_CHANNELS(INJ_CHANNELS, FUEL_INTERRUPT_PROTOTYPE)
+  SCHEDULE_CHANNELS(IGN_CHANNELS, IGNITION_INTERRUPT_PROTOTYPE)
+#endif
+
+/*
+ * Adds an event to the end of a schedules queue. Called from the main loop only.
+ * runningStart is the start compare of the event that is RUNNING on the schedule.
+ * The loop sets the schedule on every pass rather than once per event, so the new event is either the last queued pulse again (With a start that has moved
+ * as the RPM or angle changed) or the pulse after it. Pulses on a channel are evenly spaced, so the new event is the same pulse (And keeps its sequence) unless it
+ * starts at least half of the spacing between the last queued pulse and the one before it later than the last queued pulse.
+ * The same pulse replaces the queued event, even if it now starts after the queued event would have ended. Only the next pulse is added.
+ * Returns false if the queue is full.
+ */
+static inline bool scheduleQueuePush(struct scheduleQueue &queue, COUNTER_TYPE counter, COMPARE_TYPE runningStart, COMPARE_TYPE startCompare, COMPARE_TYPE endCompare)
+{
+  uint8_t tail = queue.tail;
+  uint8_t sequence = 0;
+  if(tail != queue.head)
   {
-    queue[2] = schedule2;
-    queue[3] = schedule2;
-    tmpQueue[2] = schedule2->startCompare - CNT;
-    tmpQueue[3] = schedule2->endCompare - CNT;
+    struct scheduleEvent &lastEvent = queue.events[(uint8_t)(tail - 1U) & SCHEDULE_QUEUE_MASK];
+    COMPARE_TYPE previousStart = runningStart;
+    if( (uint8_t)(tail - queue.head) >= 2U ) { previousStart = queue.events[(uint8_t)(tail - 2U) & SCHEDULE_QUEUE_MASK].startCompare; }
+    unsigned long halfSpacing = (COMPARE_TYPE)(lastEvent.startCompare - previousStart) / 2U;
+
+    if( (COMPARE_TYPE)(startCompare - counter) < ((COMPARE_TYPE)(lastEvent.startCompare - counter) + halfSpacing) )
+    {
+      //The same pulse. The ISR may be taking this event right now, so it can only be changed with interrupts off
+      noInterrupts();
+      if(tail != queue.head)
+      {
+        lastEvent.startCompare = startCompare;
+        lastEvent.endCompare = endCompare;
+      }
+      interrupts();
+      //If the ISR has already taken it, this pulse is PENDING at the time it was queued for and must not be added again
+      return true;
+    }
+    sequence = lastEvent.sequence + 1U;
   }
 
+  if( (uint8_t)(tail - queue.head) >= SCHEDULE_QUEUE_SIZE ) { return false; } //Full
+  queue.events[tail & SCHEDULE_QUEUE_MASK].startCompare = startCompare;
+  queue.events[tail & SCHEDULE_QUEUE_MASK].endCompare = endCompare;
+  queue.events[tail & SCHEDULE_QUEUE_MASK].sequence = sequence;
+  queue.tail = tail + 1U; //The event is only visible to the ISR once this (Single byte) write is done
+  return true;
+}
 
-  //Sort the queues. Both queues are kept in sync.
-  //This implementes a sorting networking based on the Bose-Nelson sorting network
-  //See: pages.ripco.net/~jgamble/nw.html
-  #define SWAP(x,y) if(tmpQueue[y] < tmpQueue[x]) { unsigned int tmp = tmpQueue[x]; tmpQueue[x] = tmpQueue[y]; tmpQueue[y] = tmp; volatile Schedule *tmpS = queue[x]; queue[x] = queue[y]; queue[y] = tmpS; }
-  /*SWAP(0, 1); */ //Likely not needed
-  /*SWAP(2, 3); */ //Likely not needed
-  SWAP(0, 2);
-  SWAP(1, 3);
-  SWAP(1, 2);
+/*
+ * Takes the next event from a schedules queue. Called from the schedules ISR only.
+ * Returns false if there are no events waiting.
+ */
+static inline bool scheduleQueuePop(struct scheduleQueue &queue, struct scheduleEvent &event)
+{
+  uint8_t head = queue.head;
+  if(head == queue.tail) { return false; }
+  event = queue.events[head & SCHEDULE_QUEUE_MASK];
+  queue.head = head + 1U;
+  return true;
+}
 
-  //Return the next compare time in the queue
-  return tmpQueue[0] + CNT; //Return the
+/*
+ * Throws away any queued events. Interrupts must be off, as this writes head, which is otherwise only written by the ISR
+ */
+static inline void scheduleQueueClear(struct scheduleQueue &queue)
+{
+  queue.head = queue.tail;
 }
 
+#if defined(SCHEDULE_ACCURACY)
 /*
- * Moves all the Schedules in a queue forward one position.
- * The current item (0) is discarded
- * The final queue slot is set to nullSchedule to indicate that no action should be taken
+ * Adds one interrupt to a schedules accuracy histogram. late is the number of timer ticks between the compare value and when the interrupt actually ran.
  */
-static inline unsigned int popQueue(volatile Schedule *queue[])
+#define SCHEDULE_ACCURACY_ADD(schedule, compare) scheduleAccuracyAdd((schedule).accuracy, TTimer::counter() - (compare))
+static inline void scheduleAccuracyAdd(struct scheduleAccuracy &accuracy, COMPARE_TYPE late)
+{
+  if(late > accuracy.maxLate) { accuracy.maxLate = late; }
+  uint8_t bin = 0;
+  while( (late > 0) && (bin < (SCHEDULE_ACCURACY_BINS - 1)) )
+  {
+    late >>= 1;
+    bin++;
+  }
+  if(accuracy.lateCount[bin] < UINT16_MAX) { accuracy.lateCount[bin]++; }
+}
+#else
+#define SCHEDULE_ACCURACY_ADD(schedule, compare)
+#endif
+
+/*
+These functions turn a schedule on, provides the time to start and the duration and gives it callback functions.
+They are the same for every channel, setFuelSchedule1() etc (In scheduler.ino) pass in the channels schedule and timer (See SCHEDULE_TIMER())
+Args:
+startCallback: The function to be called once the timeout is reached
+timeout: The number of uS in the future that the startCallback should be triggered
+duration: The number of uS after startCallback is called before endCallback is called
+endCallback: This function is called once the duration time has been reached
+If the schedule is already RUNNING, the new one is added to the schedules queue (See scheduleQueuePush()) and is started by the ISR once the current one ends.
+*/
+template <typename TTimer>
+void setFuelSchedule(struct FuelSchedule &schedule, unsigned long timeout, unsigned long duration)
 {
-  queue[0] = queue[1];
-  queue[1] = queue[2];
-  queue[2] = queue[3];
-  //queue[3] = &nullSchedule;
+  //Check whether timeout exceeds the maximum future time. This can potentially occur on sequential setups when below ~115rpm
+  //The end of the pulse must also fit, otherwise the end compare will overflow
+  if((timeout+duration) < MAX_TIMER_PERIOD)
+  {
+    if(schedule.Status != RUNNING) //Check that we're not already part way through a schedule
+    {
+      schedule.duration = duration;
+      //The following must be enclosed in the noInterupts block to avoid contention caused if the relevant interrupt fires before the state is fully set
+      noInterrupts();
+      if(schedule.Status == OFF) { scheduleQueueClear(schedule.queue); } //Anything left in the queue was set before the schedule was turned off and is stale
+      schedule.startCompare = TTimer::counter() + uS_TO_TIMER_COMPARE(timeout);
+      schedule.endCompare = schedule.startCompare + uS_TO_TIMER_COMPARE(duration);
+      schedule.startAngle = ANGLE_SCHEDULE_NONE;
+      TTimer::setCompare(schedule.startCompare);
+      schedule.Status = PENDING; //Turn this schedule on
+      schedule.schedulesSet++; //Increment the number of times this schedule has been set
+      interrupts();
+      TTimer::enable();
+    }
+    else
+    {
+      //If the schedule is already running, we can queue the next schedule so it is ready to go
+      //This is required in cases of high rpm and high DC where there otherwise would not be enough time to set the schedule
+      COUNTER_TYPE counter = TTimer::counter();
+      COMPARE_TYPE startCompare = counter + uS_TO_TIMER_COMPARE(timeout);
+      scheduleQueuePush(schedule.queue, counter, schedule.startCompare, startCompare, startCompare + uS_TO_TIMER_COMPARE(duration));
+    } //Schedule is RUNNING
+  } //Timeout less than threshold
+}
 
-  unsigned int returnCompare;
-  if( queue[0]->Status == PENDING ) { returnCompare = queue[0]->startCompare; }
-  else { returnCompare = queue[0]->endCompare; }
+template <typename TTimer>
+void setIgnitionSchedule(struct Schedule &schedule, void (*startCallback)(), unsigned long timeout, unsigned long duration, void(*endCallback)())
+{
+  if(schedule.Status != RUNNING) //Check that we're not already part way through a schedule
+  {
+    schedule.StartCallback = startCallback; //Name the start callback function
+    schedule.EndCallback = endCallback; //Name the start callback function
+    schedule.duration = duration;
+
+    //Need to check that the timeout doesn't exceed the overflow
+    uint16_t timeout_timer_compare;
+    if (timeout > MAX_TIMER_PERIOD) { timeout_timer_compare = uS_TO_TIMER_COMPARE( (MAX_TIMER_PERIOD - 1) ); } // If the timeout is >4x (Each tick represents 4uS) the maximum allowed value of unsigned int (65535), the timer compare value will overflow when appliedcausing erratic behaviour such as erroneous sparking.
+    else { timeout_timer_compare = uS_TO_TIMER_COMPARE(timeout); } //Normal case
+
+    noInterrupts();
+    if(schedule.Status == OFF) { scheduleQueueClear(schedule.queue); } //Anything left in the queue was set before the schedule was turned off and is stale
+    schedule.startCompare = TTimer::counter() + timeout_timer_compare;
+    if(schedule.endScheduleSetByDecoder == false) { schedule.endCompare = schedule.startCompare + uS_TO_TIMER_COMPARE(duration); } //The .endCompare value is also set by the per tooth timing in decoders.ino. The check here is so that it's not getting overridden. 
+    schedule.startAngle = ANGLE_SCHEDULE_NONE;
+    TTimer::setCompare(schedule.startCompare);
+    schedule.Status = PENDING; //Turn this schedule on
+    schedule.schedulesSet++;
+    interrupts();
+    TTimer::enable();
+  }
+  else
+  {
+    //If the schedule is already running, we can queue the next schedule so it is ready to go
+    //This is required in cases of high rpm and high DC where there otherwise would not be enough time to set the schedule
+    if (timeout < MAX_TIMER_PERIOD)
+    {
+      COUNTER_TYPE counter = TTimer::counter();
+      COMPARE_TYPE startCompare = counter + uS_TO_TIMER_COMPARE(timeout);
+      scheduleQueuePush(schedule.queue, counter, schedule.startCompare, startCompare, startCompare + uS_TO_TIMER_COMPARE(duration));
+    }
+  }
+}
 
-  return returnCompare;
+/*******************************************************************************************************************************************************************************************************/
+/** fuelScheduleISR() and ignitionScheduleISR() get called (as timed interrupts) when either the start time or the duration time are reached.
+* This calls the relevant callback function (startCallback or endCallback) depending on the status (PENDING => Needs to run, RUNNING => Needs to stop) of the schedule.
+* The status of schedule is managed here based on startCallback /endCallback function called:
+* - startCallback - change scheduler into RUNNING state
+* - endCallback - change scheduler into OFF state (or PENDING if there is another schedule in the queue)
+* Every channel runs through these same 2 functions. The interrupt vector for each channel (In scheduler.ino) passes in its schedule and timer, and the function is inlined into it.
+* When SCHEDULE_ACCURACY is defined, how late each interrupt ran is added to the schedules accuracy histogram. So that this can be measured, endCompare is always the compare value of the end interrupt once RUNNING.
+*/
+template <typename TTimer>
+inline void fuelScheduleISR(struct FuelSchedule &schedule) __attribute__((always_inline));
+template <typename TTimer>
+inline void fuelScheduleISR(struct FuelSchedule &schedule)
+{
+  if (schedule.Status == PENDING) //Check to see if this schedule is turn on
+  {
+    SCHEDULE_ACCURACY_ADD(schedule, schedule.startCompare);
+    schedule.StartCallback();
+    schedule.Status = RUNNING; //Set the status to be in progress (ie The start callback has been called, but not the end callback)
+    schedule.endCompare = TTimer::counter() + (COMPARE_TYPE)(schedule.endCompare - schedule.startCompare); //Doing this here prevents a potential overflow on restarts
+    TTimer::setCompare(schedule.endCompare);
+  }
+  else if (schedule.Status == RUNNING)
+  {
+    SCHEDULE_ACCURACY_ADD(schedule, schedule.endCompare);
+    schedule.EndCallback();
+    schedule.Status = OFF; //Turn off the schedule
+    schedule.schedulesSet = 0;
+
+    //If there is a next schedule queued up, activate it
+    struct scheduleEvent nextEvent;
+    if(scheduleQueuePop(schedule.queue, nextEvent) == true)
+    {
+      schedule.startCompare = nextEvent.startCompare;
+      schedule.endCompare = nextEvent.endCompare;
+      schedule.startAngle = ANGLE_SCHEDULE_NONE;
+      TTimer::setCompare(schedule.startCompare);
+      schedule.Status = PENDING;
+      schedule.schedulesSet = 1;
+    }
+    else { TTimer::disable(); }
+  }
+  else if (schedule.Status == OFF) { TTimer::disable(); } //Safety check. Turn off this output compare unit and return without performing any action
 }
 
+template <typename TTimer>
+inline void ignitionScheduleISR(struct Schedule &schedule) __attribute__((always_inline));
+template <typename TTimer>
+inline void ignitionScheduleISR(struct Schedule &schedule)
+{
+  if (schedule.Status == PENDING) //Check to see if this schedule is turn on
+  {
+    SCHEDULE_ACCURACY_ADD(schedule, schedule.startCompare);
+    schedule.StartCallback();
+    schedule.Status = RUNNING; //Set the status to be in progress (ie The start callback has been called, but not the end callback)
+    schedule.startTime = micros();
+    //If the decoder has set the end compare value, it is used as is. Otherwise the end is set from now, which prevents a potential overflow that can occur at low RPMs
+    if(schedule.endScheduleSetByDecoder == false) { schedule.endCompare = TTimer::counter() + (COMPARE_TYPE)(schedule.endCompare - schedule.startCompare); }
+    TTimer::setCompare(schedule.endCompare);
+  }
+  else if (schedule.Status == RUNNING)
+  {
+    SCHEDULE_ACCURACY_ADD(schedule, schedule.endCompare);
+    schedule.Status = OFF; //Turn off the schedule
+    schedule.EndCallback();
+    schedule.schedulesSet = 0;
+    schedule.endScheduleSetByDecoder = false;
+    ignitionCount += 1; //Increment the igintion counter
+
+    //If there is a next schedule queued up, activate it
+    struct scheduleEvent nextEvent;
+    if(scheduleQueuePop(schedule.queue, nextEvent) == true)
+    {
+      schedule.startCompare = nextEvent.startCompare;
+      schedule.endCompare = nextEvent.endCompare;
+      schedule.startAngle = ANGLE_SCHEDULE_NONE;
+      TTimer::setCompare(schedule.startCompare);
+      schedule.Status = PENDING;
+      schedule.schedulesSet = 1;
+    }
+    else { TTimer::disable(); }
+  }
+  else if (schedule.Status == OFF)
+  {
+    //Catch any spurious interrupts. This really shouldn't ever be called, but there as a safety
+    TTimer::disable();
+  }
+}
 
 #endif // SCHEDULER_H
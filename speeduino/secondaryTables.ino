@@ -180,7 +180,7 @@ byte getVE2()
     currentStatus.fuelLoad2 = (currentStatus.MAP * 100) / currentStatus.EMAP;
   }
   else { currentStatus.fuelLoad2 = currentStatus.MAP; } //Fallback position
-  tempVE = get3DTableValue(&fuelTable2, currentStatus.fuelLoad2, currentStatus.RPM); //Perform lookup into fuel map for RPM vs MAP value
+  tempVE = get3DTableValue(&fuelTable2, &fuelAxisContext, currentStatus.fuelLoad2, currentStatus.RPM); //Perform lookup into fuel map for RPM vs MAP value
 
   return tempVE;
 }
@@ -210,7 +210,7 @@ byte getAdvance2()
     currentStatus.ignLoad2 = (currentStatus.MAP * 100) / currentStatus.EMAP;
   }
   else { currentStatus.ignLoad2 = currentStatus.MAP; }
-  tempAdvance = get3DTableValue(&ignitionTable2, currentStatus.ignLoad2, currentStatus.RPM) - OFFSET_IGNITION; //As above, but for ignition advance
+  tempAdvance = get3DTableValue(&ignitionTable2, &ignitionAxisContext, currentStatus.ignLoad2, currentStatus.RPM) - OFFSET_IGNITION; //As above, but for ignition advance
   tempAdvance = correctionsIgn(tempAdvance);
 
   return tempAdvance;
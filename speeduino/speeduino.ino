@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "table.h"
 #include "scheduler.h"
 #include "comms.h"
+#include "comms_frame.h"
 #include "cancomms.h"
 #include "maths.h"
 #include "corrections.h"
@@ -124,8 +125,8 @@ void loop()
         if(Serial.availableForWrite() > 16) { sendCompositeLog(inProgressOffset); }
       }
 
-      //Check for any new requets from serial.
-      if ( (Serial.available()) > 0) { command(); }
+      //Check for any new requets from serial. These can be either framed or legacy single letter commands, see serialReceive()
+      if ( ((Serial.available()) > 0) || (serialFramePending() == true) ) { serialReceive(); }
       else if(cmdPending == true)
       {
         //This is a special case just for the tooth and composite loggers
@@ -259,10 +260,6 @@ void loop()
         if(configPage6.flatSEnable && clutchTrigger && (currentStatus.RPM > ((unsigned int)(configPage6.flatSArm) * 100)) && (currentStatus.RPM > currentStatus.clutchEngagedRPM) ) { currentStatus.flatShiftingHard = true; }
         else { currentStatus.flatShiftingHard = false; }
       }
-
-      //And check whether the tooth log buffer is ready
-      if(toothHistoryIndex > TOOTH_LOG_SIZE) { BIT_SET(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY); }
-
     }
     if(BIT_CHECK(LOOP_TIMER, BIT_TIMER_10HZ)) //10 hertz
     {
@@ -492,7 +489,7 @@ void loop()
         {
           uint32_t tempPW3 = (((unsigned long)currentStatus.PW1 * staged_req_fuel_mult_sec) / 100); //This is ONLY needed in in table mode. Auto mode only calculates the difference.
 
-          byte stagingSplit = get3DTableValue(&stagingTable, currentStatus.MAP, currentStatus.RPM);
+          byte stagingSplit = get3DTableValue(&stagingTable, &fuelAxisContext, currentStatus.MAP, currentStatus.RPM);
           currentStatus.PW1 = ((100 - stagingSplit) * tempPW1) / 100;
           currentStatus.PW1 += inj_opentime_uS; 
 
@@ -723,7 +720,7 @@ void loop()
       }
       currentStatus.dwell = correctionsDwell(currentStatus.dwell);
 
-      int dwellAngle = timeToAngle(currentStatus.dwell, CRANKMATH_METHOD_INTERVAL_REV); //Convert the dwell time to dwell angle based on the current engine speed
+      int dwellAngle = timeToAngle(currentStatus.dwell, CRANKMATH_METHOD_INTERVAL_DEFAULT); //Convert the dwell time to dwell angle based on the current engine speed
 
       calculateIgnitionAngles(dwellAngle);
 
@@ -825,6 +822,7 @@ void loop()
                       ((injector1StartAngle - crankAngle) * (unsigned long)timePerDegree),
                       (unsigned long)currentStatus.PW1
                       );
+            setFuelScheduleAngle(1, injector1StartAngle);
           }
         }
 #endif
@@ -853,6 +851,7 @@ void loop()
                       ((tempStartAngle - tempCrankAngle) * (unsigned long)timePerDegree),
                       (unsigned long)currentStatus.PW2
                       );
+            setFuelScheduleAngle(2, injector2StartAngle);
           }
         }
 #endif
@@ -871,6 +870,7 @@ void loop()
                       ((tempStartAngle - tempCrankAngle) * (unsigned long)timePerDegree),
                       (unsigned long)currentStatus.PW3
                       );
+            setFuelScheduleAngle(3, injector3StartAngle);
           }
         }
 #endif
@@ -889,6 +889,7 @@ void loop()
                       ((tempStartAngle - tempCrankAngle) * (unsigned long)timePerDegree),
                       (unsigned long)currentStatus.PW4
                       );
+            setFuelScheduleAngle(4, injector4StartAngle);
           }
         }
 #endif
@@ -915,6 +916,7 @@ void loop()
                       ((tempStartAngle - tempCrankAngle) * (unsigned long)timePerDegree),
                       (unsigned long)currentStatus.PW5
                       );
+            setFuelScheduleAngle(5, injector5StartAngle);
           }
         }
 #endif
@@ -933,6 +935,7 @@ void loop()
                       ((tempStartAngle - tempCrankAngle) * (unsigned long)timePerDegree),
                       (unsigned long)currentStatus.PW6
                       );
+            setFuelScheduleAngle(6, injector6StartAngle);
           }
         }
 #endif
@@ -951,6 +954,7 @@ void loop()
                       ((tempStartAngle - tempCrankAngle) * (unsigned long)timePerDegree),
                       (unsigned long)currentStatus.PW7
                       );
+            setFuelScheduleAngle(7, injector7StartAngle);
           }
         }
 #endif
@@ -969,6 +973,7 @@ void loop()
                       ((tempStartAngle - tempCrankAngle) * (unsigned long)timePerDegree),
                       (unsigned long)currentStatus.PW8
                       );
+            setFuelScheduleAngle(8, injector8StartAngle);
           }
         }
 #endif
@@ -1011,10 +1016,11 @@ void loop()
           
           setIgnitionSchedule1(ign1StartFunction,
                     //((unsigned long)(ignition1StartAngle - crankAngle) * (unsigned long)timePerDegree),
-                    angleToTime((ignition1StartAngle - crankAngle), CRANKMATH_METHOD_INTERVAL_REV),
+                    angleToTime((ignition1StartAngle - crankAngle), CRANKMATH_METHOD_INTERVAL_DEFAULT),
                     currentStatus.dwell + fixedCrankingOverride, //((unsigned long)((unsigned long)currentStatus.dwell* currentStatus.RPM) / newRPM) + fixedCrankingOverride,
                     ign1EndFunction
                     );
+          setIgnitionScheduleAngle(1, ignition1StartAngle);
         }
 #endif
 
@@ -1048,7 +1054,7 @@ void loop()
 
             unsigned long ignition2StartTime = 0;
             if ( (tempStartAngle <= tempCrankAngle) && (ignitionSchedule2.Status == RUNNING) ) { tempStartAngle += CRANK_ANGLE_MAX_IGN; }
-            if(tempStartAngle > tempCrankAngle) { ignition2StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_REV); }
+            if(tempStartAngle > tempCrankAngle) { ignition2StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_DEFAULT); }
             //else if (tempStartAngle < tempCrankAngle) { ignition2StartTime = ((long)(360 - tempCrankAngle + tempStartAngle) * (long)timePerDegree); }
             else { ignition2StartTime = 0; }
 
@@ -1059,6 +1065,7 @@ void loop()
                         currentStatus.dwell + fixedCrankingOverride,
                         ign2EndFunction
                         );
+              setIgnitionScheduleAngle(2, ignition2StartAngle);
             }
         }
 #endif
@@ -1073,7 +1080,7 @@ void loop()
 
             unsigned long ignition3StartTime = 0;
             if ( (tempStartAngle <= tempCrankAngle) && (ignitionSchedule3.Status == RUNNING) ) { tempStartAngle += CRANK_ANGLE_MAX_IGN; }
-            if(tempStartAngle > tempCrankAngle) { ignition3StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_REV); }
+            if(tempStartAngle > tempCrankAngle) { ignition3StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_DEFAULT); }
             //else if (tempStartAngle < tempCrankAngle) { ignition3StartTime = ((long)(360 - tempCrankAngle + tempStartAngle) * (long)timePerDegree); }
             else { ignition3StartTime = 0; }
 
@@ -1084,6 +1091,7 @@ void loop()
                         currentStatus.dwell + fixedCrankingOverride,
                         ign3EndFunction
                         );
+              setIgnitionScheduleAngle(3, ignition3StartAngle);
             }
         }
 #endif
@@ -1098,7 +1106,7 @@ void loop()
 
             unsigned long ignition4StartTime = 0;
             if ( (tempStartAngle <= tempCrankAngle) && (ignitionSchedule4.Status == RUNNING) ) { tempStartAngle += CRANK_ANGLE_MAX_IGN; }
-            if(tempStartAngle > tempCrankAngle) { ignition4StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_REV); }
+            if(tempStartAngle > tempCrankAngle) { ignition4StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_DEFAULT); }
             //else if (tempStartAngle < tempCrankAngle) { ignition4StartTime = ((long)(360 - tempCrankAngle + tempStartAngle) * (long)timePerDegree); }
             else { ignition4StartTime = 0; }
 
@@ -1109,6 +1117,7 @@ void loop()
                         currentStatus.dwell + fixedCrankingOverride,
                         ign4EndFunction
                         );
+              setIgnitionScheduleAngle(4, ignition4StartAngle);
             }
         }
 #endif
@@ -1123,7 +1132,7 @@ void loop()
 
             unsigned long ignition5StartTime = 0;
             if ( (tempStartAngle <= tempCrankAngle) && (ignitionSchedule5.Status == RUNNING) ) { tempStartAngle += CRANK_ANGLE_MAX_IGN; }
-            if(tempStartAngle > tempCrankAngle) { ignition5StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_REV); }
+            if(tempStartAngle > tempCrankAngle) { ignition5StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_DEFAULT); }
             //else if (tempStartAngle < tempCrankAngle) { ignition5StartTime = ((long)(360 - tempCrankAngle + tempStartAngle) * (long)timePerDegree); }
             else { ignition5StartTime = 0; }
 
@@ -1134,6 +1143,7 @@ void loop()
                         currentStatus.dwell + fixedCrankingOverride,
                         ign5EndFunction
                         );
+              setIgnitionScheduleAngle(5, ignition5StartAngle);
             }
         }
 #endif
@@ -1148,7 +1158,7 @@ void loop()
 
             unsigned long ignition6StartTime = 0;
             if ( (tempStartAngle <= tempCrankAngle) && (ignitionSchedule6.Status == RUNNING) ) { tempStartAngle += CRANK_ANGLE_MAX_IGN; }
-            if(tempStartAngle > tempCrankAngle) { ignition6StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_REV); }
+            if(tempStartAngle > tempCrankAngle) { ignition6StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_DEFAULT); }
             //else if (tempStartAngle < tempCrankAngle) { ignition6StartTime = ((long)(360 - tempCrankAngle + tempStartAngle) * (long)timePerDegree); }
             else { ignition6StartTime = 0; }
 
@@ -1159,6 +1169,7 @@ void loop()
                         currentStatus.dwell + fixedCrankingOverride,
                         ign6EndFunction
                         );
+              setIgnitionScheduleAngle(6, ignition6StartAngle);
             }
         }
 #endif
@@ -1173,7 +1184,7 @@ void loop()
 
             unsigned long ignition7StartTime = 0;
             if ( (tempStartAngle <= tempCrankAngle) && (ignitionSchedule7.Status == RUNNING) ) { tempStartAngle += CRANK_ANGLE_MAX_IGN; }
-            if(tempStartAngle > tempCrankAngle) { ignition7StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_REV); }
+            if(tempStartAngle > tempCrankAngle) { ignition7StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_DEFAULT); }
             //else if (tempStartAngle < tempCrankAngle) { ignition7StartTime = ((long)(360 - tempCrankAngle + tempStartAngle) * (long)timePerDegree); }
             else { ignition7StartTime = 0; }
 
@@ -1184,6 +1195,7 @@ void loop()
                         currentStatus.dwell + fixedCrankingOverride,
                         ign7EndFunction
                         );
+              setIgnitionScheduleAngle(7, ignition7StartAngle);
             }
         }
 #endif
@@ -1198,7 +1210,7 @@ void loop()
 
             unsigned long ignition8StartTime = 0;
             if ( (tempStartAngle <= tempCrankAngle) && (ignitionSchedule8.Status == RUNNING) ) { tempStartAngle += CRANK_ANGLE_MAX_IGN; }
-            if(tempStartAngle > tempCrankAngle) { ignition8StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_REV); }
+            if(tempStartAngle > tempCrankAngle) { ignition8StartTime = angleToTime((tempStartAngle - tempCrankAngle), CRANKMATH_METHOD_INTERVAL_DEFAULT); }
             //else if (tempStartAngle < tempCrankAngle) { ignition8StartTime = ((long)(360 - tempCrankAngle + tempStartAngle) * (long)timePerDegree); }
             else { ignition8StartTime = 0; }
 
@@ -1209,6 +1221,7 @@ void loop()
                         currentStatus.dwell + fixedCrankingOverride,
                         ign8EndFunction
                         );
+              setIgnitionScheduleAngle(8, ignition8StartAngle);
             }
         }
 #endif
@@ -1324,7 +1337,7 @@ byte getVE1()
     currentStatus.fuelLoad = (currentStatus.MAP * 100) / currentStatus.EMAP;
   }
   else { currentStatus.fuelLoad = currentStatus.MAP; } //Fallback position
-  tempVE = get3DTableValue(&fuelTable, currentStatus.fuelLoad, currentStatus.RPM); //Perform lookup into fuel map for RPM vs MAP value
+  tempVE = get3DTableValue(&fuelTable, &fuelAxisContext, currentStatus.fuelLoad, currentStatus.RPM); //Perform lookup into fuel map for RPM vs MAP value
 
   return tempVE;
 }
@@ -1353,7 +1366,7 @@ byte getAdvance1()
     //IMAP / EMAP
     currentStatus.ignLoad = (currentStatus.MAP * 100) / currentStatus.EMAP;
   }
-  tempAdvance = get3DTableValue(&ignitionTable, currentStatus.ignLoad, currentStatus.RPM) - OFFSET_IGNITION; //As above, but for ignition advance
+  tempAdvance = get3DTableValue(&ignitionTable, &ignitionAxisContext, currentStatus.ignLoad, currentStatus.RPM) - OFFSET_IGNITION; //As above, but for ignition advance
   tempAdvance = correctionsIgn(tempAdvance);
 
   return tempAdvance;
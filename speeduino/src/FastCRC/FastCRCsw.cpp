@@ -392,6 +392,16 @@ FastCRC32::FastCRC32(){}
 	pgm_read_dword(&table[((crc >> 16) & 0xff) + 0x100]) ^	\
 	pgm_read_dword(&table[(crc >> 24) & 0xff]);
 	
+#define crc_n8d(crc, data1, data2, table, table8) crc ^= data1; \
+	crc = pgm_read_dword(&table8[(crc & 0xff) + 0x300]) ^	\
+	pgm_read_dword(&table8[((crc >> 8) & 0xff) + 0x200]) ^	\
+	pgm_read_dword(&table8[((crc >> 16) & 0xff) + 0x100]) ^	\
+	pgm_read_dword(&table8[(crc >> 24) & 0xff]) ^	\
+	pgm_read_dword(&table[(data2 & 0xff) + 0x300]) ^	\
+	pgm_read_dword(&table[((data2 >> 8) & 0xff) + 0x200]) ^	\
+	pgm_read_dword(&table[((data2 >> 16) & 0xff) + 0x100]) ^	\
+	pgm_read_dword(&table[(data2 >> 24) & 0xff]);
+
 #define crcsm_n4d(crc, data, table) crc ^= data; \
 	crc = (crc >> 8) ^ pgm_read_dword(&table[crc & 0xff]); \
 	crc = (crc >> 8) ^ pgm_read_dword(&table[crc & 0xff]); \
@@ -422,7 +432,10 @@ uint32_t FastCRC32::crc32_upd(const uint8_t *data, uint16_t len, bool reflect)
 
 	while (len >= 16) {
 		len -= 16;
-		#if CRC_BIGTABLES
+		#if CRC_BIGTABLES && CRC_SLICE8
+		crc_n8d(crc, ((uint32_t *)data)[0], ((uint32_t *)data)[1], CRC_TABLE_CRC32, crc_table_crc32_slice8);
+		crc_n8d(crc, ((uint32_t *)data)[2], ((uint32_t *)data)[3], CRC_TABLE_CRC32, crc_table_crc32_slice8);
+		#elif CRC_BIGTABLES
 		crc_n4d(crc, ((uint32_t *)data)[0], CRC_TABLE_CRC32);
 		crc_n4d(crc, ((uint32_t *)data)[1], CRC_TABLE_CRC32);
 		crc_n4d(crc, ((uint32_t *)data)[2], CRC_TABLE_CRC32);
@@ -5,9 +5,12 @@
    (c) Frank Boesing 2014-2016
 
    Edit FastCRC.h for smaller Tables (#define CRC_BIGTABLES 1) - not needed for Teensy 3.x
+   The CRC32 method can be chosen with -DCRC_SLICE8=0 or 1. The same CRC32 benchmark runs on the host with: pio test -e native -f bench_crc
 */
 
-#include <util/crc16.h>
+#if defined(__AVR__)
+#include <util/crc16.h> //The builtin CRCs are only available on the AVR
+#endif
 #include <FastCRC.h>
 
 
@@ -20,6 +23,8 @@
 #define BUFSIZE (12 * 1024) // 12KB for Teensy 3.0
 #elif defined(__MKL26Z64__)
 #define BUFSIZE (4 * 1024)  // 4KB for Teensy LC
+#elif defined(__IMXRT1062__)
+#define BUFSIZE (32 * 1024) // 32KB for Teensy 4.x
 #else
 #define BUFSIZE (1 * 1024)  // 1KB for Teensy 2.0 / others...(use max. possible!)
 #endif
@@ -31,6 +36,7 @@ FastCRC16 CRC16;
 FastCRC32 CRC32;
 
 
+#if defined(__AVR__)
 // Supporting functions for Software CRC
 
 inline uint16_t softcrc(uint16_t seed, uint8_t *data, uint16_t datalen) {
@@ -60,6 +66,7 @@ inline uint16_t softcrcXMODEM(uint16_t seed, uint8_t *data, uint16_t datalen) {
   }
   return seed;
 }
+#endif
 
 
 void printVals(const char * name, const uint32_t crc, const uint32_t time) {
@@ -100,10 +107,12 @@ void setup() {
   time = micros() - time;
   printVals("Maxim (iButton) FastCRC:", crc, time);
 
+#if defined(__AVR__)
   time = micros();
   crc = softcrcIbutton(0, buf, BUFSIZE);
   time = micros() - time;
   printVals("Maxim (iButton) builtin:", crc, time);
+#endif
 
 #if !defined(LOFLASH)
   time = micros();
@@ -111,20 +120,24 @@ void setup() {
   time = micros() - time;
   printVals("MODBUS FastCRC:", crc, time);
 
+#if defined(__AVR__)
   time = micros();
   crc = softcrc(0xffff, buf, BUFSIZE);
   time = micros() - time;
   printVals("MODBUS builtin: ", crc, time);
+#endif
 
   time = micros();
   crc = CRC16.xmodem(buf, BUFSIZE);
   time = micros() - time;
   printVals("XMODEM FastCRC:", crc, time);
 
+#if defined(__AVR__)
   time = micros();
   crc = softcrcXMODEM(0, buf, BUFSIZE);
   time = micros() - time;
   printVals("XMODEM builtin: ", crc, time);
+#endif
 #endif
 
   /* 16 BIT */
@@ -134,10 +147,12 @@ void setup() {
   printVals("MCRF4XX FastCRC:", crc, time);
 
 
+#if defined(__AVR__)
   time = micros();
   crc = softcrcCCIT(0xffff, buf, BUFSIZE);
   time = micros() - time;
   printVals("MCRF4XX builtin:", crc, time);
+#endif
 
 #if !defined(LOFLASH)
   time = micros();
@@ -149,6 +164,11 @@ void setup() {
 
   /* 32 BIT */
 #if !defined(LOFLASH)
+#if CRC_SLICE8
+  Serial.println("CRC32 method: Slice-by-8");
+#elif CRC_BIGTABLES
+  Serial.println("CRC32 method: Slice-by-4");
+#endif
   time = micros();
   crc = CRC32.crc32(buf, BUFSIZE);
   time = micros() - time;
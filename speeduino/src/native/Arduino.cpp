@@ -0,0 +1,148 @@
+/*
+Speeduino - Simple engine management for the Arduino Mega 2560 platform
+Copyright (C) Josh Stewart
+A full copy of the license may be found in the projects root directory
+*/
+#if defined(NATIVE_BOARD)
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "SPI.h"
+#include <stdio.h>
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+SPIClass SPI;
+
+static unsigned long simulatedMicros = 0;
+
+//Every pin gets its own 'port' with a single bit mask. This is wasteful but keeps the port lookup a simple array index
+//The registers behave like the AVR ones: mode (DDR) 1 = output, output (PORT) doubles as the pullup enable for inputs, input (PIN) is driven by the harness
+static volatile uint8_t modePorts[NUM_DIGITAL_PINS];
+static volatile uint8_t outputPorts[NUM_DIGITAL_PINS];
+static volatile uint8_t inputPorts[NUM_DIGITAL_PINS];
+static uint16_t analogValues[NUM_DIGITAL_PINS];
+
+unsigned long micros() { return simulatedMicros; }
+unsigned long millis() { return simulatedMicros / 1000UL; }
+void setMicros(unsigned long newMicros) { simulatedMicros = newMicros; }
+//Delays are only used during startup and in blocking comms code. Moving the clock is all that is needed
+void delay(unsigned long ms) { simulatedMicros += (ms * 1000UL); }
+void delayMicroseconds(unsigned int us) { simulatedMicros += us; }
+
+static inline uint8_t clampPin(uint8_t pin) { return (pin < NUM_DIGITAL_PINS) ? pin : 0; }
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  pin = clampPin(pin);
+  modePorts[pin] = (mode == OUTPUT) ? 1 : 0;
+  if(mode == INPUT_PULLUP) { outputPorts[pin] = 1; inputPorts[pin] = 1; }
+  else if(mode == INPUT) { outputPorts[pin] = 0; }
+}
+void digitalWrite(uint8_t pin, uint8_t val) { outputPorts[clampPin(pin)] = (val == LOW) ? 0 : 1; }
+int digitalRead(uint8_t pin)
+{
+  pin = clampPin(pin);
+  if(modePorts[pin] == 1) { return outputPorts[pin] ? HIGH : LOW; }
+  return inputPorts[pin] ? HIGH : LOW;
+}
+int analogRead(uint8_t pin) { return analogValues[clampPin(pin)]; }
+void analogWrite(uint8_t pin, int val) { outputPorts[clampPin(pin)] = (val == 0) ? 0 : 1; }
+void analogReadResolution(int bits) { (void)bits; }
+void setAnalogValue(uint8_t pin, uint16_t value) { analogValues[clampPin(pin)] = value; }
+void setDigitalValue(uint8_t pin, uint8_t val) { inputPorts[clampPin(pin)] = (val == LOW) ? 0 : 1; }
+
+uint8_t digitalPinToPort(uint8_t pin) { return clampPin(pin); }
+uint8_t digitalPinToBitMask(uint8_t pin) { (void)pin; return 1U; }
+volatile uint8_t* portModeRegister(uint8_t port) { return &modePorts[clampPin(port)]; }
+volatile uint8_t* portOutputRegister(uint8_t port) { return &outputPorts[clampPin(port)]; }
+volatile uint8_t* portInputRegister(uint8_t port) { return &inputPorts[clampPin(port)]; }
+
+//The trigger inputs are driven directly by the harness calling the decoder functions, so there is nothing to attach to
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode) { (void)interruptNum; (void)userFunc; (void)mode; }
+void detachInterrupt(uint8_t interruptNum) { (void)interruptNum; }
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+  if(in_max == in_min) { return out_min; } //A divide by 0 traps on the host where it would just give junk on the AVR
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+/*
+***********************************************************************************************************
+* Serial
+*/
+int HardwareSerial::available() { return (int)(rxHead - rxTail); }
+
+int HardwareSerial::peek() { return (rxHead == rxTail) ? -1 : rxData[rxTail % SERIAL_NATIVE_BUFFER_SIZE]; }
+
+int HardwareSerial::read()
+{
+  if(rxHead == rxTail) { return -1; }
+  return rxData[(rxTail++) % SERIAL_NATIVE_BUFFER_SIZE];
+}
+
+size_t HardwareSerial::write(uint8_t value)
+{
+  //Output that is never collected by the harness simply wraps around
+  if(txHead >= SERIAL_NATIVE_BUFFER_SIZE) { txHead = 0; }
+  txData[txHead++] = value;
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+  for(size_t x = 0; x < size; x++) { write(buffer[x]); }
+  return size;
+}
+
+size_t HardwareSerial::print(long value, int base)
+{
+  if( (value < 0) && (base == DEC) ) { return write((uint8_t)'-') + print((unsigned long)(-value), base); }
+  return print((unsigned long)value, base);
+}
+
+size_t HardwareSerial::print(unsigned long value, int base)
+{
+  char buffer[8 * sizeof(long) + 1];
+  char *str = &buffer[sizeof(buffer) - 1];
+  *str = '\0';
+  if(base < 2) { base = DEC; }
+  do
+  {
+    unsigned long digit = value % base;
+    value /= base;
+    *--str = (char)(digit < 10 ? digit + '0' : digit + 'A' - 10);
+  } while(value > 0);
+  return write(str);
+}
+
+size_t HardwareSerial::print(double value, int digits)
+{
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  return write(buffer);
+}
+
+void HardwareSerial::injectRx(const uint8_t *buffer, size_t size)
+{
+  for(size_t x = 0; x < size; x++) { rxData[(rxHead++) % SERIAL_NATIVE_BUFFER_SIZE] = buffer[x]; }
+}
+
+/*
+***********************************************************************************************************
+* Entry point
+* There is nothing to wake the main loop on the host, so it is only run a fixed number of times (Default once) after setup().
+* This is weak so that a benchmark or test harness can provide its own main().
+*/
+#ifndef NATIVE_LOOP_ITERATIONS
+  #define NATIVE_LOOP_ITERATIONS 1
+#endif
+
+__attribute__((weak)) int main()
+{
+  setup();
+  for(unsigned long x = 0; x < NATIVE_LOOP_ITERATIONS; x++) { loop(); }
+  return 0;
+}
+
+#endif //NATIVE_BOARD
@@ -0,0 +1,189 @@
+/*
+Speeduino - Simple engine management for the Arduino Mega 2560 platform
+Copyright (C) Josh Stewart
+A full copy of the license may be found in the projects root directory
+*/
+/** @file
+ * Minimal host (x86/ARM Linux, macOS) implementation of the Arduino core API.
+ *
+ * This is ONLY used by the `native` build environment. It provides just enough of the Arduino API for the engine core
+ * (decoders, scheduler, tables, corrections etc) to compile and run at host speed so that it can be unit tested, profiled and benchmarked without hardware.
+ *
+ * Time is simulated rather than real: micros() and millis() return a clock that only moves when the test/benchmark harness moves it
+ * (See @ref setMicros() and nativeAdvanceTime() in board_native.ino). This makes all timing dependent code fully deterministic.
+ */
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+#if defined(NATIVE_BOARD)
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH          0x1
+#define LOW           0x0
+
+#define INPUT         0x0
+#define OUTPUT        0x1
+#define INPUT_PULLUP  0x2
+
+#define CHANGE        1
+#define FALLING       2
+#define RISING        3
+
+#define LED_BUILTIN   13
+#define NUM_DIGITAL_PINS  70
+#define NUM_ANALOG_INPUTS 16
+
+#define A0  54
+#define A1  55
+#define A2  56
+#define A3  57
+#define A4  58
+#define A5  59
+#define A6  60
+#define A7  61
+#define A8  62
+#define A9  63
+#define A10 64
+#define A11 65
+#define A12 66
+#define A13 67
+#define A14 68
+#define A15 69
+
+//Flash memory is just normal memory on the host
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_byte_near(addr) pgm_read_byte(addr)
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_word_near(addr) pgm_read_word(addr)
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+class __FlashStringHelper;
+
+#define lowByte(w) ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+#define word(h, l) ((uint16_t)(((h) << 8) | (l)))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+//Templates rather than the usual macros so that the host C++ standard library headers can still be included
+template<class A, class B> inline auto min(const A &a, const B &b) -> decltype(b < a ? b : a) { return (b < a) ? b : a; }
+template<class A, class B> inline auto max(const A &a, const B &b) -> decltype(b > a ? b : a) { return (b > a) ? b : a; }
+
+//There are no interrupts on the host, everything runs on the one thread
+#define noInterrupts()
+#define interrupts()
+#define sei()
+#define cli()
+
+/*
+***********************************************************************************************************
+* Time
+*/
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void setMicros(unsigned long newMicros); ///< Sets the simulated clock. Only for use by the test/benchmark harness
+
+/*
+***********************************************************************************************************
+* I/O
+* Every pin is backed by a byte of simulated port memory, so the direct port manipulation used by the injector/coil outputs works unchanged
+*/
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+void analogReadResolution(int bits);
+void setAnalogValue(uint8_t pin, uint16_t value); ///< Sets the value the next analogRead() of the pin will return. Only for use by the test/benchmark harness
+void setDigitalValue(uint8_t pin, uint8_t val); ///< Sets the level seen on an input pin. Only for use by the test/benchmark harness
+
+uint8_t digitalPinToPort(uint8_t pin);
+uint8_t digitalPinToBitMask(uint8_t pin);
+volatile uint8_t* portModeRegister(uint8_t port);
+volatile uint8_t* portOutputRegister(uint8_t port);
+volatile uint8_t* portInputRegister(uint8_t port);
+#define digitalPinToInterrupt(p) (p)
+#define NOT_A_PIN 0xFF
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+/*
+***********************************************************************************************************
+* Serial
+* Output is captured in a buffer and input is injected by the harness, so comms can be exercised without a port
+*/
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+#define SERIAL_NATIVE_BUFFER_SIZE 4096
+
+class HardwareSerial
+{
+  public:
+    void begin(unsigned long) { }
+    void end() { }
+    int available();
+    int availableForWrite() { return SERIAL_NATIVE_BUFFER_SIZE; }
+    int peek();
+    int read();
+    void flush() { }
+    size_t write(uint8_t value);
+    size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+
+    size_t print(const __FlashStringHelper *str) { return write((const char *)str); }
+    size_t print(const char *str) { return write(str); }
+    size_t print(char value) { return write((uint8_t)value); }
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(double value, int digits = 2);
+
+    size_t println() { return write((const uint8_t *)"\r\n", 2); }
+    template<typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template<typename T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+
+    operator bool() { return true; }
+
+    //Harness side of the port
+    void injectRx(const uint8_t *buffer, size_t size); ///< Queue bytes as if they had been received
+    size_t txLength() const { return txHead; }         ///< Number of bytes written since the last clearTx()
+    const uint8_t* txBuffer() const { return txData; }
+    void clearTx() { txHead = 0; }
+
+  private:
+    uint8_t rxData[SERIAL_NATIVE_BUFFER_SIZE];
+    size_t rxHead = 0;
+    size_t rxTail = 0;
+    uint8_t txData[SERIAL_NATIVE_BUFFER_SIZE];
+    size_t txHead = 0;
+};
+
+extern HardwareSerial Serial;
+
+void setup();
+void loop();
+
+#endif //NATIVE_BOARD
+#endif //NATIVE_ARDUINO_H
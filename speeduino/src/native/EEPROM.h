@@ -0,0 +1,49 @@
+/*
+Speeduino - Simple engine management for the Arduino Mega 2560 platform
+Copyright (C) Josh Stewart
+A full copy of the license may be found in the projects root directory
+*/
+/** @file
+ * RAM backed EEPROM for the `native` build environment. Same interface as the AVR EEPROM library.
+ */
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+#if defined(NATIVE_BOARD)
+#include <stdint.h>
+#include <string.h>
+
+#define NATIVE_EEPROM_SIZE 4096 //Same as the Mega 2560
+
+class EEPROMClass
+{
+  public:
+    EEPROMClass() { memset(data, 0xFF, sizeof(data)); } //Starts erased, the same as a new chip
+
+    uint8_t read(int idx) { return data[idx % NATIVE_EEPROM_SIZE]; }
+    void write(int idx, uint8_t val) { data[idx % NATIVE_EEPROM_SIZE] = val; writeCount++; }
+    void update(int idx, uint8_t val) { if(read(idx) != val) { write(idx, val); } }
+    uint16_t length() { return NATIVE_EEPROM_SIZE; }
+
+    template< typename T > T &get( int idx, T &t )
+    {
+      uint8_t *ptr = (uint8_t*) &t;
+      for( int count = sizeof(T) ; count ; --count, ++idx )  { *ptr++ = read(idx); }
+      return t;
+    }
+    template< typename T > const T &put( int idx, const T &t )
+    {
+      const uint8_t *ptr = (const uint8_t*) &t;
+      for( int count = sizeof(T) ; count ; --count, ++idx )  { update(idx, *ptr++); }
+      return t;
+    }
+
+    uint32_t writeCount = 0; ///< The number of physical writes performed. Used to check EEPROM wear in tests
+
+  private:
+    uint8_t data[NATIVE_EEPROM_SIZE];
+};
+
+extern EEPROMClass EEPROM; //Unlike the AVR library this holds the data, so there must only be one instance (See Arduino.cpp)
+
+#endif //NATIVE_BOARD
+#endif //NATIVE_EEPROM_H
@@ -0,0 +1,36 @@
+/** @file
+ * SPI for the `native` build environment. There is nothing on the other end of the bus, all transfers read back 0.
+ */
+#ifndef NATIVE_SPI_H
+#define NATIVE_SPI_H
+#if defined(NATIVE_BOARD)
+#include "Arduino.h"
+
+#define MSBFIRST  1
+#define LSBFIRST  0
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPISettings
+{
+  public:
+    SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) { (void)clock; (void)bitOrder; (void)dataMode; }
+};
+
+class SPIClass
+{
+  public:
+    void begin() { }
+    void end() { }
+    void beginTransaction(SPISettings settings) { (void)settings; }
+    void endTransaction() { }
+    uint8_t transfer(uint8_t data) { (void)data; return 0; }
+    uint16_t transfer16(uint16_t data) { (void)data; return 0; }
+};
+
+extern SPIClass SPI;
+
+#endif //NATIVE_BOARD
+#endif //NATIVE_SPI_H
@@ -0,0 +1,7 @@
+/** @file
+ * Flash memory access for the `native` build environment. Flash is just normal memory on the host, see Arduino.h
+ */
+#ifndef NATIVE_AVR_PGMSPACE_H
+#define NATIVE_AVR_PGMSPACE_H
+#include "../Arduino.h"
+#endif //NATIVE_AVR_PGMSPACE_H
@@ -0,0 +1,7 @@
+/** @file
+ * Some libraries (Eg FastCRC) include pgmspace.h directly on non-AVR cores.
+ */
+#ifndef NATIVE_PGMSPACE_H
+#define NATIVE_PGMSPACE_H
+#include "avr/pgmspace.h"
+#endif //NATIVE_PGMSPACE_H
@@ -0,0 +1,49 @@
+/*
+Speeduino - Simple engine management for the Arduino Mega 2560 platform
+Copyright (C) Josh Stewart
+A full copy of the license may be found in the projects root directory
+*/
+/*
+The Arduino build joins all the .ino files into a single translation unit, speeduino.ino first and then the rest in alphabetical order.
+The native platform has no Arduino framework to do this, so this file does the same join for the host build. The .ino files are excluded from the
+native build in platformio.ini so that they are only compiled here.
+Any new .ino file must be added to this list.
+*/
+#if defined(NATIVE_BOARD)
+#include "Arduino.h"
+#include "../../speeduino.ino"
+#include "../../SD_logger.ino"
+#include "../../TS_CommandButtonHandler.ino"
+#include "../../acc_mc33810.ino"
+#include "../../auxiliaries.ino"
+#include "../../board_avr2560.ino"
+#include "../../board_native.ino"
+#include "../../board_same51.ino"
+#include "../../board_stm32_generic.ino"
+#include "../../board_stm32_official.ino"
+#include "../../board_teensy35.ino"
+#include "../../board_teensy41.ino"
+#include "../../board_template.ino"
+#include "../../cancomms.ino"
+#include "../../corrections.ino"
+#include "../../crankMaths.ino"
+#include "../../decoders.ino"
+#include "../../display.ino"
+#include "../../engineProtection.ino"
+#include "../../errors.ino"
+#include "../../globals.ino"
+#include "../../idle.ino"
+#include "../../init.ino"
+#include "../../logger.ino"
+#include "../../maths.ino"
+#include "../../rtc_common.ino"
+#include "../../scheduledIO.ino"
+#include "../../scheduler.ino"
+#include "../../secondaryTables.ino"
+#include "../../sensors.ino"
+#include "../../storage.ino"
+#include "../../table.ino"
+#include "../../timers.ino"
+#include "../../updates.ino"
+#include "../../utilities.ino"
+#endif
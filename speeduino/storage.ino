@@ -73,13 +73,12 @@ namespace {
 
   inline int16_t writeTableValues(const table3D *pTable, int &index, int16_t counter)
   {
-    byte **pRow = pTable->values + (pTable->xSize-1);
-    byte **pRowEnd = pTable->values - 1;
-    int rowSize = pTable->xSize;
-    while (counter<=EEPROM_MAX_WRITE_BLOCK && pRow!=pRowEnd)
+    table_row_iterator_t it = rows_begin(pTable);
+    while (counter<=EEPROM_MAX_WRITE_BLOCK && !at_end(it))
     {
-      counter = write_range(index, *pRow, *pRow+rowSize, counter);
-      --pRow;
+      table_row_t row = get_row(it);
+      counter = write_range(index, row.pValue, row.pEnd, counter);
+      advance_row(it);
     }
     return counter;
   }
@@ -324,12 +323,10 @@ namespace
 
   inline int loadTableValues(table3D *pTable, int index)
   {
-    byte **pRow = pTable->values + (pTable->xSize-1);
-    byte **pRowEnd = pTable->values - 1;
-    int rowSize = pTable->xSize;
-    for(; pRow!=pRowEnd; --pRow)
+    for(table_row_iterator_t it = rows_begin(pTable); !at_end(it); advance_row(it))
     {
-      index = load_range(index, *pRow, *pRow+rowSize);
+      table_row_t row = get_row(it);
+      index = load_range(index, row.pValue, row.pEnd);
     }
     return index; 
   }
@@ -346,9 +343,11 @@ namespace
 
   inline int loadTable(table3D *pTable, int index)
   {
-    return loadTableAxisY(pTable,
+    index = loadTableAxisY(pTable,
                           loadTableAxisX(pTable, 
                                           loadTableValues(pTable, index)));
+    table3D_axisChanged(pTable);
+    return index;
   }
 }
 /** Load all config tables from storage.
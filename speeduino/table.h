@@ -11,12 +11,12 @@ This file is used for everything related to maps/tables including their definiti
 #define TABLE_SHIFT_FACTOR  8
 #define TABLE_SHIFT_POWER   (1UL<<TABLE_SHIFT_FACTOR)
 
-//Define the total table memory sizes. Used for adding up the static heap size
-#define TABLE3D_SIZE_16  (16 * 16 + 32 + 32 + (16 * sizeof(byte*))) //2 bytes for each value on the axis + allocation for array pointers
-#define TABLE3D_SIZE_12  (12 * 12 + 24 + 24 + (12 * sizeof(byte*))) //2 bytes for each value on the axis + allocation for array pointers
-#define TABLE3D_SIZE_8   (8 * 8 + 16 + 16 + (8 * sizeof(byte*))) //2 bytes for each value on the axis + allocation for array pointers
-#define TABLE3D_SIZE_6   (6 * 6 + 12 + 12 + (6 * sizeof(byte*))) //2 bytes for each value on the axis + allocation for array pointers
-#define TABLE3D_SIZE_4   (4 * 4 + 8 + 8 + (4 * sizeof(byte*))) //2 bytes for each value on the axis + allocation for array pointers
+//Bin width reciprocals are ceil(2^(s + TABLE_RECIP_BITS) / width), where s is the highest set bit of the width. This is always 129 - 256, so it is stored less 1 in a byte
+#define TABLE_RECIP_BITS    8
+
+//The types a 2D table can contain (Values and axis can differ)
+#define SIZE_BYTE           8
+#define SIZE_INT            16
 
 //Define the table sizes
 #define TABLE_FUEL1_SIZE    16;
@@ -39,12 +39,6 @@ This file is used for everything related to maps/tables including their definiti
 #define TABLE_TRIM8_SIZE    6;
 #define TABLE_DWELL_SIZE    4;
 
-/*
-*********** WARNING! ***********
-YOU MUST UPDATE THE TABLE COUNTS IN THE LINE BELOW WHENEVER A NEW TABLE IS ADDED!
-*/
-#define TABLE_HEAP_SIZE     ((5 * TABLE3D_SIZE_16) + (5 * TABLE3D_SIZE_8) + (8 * TABLE3D_SIZE_6) + (1 * TABLE3D_SIZE_4) + 1)
-
 
 /*
 The 2D table can contain either 8-bit (byte) or 16-bit (int) values
@@ -84,7 +78,7 @@ struct table3D {
   byte xSize;
   byte ySize;
 
-  byte **values;
+  byte *values; ///< All values in a single block, one row (Y index) after another. Value (y,x) is at values[(y * xSize) + x]
   int16_t *axisX;
   int16_t *axisY;
 
@@ -96,10 +90,44 @@ struct table3D {
   int16_t lastXInput, lastYInput;
   byte lastOutput; //This will need changing if we ever have 16-bit table values
   bool cacheIsValid; ///< This tracks whether the tables cache should be used. Ordinarily this is true, but is set to false whenever TunerStudio sends a new value for the table
+
+  //Reciprocal of the width of every bin, so the interpolation weights can be found without a division. Bin n is between axis values n and n+1
+  //The xSize-1 X bins come first, followed by the ySize-1 Y bins. These are only calculated when the axis is edited or loaded (See table3D_axisChanged())
+  uint8_t *binRecips;
 };
 
-//void table3D_setSize(struct table3D *targetTable, byte);
-void table3D_setSize(struct table3D *targetTable, byte);
+//Must be called whenever the axis values of a 3D table are changed. Recalculates the bin reciprocals
+void table3D_axisChanged(struct table3D *pTable);
+
+//Returns the highest set bit of a bin width, which is the number of bits the weight is shifted down by (See TABLE_RECIP_BITS)
+inline uint8_t table3D_binShift(uint16_t width)
+{
+  uint8_t shift = 0;
+  if(width >= 256) { width >>= 8; shift = 8; } //A whole byte is a move on the AVR, rather than 8 single bit shifts
+  while(width > 1) { width >>= 1; shift++; }
+  return shift;
+}
+
+/*
+Returns (position << TABLE_SHIFT_FACTOR) / width using the stored reciprocal of the width. As the reciprocal is rounded up the product is never below the division
+and is at most 2 over it, so up to 2 multiplies and compares make it exact
+*/
+inline uint16_t table3D_binWeight(uint16_t position, uint16_t width, uint8_t recip)
+{
+  if(position >= width) { return TABLE_SHIFT_POWER; } //At the top of the bin, which the same/next/previous bin checks allow
+  uint32_t product = (uint32_t)position * (recip + 1U);
+  uint8_t shift = table3D_binShift(width);
+  if(shift >= 8) { product >>= 8; shift -= 8; }
+  uint16_t weight = product >> shift;
+  while( ((uint32_t)weight * width) > ((uint32_t)position << TABLE_SHIFT_FACTOR) ) { weight--; }
+  return weight;
+}
+
+//Returns a pointer to the first value in the given row of a 3D table
+inline byte* table3D_getRow(const struct table3D *pTable, byte yIndex)
+{
+  return pTable->values + ((uint16_t)yIndex * pTable->xSize);
+}
 
 /*
 3D Tables have an origin (0,0) in the top left hand corner. Vertical axis is expressed first.
@@ -117,4 +145,82 @@ Eg: 2x2 table
 int get3DTableValue(struct table3D *fromTable, int, int);
 int table2D_getValue(struct table2D *fromTable, int);
 
+/*
+The result of a bin search on the X and Y axis of a 3D table, along with the interpolation weights for it.
+Tables that are looked up against the same inputs can share a context. If a tables size and axis values (At the bins that were found) match those in the context, the bin search and weight calculation are skipped and only the 4 corner interpolation is done.
+If they don't match, the bins are searched for as normal and the context is updated to this table.
+*/
+struct table3DAxisContext
+{
+  int16_t lastXInput, lastYInput; ///< The inputs the bins were found for
+  int16_t X, Y; ///< The inputs, clamped to the axis range
+  byte xSize, ySize;
+  byte xMin, xMax;
+  byte yMin, yMax;
+  int16_t xMinValue, xMaxValue;
+  int16_t yMinValue, yMaxValue;
+  uint8_t xBinRecip, yBinRecip; ///< Reciprocal of the bin widths (See TABLE_RECIP_BITS)
+  uint16_t p, q; ///< Position of X and Y between their bins (0 - TABLE_SHIFT_POWER). Only calculated when needed
+  bool weightsValid;
+  bool isValid; ///< Set to false to force a new bin search
+};
+
+int get3DTableValue(struct table3D *fromTable, struct table3DAxisContext *context, int Y_in, int X_in);
+
+/*
+Compile time sized tables.
+These are still table3D/table2D structs, so can be passed to anything that takes a table3D* or table2D* (Eg the page, CRC and storage code).
+The difference is that the lookup functions below know the size (And for 2D tables, the value and axis types) at compile time, so the bin searches can be unrolled and the SIZE_BYTE/SIZE_INT checks are removed.
+A 3D table also contains its own storage, so does not need to be sized at startup.
+*/
+template <uint8_t N>
+struct Table3D : public table3D
+{
+  Table3D()
+  {
+    xSize = N;
+    ySize = N;
+    values = _values;
+    axisX = _axisX;
+    axisY = _axisY;
+    binRecips = _binRecips;
+    table3D_axisChanged(this);
+  }
+  //The base pointers refer to this tables own storage, so a copy would share its values with the original
+  Table3D(const Table3D &) = delete;
+  Table3D& operator=(const Table3D &) = delete;
+
+private:
+  byte _values[N * N];
+  int16_t _axisX[N];
+  int16_t _axisY[N];
+  uint8_t _binRecips[2 * (N - 1)];
+};
+
+/*
+The values and axis of a 2D table are held in the config pages, so (As for table2D) the values and axisX pointers must still be set before use.
+TValue and TAxis must be either uint8_t or int16_t, as these are the types the runtime functions read SIZE_BYTE and SIZE_INT tables as.
+*/
+template <uint8_t N, typename TValue, typename TAxis = TValue>
+struct Table2D : public table2D
+{
+  static_assert( (sizeof(TValue) == 1) || (sizeof(TValue) == 2), "2D table values must be 8 or 16 bit");
+  static_assert( (sizeof(TAxis) == 1) || (sizeof(TAxis) == 2), "2D table axis must be 8 or 16 bit");
+
+  Table2D()
+  {
+    valueSize = (sizeof(TValue) == 1) ? SIZE_BYTE : SIZE_INT;
+    axisSize = (sizeof(TAxis) == 1) ? SIZE_BYTE : SIZE_INT;
+    xSize = N;
+  }
+};
+
+//These are explicitly instantiated in table.ino for the table sizes/types that are used. Any new combination needs to be added there
+template <uint8_t N>
+int get3DTableValue(Table3D<N> *fromTable, int Y_in, int X_in);
+template <uint8_t N>
+int get3DTableValue(Table3D<N> *fromTable, struct table3DAxisContext *context, int Y_in, int X_in);
+template <uint8_t N, typename TValue, typename TAxis>
+int table2D_getValue(Table2D<N, TValue, TAxis> *fromTable, int X_in);
+
 #endif // TABLE_H
@@ -36,52 +36,32 @@ void table2D_setSize(struct table2D* targetTable, byte newSize)
 }
 */
 
-static uint8_t _3DTable_heap[TABLE_HEAP_SIZE];
-static uint16_t _heap_pointer = 0;
-
-void* heap_alloc(uint16_t size)
- {
-     uint8_t* value = nullptr;
-     if (size < (TABLE_HEAP_SIZE - _heap_pointer))
-     {
-         value = &_3DTable_heap[_heap_pointer];
-         _heap_pointer += size;
-     }
-     return value;
- }
-
-
-void table3D_setSize(struct table3D *targetTable, byte newSize)
+//Value and axis access for a table2D whose size and types are only known at runtime
+struct table2DRuntimeAccess
 {
-  if(initialisationComplete == false)
-  {
-    /*
-    targetTable->values = (byte **)malloc(newSize * sizeof(byte*));
-    for(byte i = 0; i < newSize; i++) { targetTable->values[i] = (byte *)malloc(newSize * sizeof(byte)); }
-    */
-    targetTable->values = (byte **)heap_alloc(newSize * sizeof(byte*));
-    for(byte i = 0; i < newSize; i++) { targetTable->values[i] = (byte *)heap_alloc(newSize * sizeof(byte)); }
-
-    /*
-    targetTable->axisX = (int16_t *)malloc(newSize * sizeof(int16_t));
-    targetTable->axisY = (int16_t *)malloc(newSize * sizeof(int16_t));
-    */
-    targetTable->axisX = (int16_t *)heap_alloc(newSize * sizeof(int16_t));
-    targetTable->axisY = (int16_t *)heap_alloc(newSize * sizeof(int16_t));
-    targetTable->xSize = newSize;
-    targetTable->ySize = newSize;
-    targetTable->cacheIsValid = false; //Invalid the tables cache to ensure a lookup of new values
-  } //initialisationComplete
-}
+  static inline byte size(const struct table2D *fromTable) { return fromTable->xSize; }
+  static inline int16_t axis(struct table2D *fromTable, byte index) { return table2D_getAxisValue(fromTable, index); }
+  static inline int16_t value(struct table2D *fromTable, byte index) { return table2D_getRawValue(fromTable, index); }
+};
+
+//Value and axis access for a Table2D, where the size and types are template parameters
+template <uint8_t N, typename TValue, typename TAxis>
+struct table2DFixedAccess
+{
+  static inline byte size(const struct table2D *) { return N; }
+  static inline int16_t axis(const struct table2D *fromTable, byte index) { return ((const TAxis *)fromTable->axisX)[index]; }
+  static inline int16_t value(const struct table2D *fromTable, byte index) { return ((const TValue *)fromTable->values)[index]; }
+};
 
 /*
 This function pulls a 1D linear interpolated (ie averaged) value from a 2D table
 ie: Given a value on the X axis, it returns a Y value that coresponds to the point on the curve between the nearest two defined X values
 
-This function must take into account whether a table contains 8-bit or 16-bit values.
-Unfortunately this means many of the lines are duplicated depending on this
+This function must take into account whether a table contains 8-bit or 16-bit values. This is done through TAccess, which is either
+table2DRuntimeAccess (Checks valueSize/axisSize on each read) or table2DFixedAccess (Types known at compile time)
 */
-int table2D_getValue(struct table2D *fromTable, int X_in)
+template <typename TAccess>
+static inline int table2D_getValueImpl(struct table2D *fromTable, int X_in)
 {
   //Orig memory usage = 5414
   int returnValue = 0;
@@ -90,7 +70,7 @@ int table2D_getValue(struct table2D *fromTable, int X_in)
   int X = X_in;
   int xMinValue, xMaxValue;
   int xMin = 0;
-  int xMax = fromTable->xSize-1;
+  int xMax = TAccess::size(fromTable)-1;
 
   //Check whether the X input is the same as last time this ran
   if( (X_in == fromTable->lastInput) && (fromTable->cacheTime == currentStatus.secl) )
@@ -99,14 +79,14 @@ int table2D_getValue(struct table2D *fromTable, int X_in)
     valueFound = true;
   }
   //If the requested X value is greater/small than the maximum/minimum bin, simply return that value
-  else if(X >= table2D_getAxisValue(fromTable, xMax))
+  else if(X >= TAccess::axis(fromTable, xMax))
   {
-    returnValue = table2D_getRawValue(fromTable, xMax);
+    returnValue = TAccess::value(fromTable, xMax);
     valueFound = true;
   }
-  else if(X <= table2D_getAxisValue(fromTable, xMin))
+  else if(X <= TAccess::axis(fromTable, xMin))
   {
-    returnValue = table2D_getRawValue(fromTable, xMin);
+    returnValue = TAccess::value(fromTable, xMin);
     valueFound = true;
   }
   //Finally if none of that is found
@@ -115,8 +95,8 @@ int table2D_getValue(struct table2D *fromTable, int X_in)
     fromTable->cacheTime = currentStatus.secl; //As we're not using the cache value, set the current secl value to track when this new value was calc'd
 
     //1st check is whether we're still in the same X bin as last time
-    xMaxValue = table2D_getAxisValue(fromTable, fromTable->lastXMax);
-    xMinValue = table2D_getAxisValue(fromTable, fromTable->lastXMin);
+    xMaxValue = TAccess::axis(fromTable, fromTable->lastXMax);
+    xMinValue = TAccess::axis(fromTable, fromTable->lastXMin);
     if ( (X <= xMaxValue) && (X > xMinValue) )
     {
       xMax = fromTable->lastXMax;
@@ -125,15 +105,15 @@ int table2D_getValue(struct table2D *fromTable, int X_in)
     else
     {
       //If we're not in the same bin, loop through to find where we are
-      xMaxValue = table2D_getAxisValue(fromTable, fromTable->xSize-1); // init xMaxValue in preparation for loop.
-      for (int x = fromTable->xSize-1; x > 0; x--)
+      xMaxValue = TAccess::axis(fromTable, TAccess::size(fromTable)-1); // init xMaxValue in preparation for loop.
+      for (int x = TAccess::size(fromTable)-1; x > 0; x--)
       {
-        xMinValue = table2D_getAxisValue(fromTable, x-1); // fetch next Min
+        xMinValue = TAccess::axis(fromTable, x-1); // fetch next Min
 
         //Checks the case where the X value is exactly what was requested
         if (X == xMaxValue)
         {
-          returnValue = table2D_getRawValue(fromTable, x); //Simply return the coresponding value
+          returnValue = TAccess::value(fromTable, x); //Simply return the coresponding value
           valueFound = true;
           break;
         }
@@ -157,8 +137,8 @@ int table2D_getValue(struct table2D *fromTable, int X_in)
     int16_t m = X - xMinValue;
     int16_t n = xMaxValue - xMinValue;
 
-    int16_t yMax = table2D_getRawValue(fromTable, xMax);
-    int16_t yMin = table2D_getRawValue(fromTable, xMin);
+    int16_t yMax = TAccess::value(fromTable, xMax);
+    int16_t yMin = TAccess::value(fromTable, xMin);
 
     /* Float version (if m, yMax, yMin and n were float's)
        int yVal = (m * (yMax - yMin)) / n;
@@ -175,6 +155,17 @@ int table2D_getValue(struct table2D *fromTable, int X_in)
   return returnValue;
 }
 
+int table2D_getValue(struct table2D *fromTable, int X_in)
+{
+  return table2D_getValueImpl<table2DRuntimeAccess>(fromTable, X_in);
+}
+
+template <uint8_t N, typename TValue, typename TAxis>
+int table2D_getValue(Table2D<N, TValue, TAxis> *fromTable, int X_in)
+{
+  return table2D_getValueImpl< table2DFixedAccess<N, TValue, TAxis> >(fromTable, X_in);
+}
+
 /**
  * @brief Returns an axis (bin) value from the 2D table. This works regardless of whether that axis is bytes or int16_ts
  * 
@@ -210,19 +201,44 @@ int16_t table2D_getRawValue(struct table2D *fromTable, byte X_index)
 }
 
 
-//This function pulls a value from a 3D table given a target for X and Y coordinates.
-//It performs a 2D linear interpolation as descibred in: www.megamanual.com/v22manual/ve_tuner.pdf
-int get3DTableValue(struct table3D *fromTable, int Y_in, int X_in)
+//Returns the reciprocal of a bin width, less 1 (See TABLE_RECIP_BITS). It is rounded up, so (position * reciprocal) is never below the true value once shifted down to a weight
+static uint8_t table3D_binRecip(int32_t width)
+{
+  if(width <= 0) { return 0; } //Not a valid bin. The bin search never interpolates across one of these
+  uint8_t shift = table3D_binShift(width);
+  return ( ((1UL << (shift + TABLE_RECIP_BITS)) + width - 1) / width ) - 1;
+}
+
+/*
+Calculates the reciprocal of every bin on both axis. This is where all the divisions for the interpolation weights are done, so that the lookups don't need any.
+It only needs to run when an axis is edited (setPageValue()/setPageValues()) or loaded (loadConfig())
+*/
+void table3D_axisChanged(struct table3D *pTable)
+{
+  //The X axis increases along the table and the Y axis decreases
+  uint8_t *yBinRecips = &pTable->binRecips[pTable->xSize - 1];
+  for(byte x = 0; x < (pTable->xSize - 1); x++) { pTable->binRecips[x] = table3D_binRecip((int32_t)pTable->axisX[x + 1] - pTable->axisX[x]); }
+  for(byte y = 0; y < (pTable->ySize - 1); y++) { yBinRecips[y] = table3D_binRecip((int32_t)pTable->axisY[y] - pTable->axisY[y + 1]); }
+  pTable->cacheIsValid = false;
+}
+
+/*
+Finds the bins on each axis that the X and Y inputs fall between and stores them, along with the inputs (clamped to the axis range), in the context.
+N is the size of the table if known at compile time, or 0 to use the size stored in the table
+*/
+template <uint8_t N>
+static inline void table3D_findBins(struct table3D *fromTable, int Y_in, int X_in, struct table3DAxisContext &context)
   {
+    const byte xSize = (N == 0) ? fromTable->xSize : N;
+    const byte ySize = (N == 0) ? fromTable->ySize : N;
     int X = X_in;
     int Y = Y_in;
 
-    int tableResult = 0;
     //Loop through the X axis bins for the min/max pair
     //Note: For the X axis specifically, rather than looping from tableAxisX[0] up to tableAxisX[max], we start at tableAxisX[Max] and go down.
     //      This is because the important tables (fuel and injection) will have the highest RPM at the top of the X axis, so starting there will mean the best case occurs when the RPM is highest (And hence the CPU is needed most)
     int xMinValue = fromTable->axisX[0];
-    int xMaxValue = fromTable->axisX[fromTable->xSize-1];
+    int xMaxValue = fromTable->axisX[xSize-1];
     byte xMin = 0;
     byte xMax = 0;
 
@@ -230,12 +246,6 @@ int get3DTableValue(struct table3D *fromTable, int Y_in, int X_in)
     if(X > xMaxValue) { X = xMaxValue; }
     if(X < xMinValue) { X = xMinValue; }
 
-    //0th check is whether the same X and Y values are being sent as last time. If they are, this not only prevents a lookup of the axis, but prevents the interpolation calcs being performed
-    if( (X_in == fromTable->lastXInput) && (Y_in == fromTable->lastYInput) && (fromTable->cacheIsValid == true))
-    {
-      return fromTable->lastOutput;
-    }
-
     //Commence the lookups on the X and Y axis
 
     //1st check is whether we're still in the same X bin as last time
@@ -247,7 +257,7 @@ int get3DTableValue(struct table3D *fromTable, int Y_in, int X_in)
       xMin = fromTable->lastXMin;
     }
     //2nd check is whether we're in the next RPM bin (To the right)
-    else if ( ((fromTable->lastXMax + 1) < fromTable->xSize ) && (X <= fromTable->axisX[fromTable->lastXMax +1 ]) && (X > fromTable->axisX[fromTable->lastXMin + 1]) ) //First make sure we're not already at the last X bin
+    else if ( ((fromTable->lastXMax + 1) < xSize ) && (X <= fromTable->axisX[fromTable->lastXMax +1 ]) && (X > fromTable->axisX[fromTable->lastXMin + 1]) ) //First make sure we're not already at the last X bin
     {
       xMax = fromTable->lastXMax + 1;
       fromTable->lastXMax = xMax;
@@ -269,7 +279,7 @@ int get3DTableValue(struct table3D *fromTable, int Y_in, int X_in)
     else
     //If it's not caught by one of the above scenarios, give up and just run the loop
     {
-      for (int8_t x = fromTable->xSize-1; x >= 0; x--)
+      for (int8_t x = xSize-1; x >= 0; x--)
       {
         //Checks the case where the X value is exactly what was requested
         if ( (X == fromTable->axisX[x]) || (x == 0) )
@@ -298,7 +308,7 @@ int get3DTableValue(struct table3D *fromTable, int Y_in, int X_in)
 
     //Loop through the Y axis bins for the min/max pair
     int yMaxValue = fromTable->axisY[0];
-    int yMinValue = fromTable->axisY[fromTable->ySize-1];
+    int yMinValue = fromTable->axisY[ySize-1];
     byte yMin = 0;
     byte yMax = 0;
 
@@ -325,7 +335,7 @@ int get3DTableValue(struct table3D *fromTable, int Y_in, int X_in)
       yMinValue = fromTable->axisY[fromTable->lastYMin];
     }
     //3rd check is to look at the previous bin (Next one down)
-    else if ( ((fromTable->lastYMax + 1) < fromTable->ySize) && (Y <= fromTable->axisY[fromTable->lastYMin + 1]) && (Y > fromTable->axisY[fromTable->lastYMax + 1]) ) //First make sure we're not already at the bottom Y bin
+    else if ( ((fromTable->lastYMax + 1) < ySize) && (Y <= fromTable->axisY[fromTable->lastYMin + 1]) && (Y > fromTable->axisY[fromTable->lastYMax + 1]) ) //First make sure we're not already at the bottom Y bin
     {
       yMax = fromTable->lastYMax + 1;
       fromTable->lastYMax = yMax;
@@ -338,7 +348,7 @@ int get3DTableValue(struct table3D *fromTable, int Y_in, int X_in)
     //If it's not caught by one of the above scenarios, give up and just run the loop
     {
 
-      for (int8_t y = fromTable->ySize-1; y >= 0; y--)
+      for (int8_t y = ySize-1; y >= 0; y--)
       {
         //Checks the case where the Y value is exactly what was requested
         if ( (Y == fromTable->axisY[y]) || (y==0) )
@@ -365,7 +375,75 @@ int get3DTableValue(struct table3D *fromTable, int Y_in, int X_in)
       }
     }
 
+    context.lastXInput = X_in;
+    context.lastYInput = Y_in;
+    context.X = X;
+    context.Y = Y;
+    context.xSize = xSize;
+    context.ySize = ySize;
+    context.xMin = xMin;
+    context.xMax = xMax;
+    context.yMin = yMin;
+    context.yMax = yMax;
+    context.xMinValue = xMinValue;
+    context.xMaxValue = xMaxValue;
+    context.yMinValue = yMinValue;
+    context.yMaxValue = yMaxValue;
+    context.xBinRecip = (xMax == xMin) ? 0 : fromTable->binRecips[xMin]; //Exactly on a bin (Or clamped to the end of the axis), there is nothing to interpolate
+    context.yBinRecip = (yMax == yMin) ? 0 : fromTable->binRecips[(xSize - 1) + yMin];
+    context.p = 0; //The weights are only calculated if the table values at the 4 corners differ (See table3D_blend())
+    context.q = 0;
+    context.weightsValid = false;
+    context.isValid = true;
+  }
+
+/*
+Whether the bins in the context can be used for this table without searching its axis.
+This requires the same inputs, the same table size and the same axis values at each of the bins. As the axis values always increase, a search of this tables axis would then find the same bins
+*/
+template <uint8_t N>
+static inline bool table3D_contextMatches(const struct table3D *fromTable, int Y_in, int X_in, const struct table3DAxisContext &context)
+{
+  const byte xSize = (N == 0) ? fromTable->xSize : N;
+  const byte ySize = (N == 0) ? fromTable->ySize : N;
+
+  return (context.isValid == true)
+      && (context.lastXInput == X_in) && (context.lastYInput == Y_in)
+      && (context.xSize == xSize) && (context.ySize == ySize)
+      && (fromTable->axisX[context.xMin] == context.xMinValue) && (fromTable->axisX[context.xMax] == context.xMaxValue)
+      && (fromTable->axisY[context.yMin] == context.yMinValue) && (fromTable->axisY[context.yMax] == context.yMaxValue);
+}
+
+//Create some normalised position values
+//These are essentially percentages (between 0 and 1) of where the desired value falls between the nearest bins on each axis
+static inline void table3D_calcWeights(struct table3DAxisContext &context)
+{
+  //Initial check incase the values were hit straight on
+  unsigned long p = (long)context.X - context.xMinValue;
+  if (context.xMaxValue == context.xMinValue) { p = (p << TABLE_SHIFT_FACTOR); }  //This only occurs if the requested X value was equal to one of the X axis bins
+  else { p = table3D_binWeight(p, context.xMaxValue - context.xMinValue, context.xBinRecip); } //This is the standard case
 
+  unsigned long q;
+  if (context.yMaxValue == context.yMinValue)
+  {
+    q = (long)context.Y - context.yMinValue;
+    q = (q << TABLE_SHIFT_FACTOR);
+  }
+  //Standard case
+  else
+  {
+    q = long(context.Y) - context.yMaxValue;
+    q = TABLE_SHIFT_POWER - table3D_binWeight(q, context.yMinValue - context.yMaxValue, context.yBinRecip);
+  }
+
+  context.p = p;
+  context.q = q;
+  context.weightsValid = true;
+}
+
+//Interpolates between the 4 table values at the bins in the context
+static inline int table3D_blend(const struct table3D *fromTable, struct table3DAxisContext &context)
+{
     /*
     At this point we have the 4 corners of the map where the interpolated value will fall in
     Eg: (yMin,xMin)  (yMin,xMax)
@@ -378,45 +456,43 @@ int get3DTableValue(struct table3D *fromTable, int Y_in, int X_in)
               C          D
 
     */
-    int A = fromTable->values[yMin][xMin];
-    int B = fromTable->values[yMin][xMax];
-    int C = fromTable->values[yMax][xMin];
-    int D = fromTable->values[yMax][xMax];
+    const byte *rowMin = table3D_getRow(fromTable, context.yMin);
+    const byte *rowMax = table3D_getRow(fromTable, context.yMax);
+    int A = rowMin[context.xMin];
+    int B = rowMin[context.xMax];
+    int C = rowMax[context.xMin];
+    int D = rowMax[context.xMax];
 
     //Check that all values aren't just the same (This regularly happens with things like the fuel trim maps)
-    if( (A == B) && (A == C) && (A == D) ) { tableResult = A; }
-    else
-    {
-      //Create some normalised position values
-      //These are essentially percentages (between 0 and 1) of where the desired value falls between the nearest bins on each axis
-
-
-      //Initial check incase the values were hit straight on
-
-      unsigned long p = (long)X - xMinValue;
-      if (xMaxValue == xMinValue) { p = (p << TABLE_SHIFT_FACTOR); }  //This only occurs if the requested X value was equal to one of the X axis bins
-      else { p = ( (p << TABLE_SHIFT_FACTOR) / (xMaxValue - xMinValue) ); } //This is the standard case
-
-      unsigned long q;
-      if (yMaxValue == yMinValue)
-      {
-        q = (long)Y - yMinValue;
-        q = (q << TABLE_SHIFT_FACTOR);
-      }
-      //Standard case
-      else
-      {
-        q = long(Y) - yMaxValue;
-        q = TABLE_SHIFT_POWER - ( (q << TABLE_SHIFT_FACTOR) / (yMinValue - yMaxValue) );
-      }
+    if( (A == B) && (A == C) && (A == D) ) { return A; }
+
+    //The weights are only calculated once for the context, no matter how many tables are looked up with it
+    if(context.weightsValid == false) { table3D_calcWeights(context); }
+    uint32_t p = context.p;
+    uint32_t q = context.q;
+
+    uint32_t m = ((TABLE_SHIFT_POWER-p) * (TABLE_SHIFT_POWER-q)) >> TABLE_SHIFT_FACTOR;
+    uint32_t n = (p * (TABLE_SHIFT_POWER-q)) >> TABLE_SHIFT_FACTOR;
+    uint32_t o = ((TABLE_SHIFT_POWER-p) * q) >> TABLE_SHIFT_FACTOR;
+    uint32_t r = (p * q) >> TABLE_SHIFT_FACTOR;
+    return ( (A * m) + (B * n) + (C * o) + (D * r) ) >> TABLE_SHIFT_FACTOR;
+}
 
-      uint32_t m = ((TABLE_SHIFT_POWER-p) * (TABLE_SHIFT_POWER-q)) >> TABLE_SHIFT_FACTOR;
-      uint32_t n = (p * (TABLE_SHIFT_POWER-q)) >> TABLE_SHIFT_FACTOR;
-      uint32_t o = ((TABLE_SHIFT_POWER-p) * q) >> TABLE_SHIFT_FACTOR;
-      uint32_t r = (p * q) >> TABLE_SHIFT_FACTOR;
-      tableResult = ( (A * m) + (B * n) + (C * o) + (D * r) ) >> TABLE_SHIFT_FACTOR;
+//This function pulls a value from a 3D table given a target for X and Y coordinates.
+//It performs a 2D linear interpolation as descibred in: www.megamanual.com/v22manual/ve_tuner.pdf
+template <uint8_t N>
+static inline int get3DTableValueImpl(struct table3D *fromTable, struct table3DAxisContext &context, int Y_in, int X_in)
+{
+    //0th check is whether the same X and Y values are being sent as last time. If they are, this not only prevents a lookup of the axis, but prevents the interpolation calcs being performed
+    if( (X_in == fromTable->lastXInput) && (Y_in == fromTable->lastYInput) && (fromTable->cacheIsValid == true))
+    {
+      return fromTable->lastOutput;
     }
 
+    //Only search the axis if the context was for a different input or for a table with different axis values
+    if(table3D_contextMatches<N>(fromTable, Y_in, X_in, context) == false) { table3D_findBins<N>(fromTable, Y_in, X_in, context); }
+    int tableResult = table3D_blend(fromTable, context);
+
     //Update the tables cache data
     fromTable->lastXInput = X_in;
     fromTable->lastYInput = Y_in;
@@ -425,3 +501,48 @@ int get3DTableValue(struct table3D *fromTable, int Y_in, int X_in)
 
     return tableResult;
 }
+
+int get3DTableValue(struct table3D *fromTable, int Y_in, int X_in)
+{
+  struct table3DAxisContext context;
+  context.isValid = false;
+  context.weightsValid = false;
+  return get3DTableValueImpl<0>(fromTable, context, Y_in, X_in);
+}
+
+template <uint8_t N>
+int get3DTableValue(Table3D<N> *fromTable, int Y_in, int X_in)
+{
+  struct table3DAxisContext context;
+  context.isValid = false;
+  context.weightsValid = false;
+  return get3DTableValueImpl<N>(fromTable, context, Y_in, X_in);
+}
+
+int get3DTableValue(struct table3D *fromTable, struct table3DAxisContext *context, int Y_in, int X_in)
+{
+  return get3DTableValueImpl<0>(fromTable, *context, Y_in, X_in);
+}
+
+template <uint8_t N>
+int get3DTableValue(Table3D<N> *fromTable, struct table3DAxisContext *context, int Y_in, int X_in)
+{
+  return get3DTableValueImpl<N>(fromTable, *context, Y_in, X_in);
+}
+
+//The compile time sized tables that are in use (See globals.h)
+template int get3DTableValue(Table3D<16> *, int, int);
+template int get3DTableValue(Table3D<8> *, int, int);
+template int get3DTableValue(Table3D<6> *, int, int);
+template int get3DTableValue(Table3D<4> *, int, int);
+template int get3DTableValue(Table3D<16> *, struct table3DAxisContext *, int, int);
+template int get3DTableValue(Table3D<8> *, struct table3DAxisContext *, int, int);
+template int table2D_getValue(Table2D<4, uint8_t> *, int);
+template int table2D_getValue(Table2D<6, uint8_t> *, int);
+template int table2D_getValue(Table2D<8, uint8_t> *, int);
+template int table2D_getValue(Table2D<9, uint8_t> *, int);
+template int table2D_getValue(Table2D<10, uint8_t> *, int);
+template int table2D_getValue(Table2D<4, int16_t, uint8_t> *, int);
+template int table2D_getValue(Table2D<6, int16_t, uint8_t> *, int);
+template int table2D_getValue(Table2D<32, int16_t> *, int);
+template int table2D_getValue(Table2D<32, uint8_t, int16_t> *, int);
@@ -69,33 +69,35 @@ inline bool at_end(const table_row_t &it)
 }
 
 // ========================= INTER-ROW ITERATION ========================= 
+// The values are a single row-major block, so rows are iterated by stepping 
+// back one row width at a time (last row first, same order as the Y axis)
 typedef struct table_row_iterator_t
 {
-    byte **pRowsStart;
-    byte **pRowsEnd;
+    byte *pRowStart;
+    byte *pRowsEnd;
     uint8_t rowWidth;
 } table_row_iterator_t;
 
 inline table_row_iterator_t rows_begin(const table3D *pTable)
 {
-    return {    pTable->values + (pTable->ySize-1),
-                pTable->values - 1,
+    return {    table3D_getRow(pTable, pTable->ySize-1),
+                pTable->values - pTable->xSize,
                 pTable->xSize
     };
 };
 
 inline bool at_end(const table_row_iterator_t &it)
 {
-    return it.pRowsStart == it.pRowsEnd;
+    return it.pRowStart == it.pRowsEnd;
 }
 
 inline table_row_t get_row(const table_row_iterator_t &it)
 {
-    return { *it.pRowsStart, (*it.pRowsStart) + it.rowWidth };
+    return { it.pRowStart, it.pRowStart + it.rowWidth };
 }
 
 inline table_row_iterator_t& advance_row(table_row_iterator_t &it)
 {
-    --it.pRowsStart;
+    it.pRowStart -= it.rowWidth;
     return it;
 }
\ No newline at end of file
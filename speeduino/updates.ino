@@ -25,7 +25,7 @@ void doUpdates()
     {
       for(int y=0; y<16; y++)
       {
-        ignitionTable.values[x][y] = ignitionTable.values[x][y] + 40;
+        table3D_getRow(&ignitionTable, x)[y] = table3D_getRow(&ignitionTable, x)[y] + 40;
       }
     }
     writeAllConfig();
@@ -471,7 +471,7 @@ void doUpdates()
     {
       for(int y=0; y<8; y++)
       {
-        vvtTable.values[x][y] = vvtTable.values[x][y] << 1;
+        table3D_getRow(&vvtTable, x)[y] = table3D_getRow(&vvtTable, x)[y] << 1;
       }
     }
     configPage10.vvtCLholdDuty = configPage10.vvtCLholdDuty << 1;
@@ -196,25 +196,16 @@ void checkProgrammableIO()
   }
 }
 /** Get single I/O data var (from currentStatus) for comparison.
- * Uses member offset index @ref fsIntIndex to lookup realtime 'live' data from @ref currentStatus.
- * @param index - Field index/number (?)
+ * Uses the live data field descriptors (See getLogEntryField()) to lookup realtime 'live' data from @ref currentStatus.
+ * @param index - Byte number of the field in the live data packet
  * @return 16 bit (int) result
  */
 int16_t ProgrammableIOGetData(uint16_t index)
 {
   int16_t result;
-  uint8_t x;
   if ( index < LOG_ENTRY_SIZE )
   {
-    
-    for(x = 0; x<sizeof(fsIntIndex); x++)
-    {
-      // Stop at desired field
-      if (fsIntIndex[x] == index) { break; }
-    }
-    if (x >= sizeof(fsIntIndex)) { result = getStatusEntry(index); } // 8-bit, coerce to 16 bit result
-    else { result = word(getStatusEntry(index+1), getStatusEntry(index)); } // Assemble 2 bytes to word of 16 bit result
-    
+    result = getLogEntryField(index); //8 bit fields are coerced to a 16 bit result
 
     //Special cases for temperatures
     if( (index == 6) || (index == 7) ) { result -= CALIBRATION_TEMPERATURE_OFFSET; }
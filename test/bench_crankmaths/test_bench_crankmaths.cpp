@@ -0,0 +1,200 @@
+/*
+Crank speed prediction benchmark. Native (host) build only: pio test -e native -f bench_crankmaths
+
+A 36 tooth (Even spacing, no missing tooth) wheel is run through an acceleration and deceleration profile. At every tooth the decoder variables are set the
+same way the decoders would leave them and angleToTime() is asked how long it will take the crank to turn a further BENCH_PREDICT_ANGLE degrees. This is
+compared against when the crank really gets there, for the INTERVAL_REV, INTERVAL_TOOTH, ALPHA_BETA and 2ND_DERIVATIVE methods.
+The error is reported in degrees (RMS and max) for each part of the profile, both with perfect tooth times and with BENCH_JITTER uS of noise on each tooth
+*/
+#include <Arduino.h>
+#include <stdio.h>
+#include <math.h>
+#include <unity.h>
+#include "globals.h"
+#include "decoders.h"
+
+//crankMaths.h defines these rather than declaring them, so it can't be included here
+#define CRANKMATH_METHOD_INTERVAL_REV   1
+#define CRANKMATH_METHOD_INTERVAL_TOOTH 2
+#define CRANKMATH_METHOD_ALPHA_BETA     3
+#define CRANKMATH_METHOD_2ND_DERIVATIVE 4
+unsigned long angleToTime(int16_t, byte);
+void crankSpeedFilterUpdate();
+void crankSpeedFilterReset();
+bool crankToothHistoryUpdate();
+void crankToothHistoryReset();
+
+#define BENCH_TEETH           36
+#define BENCH_TOOTH_ANGLE     (360 / BENCH_TEETH)
+#define BENCH_PREDICT_ANGLE   90      //Roughly the distance between the last tooth and the start of an ignition schedule
+#define BENCH_JITTER          4       //uS
+#define BENCH_MAX_TEETH       4000
+#define BENCH_START_TIME      1000000UL
+#define BENCH_METHODS         4
+
+struct benchSegment
+{
+  const char *name;
+  double duration; //uS
+  double startRPM;
+  double endRPM;
+};
+
+static const benchSegment benchProfile[] = {
+  { "Steady 1000",  300000, 1000, 1000 },
+  { "Accel",        500000, 1000, 6000 },
+  { "Steady 6000",  300000, 6000, 6000 },
+  { "Decel",        700000, 6000, 1500 },
+  { "Steady 1500",  300000, 1500, 1500 },
+};
+#define BENCH_SEGMENTS (sizeof(benchProfile) / sizeof(benchProfile[0]))
+
+static const byte benchMethods[BENCH_METHODS] = { CRANKMATH_METHOD_INTERVAL_REV, CRANKMATH_METHOD_INTERVAL_TOOTH, CRANKMATH_METHOD_ALPHA_BETA, CRANKMATH_METHOD_2ND_DERIVATIVE };
+
+static double toothTimes[BENCH_MAX_TEETH];   //The true time of each tooth
+static uint8_t toothSegments[BENCH_MAX_TEETH];
+static uint16_t toothCount;
+
+struct benchError
+{
+  double sumSquares;
+  double max;
+  uint32_t samples;
+};
+static benchError errors[2][BENCH_SEGMENTS][BENCH_METHODS]; //[jitter][segment][method]
+
+//Steps through the profile (RPM linear in time within each segment), recording the time each tooth is reached
+static void buildTrace(void)
+{
+  double time = 0;
+  double angle = 0;
+  double nextTooth = 0;
+  toothCount = 0;
+  for(uint8_t segment = 0; segment < BENCH_SEGMENTS; segment++)
+  {
+    const benchSegment &profile = benchProfile[segment];
+    for(double segmentTime = 0; segmentTime < profile.duration; segmentTime += 1)
+    {
+      double rpm = profile.startRPM + ((profile.endRPM - profile.startRPM) * (segmentTime / profile.duration));
+      double step = rpm * 6.0e-6; //Degrees per uS
+      if( (angle + step) >= nextTooth )
+      {
+        if(toothCount >= BENCH_MAX_TEETH) { return; }
+        toothTimes[toothCount] = time + ((nextTooth - angle) / step);
+        toothSegments[toothCount] = segment;
+        toothCount++;
+        nextTooth += BENCH_TOOTH_ANGLE;
+      }
+      angle += step;
+      time += 1;
+    }
+  }
+}
+
+//Simple repeatable noise, -BENCH_JITTER to +BENCH_JITTER
+static long benchNoise(uint16_t tooth)
+{
+  uint32_t hash = (uint32_t)tooth * 2654435761UL;
+  return (long)((hash >> 16) % ((2 * BENCH_JITTER) + 1)) - BENCH_JITTER;
+}
+
+static unsigned long measuredToothTime(uint16_t tooth, bool jitter)
+{
+  unsigned long time = BENCH_START_TIME + lround(toothTimes[tooth]);
+  if(jitter == true) { time += benchNoise(tooth); }
+  return time;
+}
+
+static void runTrace(bool jitter)
+{
+  memset(errors[jitter], 0, sizeof(errors[jitter]));
+  crankSpeedFilterReset();
+  crankToothHistoryReset();
+  triggerToothAngle = BENCH_TOOTH_ANGLE;
+  triggerToothAngleIsCorrect = true;
+
+  uint16_t predictTeeth = BENCH_PREDICT_ANGLE / BENCH_TOOTH_ANGLE;
+  for(uint16_t tooth = BENCH_TEETH; (tooth + predictTeeth) < toothCount; tooth++)
+  {
+    toothLastToothTime = measuredToothTime(tooth, jitter);
+    toothLastMinusOneToothTime = measuredToothTime(tooth - 1, jitter);
+    revolutionTime = toothLastToothTime - measuredToothTime(tooth - BENCH_TEETH, jitter);
+    setMicros(toothLastToothTime);
+    crankSpeedFilterUpdate();
+    crankToothHistoryUpdate();
+
+    //Skip the first revolution so the filter has settled from the start of the trace
+    if(tooth < (2 * BENCH_TEETH)) { continue; }
+
+    double actualTime = toothTimes[tooth + predictTeeth] - toothTimes[tooth];
+    double degreesPerUS = BENCH_TOOTH_ANGLE / (toothTimes[tooth + predictTeeth] - toothTimes[tooth + predictTeeth - 1]); //Speed at the target angle
+    for(uint8_t method = 0; method < BENCH_METHODS; method++)
+    {
+      double predictedTime = angleToTime(BENCH_PREDICT_ANGLE, benchMethods[method]);
+      double error = (predictedTime - actualTime) * degreesPerUS;
+      benchError &result = errors[jitter][toothSegments[tooth]][method];
+      result.sumSquares += error * error;
+      result.max = max(result.max, fabs(error));
+      result.samples++;
+    }
+  }
+}
+
+static double rmsError(bool jitter, uint8_t segment, uint8_t method)
+{
+  const benchError &result = errors[jitter][segment][method];
+  return (result.samples > 0) ? sqrt(result.sumSquares / result.samples) : 0;
+}
+
+static void reportTrace(bool jitter)
+{
+  char line[200];
+  for(uint8_t segment = 0; segment < BENCH_SEGMENTS; segment++)
+  {
+    int length = snprintf(line, sizeof(line), "%-11s %-6s |", benchProfile[segment].name, (jitter ? "Jitter" : "Clean"));
+    for(uint8_t method = 0; method < BENCH_METHODS; method++)
+    {
+      length += snprintf(line + length, sizeof(line) - length, " %6.2f %6.2f |", rmsError(jitter, segment, method), errors[jitter][segment][method].max);
+    }
+    TEST_MESSAGE(line);
+  }
+}
+
+//Accel and decel are the segments 1 and 3 of the profile. Methods 2 and 3 are ALPHA_BETA and 2ND_DERIVATIVE
+static void test_bench_crankmaths_clean(void)
+{
+  runTrace(false);
+  reportTrace(false);
+  TEST_ASSERT_TRUE(rmsError(false, 1, 2) < rmsError(false, 1, 0));
+  TEST_ASSERT_TRUE(rmsError(false, 3, 2) < rmsError(false, 3, 0));
+  TEST_ASSERT_TRUE(rmsError(false, 1, 3) < rmsError(false, 1, 0));
+  TEST_ASSERT_TRUE(rmsError(false, 3, 3) < rmsError(false, 3, 0));
+}
+
+static void test_bench_crankmaths_jitter(void)
+{
+  runTrace(true);
+  reportTrace(true);
+  TEST_ASSERT_TRUE(rmsError(true, 1, 2) < rmsError(true, 1, 0));
+  TEST_ASSERT_TRUE(rmsError(true, 3, 2) < rmsError(true, 3, 0));
+  TEST_ASSERT_TRUE(rmsError(true, 1, 3) < rmsError(true, 1, 0));
+  TEST_ASSERT_TRUE(rmsError(true, 3, 3) < rmsError(true, 3, 0));
+}
+
+void setup()
+{
+  buildTrace();
+
+  UNITY_BEGIN();
+  char line[100];
+  snprintf(line, sizeof(line), "Error predicting %d degrees ahead (Degrees, RMS and max)", BENCH_PREDICT_ANGLE);
+  TEST_MESSAGE(line);
+  TEST_MESSAGE("Segment            |    Rev         |   Tooth        |   AlphaBeta    |  2nd Deriv     |");
+  RUN_TEST(test_bench_crankmaths_clean);
+  RUN_TEST(test_bench_crankmaths_jitter);
+  UNITY_END();
+}
+
+void loop()
+{
+}
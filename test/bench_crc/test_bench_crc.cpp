@@ -0,0 +1,117 @@
+/*
+CRC32 benchmark: pio test -e native -f bench_crc (Also runs on the Mega: pio test -e megaatmega2560 -f bench_crc)
+
+This is the CRC32 part of the FastCRC_Benchmark example sketch (src/FastCRC/examples), as a test so that it runs on the host and the boards.
+Reports the time to CRC the benchmark buffer and a 288 byte page (The largest TS page) with whichever table method FastCRC was built with.
+To compare the methods, run it again with -DCRC_SLICE8=0 (Slice-by-4) added to build_flags.
+
+The results are also checked against a bit at a time CRC32 for every length up to 64 bytes and every alignment, which covers the
+start (Unaligned bytes), middle (16 byte blocks) and end (Remaining bytes) of FastCRC32::crc32_upd()
+*/
+#include <Arduino.h>
+#include <stdio.h>
+#include <unity.h>
+#include "src/FastCRC/FastCRC.h"
+#if defined(NATIVE_BOARD)
+  #include <chrono>
+#endif
+
+#if defined(NATIVE_BOARD)
+  #define BENCH_BUFSIZE (32 * 1024)
+  #define BENCH_RUNS    100
+#else
+  #define BENCH_BUFSIZE (1 * 1024) //Same as the example sketch
+  #define BENCH_RUNS    10
+#endif
+#define BENCH_PAGE_SIZE 288
+
+static uint8_t benchBuffer[BENCH_BUFSIZE];
+static FastCRC32 benchCRC32;
+static volatile uint32_t benchSink; //Stops the compiler throwing away the results
+
+//Timing is in nS on the host, but the micros() resolution on the AVR means uS per run is all there is
+static uint32_t benchNow(void)
+{
+#if defined(NATIVE_BOARD)
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return micros() * 1000UL;
+#endif
+}
+
+static uint32_t referenceCRC32(const uint8_t *data, uint16_t length)
+{
+  uint32_t crc = 0xFFFFFFFF;
+  for (uint16_t x = 0; x < length; x++)
+  {
+    crc ^= data[x];
+    for (uint8_t bit = 0; bit < 8; bit++) { crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320UL : 0); }
+  }
+  return ~crc;
+}
+
+static void benchReport(const char *name, uint16_t length, uint32_t start, uint32_t end)
+{
+  uint32_t time = (end - start) / BENCH_RUNS;
+  char line[100];
+  snprintf(line, sizeof(line), "%-24s %6u bytes %10lu nS %8lu nS/KB", name, length, (unsigned long)time, (unsigned long)((time * 1024.0) / length));
+  TEST_MESSAGE(line);
+}
+
+void test_crc32_check(void)
+{
+  //The standard check value
+  TEST_ASSERT_EQUAL_UINT32(0xCBF43926UL, benchCRC32.crc32((const uint8_t *)"123456789", 9));
+
+  for (uint8_t align = 0; align < 4; align++)
+  {
+    for (uint16_t length = 0; length <= 64; length++)
+    {
+      TEST_ASSERT_EQUAL_UINT32(referenceCRC32(&benchBuffer[align], length), benchCRC32.crc32(&benchBuffer[align], length));
+    }
+  }
+
+  //Updating in pieces gives the same result as all in one
+  benchCRC32.crc32(benchBuffer, 37, false);
+  uint32_t crc = benchCRC32.crc32_upd(&benchBuffer[37], BENCH_PAGE_SIZE - 37);
+  TEST_ASSERT_EQUAL_UINT32(referenceCRC32(benchBuffer, BENCH_PAGE_SIZE), crc);
+}
+
+void test_bench_crc32_buffer(void)
+{
+  uint32_t start = benchNow();
+  for (uint16_t n = 0; n < BENCH_RUNS; n++) { benchSink = benchCRC32.crc32(benchBuffer, BENCH_BUFSIZE); }
+  benchReport("Ethernet FastCRC", BENCH_BUFSIZE, start, benchNow());
+}
+
+void test_bench_crc32_page(void)
+{
+  uint32_t start = benchNow();
+  for (uint16_t n = 0; n < BENCH_RUNS; n++) { benchSink = benchCRC32.crc32(benchBuffer, BENCH_PAGE_SIZE); }
+  benchReport("Ethernet FastCRC (page)", BENCH_PAGE_SIZE, start, benchNow());
+}
+
+void setup()
+{
+  delay(2000); //Allow the serial port to come up on the Mega
+
+  //Fill array with testdata, the same as the example sketch
+  for (uint16_t i = 0; i < BENCH_BUFSIZE; i++) { benchBuffer[i] = (i + 1) & 0xff; }
+
+  UNITY_BEGIN();
+#if CRC_SLICE8
+  TEST_MESSAGE("CRC32 method: Slice-by-8");
+#elif CRC_BIGTABLES
+  TEST_MESSAGE("CRC32 method: Slice-by-4");
+#else
+  TEST_MESSAGE("CRC32 method: Byte table");
+#endif
+  RUN_TEST(test_crc32_check);
+  RUN_TEST(test_bench_crc32_buffer);
+  RUN_TEST(test_bench_crc32_page);
+  UNITY_END();
+}
+
+void loop()
+{
+}
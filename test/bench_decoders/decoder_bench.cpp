@@ -0,0 +1,396 @@
+#include <chrono>
+#include <vector>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <globals.h>
+#include <decoders.h>
+#include <init.h>
+#include "decoder_bench.h"
+
+void doCrankSpeedCalcs(); //crankMaths.h defines (rather than declares) its variables, so cannot be included here
+
+#define BENCH_PIN_PRIMARY   19
+#define BENCH_PIN_SECONDARY 18
+#define BENCH_PIN_TERTIARY  3
+
+#define BENCH_CRANKING_RPM  250
+#define BENCH_SETTLE_ANGLE  720 //Crank angle that sync must have been held for before getCrankAngle() is checked. Also the angle a constant RPM segment must have run for before it is counted as steady
+
+struct edgeRecord
+{
+  unsigned long time;
+  uint16_t rpm;
+  uint8_t input;
+  uint8_t level;
+};
+
+static triggerWheel wheel;
+
+//Cranking, then up to 8000rpm in steps with ramps of 4000-7000rpm/s between them, then a hard decel back to 1000rpm
+static const rpmSegment benchProfile[] =
+{
+  { 1000000, BENCH_CRANKING_RPM, BENCH_CRANKING_RPM },
+  {  500000, BENCH_CRANKING_RPM, 1000 },
+  {  500000, 1000, 1000 },
+  {  500000, 1000, 3000 },
+  {  300000, 3000, 3000 },
+  {  500000, 3000, 6000 },
+  {  300000, 6000, 6000 },
+  {  300000, 6000, 8000 },
+  {  300000, 8000, 8000 },
+  { 1000000, 8000, 1000 },
+  {  500000, 1000, 1000 },
+};
+static const rpmSegment syncProfile[] = { { 2000000, BENCH_CRANKING_RPM, BENCH_CRANKING_RPM } };
+//Crank, then hold 1000rpm. The edge is dropped once the steady speed has run for a while
+static const rpmSegment resyncProfile[] =
+{
+  { 1000000, BENCH_CRANKING_RPM, BENCH_CRANKING_RPM },
+  {  500000, BENCH_CRANKING_RPM, 1000 },
+  { 1000000, 1000, 1000 },
+};
+#define BENCH_RESYNC_DROP_TIME  1700000.0 //uS into resyncProfile that the first trial drops an edge
+#define BENCH_RESYNC_MARGIN     1.0 //Degrees over the decoders steady state error that counts as having lost the crank position
+
+//A primary edge that is not passed to the decoder, and how long the decoder then takes to get the crank angle right again
+struct droppedEdge
+{
+  double time;        //The first active primary edge at or after this time is dropped
+  double tolerance;   //Largest getCrankAngle() error that counts as being in sync
+  bool dropped;
+  double dropTime;    //Time the edge was dropped
+  double lastBadTime; //Last time the decoder had no sync or the angle was out by more than tolerance
+  bool badAtEnd;      //Whether that was still the case at the end of the profile
+  double syncLostTime; //Time hasSync was last dropped, or -1 if it hasn't been
+  double noSyncTime;  //Total time without hasSync after the drop, up to the end of the profile if it never came back
+};
+
+static void benchNullHandler() { }
+
+static bool edgeIsActive(uint8_t input, uint8_t level)
+{
+  byte edge = (input == SYNTH_PRIMARY) ? primaryTriggerEdge : secondaryTriggerEdge;
+  if(edge == CHANGE) { return true; }
+  if(edge == RISING) { return (level == HIGH); }
+  if(edge == FALLING) { return (level == LOW); }
+  return false; //No interrupt attached to this input
+}
+
+static void resetDecoder(const triggerPattern &pattern, double startAngle)
+{
+  setMicros(BENCH_START_TIME);
+
+  memset(&configPage2, 0, sizeof(configPage2));
+  memset(&configPage4, 0, sizeof(configPage4));
+  configPage2.nCylinders = 4;
+  configPage4.crankRPM = 40;
+  if(pattern.cycleAngle == 720)
+  {
+    configPage4.sparkMode = IGN_MODE_SEQUENTIAL;
+    configPage2.injLayout = INJ_SEQUENTIAL;
+  }
+  else
+  {
+    configPage4.sparkMode = IGN_MODE_WASTED;
+    configPage2.injLayout = INJ_PAIRED;
+  }
+  pattern.configure();
+  configPage4.TrigPattern = pattern.decoder;
+
+  CRANK_ANGLE_MAX = pattern.cycleAngle;
+  CRANK_ANGLE_MAX_IGN = pattern.cycleAngle;
+  CRANK_ANGLE_MAX_INJ = pattern.cycleAngle;
+  currentStatus.crankRPM = ((unsigned int)configPage4.crankRPM * 10);
+
+  //Same as the stall handling in loop(), plus the counters the individual decoders leave set
+  currentStatus.RPM = 0;
+  currentStatus.longRPM = 0;
+  currentStatus.rpmDOT = 0;
+  currentStatus.hasSync = false;
+  currentStatus.startRevolutions = 0;
+  currentStatus.syncLossCounter = 0;
+  currentStatus.engine = 0;
+  currentStatus.advance = 0;
+  toothLastToothTime = 0;
+  toothLastSecToothTime = 0;
+  toothLastMinusOneToothTime = 0;
+  toothOneTime = 0;
+  toothOneMinusOneTime = 0;
+  toothSystemCount = 0;
+  toothSystemLastToothTime = 0;
+  toothCurrentCount = 0;
+  secondaryToothCount = 0;
+  checkSyncToothCount = 0;
+  revolutionOne = 0;
+  triggerFilterTime = 0;
+  triggerSecFilterTime = 0;
+  curGap = 0;
+  lastGap = 0;
+
+  pinTrigger = BENCH_PIN_PRIMARY;
+  pinTrigger2 = BENCH_PIN_SECONDARY;
+  pinTrigger3 = BENCH_PIN_TERTIARY;
+  setDigitalValue(pinTrigger, wheelLevelAt(wheel, SYNTH_PRIMARY, startAngle));
+  setDigitalValue(pinTrigger2, wheelLevelAt(wheel, SYNTH_SECONDARY, startAngle));
+
+  initialiseTriggers();
+  if(pattern.wire != NULL) { pattern.wire(); }
+}
+
+//The parts of loop() that the decoders depend on
+static void loopTick()
+{
+  if( (toothLastToothTime > 0) && ((micros() - toothLastToothTime) < MAX_STALL_TIME) )
+  {
+    currentStatus.longRPM = getRPM();
+    currentStatus.RPM = currentStatus.longRPM;
+  }
+  else { currentStatus.RPM = 0; }
+  if( (currentStatus.hasSync == true) && (currentStatus.RPM > 0) ) { doCrankSpeedCalcs(); }
+}
+
+static double angleError(int decoderAngle, double trueAngle, uint16_t cycleAngle)
+{
+  double error = decoderAngle - fmod(trueAngle, cycleAngle);
+  if(error > (cycleAngle / 2)) { error -= cycleAngle; }
+  else if(error <= -(cycleAngle / 2)) { error += cycleAngle; }
+  return error;
+}
+
+/*
+Runs the wheel through the given RPM profile, feeding each edge to the decoder as it occurs and running the main loop every BENCH_LOOP_INTERVAL.
+If stopAtSync is set this returns as soon as the decoder has sync. Returns the time (uS) sync was first gained, or -1 if it never was
+*/
+static double runProfile(const triggerPattern &pattern, const rpmSegment *profile, uint8_t profileLength, double startAngle, bool stopAtSync, decoderBenchResult &result, std::vector<edgeRecord> *records, droppedEdge *drop)
+{
+  engineModel engine;
+  engineInit(engine, profile, profileLength, startAngle);
+
+  //Find the first edge after the start angle
+  double cycleStart = floor(startAngle / 720) * 720;
+  uint16_t edgeIndex = 0;
+  while( (edgeIndex < wheel.edgeCount) && ((cycleStart + wheel.edges[edgeIndex].angle) <= startAngle) ) { edgeIndex++; }
+
+  double nextLoopTime = BENCH_LOOP_INTERVAL;
+  double syncTime = -1;
+  double syncAngle = 0; //Angle sync was (most recently) gained at
+  bool hadSync = false;
+  double steadyErrorSum = 0;
+  uint8_t segment = 0;
+  double segmentStartAngle = startAngle;
+
+  result.edges = 0;
+  result.syncLosses = 0;
+  result.steadySamples = 0;
+  result.rampSamples = 0;
+  result.steadyErrorMax = 0;
+  result.rampErrorMax = 0;
+
+  while(engineFinished(engine) == false)
+  {
+    if(edgeIndex >= wheel.edgeCount) { edgeIndex = 0; cycleStart += 720; }
+    const synthEdge &edge = wheel.edges[edgeIndex];
+    double edgeTime = engineTimeAtAngle(engine, cycleStart + edge.angle);
+    if(edgeTime < 0) { break; } //Past the end of the profile
+
+    //Run the main loop until the edge is due
+    while(nextLoopTime < edgeTime)
+    {
+      engineAdvanceTime(engine, nextLoopTime);
+      setMicros(BENCH_START_TIME + lround(nextLoopTime));
+      loopTick();
+      if(engine.segment != segment) { segment = engine.segment; segmentStartAngle = engine.angle; }
+
+      if( (drop != NULL) && (drop->dropped == true) )
+      {
+        bool inSync = false;
+        if( (currentStatus.hasSync == true) && (currentStatus.RPM > 0) ) { inSync = (fabs(angleError(getCrankAngle(), engine.angle, pattern.cycleAngle)) <= drop->tolerance); }
+        if(inSync == false) { drop->lastBadTime = nextLoopTime; }
+        drop->badAtEnd = !inSync;
+      }
+      //As in loop(), getCrankAngle() is only used once there is sync and an RPM
+      else if( (hadSync == true) && (currentStatus.RPM > 0) && ((engine.angle - syncAngle) >= BENCH_SETTLE_ANGLE) )
+      {
+        int crankAngle = getCrankAngle();
+        double error = angleError(crankAngle, engine.angle, pattern.cycleAngle);
+        if( engineSegmentIsSteady(engine) && ((engine.angle - segmentStartAngle) >= BENCH_SETTLE_ANGLE) )
+        {
+          steadyErrorSum += error;
+          result.steadySamples++;
+          result.steadyErrorMax = max(result.steadyErrorMax, fabs(error));
+        }
+        else
+        {
+          result.rampSamples++;
+          result.rampErrorMax = max(result.rampErrorMax, fabs(error));
+        }
+      }
+      nextLoopTime += BENCH_LOOP_INTERVAL;
+    }
+
+    engineAdvanceTime(engine, edgeTime);
+    setMicros(BENCH_START_TIME + lround(edgeTime));
+    if(edge.input == SYNTH_PRIMARY) { setDigitalValue(pinTrigger, edge.level); }
+    else { setDigitalValue(pinTrigger2, edge.level); }
+
+    if( (drop != NULL) && (drop->dropped == false) && (edge.input == SYNTH_PRIMARY) && (edgeTime >= drop->time) && edgeIsActive(edge.input, edge.level) )
+    {
+      drop->dropped = true;
+      drop->dropTime = edgeTime;
+      drop->lastBadTime = edgeTime;
+    }
+    else if(edgeIsActive(edge.input, edge.level))
+    {
+      if(records != NULL) { records->push_back({ micros(), currentStatus.RPM, edge.input, edge.level }); }
+      if(edge.input == SYNTH_PRIMARY) { triggerHandler(); }
+      else { triggerSecondaryHandler(); }
+      result.edges++;
+    }
+
+    if( (drop != NULL) && (drop->dropped == true) && (currentStatus.hasSync != hadSync) )
+    {
+      if(currentStatus.hasSync == false) { drop->syncLostTime = edgeTime; }
+      else if(drop->syncLostTime >= 0) { drop->noSyncTime += edgeTime - drop->syncLostTime; drop->syncLostTime = -1; }
+    }
+
+    if( (currentStatus.hasSync == true) && (hadSync == false) )
+    {
+      if(syncTime < 0) { syncTime = edgeTime; }
+      syncAngle = engine.angle;
+      if(stopAtSync == true) { break; }
+    }
+    else if( (currentStatus.hasSync == false) && (hadSync == true) ) { result.syncLosses++; }
+    hadSync = currentStatus.hasSync;
+
+    edgeIndex++;
+  }
+
+  result.steadyErrorMean = (result.steadySamples > 0) ? (steadyErrorSum / result.steadySamples) : 0;
+  return syncTime;
+}
+
+//Replays recorded edges from a clean start, calling either the decoder or an empty handler. Returns the host time taken in nS
+static double replayEdges(const triggerPattern &pattern, const std::vector<edgeRecord> &records, bool useDecoder)
+{
+  resetDecoder(pattern, 719);
+  void (* volatile primary)() = useDecoder ? triggerHandler : benchNullHandler;
+  void (* volatile secondary)() = useDecoder ? triggerSecondaryHandler : benchNullHandler;
+
+  auto start = std::chrono::steady_clock::now();
+  for(size_t x = 0; x < records.size(); x++)
+  {
+    const edgeRecord &record = records[x];
+    setMicros(record.time);
+    currentStatus.RPM = record.rpm;
+    if(record.input == SYNTH_PRIMARY) { setDigitalValue(pinTrigger, record.level); primary(); }
+    else { setDigitalValue(pinTrigger2, record.level); secondary(); }
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+static double minEdgeInterval(double rpm)
+{
+  double minGap = 720;
+  double firstAngle = -1;
+  double lastAngle = -1;
+  for(uint16_t x = 0; x < wheel.edgeCount; x++)
+  {
+    if(edgeIsActive(wheel.edges[x].input, wheel.edges[x].level) == false) { continue; }
+    if(lastAngle >= 0) { minGap = min(minGap, wheel.edges[x].angle - lastAngle); }
+    else { firstAngle = wheel.edges[x].angle; }
+    lastAngle = wheel.edges[x].angle;
+  }
+  if(firstAngle >= 0) { minGap = min(minGap, (firstAngle + 720) - lastAngle); }
+  return minGap / (rpm * 6.0e-6);
+}
+
+void benchDecoder(const triggerPattern &pattern, decoderBenchResult &result)
+{
+  wheelClear(wheel);
+  pattern.build(wheel);
+  wheelSort(wheel);
+
+  //Time to sync from a number of different stopping points
+  result.syncTrialsPassed = 0;
+  result.syncEdgesMean = 0;
+  result.syncEdgesMax = 0;
+  result.syncTimeMean = 0;
+  result.syncTimeMax = 0;
+  for(uint8_t trial = 0; trial < BENCH_SYNC_TRIALS; trial++)
+  {
+    double startAngle = 1 + (trial * (720.0 / BENCH_SYNC_TRIALS));
+    resetDecoder(pattern, startAngle);
+    double syncTime = runProfile(pattern, syncProfile, 1, startAngle, true, result, NULL, NULL);
+    if(syncTime >= 0)
+    {
+      result.syncTrialsPassed++;
+      result.syncEdgesMean += result.edges;
+      result.syncEdgesMax = max(result.syncEdgesMax, result.edges);
+      result.syncTimeMean += syncTime / 1000;
+      result.syncTimeMax = max(result.syncTimeMax, syncTime / 1000);
+    }
+  }
+  if(result.syncTrialsPassed > 0)
+  {
+    result.syncEdgesMean /= result.syncTrialsPassed;
+    result.syncTimeMean /= result.syncTrialsPassed;
+  }
+
+  //Full RPM profile, starting just before tooth #1
+  std::vector<edgeRecord> records;
+  resetDecoder(pattern, 719);
+  runProfile(pattern, benchProfile, sizeof(benchProfile) / sizeof(benchProfile[0]), 719, false, result, &records, NULL);
+  result.minEdgeInterval = minEdgeInterval(8000);
+
+  //Time to re-sync after a dropped edge, with the drop moved through one cycle at 1000rpm
+  result.resyncTrialsPassed = 0;
+  result.resyncLosses = 0;
+  result.resyncTimeMean = 0;
+  result.resyncTimeMax = 0;
+  result.noSyncTrials = 0;
+  result.noSyncTimeMean = 0;
+  result.noSyncTimeMax = 0;
+  for(uint8_t trial = 0; trial < BENCH_RESYNC_TRIALS; trial++)
+  {
+    droppedEdge drop;
+    drop.time = BENCH_RESYNC_DROP_TIME + (trial * (120000.0 / BENCH_RESYNC_TRIALS)); //120mS is a 720 degree cycle at 1000rpm
+    drop.tolerance = result.steadyErrorMax + BENCH_RESYNC_MARGIN;
+    drop.dropped = false;
+    drop.badAtEnd = true;
+    drop.syncLostTime = -1;
+    drop.noSyncTime = 0;
+
+    decoderBenchResult trialResult;
+    resetDecoder(pattern, 719);
+    runProfile(pattern, resyncProfile, sizeof(resyncProfile) / sizeof(resyncProfile[0]), 719, false, trialResult, NULL, &drop);
+    result.resyncLosses += trialResult.syncLosses;
+    if( (drop.noSyncTime > 0) && (drop.syncLostTime < 0) )
+    {
+      result.noSyncTrials++;
+      result.noSyncTimeMean += drop.noSyncTime / 1000;
+      result.noSyncTimeMax = max(result.noSyncTimeMax, drop.noSyncTime / 1000);
+    }
+    if( (drop.dropped == true) && (drop.badAtEnd == false) )
+    {
+      double resyncTime = (drop.lastBadTime - drop.dropTime) / 1000;
+      result.resyncTrialsPassed++;
+      result.resyncTimeMean += resyncTime;
+      result.resyncTimeMax = max(result.resyncTimeMax, resyncTime);
+    }
+  }
+  if(result.resyncTrialsPassed > 0) { result.resyncTimeMean /= result.resyncTrialsPassed; }
+  if(result.noSyncTrials > 0) { result.noSyncTimeMean /= result.noSyncTrials; }
+
+  //Cost per edge
+  double decoderTime = 1e18;
+  double baseTime = 1e18;
+  for(uint8_t run = 0; run < BENCH_REPLAY_RUNS; run++)
+  {
+    decoderTime = min(decoderTime, replayEdges(pattern, records, true));
+    baseTime = min(baseTime, replayEdges(pattern, records, false));
+  }
+  result.nsPerEdge = (records.size() > 0) ? max(0.0, (decoderTime - baseTime) / records.size()) : 0;
+}
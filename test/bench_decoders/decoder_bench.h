@@ -0,0 +1,45 @@
+#ifndef DECODER_BENCH_H
+#define DECODER_BENCH_H
+
+#include "trigger_patterns.h"
+
+#define BENCH_SYNC_TRIALS     8     //Number of different starting angles that time to sync is measured from
+#define BENCH_LOOP_INTERVAL   250   //uS between runs of the (emulated) main loop, which is also when getCrankAngle() is sampled
+#define BENCH_REPLAY_RUNS     5     //Edge cost is the fastest of this many replays
+#define BENCH_START_TIME      1000000UL //Simulated micros() at the start of each run
+#define BENCH_RESYNC_TRIALS   8     //Number of different angles that a primary edge is dropped at to measure the time to re-sync
+
+struct decoderBenchResult
+{
+  //Time to sync, cranking at a constant speed
+  uint8_t syncTrialsPassed;
+  double syncEdgesMean;
+  uint32_t syncEdgesMax;
+  double syncTimeMean;      //mS
+  double syncTimeMax;       //mS
+
+  //Full RPM profile
+  uint32_t edges;           //Number of edges passed to the decoder
+  uint16_t syncLosses;
+  uint32_t steadySamples;
+  uint32_t rampSamples;
+  double steadyErrorMean;   //Mean of getCrankAngle() - true angle when the RPM is constant
+  double steadyErrorMax;    //Largest absolute error when the RPM is constant
+  double rampErrorMax;      //Largest absolute error when the RPM is ramping (Or has been constant for less than BENCH_SETTLE_ANGLE)
+  double minEdgeInterval;   //Shortest time between 2 edges at 8000rpm, uS
+
+  double nsPerEdge;         //Host time per call to the trigger handlers, less the cost of calling an empty handler
+
+  //Time to re-sync after a single primary edge is dropped at a steady 1000rpm
+  uint8_t resyncTrialsPassed;
+  uint16_t resyncLosses;    //Total times hasSync was dropped over all the trials
+  double resyncTimeMean;    //mS from the dropped edge until getCrankAngle() is back within the steady error, and stays there
+  double resyncTimeMax;     //mS
+  uint8_t noSyncTrials;     //Trials where hasSync was dropped and then regained
+  double noSyncTimeMean;    //mS from hasSync being dropped until the decoder had sync again, over those trials
+  double noSyncTimeMax;     //mS
+};
+
+void benchDecoder(const triggerPattern &pattern, decoderBenchResult &result);
+
+#endif
@@ -0,0 +1,60 @@
+/*
+Decoder benchmark. Native (host) build only: pio test -e native -f bench_decoders
+
+Every decoder is fed a synthetic version of its trigger wheel (See trigger_patterns.cpp) through a cranking + RPM sweep profile and reports:
+- Sync: How many edges / mS of cranking it takes to gain sync, from 8 different starting angles
+- Err:  getCrankAngle() minus the true crank angle, sampled every 250uS once sync has been held for a full cycle. Reported separately for constant RPM and for the acceleration/deceleration ramps
+- Cost: Host time per trigger interrupt. This is NOT the AVR time, but the relative cost between decoders holds well enough to compare them
+- Budget: Shortest time between 2 interrupts at 8000rpm, which the ISR (plus everything else) needs to fit within
+- Resync: With a single primary edge dropped at 8 different angles at 1000rpm, how many times the decoder got back in sync, the mS until getCrankAngle()
+  was right again and how many times hasSync was dropped on the way
+- No sync: For the trials where hasSync was dropped, the mS until the decoder had sync again
+*/
+#include <Arduino.h>
+#include <stdio.h>
+#include <unity.h>
+#include "decoder_bench.h"
+
+static uint8_t patternIndex;
+
+static void test_bench_decoder(void)
+{
+  const triggerPattern &pattern = triggerPatterns[patternIndex];
+  decoderBenchResult result;
+  benchDecoder(pattern, result);
+
+  char line[240];
+  snprintf(line, sizeof(line), "%-19s | %d/%d | %5.1f %4lu | %6.1f %6.1f | %6lu %3u | %6.2f %6.2f %6.2f | %6.1f | %6.1f | %d/%d %6.1f %6.1f %3u | %d %6.1f %6.1f",
+    pattern.name,
+    result.syncTrialsPassed, BENCH_SYNC_TRIALS, result.syncEdgesMean, (unsigned long)result.syncEdgesMax, result.syncTimeMean, result.syncTimeMax,
+    (unsigned long)result.edges, result.syncLosses,
+    result.steadyErrorMean, result.steadyErrorMax, result.rampErrorMax,
+    result.nsPerEdge, result.minEdgeInterval,
+    result.resyncTrialsPassed, BENCH_RESYNC_TRIALS, result.resyncTimeMean, result.resyncTimeMax, result.resyncLosses,
+    result.noSyncTrials, result.noSyncTimeMean, result.noSyncTimeMax);
+  TEST_MESSAGE(line);
+
+  if(pattern.knownIssue != NULL) { TEST_IGNORE_MESSAGE(pattern.knownIssue); }
+
+  //Every decoder must be able to find sync from any starting point on its own wheel and then hold it through the profile
+  TEST_ASSERT_EQUAL(BENCH_SYNC_TRIALS, result.syncTrialsPassed);
+  TEST_ASSERT_EQUAL(0, result.syncLosses);
+  TEST_ASSERT_TRUE(result.steadySamples > 0);
+}
+
+void setup()
+{
+  UNITY_BEGIN();
+
+  TEST_MESSAGE("Decoder             | Sync| edges  max |   mS     max |  Edges lost| Err: mean    max   ramp |  nS/edge | uS@8000 | Resync    mS    max lost | No sync mS   max");
+  for(patternIndex = 0; patternIndex < triggerPatternCount; patternIndex++)
+  {
+    RUN_TEST(test_bench_decoder);
+  }
+
+  UNITY_END();
+}
+
+void loop()
+{
+}
@@ -0,0 +1,321 @@
+#include <globals.h>
+#include <decoders.h>
+#include "trigger_patterns.h"
+
+/*
+Each wheel below is derived from the decoders own description of the pattern (toothAngles[], sync rules etc) in decoders.ino
+Widths of the teeth only matter for decoders that read the level of an input (CHANGE edges, or checking the other input during sync)
+*/
+
+//Missing tooth wheels with a single tooth cam just before tooth #1 of the first revolution
+static void buildMissingTooth(triggerWheel &wheel, uint8_t teeth, uint8_t missing)
+{
+  double toothAngle = 360.0 / teeth;
+  for(uint8_t x = 0; x < (teeth - missing); x++) { wheelAddCrankTooth(wheel, SYNTH_PRIMARY, x * toothAngle, (x * toothAngle) + (toothAngle / 2)); }
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 705, 708);
+}
+static void configMissingTooth36_1()
+{
+  configPage4.triggerTeeth = 36;
+  configPage4.triggerMissingTeeth = 1;
+  configPage4.TrigSpeed = CRANK_SPEED;
+  configPage4.trigPatternSec = SEC_TRIGGER_SINGLE;
+}
+static void buildMissingTooth36_1(triggerWheel &wheel) { buildMissingTooth(wheel, 36, 1); }
+static void configMissingTooth60_2()
+{
+  configPage4.triggerTeeth = 60;
+  configPage4.triggerMissingTeeth = 2;
+  configPage4.TrigSpeed = CRANK_SPEED;
+  configPage4.trigPatternSec = SEC_TRIGGER_SINGLE;
+}
+static void buildMissingTooth60_2(triggerWheel &wheel) { buildMissingTooth(wheel, 60, 2); }
+
+//1 tooth per cylinder over 720 degrees
+static void configBasicDistributor() { configPage2.nCylinders = 4; }
+static void buildBasicDistributor(triggerWheel &wheel)
+{
+  for(uint8_t x = 0; x < 4; x++) { wheelAddTooth(wheel, SYNTH_PRIMARY, x * 180, (x * 180) + 20); }
+}
+
+//12 evenly spaced crank teeth. The cam tooth sets the next crank tooth to be #1
+static void configDualWheel()
+{
+  configPage4.triggerTeeth = 12;
+  configPage4.TrigSpeed = CRANK_SPEED;
+  configPage4.useResync = 1;
+}
+static void buildDualWheel(triggerWheel &wheel)
+{
+  for(uint8_t x = 0; x < 12; x++) { wheelAddCrankTooth(wheel, SYNTH_PRIMARY, x * 30, (x * 30) + 15); }
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 710, 715);
+}
+
+//6 even teeth plus the sync tooth 10 degrees after tooth #2. Tooth #1 is 42 degrees ATDC
+static void configGM7X() { }
+static void buildGM7X(triggerWheel &wheel)
+{
+  static const double angles[] = { 42, 102, 112, 162, 222, 282, 342 };
+  for(uint8_t x = 0; x < 7; x++) { wheelAddCrankTooth(wheel, SYNTH_PRIMARY, angles[x], angles[x] + 5); }
+}
+
+//4 cylinder: 70 degree high windows every 180 degrees (Both edges are used). The cam is high for the crank window at 285-355 and falls during the window at 645-715
+static void config4G63() { configPage2.nCylinders = 4; }
+static void build4G63(triggerWheel &wheel)
+{
+  for(uint8_t x = 0; x < 4; x++) { wheelAddTooth(wheel, SYNTH_PRIMARY, 105 + (x * 180), 175 + (x * 180)); }
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 200, 400);
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 560, 690);
+}
+
+//24 crank teeth at the decoders toothAngles[]. The cam changes level once per revolution, at 0 degrees
+static void config24X() { }
+static void build24X(triggerWheel &wheel)
+{
+  static const double angles[] = { 12, 18, 33, 48, 63, 78, 102, 108, 123, 138, 162, 177, 183, 198, 222, 237, 252, 258, 282, 288, 312, 327, 342, 357 };
+  for(uint8_t x = 0; x < 24; x++) { wheelAddCrankTooth(wheel, SYNTH_PRIMARY, angles[x], angles[x] + 2); }
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 0, 360);
+}
+
+//3 groups of 4 teeth (20 degrees apart) per revolution. The cam changes level 28 degrees before tooth #1
+static void configJeep2000() { }
+static void buildJeep2000(triggerWheel &wheel)
+{
+  for(uint8_t group = 0; group < 3; group++)
+  {
+    for(uint8_t x = 0; x < 4; x++)
+    {
+      double angle = 174 + (group * 120) + (x * 20);
+      wheelAddCrankTooth(wheel, SYNTH_PRIMARY, angle, angle + 5);
+    }
+  }
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 146, 506);
+}
+
+//135 even teeth on the crank (Only every 3rd is used by the decoder), single cam tooth just before tooth #1
+static void configAudi135() { configPage4.useResync = 1; }
+static void buildAudi135(triggerWheel &wheel)
+{
+  double toothAngle = 360.0 / 135;
+  for(uint8_t x = 0; x < 135; x++) { wheelAddCrankTooth(wheel, SYNTH_PRIMARY, x * toothAngle, (x * toothAngle) + (toothAngle / 2)); }
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 718.5, 730);
+}
+
+//12 even teeth plus a 13th, 10 degrees after tooth #12
+static void configHondaD17() { }
+static void buildHondaD17(triggerWheel &wheel)
+{
+  for(uint8_t x = 0; x < 12; x++) { wheelAddCrankTooth(wheel, SYNTH_PRIMARY, x * 30, (x * 30) + 5); }
+  wheelAddCrankTooth(wheel, SYNTH_PRIMARY, 340, 345);
+}
+
+//4 crank edges per revolution. Single cam tooth before tooth #2 (100), double cam tooth before tooth #6 (460)
+static void configMiata9905() { configPage2.nCylinders = 4; }
+static void buildMiata9905(triggerWheel &wheel)
+{
+  static const double angles[] = { 100, 170, 280, 350 };
+  for(uint8_t x = 0; x < 4; x++) { wheelAddCrankTooth(wheel, SYNTH_PRIMARY, angles[x], angles[x] + 10); }
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 40, 45);
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 390, 395);
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 420, 425);
+}
+
+//4 uneven crank teeth per revolution. Cam has a single tooth and a pair of close teeth (The 2nd of the pair is at 421)
+static void configMazdaAU() { configPage2.nCylinders = 4; }
+static void buildMazdaAU(triggerWheel &wheel)
+{
+  static const double angles[] = { 96, 168, 276, 348 };
+  for(uint8_t x = 0; x < 4; x++) { wheelAddCrankTooth(wheel, SYNTH_PRIMARY, angles[x], angles[x] + 10); }
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 55, 60);
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 395, 400);
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 416, 421);
+}
+
+//14 tooth crank wheel, which does not divide into 360 evenly (TrigAngMul of 7 gives 180 'degrees' per tooth)
+static void configNon360()
+{
+  configPage4.triggerTeeth = 14;
+  configPage4.TrigAngMul = 7;
+  configPage4.TrigSpeed = CRANK_SPEED;
+  configPage4.useResync = 1;
+}
+static void buildNon360(triggerWheel &wheel)
+{
+  double toothAngle = 360.0 / 14;
+  for(uint8_t x = 0; x < 14; x++) { wheelAddCrankTooth(wheel, SYNTH_PRIMARY, x * toothAngle, (x * toothAngle) + (toothAngle / 2)); }
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 700, 715);
+}
+
+//360 slots at cam speed (2 crank degrees each). 4 cylinder cam windows of 16, 12, 8 and 4 slots that end at teeth #16, #102, #188 and #274
+static void configNissan360()
+{
+  configPage2.nCylinders = 4;
+  configPage4.TrigEdgeSec = 1; //Windows are high
+}
+static void buildNissan360(triggerWheel &wheel)
+{
+  static const uint16_t windowEnds[] = { 16, 102, 188, 274 };
+  static const uint8_t windowLengths[] = { 16, 12, 8, 4 };
+  for(uint16_t x = 0; x < 360; x++) { wheelAddTooth(wheel, SYNTH_PRIMARY, x * 2, (x * 2) + 1); }
+  for(uint8_t x = 0; x < 4; x++)
+  {
+    //Window edges fall half way between primary edges
+    double end = ((windowEnds[x] - 1) * 2) + 1.5;
+    wheelAddTooth(wheel, SYNTH_SECONDARY, end - (windowLengths[x] * 2), end);
+  }
+}
+
+//12 crank teeth over 720 degrees at the decoders toothAngles[]. 7 cam teeth in groups of 3, 1, 2 and 1, each group 3 crank teeth apart
+static void configSubaru67() { configPage2.nCylinders = 4; }
+static void buildSubaru67(triggerWheel &wheel)
+{
+  static const double crankAngles[] = { 83, 115, 170, 263, 295, 350 };
+  static const double camAngles[] = { 10, 30, 50, 200, 380, 400, 560 };
+  for(uint8_t x = 0; x < 6; x++) { wheelAddCrankTooth(wheel, SYNTH_PRIMARY, crankAngles[x], crankAngles[x] + 5); }
+  for(uint8_t x = 0; x < 7; x++) { wheelAddTooth(wheel, SYNTH_SECONDARY, camAngles[x] - 5, camAngles[x]); } //Falling edge
+}
+
+//1 tooth per cylinder plus an extra tooth 30 degrees after tooth #1, over 720 degrees
+static void configDaihatsu() { configPage2.nCylinders = 4; }
+static void buildDaihatsu(triggerWheel &wheel)
+{
+  static const double angles[] = { 0, 30, 180, 360, 540 };
+  for(uint8_t x = 0; x < 5; x++) { wheelAddTooth(wheel, SYNTH_PRIMARY, angles[x], angles[x] + 5); }
+}
+
+//2 uneven teeth per revolution, 157 degrees apart
+static void configHarley() { }
+static void buildHarley(triggerWheel &wheel)
+{
+  wheelAddCrankTooth(wheel, SYNTH_PRIMARY, 0, 20);
+  wheelAddCrankTooth(wheel, SYNTH_PRIMARY, 157, 177);
+}
+
+//H4 version of 36-2-2-2. Teeth #14, #15, #17, #18, #32 and #33 are missing
+static void config36_2_2_2()
+{
+  configPage2.nCylinders = 4;
+  configPage4.triggerTeeth = 36;
+  configPage4.TrigSpeed = CRANK_SPEED;
+}
+static void build36_2_2_2(triggerWheel &wheel)
+{
+  for(uint8_t tooth = 1; tooth <= 36; tooth++)
+  {
+    if( (tooth == 14) || (tooth == 15) || (tooth == 17) || (tooth == 18) || (tooth == 32) || (tooth == 33) ) { continue; }
+    wheelAddCrankTooth(wheel, SYNTH_PRIMARY, (tooth - 1) * 10, ((tooth - 1) * 10) + 5);
+  }
+}
+
+//36-2-1: Double gap before tooth #1, single gap where tooth #19 would be
+static void config36_2_1()
+{
+  configPage4.triggerTeeth = 36;
+  configPage4.TrigSpeed = CRANK_SPEED;
+}
+static void build36_2_1(triggerWheel &wheel)
+{
+  for(uint8_t tooth = 1; tooth <= 34; tooth++)
+  {
+    if(tooth == 19) { continue; }
+    wheelAddCrankTooth(wheel, SYNTH_PRIMARY, (tooth - 1) * 10, ((tooth - 1) * 10) + 5);
+  }
+}
+/*
+Wheels run on the generic decoder with their own pattern descriptors. These are hooked up as a 36-2-1 (Which is a generic decoder pattern) and
+then switched to the descriptor being tested
+*/
+static void configGeneric()
+{
+  configPage2.nCylinders = 4;
+  configPage4.TrigEdgeSec = 0;
+}
+
+//36-1 crank plus a single cam tooth, the same wheel as buildMissingTooth36_1()
+static const uint16_t genericAngles36_1[] = { 0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 110, 120, 130, 140, 150, 160, 170,
+                                              180, 190, 200, 210, 220, 230, 240, 250, 260, 270, 280, 290, 300, 310, 320, 330, 340 };
+static const uint8_t genericCounts36_1[] = { 1, 0 };
+static const triggerPatternDescriptor genericPattern36_1 = { 720, 360, 35, genericAngles36_1, genericCounts36_1 };
+static void wireGeneric36_1() { triggerSetup_Generic(genericPattern36_1); }
+
+//H4 36-2-2-2, the same wheel as build36_2_2_2()
+static const uint16_t genericAngles36_2_2_2[] = { 0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 110, 120, 150, 180, 190, 200, 210,
+                                                  220, 230, 240, 250, 260, 270, 280, 290, 300, 330, 340, 350 };
+static const triggerPatternDescriptor genericPattern36_2_2_2 = { 360, 360, 30, genericAngles36_2_2_2, NULL };
+static void wireGeneric36_2_2_2() { triggerSetup_Generic(genericPattern36_2_2_2); }
+
+//Subaru 6/7, the same wheel as buildSubaru67(). The crank pattern repeats every 180 degrees and the cam groups of 3, 1, 2 and 1 teeth tell them apart
+static const uint16_t genericAnglesSubaru67[] = { 83, 115, 170 };
+static const uint8_t genericCountsSubaru67[] = { 3, 1, 2, 1 };
+static const triggerPatternDescriptor genericPatternSubaru67 = { 720, 180, 3, genericAnglesSubaru67, genericCountsSubaru67 };
+static void wireGenericSubaru67()
+{
+  triggerSetup_Generic(genericPatternSubaru67);
+  secondaryTriggerEdge = FALLING;
+}
+
+//16 crank teeth over 720 degrees at the decoders toothAngles[]. Cam falls with the crank low after tooth #5 and with the crank high after tooth #13
+static void config420a() { configPage2.nCylinders = 4; }
+static void build420a(triggerWheel &wheel)
+{
+  static const double angles[] = { 111, 131, 151, 171, 291, 311, 331, 351 };
+  for(uint8_t x = 0; x < 8; x++) { wheelAddCrankTooth(wheel, SYNTH_PRIMARY, angles[x], angles[x] + 10); }
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 175, 185);
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 525, 535);
+}
+
+//4 crank teeth 90 degrees apart, 2 cam teeth 180 crank degrees apart. The cam teeth come just after tooth #1 and #3 of the 2nd revolution
+static void configWeber()
+{
+  configPage4.triggerTeeth = 4;
+  configPage4.TrigSpeed = CRANK_SPEED;
+  configPage4.useResync = 1;
+}
+static void buildWeber(triggerWheel &wheel)
+{
+  for(uint8_t x = 0; x < 4; x++) { wheelAddCrankTooth(wheel, SYNTH_PRIMARY, x * 90, (x * 90) + 10); }
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 365, 370);
+  wheelAddTooth(wheel, SYNTH_SECONDARY, 545, 550);
+}
+
+//36-1 crank with an 8-3 cam (Teeth 90 crank degrees apart, the first after the gap is just before tooth #1)
+static void configST170()
+{
+  configPage4.trigPatternSec = SEC_TRIGGER_4_1; //Anything other than single tooth so the missing tooth primary leaves secondaryToothCount alone
+}
+static void buildST170(triggerWheel &wheel)
+{
+  static const double camAngles[] = { 75, 165, 255, 345, 705 };
+  for(uint8_t x = 0; x < 35; x++) { wheelAddCrankTooth(wheel, SYNTH_PRIMARY, x * 10, (x * 10) + 5); }
+  for(uint8_t x = 0; x < 5; x++) { wheelAddTooth(wheel, SYNTH_SECONDARY, camAngles[x], camAngles[x] + 3); }
+}
+
+const triggerPattern triggerPatterns[] =
+{
+  { "Missing tooth 36-1", DECODER_MISSING_TOOTH,     720, configMissingTooth36_1, buildMissingTooth36_1, NULL, NULL },
+  { "Missing tooth 60-2", DECODER_MISSING_TOOTH,     720, configMissingTooth60_2, buildMissingTooth60_2, NULL, NULL },
+  { "Basic distributor",  DECODER_BASIC_DISTRIBUTOR, 360, configBasicDistributor, buildBasicDistributor, NULL, NULL },
+  { "Dual wheel 12/1",    DECODER_DUAL_WHEEL,        720, configDualWheel,        buildDualWheel,        NULL, NULL },
+  { "GM 7X",              DECODER_GM7X,              360, configGM7X,             buildGM7X,             NULL, NULL },
+  { "4G63",               DECODER_4G63,              720, config4G63,             build4G63,             NULL, NULL },
+  { "GM 24X",             DECODER_24X,               360, config24X,              build24X,              NULL, NULL },
+  { "Jeep 2000",          DECODER_JEEP2000,          360, configJeep2000,         buildJeep2000,         NULL, NULL },
+  { "Audi 135",           DECODER_AUDI135,           720, configAudi135,          buildAudi135,          NULL, NULL },
+  { "Honda D17",          DECODER_HONDA_D17,         360, configHondaD17,         buildHondaD17,         NULL, NULL },
+  { "Miata 99-05",        DECODER_MIATA_9905,        720, configMiata9905,        buildMiata9905,        NULL, NULL },
+  { "Mazda AU",           DECODER_MAZDA_AU,          360, configMazdaAU,          buildMazdaAU,          NULL, "Sync needs the 1st cam gap to be less than 2x the 2nd, but the 1st gap is timed from toothLastSecToothTime = 0" },
+  { "Non-360 14/1",       DECODER_NON360,            360, configNon360,           buildNon360,           NULL, NULL },
+  { "Nissan 360",         DECODER_NISSAN_360,        720, configNissan360,        buildNissan360,        NULL, NULL },
+  { "Subaru 6/7",         DECODER_SUBARU_67,         720, configSubaru67,         buildSubaru67,         NULL, NULL },
+  { "Daihatsu +1",        DECODER_DAIHATSU_PLUS1,    720, configDaihatsu,         buildDaihatsu,         NULL, NULL },
+  { "Harley",             DECODER_HARLEY,            360, configHarley,           buildHarley,           NULL, NULL },
+  { "36-2-2-2 (H4)",      DECODER_36_2_2_2,          360, config36_2_2_2,         build36_2_2_2,         NULL, NULL },
+  { "36-2-1",             DECODER_36_2_1,            360, config36_2_1,           build36_2_1,           NULL, NULL },
+  { "DSM 420a",           DECODER_420A,              720, config420a,             build420a,             NULL, NULL },
+  { "Weber-Marelli",      DECODER_WEBER,             720, configWeber,            buildWeber,            NULL, "The first cam pulse is always rejected by the secondary filter. If that was the pulse after tooth #1, sync is 180 degrees out" },
+  { "Ford ST170",         DECODER_ST170,             720, configST170,            buildST170,            NULL, NULL },
+  { "Generic 36-1 + cam", DECODER_36_2_1,            720, configGeneric,          buildMissingTooth36_1, wireGeneric36_1, NULL },
+  { "Generic 36-2-2-2",   DECODER_36_2_1,            360, configGeneric,          build36_2_2_2,         wireGeneric36_2_2_2, NULL },
+  { "Generic Subaru 6/7", DECODER_36_2_1,            720, configGeneric,          buildSubaru67,         wireGenericSubaru67, NULL },
+};
+const uint8_t triggerPatternCount = sizeof(triggerPatterns) / sizeof(triggerPatterns[0]);
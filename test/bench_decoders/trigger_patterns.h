@@ -0,0 +1,27 @@
+#ifndef TRIGGER_PATTERNS_H
+#define TRIGGER_PATTERNS_H
+
+#include "trigger_synth.h"
+
+/*
+Describes one decoder and a synthetic wheel that it is able to decode.
+configure() is run before initialiseTriggers() and sets only the config values the decoder needs. All other config is zeroed by the benchmark.
+wire() is optional and is run after initialiseTriggers(). It is only needed for decoders that initialiseTriggers() does not hook up itself.
+The wheels are built so that the decoders tooth #1 reference is at 0 degrees.
+knownIssue is NULL unless the decoder is known to not cope with its own wheel. The results are still reported, but the test is ignored rather than failed.
+*/
+struct triggerPattern
+{
+  const char *name;
+  uint8_t decoder;        //DECODER_* value
+  uint16_t cycleAngle;    //The CRANK_ANGLE_MAX the decoder is run with (720 for decoders that can do full sequential)
+  void (*configure)(void);
+  void (*build)(triggerWheel &wheel);
+  void (*wire)(void);
+  const char *knownIssue;
+};
+
+extern const triggerPattern triggerPatterns[];
+extern const uint8_t triggerPatternCount;
+
+#endif
@@ -0,0 +1,159 @@
+#include <math.h>
+#include <stdlib.h>
+#include <Arduino.h>
+#include "trigger_synth.h"
+
+static double wrap720(double angle)
+{
+  angle = fmod(angle, 720.0);
+  if(angle < 0) { angle += 720.0; }
+  return angle;
+}
+
+static void wheelAddEdge(triggerWheel &wheel, uint8_t input, double angle, uint8_t level)
+{
+  if(wheel.edgeCount >= SYNTH_MAX_EDGES) { return; }
+  wheel.edges[wheel.edgeCount].angle = wrap720(angle);
+  wheel.edges[wheel.edgeCount].input = input;
+  wheel.edges[wheel.edgeCount].level = level;
+  wheel.edgeCount++;
+}
+
+void wheelClear(triggerWheel &wheel)
+{
+  wheel.edgeCount = 0;
+}
+
+void wheelAddTooth(triggerWheel &wheel, uint8_t input, double riseAngle, double fallAngle)
+{
+  wheelAddEdge(wheel, input, riseAngle, HIGH);
+  wheelAddEdge(wheel, input, fallAngle, LOW);
+}
+
+void wheelAddCrankTooth(triggerWheel &wheel, uint8_t input, double riseAngle, double fallAngle)
+{
+  wheelAddTooth(wheel, input, riseAngle, fallAngle);
+  wheelAddTooth(wheel, input, riseAngle + 360, fallAngle + 360);
+}
+
+static int compareEdges(const void *a, const void *b)
+{
+  const synthEdge *edgeA = (const synthEdge *)a;
+  const synthEdge *edgeB = (const synthEdge *)b;
+  if(edgeA->angle < edgeB->angle) { return -1; }
+  if(edgeA->angle > edgeB->angle) { return 1; }
+  return (int)edgeA->input - (int)edgeB->input;
+}
+
+void wheelSort(triggerWheel &wheel)
+{
+  qsort(wheel.edges, wheel.edgeCount, sizeof(synthEdge), compareEdges);
+}
+
+uint8_t wheelLevelAt(const triggerWheel &wheel, uint8_t input, double angle)
+{
+  //Level is set by the last edge on this input before the angle, wrapping around to the last edge of the cycle if needed
+  angle = wrap720(angle);
+  uint8_t level = LOW;
+  bool found = false;
+  for(uint16_t x = 0; x < wheel.edgeCount; x++)
+  {
+    if(wheel.edges[x].input != input) { continue; }
+    if(wheel.edges[x].angle <= angle) { level = wheel.edges[x].level; found = true; }
+    else if(found == false) { level = wheel.edges[x].level; } //Keeps the last edge of the cycle until one before the angle is found (Edges are sorted)
+  }
+  return level;
+}
+
+/*
+Engine model
+Within a segment RPM(t) = startRPM + k.t, so angle(t) = 6e-6 * (startRPM.t + k.t^2/2) degrees for t in uS
+*/
+#define DEG_PER_US_PER_RPM  6.0e-6
+
+static double segmentSlope(const rpmSegment &segment)
+{
+  return (segment.endRPM - segment.startRPM) / segment.duration;
+}
+
+static double segmentAngle(const rpmSegment &segment, double time)
+{
+  return DEG_PER_US_PER_RPM * ( (segment.startRPM * time) + (segmentSlope(segment) * time * time * 0.5) );
+}
+
+void engineInit(engineModel &engine, const rpmSegment *segments, uint8_t segmentCount, double startAngle)
+{
+  engine.segmentCount = min(segmentCount, (uint8_t)SYNTH_MAX_SEGMENTS);
+  for(uint8_t x = 0; x < engine.segmentCount; x++) { engine.segments[x] = segments[x]; }
+  engine.segment = 0;
+  engine.segmentTime = 0;
+  engine.time = 0;
+  engine.angle = startAngle;
+}
+
+bool engineFinished(const engineModel &engine)
+{
+  return (engine.segment >= engine.segmentCount);
+}
+
+double engineRPM(const engineModel &engine)
+{
+  if(engineFinished(engine)) { return engine.segments[engine.segmentCount - 1].endRPM; }
+  const rpmSegment &segment = engine.segments[engine.segment];
+  return segment.startRPM + (segmentSlope(segment) * engine.segmentTime);
+}
+
+bool engineSegmentIsSteady(const engineModel &engine)
+{
+  if(engineFinished(engine)) { return true; }
+  return (engine.segments[engine.segment].startRPM == engine.segments[engine.segment].endRPM);
+}
+
+void engineAdvanceTime(engineModel &engine, double time)
+{
+  while( (engine.time < time) && (engineFinished(engine) == false) )
+  {
+    const rpmSegment &segment = engine.segments[engine.segment];
+    double step = min(time - engine.time, segment.duration - engine.segmentTime);
+
+    engine.angle += segmentAngle(segment, engine.segmentTime + step) - segmentAngle(segment, engine.segmentTime);
+    engine.segmentTime += step;
+    engine.time += step;
+
+    if(engine.segmentTime >= segment.duration)
+    {
+      engine.segment++;
+      engine.segmentTime = 0;
+    }
+  }
+}
+
+double engineTimeAtAngle(const engineModel &engine, double angle)
+{
+  uint8_t segmentIndex = engine.segment;
+  double segmentTime = engine.segmentTime;
+  double time = engine.time;
+  double remaining = angle - engine.angle;
+
+  while(segmentIndex < engine.segmentCount)
+  {
+    const rpmSegment &segment = engine.segments[segmentIndex];
+    double segmentRemaining = segmentAngle(segment, segment.duration) - segmentAngle(segment, segmentTime);
+    if(remaining <= segmentRemaining)
+    {
+      //Solve a.t^2 + b.t - angle = 0 for the time from the start of the segment
+      double target = remaining + segmentAngle(segment, segmentTime);
+      double a = DEG_PER_US_PER_RPM * segmentSlope(segment) * 0.5;
+      double b = DEG_PER_US_PER_RPM * segment.startRPM;
+      double t;
+      if(fabs(a) < 1e-15) { t = target / b; }
+      else { t = (-b + sqrt((b * b) + (4 * a * target))) / (2 * a); }
+      return time + (t - segmentTime);
+    }
+    remaining -= segmentRemaining;
+    time += segment.duration - segmentTime;
+    segmentTime = 0;
+    segmentIndex++;
+  }
+  return -1;
+}
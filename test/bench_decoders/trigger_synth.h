@@ -0,0 +1,69 @@
+/** @file
+ * Trigger pattern synthesizer for the decoder benchmark.
+ *
+ * A trigger wheel is described as a list of input edges over one full 720 degree engine cycle. An engine model then turns an RPM
+ * profile (A list of constant or linearly ramping RPM segments) into the exact time each of those edges occurs, as well as the true
+ * crank angle at any point in time so that the decoders' getCrankAngle() can be checked against it.
+ *
+ * All angles are in crank degrees relative to the decoders tooth #1 reference (ie what getCrankAngle() should return with a triggerAngle of 0).
+ * All times are in uS.
+ */
+#ifndef TRIGGER_SYNTH_H
+#define TRIGGER_SYNTH_H
+
+#include <stdint.h>
+
+#define SYNTH_PRIMARY     0
+#define SYNTH_SECONDARY   1
+
+#define SYNTH_MAX_EDGES   1024
+#define SYNTH_MAX_SEGMENTS 16
+
+struct synthEdge
+{
+  double angle;   //Crank angle within the 720 degree cycle that the edge occurs at
+  uint8_t input;  //SYNTH_PRIMARY or SYNTH_SECONDARY
+  uint8_t level;  //The level of the input AFTER this edge
+};
+
+struct triggerWheel
+{
+  synthEdge edges[SYNTH_MAX_EDGES];
+  uint16_t edgeCount;
+};
+
+void wheelClear(triggerWheel &wheel);
+void wheelAddTooth(triggerWheel &wheel, uint8_t input, double riseAngle, double fallAngle); //Adds a tooth that is high from riseAngle to fallAngle (Once per 720 degrees)
+void wheelAddCrankTooth(triggerWheel &wheel, uint8_t input, double riseAngle, double fallAngle); //As above, but repeated every 360 degrees
+void wheelSort(triggerWheel &wheel);
+uint8_t wheelLevelAt(const triggerWheel &wheel, uint8_t input, double angle); //The level of an input at the given angle
+
+/*
+The engine model. Speed is piecewise linear in time, which gives a constant angular acceleration within each segment
+*/
+struct rpmSegment
+{
+  double duration; //uS
+  double startRPM;
+  double endRPM;
+};
+
+struct engineModel
+{
+  rpmSegment segments[SYNTH_MAX_SEGMENTS];
+  uint8_t segmentCount;
+
+  uint8_t segment;      //Current segment
+  double segmentTime;   //Time into the current segment
+  double time;          //Time since the start of the profile
+  double angle;         //Unwrapped crank angle
+};
+
+void engineInit(engineModel &engine, const rpmSegment *segments, uint8_t segmentCount, double startAngle);
+bool engineFinished(const engineModel &engine);
+double engineRPM(const engineModel &engine);
+bool engineSegmentIsSteady(const engineModel &engine);
+void engineAdvanceTime(engineModel &engine, double time); //Moves the engine forward to the given (absolute) time
+double engineTimeAtAngle(const engineModel &engine, double angle); //Returns the (absolute) time the engine will reach the given unwrapped angle. Returns a negative value if this is beyond the end of the profile
+
+#endif
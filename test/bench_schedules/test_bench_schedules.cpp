@@ -0,0 +1,142 @@
+/*
+Schedule benchmark: pio test -e native -f bench_schedules (Also runs on the Mega: pio test -e megaatmega2560 -f bench_schedules)
+
+Reports the time per call of setting a fuel and ignition schedule and of the 2 interrupts (start and end) that each one then takes.
+The schedule functions are templates on the channels timer (See scheduler.h), so they are run here with a bench timer whose counter and compare are plain variables.
+On the Mega the schedule timer registers are in the extended I/O space and are read and written with the same lds/sts instructions as RAM, so this costs the same as a real channel.
+
+Each is timed twice:
+- Direct: The timer functions are inlined, as they are for the real channels
+- Indirect: The timer functions are called through a table of function pointers, as they were before the schedules were templates on the timer
+The difference between the two is the cost of the indirect calls (And the registers they force the interrupt to save) in every schedule interrupt.
+
+The interrupts are called directly rather than waiting for the timer. The timeout and duration are long enough that the real interrupt never fires during a run.
+Host times are only useful to compare against each other, the AVR times are the ones that matter
+*/
+#include <Arduino.h>
+#include <stdio.h>
+#include <unity.h>
+#include "globals.h"
+#include "scheduler.h"
+#if defined(NATIVE_BOARD)
+  #include <chrono>
+#endif
+
+#define BENCH_SCHEDULES 1000  //Per timed run
+#define BENCH_TIMEOUT   50000 //uS
+#define BENCH_DURATION  50000 //uS
+
+static volatile uint8_t benchCallbacks; //Stops the compiler throwing away the callbacks
+static void benchCallback(void) { benchCallbacks++; }
+
+//The bench timer. The counter moves on by 1 tick each time it is read, as a running timer would
+static volatile COUNTER_TYPE benchCounter;
+static volatile COMPARE_TYPE benchCompare;
+static volatile bool benchTimerEnabled;
+
+struct benchDirectTimer {
+  static inline COUNTER_TYPE counter() { return benchCounter++; }
+  static inline void setCompare(COMPARE_TYPE value) { benchCompare = value; }
+  static inline void enable() { benchTimerEnabled = true; }
+  static inline void disable() { benchTimerEnabled = false; }
+};
+
+//The same timer behind a table of function pointers. This is not const so that the compiler can't resolve the calls itself
+struct benchTimerFunctions {
+  COUNTER_TYPE (*counter)();
+  void (*setCompare)(COMPARE_TYPE value);
+  void (*enable)();
+  void (*disable)();
+};
+struct benchTimerFunctions benchTimer = { benchDirectTimer::counter, benchDirectTimer::setCompare, benchDirectTimer::enable, benchDirectTimer::disable };
+
+struct benchIndirectTimer {
+  static inline COUNTER_TYPE counter() { return benchTimer.counter(); }
+  static inline void setCompare(COMPARE_TYPE value) { benchTimer.setCompare(value); }
+  static inline void enable() { benchTimer.enable(); }
+  static inline void disable() { benchTimer.disable(); }
+};
+
+//Timing is in nS on the host, but the micros() resolution on the AVR means uS per run is all there is
+static uint32_t benchNow(void)
+{
+#if defined(NATIVE_BOARD)
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return micros() * 1000UL;
+#endif
+}
+
+static void benchReport(const char *name, uint32_t setTime, uint32_t startTime, uint32_t endTime)
+{
+  char line[100];
+  snprintf(line, sizeof(line), "%-14s %8lu %8lu %8lu nS/call", name, (unsigned long)(setTime / BENCH_SCHEDULES), (unsigned long)(startTime / BENCH_SCHEDULES), (unsigned long)(endTime / BENCH_SCHEDULES));
+  TEST_MESSAGE(line);
+}
+
+template <typename TTimer>
+static void benchFuelSchedule(const char *name, struct FuelSchedule &schedule)
+{
+  schedule.StartCallback = benchCallback;
+  schedule.EndCallback = benchCallback;
+  uint32_t setTime = 0, startTime = 0, endTime = 0;
+  for (uint16_t n = 0; n < BENCH_SCHEDULES; n++)
+  {
+    uint32_t time1 = benchNow();
+    setFuelSchedule<TTimer>(schedule, BENCH_TIMEOUT, BENCH_DURATION);
+    uint32_t time2 = benchNow();
+    fuelScheduleISR<TTimer>(schedule); //PENDING -> RUNNING
+    uint32_t time3 = benchNow();
+    fuelScheduleISR<TTimer>(schedule); //RUNNING -> OFF
+    uint32_t time4 = benchNow();
+    setTime += time2 - time1;
+    startTime += time3 - time2;
+    endTime += time4 - time3;
+  }
+  benchReport(name, setTime, startTime, endTime);
+  TEST_ASSERT_EQUAL(OFF, schedule.Status);
+}
+
+template <typename TTimer>
+static void benchIgnitionSchedule(const char *name, struct Schedule &schedule)
+{
+  uint32_t setTime = 0, startTime = 0, endTime = 0;
+  for (uint16_t n = 0; n < BENCH_SCHEDULES; n++)
+  {
+    uint32_t time1 = benchNow();
+    setIgnitionSchedule<TTimer>(schedule, benchCallback, BENCH_TIMEOUT, BENCH_DURATION, benchCallback);
+    uint32_t time2 = benchNow();
+    ignitionScheduleISR<TTimer>(schedule); //PENDING -> RUNNING
+    uint32_t time3 = benchNow();
+    ignitionScheduleISR<TTimer>(schedule); //RUNNING -> OFF
+    uint32_t time4 = benchNow();
+    setTime += time2 - time1;
+    startTime += time3 - time2;
+    endTime += time4 - time3;
+  }
+  benchReport(name, setTime, startTime, endTime);
+  TEST_ASSERT_EQUAL(OFF, schedule.Status);
+}
+
+void test_bench_fuel_direct(void) { benchFuelSchedule<benchDirectTimer>("Fuel direct", fuelSchedule1); }
+void test_bench_fuel_indirect(void) { benchFuelSchedule<benchIndirectTimer>("Fuel indirect", fuelSchedule1); }
+void test_bench_ignition_direct(void) { benchIgnitionSchedule<benchDirectTimer>("Ign direct", ignitionSchedule1); }
+void test_bench_ignition_indirect(void) { benchIgnitionSchedule<benchIndirectTimer>("Ign indirect", ignitionSchedule1); }
+
+void setup()
+{
+  delay(2000); //Allow the serial port to come up on the Mega
+  initialiseSchedulers();
+
+  UNITY_BEGIN();
+  TEST_MESSAGE("Timer               set    start      end");
+  RUN_TEST(test_bench_fuel_direct);
+  RUN_TEST(test_bench_fuel_indirect);
+  RUN_TEST(test_bench_ignition_direct);
+  RUN_TEST(test_bench_ignition_indirect);
+  UNITY_END();
+}
+
+void loop()
+{
+}
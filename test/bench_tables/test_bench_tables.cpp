@@ -0,0 +1,186 @@
+/*
+3D table lookup benchmark: pio test -e native -f bench_tables (Also runs on the Mega: pio test -e megaatmega2560 -f bench_tables)
+
+Reports the time per call of:
+- The interpolation weights (p and q) using a 32-bit division for each axis, as the lookup used to do
+- The same weights using the per bin reciprocals that table3D_axisChanged() calculates (See table3D_binWeight() in table.h)
+- A full get3DTableValue() lookup with both inputs changing on every call, so that the table cache is never hit
+- The same with the X input jumping to a different bin on every call. This used to need a division for each new bin
+- Reading a whole 16x16 table page the way TunerStudio does, one getPageValue() call per byte and as a single getPageValues() block
+
+Host times are only useful to compare the methods against each other, the AVR times are the ones that matter
+*/
+#include <Arduino.h>
+#include <stdio.h>
+#include <unity.h>
+#include "table.h"
+#include "pages.h"
+#if defined(NATIVE_BOARD)
+  #include <chrono>
+#endif
+
+#define BENCH_LOOKUPS   1000 //Per timed run
+#define BENCH_INPUTS    64   //Number of different X/Y inputs swept through
+#define BENCH_PAGE_READS 50  //Per timed run of the page reads
+
+static Table3D<16> benchTable;
+static int16_t benchX[BENCH_INPUTS];
+static int16_t benchY[BENCH_INPUTS];
+static int16_t benchJumpX[BENCH_INPUTS];
+static volatile uint32_t benchSink; //Stops the compiler throwing away the results
+
+//Timing is in nS on the host, but the micros() resolution on the AVR means uS per run is all there is
+static uint32_t benchNow(void)
+{
+#if defined(NATIVE_BOARD)
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return micros() * 1000UL;
+#endif
+}
+
+static void setup_BenchTable(void)
+{
+  const int16_t xAxis[16] = {500,700, 900, 1200, 1600, 2000, 2500, 3100, 3500, 4100, 4700, 5300, 5900, 6500, 6750, 7000};
+  const int16_t yAxis[16] = {100, 96, 90, 86, 76, 70, 66, 60, 56, 50, 46, 40, 36, 30, 26, 16};
+  for (byte x = 0; x < 16; x++) { benchTable.axisX[x] = xAxis[x]; }
+  for (byte y = 0; y < 16; y++) { benchTable.axisY[y] = yAxis[y]; }
+  for (uint16_t x = 0; x < (16 * 16); x++) { benchTable.values[x] = (x * 7) & 0xFF; } //No 2 neighbouring cells are the same, so every lookup interpolates
+  table3D_axisChanged(&benchTable);
+
+  //Step through the table a little at a time, the same as the engine would, so that most lookups stay within the same bins
+  for (byte i = 0; i < BENCH_INPUTS; i++)
+  {
+    benchX[i] = 1900 + (i * 13);
+    benchY[i] = 72 - (i / 8);
+    benchJumpX[i] = 550 + ((i * 7) % 15) * 430; //Every 7th bin along, wrapping, so that no 2 lookups in a row are in the same or a neighbouring bin
+  }
+}
+
+//The bins for the inputs above. 2000-2500 and 70-66 cover most of them
+struct benchBin
+{
+  int16_t xMin, xMax, yMin, yMax;
+  uint8_t xRecip, yRecip;
+};
+static benchBin benchBins[BENCH_INPUTS];
+
+static void setup_BenchBins(void)
+{
+  for (byte i = 0; i < BENCH_INPUTS; i++)
+  {
+    byte x = 0;
+    while( (x < 14) && (benchTable.axisX[x+1] <= benchX[i]) ) { x++; }
+    byte y = 0;
+    while( (y < 14) && (benchTable.axisY[y+1] >= benchY[i]) ) { y++; }
+    benchBins[i].xMin = benchTable.axisX[x];
+    benchBins[i].xMax = benchTable.axisX[x+1];
+    benchBins[i].yMin = benchTable.axisY[y];
+    benchBins[i].yMax = benchTable.axisY[y+1];
+    benchBins[i].xRecip = benchTable.binRecips[x];
+    benchBins[i].yRecip = benchTable.binRecips[15 + y];
+  }
+}
+
+static void benchReport(const char *name, uint32_t start, uint32_t end, uint16_t calls = BENCH_LOOKUPS)
+{
+  char line[80];
+  snprintf(line, sizeof(line), "%-28s %8lu nS/call", name, (unsigned long)((end - start) / calls));
+  TEST_MESSAGE(line);
+}
+
+void test_bench_weightsDivision(void)
+{
+  uint32_t start = benchNow();
+  for (uint16_t n = 0; n < BENCH_LOOKUPS; n++)
+  {
+    const byte i = n & (BENCH_INPUTS - 1);
+    const benchBin &bin = benchBins[i];
+    unsigned long p = (long)benchX[i] - bin.xMin;
+    p = ( (p << TABLE_SHIFT_FACTOR) / (bin.xMax - bin.xMin) );
+    unsigned long q = (long)benchY[i] - bin.yMax;
+    q = TABLE_SHIFT_POWER - ( (q << TABLE_SHIFT_FACTOR) / (bin.yMin - bin.yMax) );
+    benchSink = p + q;
+  }
+  benchReport("Weights (division)", start, benchNow());
+}
+
+void test_bench_weightsReciprocal(void)
+{
+  uint32_t start = benchNow();
+  for (uint16_t n = 0; n < BENCH_LOOKUPS; n++)
+  {
+    const byte i = n & (BENCH_INPUTS - 1);
+    const benchBin &bin = benchBins[i];
+    uint16_t p = table3D_binWeight(benchX[i] - bin.xMin, bin.xMax - bin.xMin, bin.xRecip);
+    uint16_t q = table3D_binWeight(benchY[i] - bin.yMax, bin.yMin - bin.yMax, bin.yRecip);
+    benchSink = p + (TABLE_SHIFT_POWER - q);
+  }
+  benchReport("Weights (reciprocal)", start, benchNow());
+}
+
+void test_bench_lookup(void)
+{
+  uint32_t start = benchNow();
+  for (uint16_t n = 0; n < BENCH_LOOKUPS; n++)
+  {
+    const byte i = n & (BENCH_INPUTS - 1);
+    benchSink = get3DTableValue(&benchTable, benchY[i], benchX[i]);
+  }
+  benchReport("get3DTableValue()", start, benchNow());
+}
+
+void test_bench_lookupNewBin(void)
+{
+  uint32_t start = benchNow();
+  for (uint16_t n = 0; n < BENCH_LOOKUPS; n++)
+  {
+    const byte i = n & (BENCH_INPUTS - 1);
+    benchSink = get3DTableValue(&benchTable, benchY[i], benchJumpX[i]);
+  }
+  benchReport("get3DTableValue() new bin", start, benchNow());
+}
+
+void test_bench_pageReadBytes(void)
+{
+  byte page[288];
+  uint32_t start = benchNow();
+  for (uint16_t n = 0; n < BENCH_PAGE_READS; n++)
+  {
+    for (uint16_t x = 0; x < sizeof(page); x++) { page[x] = getPageValue(veMapPage, x); }
+    benchSink = page[n];
+  }
+  benchReport("Page read (getPageValue)", start, benchNow(), BENCH_PAGE_READS);
+}
+
+void test_bench_pageReadBlock(void)
+{
+  byte page[288];
+  uint32_t start = benchNow();
+  for (uint16_t n = 0; n < BENCH_PAGE_READS; n++)
+  {
+    getPageValues(veMapPage, 0, page, sizeof(page));
+    benchSink = page[n];
+  }
+  benchReport("Page read (getPageValues)", start, benchNow(), BENCH_PAGE_READS);
+}
+
+void setup()
+{
+  delay(2000); //Allow the serial port to come up on the Mega
+  setup_BenchTable();
+  setup_BenchBins();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_bench_weightsDivision);
+  RUN_TEST(test_bench_weightsReciprocal);
+  RUN_TEST(test_bench_lookup);
+  RUN_TEST(test_bench_lookupNewBin);
+  RUN_TEST(test_bench_pageReadBytes);
+  RUN_TEST(test_bench_pageReadBlock);
+  UNITY_END();
+}
+
+void loop()
+{
+}
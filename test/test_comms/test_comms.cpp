@@ -0,0 +1,208 @@
+/*
+Serial protocol tests: pio test -e native -f test_comms
+These feed requests into the serial port of the native board and check what is sent back, so they only run on the native environment
+*/
+#include <Arduino.h>
+#include <unity.h>
+#include "globals.h"
+#include "comms.h"
+#include "comms_frame.h"
+#include "src/FastCRC/FastCRC.h"
+
+static FastCRC32 testCRC32;
+
+static void test_comms_reset(void)
+{
+  while(Serial.read() >= 0) { }
+  Serial.clearTx();
+  cmdPending = false;
+  while(serialFramePending() == true) { serialReceive(); }
+  Serial.clearTx();
+}
+
+//Runs the main loop serial handling until there is nothing left to do
+static void test_comms_run(void)
+{
+  for(uint16_t x = 0; (x < 2000) && ((Serial.available() > 0) || (serialFramePending() == true)); x++) { serialReceive(); }
+}
+
+static void test_comms_send_frame(const uint8_t *payload, uint16_t length)
+{
+  uint32_t crc = testCRC32.crc32(payload, length);
+  uint8_t header[2] = { highByte(length), lowByte(length) };
+  uint8_t footer[4] = { (uint8_t)(crc >> 24), (uint8_t)(crc >> 16), (uint8_t)(crc >> 8), (uint8_t)crc };
+  Serial.injectRx(header, sizeof(header));
+  Serial.injectRx(payload, length);
+  Serial.injectRx(footer, sizeof(footer));
+}
+
+//Checks that exactly one well formed frame has been sent and returns its payload length
+static uint16_t test_comms_check_response(uint8_t returnCode)
+{
+  const uint8_t *tx = Serial.txBuffer();
+  TEST_ASSERT_TRUE(Serial.txLength() >= 7);
+  uint16_t length = word(tx[0], tx[1]);
+  TEST_ASSERT_EQUAL(length + 6, Serial.txLength());
+  TEST_ASSERT_EQUAL_UINT8(returnCode, tx[2]);
+
+  uint32_t crc = testCRC32.crc32(&tx[2], length);
+  uint32_t sentCRC = ((uint32_t)tx[length + 2] << 24) | ((uint32_t)tx[length + 3] << 16) | ((uint32_t)tx[length + 4] << 8) | tx[length + 5];
+  TEST_ASSERT_EQUAL_UINT32(crc, sentCRC);
+  return length;
+}
+
+void test_comms_frame_signature(void)
+{
+  test_comms_reset();
+  const uint8_t request[] = { 'Q' };
+  test_comms_send_frame(request, sizeof(request));
+  test_comms_run();
+
+  uint16_t length = test_comms_check_response(SERIAL_RC_OK);
+  TEST_ASSERT_EQUAL(1 + strlen(TS_SIGNATURE), length);
+  TEST_ASSERT_EQUAL_MEMORY(TS_SIGNATURE, &Serial.txBuffer()[3], strlen(TS_SIGNATURE));
+}
+
+void test_comms_frame_crc_error(void)
+{
+  test_comms_reset();
+  const uint8_t request[] = { 0, 1, 'Q', 0x12, 0x34, 0x56, 0x78 };
+  Serial.injectRx(request, sizeof(request));
+  test_comms_run();
+
+  TEST_ASSERT_EQUAL(1, test_comms_check_response(SERIAL_RC_CRC_ERROR));
+}
+
+void test_comms_frame_unknown(void)
+{
+  test_comms_reset();
+  const uint8_t request[] = { 'X' };
+  test_comms_send_frame(request, sizeof(request));
+  test_comms_run();
+
+  TEST_ASSERT_EQUAL(1, test_comms_check_response(SERIAL_RC_UNKNOWN));
+}
+
+void test_comms_frame_partial(void)
+{
+  //A frame that arrives over several loops is only answered once it is complete
+  test_comms_reset();
+  const uint8_t request[] = { 'c' };
+  uint32_t crc = testCRC32.crc32(request, sizeof(request));
+  const uint8_t frame[] = { 0, 1, 'c', (uint8_t)(crc >> 24), (uint8_t)(crc >> 16), (uint8_t)(crc >> 8), (uint8_t)crc };
+  currentStatus.loopsPerSecond = 0x1234;
+
+  Serial.injectRx(frame, 4);
+  serialReceive();
+  TEST_ASSERT_TRUE(serialFramePending());
+  TEST_ASSERT_EQUAL(0, Serial.txLength());
+
+  Serial.injectRx(&frame[4], sizeof(frame) - 4);
+  test_comms_run();
+  TEST_ASSERT_EQUAL(3, test_comms_check_response(SERIAL_RC_OK));
+  TEST_ASSERT_EQUAL_UINT8(0x34, Serial.txBuffer()[3]);
+  TEST_ASSERT_EQUAL_UINT8(0x12, Serial.txBuffer()[4]);
+}
+
+void test_comms_frame_timeout(void)
+{
+  //A frame that never completes is dropped and the next one is answered
+  test_comms_reset();
+  const uint8_t partial[] = { 0, 5, 'p' };
+  Serial.injectRx(partial, sizeof(partial));
+  serialReceive();
+  TEST_ASSERT_TRUE(serialFramePending());
+
+  setMicros(micros() + ((SERIAL_FRAME_TIMEOUT + 1) * 1000UL));
+  serialReceive();
+  TEST_ASSERT_FALSE(serialFramePending());
+
+  const uint8_t request[] = { 'C' };
+  test_comms_send_frame(request, sizeof(request));
+  test_comms_run();
+  TEST_ASSERT_EQUAL(2, test_comms_check_response(SERIAL_RC_OK));
+}
+
+void test_comms_legacy_signature(void)
+{
+  test_comms_reset();
+  Serial.injectRx((const uint8_t *)"Q", 1);
+  test_comms_run();
+
+  TEST_ASSERT_EQUAL(strlen(TS_SIGNATURE), Serial.txLength());
+  TEST_ASSERT_EQUAL_MEMORY(TS_SIGNATURE, Serial.txBuffer(), strlen(TS_SIGNATURE));
+}
+
+void test_comms_legacy_calibration(void)
+{
+  //The coolant table is taken in a piece at a time as it arrives rather than waiting for all of it
+  test_comms_reset();
+  uint8_t values[64];
+  for(uint8_t x = 0; x < 32; x++)
+  {
+    values[x * 2] = lowByte(2120); //212.0F = 100C
+    values[(x * 2) + 1] = highByte(2120);
+  }
+  const uint8_t start[] = { 't', 0 };
+  Serial.injectRx(start, sizeof(start));
+  Serial.injectRx(values, 33); //Part way through a value
+  test_comms_run();
+  TEST_ASSERT_TRUE(cmdPending);
+  TEST_ASSERT_EQUAL(100 + CALIBRATION_TEMPERATURE_OFFSET, cltCalibration_values[15]);
+
+  Serial.injectRx(&values[33], sizeof(values) - 33);
+  test_comms_run();
+  TEST_ASSERT_FALSE(cmdPending);
+  TEST_ASSERT_EQUAL(100 + CALIBRATION_TEMPERATURE_OFFSET, cltCalibration_values[31]);
+  TEST_ASSERT_EQUAL(31 * 32, cltCalibration_bins[31]);
+}
+
+void test_comms_frame_calibration(void)
+{
+  //The same table sent as 2 framed requests
+  test_comms_reset();
+  uint8_t request[4 + 32];
+  request[0] = 't';
+  request[1] = 1; //IAT
+  for(uint8_t x = 0; x < 16; x++)
+  {
+    request[4 + (x * 2)] = lowByte(320); //32.0F = 0C
+    request[4 + (x * 2) + 1] = highByte(320);
+  }
+  for(uint16_t offset = 0; offset < 64; offset += 32)
+  {
+    request[2] = lowByte(offset);
+    request[3] = highByte(offset);
+    test_comms_send_frame(request, sizeof(request));
+    test_comms_run();
+    test_comms_check_response(SERIAL_RC_OK);
+    Serial.clearTx();
+  }
+  TEST_ASSERT_EQUAL(CALIBRATION_TEMPERATURE_OFFSET, iatCalibration_values[31]);
+
+  //Skipping ahead is rejected
+  request[2] = 96;
+  test_comms_send_frame(request, sizeof(request));
+  test_comms_run();
+  test_comms_check_response(SERIAL_RC_RANGE);
+}
+
+void setup()
+{
+  delay(2000);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_comms_frame_signature);
+  RUN_TEST(test_comms_frame_crc_error);
+  RUN_TEST(test_comms_frame_unknown);
+  RUN_TEST(test_comms_frame_partial);
+  RUN_TEST(test_comms_frame_timeout);
+  RUN_TEST(test_comms_legacy_signature);
+  RUN_TEST(test_comms_legacy_calibration);
+  RUN_TEST(test_comms_frame_calibration);
+  UNITY_END();
+}
+
+void loop()
+{
+}
@@ -321,6 +321,29 @@ void test_dualwheel_newIgn_4()
 
 }
 
+void test_dualwheel_blank_config()
+{
+    //A blank config has 0 teeth. The decoders that divide by the tooth count (And the non-360 angle multiplier) must start without a divide by 0, and must leave the tune alone
+    configPage4.triggerTeeth = 0;
+    configPage4.TrigAngMul = 0;
+    configPage4.TrigSpeed = CRANK_SPEED;
+    configPage2.nCylinders = 0;
+
+    triggerSetup_DualWheel();
+    TEST_ASSERT_EQUAL(90, triggerToothAngle);
+    triggerSetup_non360();
+    TEST_ASSERT_EQUAL(90, triggerToothAngle);
+    triggerSetup_missingTooth();
+    TEST_ASSERT_EQUAL(90, triggerToothAngle);
+    triggerSetup_BasicDistributor();
+    triggerSetup_Daihatsu();
+    triggerSetup_ThirtySixMinus222();
+    TEST_ASSERT_EQUAL(0, configPage4.triggerTeeth);
+    TEST_ASSERT_EQUAL(0, configPage4.TrigAngMul);
+
+    configPage2.nCylinders = 4;
+}
+
 void testDualWheel()
 {
   RUN_TEST(test_dualwheel_newIgn_12_1_trig0_1);
@@ -346,4 +369,6 @@ void testDualWheel()
 */
   //RUN_TEST(test_dualwheel_newIgn_60_2_trig181_2);
   //RUN_TEST(test_dualwheel_newIgn_60_2_trig182_2);
-}
\ No newline at end of file
+
+  RUN_TEST(test_dualwheel_blank_config);
+}
@@ -0,0 +1,70 @@
+#include <decoders.h>
+#include <globals.h>
+#include <unity.h>
+#include "gm7x.h"
+
+#define GM7X_US_PER_DEGREE 100UL
+
+static void test_setup_gm7x()
+{
+    configPage2.perToothIgn = false;
+    currentStatus.hasSync = false;
+    triggerSetup_GM7X();
+    triggerHandler = triggerPri_GM7X;
+
+    //Start on tooth #2 with a steady 60 degree gap already seen
+    toothCurrentCount = 2;
+    toothLastMinusOneToothTime = micros() - (2 * 60 * GM7X_US_PER_DEGREE);
+    toothLastToothTime = micros() - (60 * GM7X_US_PER_DEGREE);
+    curGap = 60 * GM7X_US_PER_DEGREE;
+}
+
+//Sends the next tooth the given number of degrees after the last one
+static void test_gm7x_tooth(uint16_t degrees)
+{
+    toothLastMinusOneToothTime = toothLastToothTime;
+    toothLastToothTime = micros() - (degrees * GM7X_US_PER_DEGREE);
+    triggerPrimaryISR();
+}
+
+void test_gm7x_sync_on_extra_tooth()
+{
+    test_setup_gm7x();
+    test_gm7x_tooth(10); //The extra reference tooth, 10 degrees after tooth #2
+    TEST_ASSERT_TRUE(currentStatus.hasSync);
+    TEST_ASSERT_EQUAL(3, toothCurrentCount);
+}
+
+void test_gm7x_tooth_angle_is_correct()
+{
+    //Only the 60 degree gaps can be used as triggerToothAngle. The gaps either side of the extra tooth (10 and 50 degrees) can't
+    test_setup_gm7x();
+    test_gm7x_tooth(10);
+    TEST_ASSERT_FALSE(triggerToothAngleIsCorrect);
+
+    test_gm7x_tooth(50);
+    TEST_ASSERT_EQUAL(4, toothCurrentCount);
+    TEST_ASSERT_FALSE(triggerToothAngleIsCorrect);
+
+    for(uint8_t tooth = 5; tooth <= 7; tooth++)
+    {
+        test_gm7x_tooth(60);
+        TEST_ASSERT_EQUAL(tooth, toothCurrentCount);
+        TEST_ASSERT_TRUE(triggerToothAngleIsCorrect);
+        TEST_ASSERT_EQUAL(60, triggerToothAngle);
+    }
+
+    test_gm7x_tooth(60);
+    TEST_ASSERT_EQUAL(1, toothCurrentCount);
+    TEST_ASSERT_TRUE(triggerToothAngleIsCorrect);
+    test_gm7x_tooth(60);
+    TEST_ASSERT_EQUAL(2, toothCurrentCount);
+    TEST_ASSERT_TRUE(triggerToothAngleIsCorrect);
+    TEST_ASSERT_TRUE(currentStatus.hasSync);
+}
+
+void testGM7X()
+{
+  RUN_TEST(test_gm7x_sync_on_extra_tooth);
+  RUN_TEST(test_gm7x_tooth_angle_is_correct);
+}
@@ -0,0 +1 @@
+void testGM7X();
@@ -13,6 +13,7 @@ void test_setup_36_1()
     configPage4.trigPatternSec = SEC_TRIGGER_SINGLE;
 
     triggerSetup_missingTooth();
+    triggerHandler = triggerPri_missingTooth;
 }
 
 void test_setup_60_2()
@@ -24,6 +25,7 @@ void test_setup_60_2()
     configPage4.trigPatternSec = SEC_TRIGGER_SINGLE;
 
     triggerSetup_missingTooth();
+    triggerHandler = triggerPri_missingTooth;
 }
 
 //************************************** Begin the new ignition setEndTooth tests **************************************
@@ -342,6 +344,205 @@ void test_missingtooth_newIgn_4()
 
 }
 
+void test_missingtooth_newIgn_allChannels()
+{
+    //Test that every channel is set and that changing the wheel recalculates channels whose end angle has not changed. Conditions:
+    //Trigger: 36-1 then 60-2
+    //triggerAngle=0
+    test_setup_36_1();
+    configPage4.sparkMode = IGN_MODE_WASTED;
+    configPage4.triggerAngle = 0;
+    ignition1EndAngle = 350;
+    ignition2EndAngle = 170;
+    ignition3EndAngle = 0; //Falls before tooth 1, so wraps around and is limited to the last tooth before the gap
+    ignition4EndAngle = 355;
+
+    triggerSetEndTeeth_missingTooth();
+    TEST_ASSERT_EQUAL(34, ignition1EndTooth);
+    TEST_ASSERT_EQUAL(16, ignition2EndTooth);
+    TEST_ASSERT_EQUAL(35, ignition3EndTooth);
+    TEST_ASSERT_EQUAL(34, ignition4EndTooth);
+
+    test_setup_60_2();
+    triggerSetEndTeeth_missingTooth();
+    TEST_ASSERT_EQUAL(57, ignition1EndTooth);
+    TEST_ASSERT_EQUAL(27, ignition2EndTooth);
+    TEST_ASSERT_EQUAL(58, ignition3EndTooth);
+    TEST_ASSERT_EQUAL(58, ignition4EndTooth);
+}
+
+//Moves time on by uS. The re-sync places teeth from the time since tooth #1, so time has to actually move
+static void test_missingtooth_wait(unsigned long uS)
+{
+#if defined(NATIVE_BOARD)
+    setMicros(micros() + uS);
+#else
+    delayMicroseconds(uS);
+#endif
+}
+
+//Sends the next tooth gap uS after the last one
+static void test_missingtooth_tooth(unsigned long gap)
+{
+    test_missingtooth_wait(gap);
+    triggerPrimaryISR();
+}
+
+//Sends a revolution of a 36-1 wheel at gap uS per tooth, starting with the missing tooth gap. The cam pulse comes half way after camTooth (0 for none)
+static void test_missingtooth_revolution(unsigned long gap, uint8_t camTooth)
+{
+    test_missingtooth_tooth(2 * gap);
+    for(uint8_t tooth = 2; tooth <= 35; tooth++)
+    {
+        if(tooth == (camTooth + 1))
+        {
+            test_missingtooth_wait(gap >> 1);
+            triggerSec_missingTooth();
+            test_missingtooth_tooth(gap - (gap >> 1));
+        }
+        else { test_missingtooth_tooth(gap); }
+    }
+}
+
+//Starts a 36-1 wheel at a steady 1000uS per tooth and sends 2 revolutions, so that the speed over the last revolution is known.
+//This is followed by the gap to tooth #1 and then the given number of teeth
+static void test_missingtooth_resync_setup(uint8_t teeth)
+{
+    test_setup_36_1();
+    configPage4.sparkMode = IGN_MODE_WASTED;
+    configPage2.injLayout = INJ_PAIRED;
+    configPage4.triggerFilter = 0;
+    configPage2.perToothIgn = false;
+    configPage6.vvtEnabled = 0;
+    currentStatus.RPM = 0; //Below 2000rpm, so every tooth is checked for the gap
+    currentStatus.hasSync = false;
+    currentStatus.syncLossCounter = 0;
+    toothLastSecToothTime = 0;
+    toothLastToothTime = micros() + 1000000;
+    toothLastMinusOneToothTime = toothLastToothTime - 1000;
+    setMicros(toothLastToothTime);
+
+    test_missingtooth_revolution(1000, 0);
+    test_missingtooth_revolution(1000, 0);
+    test_missingtooth_tooth(2000);
+    for(uint8_t x = 0; x < teeth; x++) { test_missingtooth_tooth(1000); }
+}
+
+void test_missingtooth_resync_dropped_tooth()
+{
+    //Tooth #12 doesn't register, so #13 arrives with the count on 12. The gap is 2 teeth wide and too early to be the missing tooth
+    test_missingtooth_resync_setup(10);
+    TEST_ASSERT_TRUE(currentStatus.hasSync);
+    TEST_ASSERT_EQUAL(11, toothCurrentCount);
+
+    test_missingtooth_tooth(2000);
+    TEST_ASSERT_TRUE(currentStatus.hasSync);
+    TEST_ASSERT_EQUAL(13, toothCurrentCount);
+    TEST_ASSERT_EQUAL(0, currentStatus.syncLossCounter);
+
+    //The real gap then comes where it should
+    for(uint8_t x = 13; x < 35; x++) { test_missingtooth_tooth(1000); }
+    TEST_ASSERT_EQUAL(35, toothCurrentCount);
+    test_missingtooth_tooth(2000);
+    TEST_ASSERT_TRUE(currentStatus.hasSync);
+    TEST_ASSERT_EQUAL(1, toothCurrentCount);
+    TEST_ASSERT_EQUAL(0, currentStatus.syncLossCounter);
+}
+
+void test_missingtooth_resync_near_gap()
+{
+    //A dropped tooth #34 looks the same as the real gap after miscounted teeth. The time since tooth #1 tells them apart
+    test_missingtooth_resync_setup(32);
+    TEST_ASSERT_EQUAL(33, toothCurrentCount);
+
+    test_missingtooth_tooth(2000);
+    TEST_ASSERT_TRUE(currentStatus.hasSync);
+    TEST_ASSERT_EQUAL(35, toothCurrentCount);
+    TEST_ASSERT_EQUAL(0, currentStatus.syncLossCounter);
+}
+
+void test_missingtooth_resync_miscounted()
+{
+    //With teeth miscounted, the real gap comes early in the count. It must never be taken as dropped teeth and give sync at the wrong tooth
+    for(uint8_t miscounted = 1; miscounted <= 5; miscounted++)
+    {
+        test_missingtooth_resync_setup(32);
+        toothCurrentCount -= miscounted;
+        test_missingtooth_tooth(1000);
+        test_missingtooth_tooth(1000);
+        test_missingtooth_tooth(2000); //The real gap
+        if(currentStatus.hasSync == true) { TEST_ASSERT_EQUAL(1, toothCurrentCount); }
+    }
+}
+
+void test_missingtooth_resync_search()
+{
+    //A noise edge part way through tooth #11 loses sync. Once the gaps are steady again, the time since tooth #1 finds the position
+    test_missingtooth_resync_setup(9);
+    TEST_ASSERT_EQUAL(10, toothCurrentCount);
+    test_missingtooth_tooth(300);
+    test_missingtooth_tooth(700);
+    TEST_ASSERT_FALSE(currentStatus.hasSync);
+    TEST_ASSERT_EQUAL(1, currentStatus.syncLossCounter);
+
+    uint8_t tooth = 11;
+    while( (currentStatus.hasSync == false) && (tooth < 20) )
+    {
+        test_missingtooth_tooth(1000);
+        tooth++;
+    }
+    TEST_ASSERT_TRUE(currentStatus.hasSync);
+    TEST_ASSERT_EQUAL(tooth, toothCurrentCount);
+    TEST_ASSERT_LESS_OR_EQUAL(17, tooth);
+}
+
+void test_missingtooth_resync_cam()
+{
+    //The cam pulse comes half way between tooth #20 and #21. It is first learnt at 1100uS per tooth
+    test_missingtooth_resync_setup(34);
+    test_missingtooth_revolution(1100, 20); //The first cam pulse is always filtered out
+    test_missingtooth_revolution(1100, 20);
+    test_missingtooth_revolution(1100, 20);
+
+    //At 1000uS per tooth the speed has changed too much for the time since tooth #1 to place the teeth, so only the cam can find the position after a noise edge
+    test_missingtooth_tooth(2000);
+    for(uint8_t x = 2; x <= 10; x++) { test_missingtooth_tooth(1000); }
+    test_missingtooth_tooth(300);
+    test_missingtooth_tooth(700);
+    TEST_ASSERT_FALSE(currentStatus.hasSync);
+    for(uint8_t x = 12; x <= 20; x++) { test_missingtooth_tooth(1000); }
+    TEST_ASSERT_FALSE(currentStatus.hasSync);
+
+    test_missingtooth_wait(500);
+    triggerSec_missingTooth();
+    test_missingtooth_tooth(500);
+    TEST_ASSERT_TRUE(currentStatus.hasSync);
+    TEST_ASSERT_EQUAL(21, toothCurrentCount);
+}
+
+void test_missingtooth_tooth_angles()
+{
+    //Every tooth position, including the missing one, has its angle from tooth #1 in the table
+    test_setup_36_1();
+    TEST_ASSERT_EQUAL(72, toothAnglesCount);
+    TEST_ASSERT_EQUAL(0, toothAngles[0]);
+    TEST_ASSERT_EQUAL(120, toothAngles[12]);
+    TEST_ASSERT_EQUAL(350, toothAngles[35]);
+
+    //A crank speed wheel has the second revolution of the cycle stored after the first
+    TEST_ASSERT_EQUAL(36, toothAnglesRevolution);
+    TEST_ASSERT_EQUAL(360, toothAngles[36]);
+    TEST_ASSERT_EQUAL(710, toothAngles[71]);
+
+    //A cam speed wheel covers the full 720 degrees
+    configPage4.TrigSpeed = CAM_SPEED;
+    triggerSetup_missingTooth();
+    TEST_ASSERT_EQUAL(36, toothAnglesCount);
+    TEST_ASSERT_EQUAL(0, toothAnglesRevolution);
+    TEST_ASSERT_EQUAL(700, toothAngles[35]);
+    configPage4.TrigSpeed = CRANK_SPEED;
+}
+
 void testMissingTooth()
 {
   RUN_TEST(test_missingtooth_newIgn_36_1_trig0_1);
@@ -366,4 +567,12 @@ void testMissingTooth()
 
   //RUN_TEST(test_missingtooth_newIgn_60_2_trig181_2);
   //RUN_TEST(test_missingtooth_newIgn_60_2_trig182_2);
+
+  RUN_TEST(test_missingtooth_newIgn_allChannels);
+  RUN_TEST(test_missingtooth_resync_dropped_tooth);
+  RUN_TEST(test_missingtooth_resync_near_gap);
+  RUN_TEST(test_missingtooth_resync_miscounted);
+  RUN_TEST(test_missingtooth_resync_search);
+  RUN_TEST(test_missingtooth_resync_cam);
+  RUN_TEST(test_missingtooth_tooth_angles);
 }
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include <decoders.h>
+#include <globals.h>
+#include <unity.h>
+#include "sync_loss.h"
+
+static void test_setup_basic_distributor()
+{
+    //4 cylinder distributor with sync, so that any extra tooth is a sync loss
+    configPage2.nCylinders = 4;
+    configPage4.triggerFilter = 0;
+    configPage4.ignCranklock = false;
+    configPage2.perToothIgn = false;
+    currentStatus.hasSync = false;
+    currentStatus.syncLossCounter = 0;
+    triggerSetup_BasicDistributor();
+    triggerHandler = triggerPri_BasicDistributor;
+
+    lockSyncLossRecord();
+    unlockSyncLossRecord(true); //Start with no record
+
+    triggerPrimaryISR(); //First tooth gives sync on tooth #1
+}
+
+//Forces the tooth count past the end of the pattern and then sends one more tooth, which the decoder sees as too many teeth
+static void test_force_sync_loss()
+{
+    toothCurrentCount = triggerActualTeeth + 1;
+    triggerPrimaryISR();
+}
+
+void test_syncloss_record()
+{
+    test_setup_basic_distributor();
+    triggerPrimaryISR(); //Tooth #2
+    test_force_sync_loss();
+    for(uint8_t x = 0; x < (SYNC_LOSS_POST_TEETH + 2); x++) { triggerPrimaryISR(); }
+
+    const struct syncLossRecord &record = lockSyncLossRecord();
+    TEST_ASSERT_EQUAL(SYNC_LOSS_TOO_MANY_TEETH, record.reason);
+    TEST_ASSERT_EQUAL(1, record.syncLossCounter);
+    TEST_ASSERT_EQUAL(SYNC_LOSS_POST_TEETH, record.postEdges);
+
+    //The edges before the loss had sync, the one that lost it didn't and the one after got it back on tooth #1
+    struct syncLossEdge lossEdge = record.edges[SYNC_LOSS_PRE_TEETH - 1];
+    TEST_ASSERT_EQUAL(triggerActualTeeth + 1, lossEdge.tooth);
+    TEST_ASSERT_FALSE(BIT_CHECK(lossEdge.flags, SYNC_LOSS_EDGE_SYNC));
+    TEST_ASSERT_TRUE(BIT_CHECK(lossEdge.flags, SYNC_LOSS_EDGE_VALID));
+    TEST_ASSERT_FALSE(BIT_CHECK(lossEdge.flags, SYNC_LOSS_EDGE_SECONDARY));
+    TEST_ASSERT_EQUAL(2, record.edges[SYNC_LOSS_PRE_TEETH - 2].tooth);
+    TEST_ASSERT_TRUE(BIT_CHECK(record.edges[SYNC_LOSS_PRE_TEETH - 2].flags, SYNC_LOSS_EDGE_SYNC));
+    TEST_ASSERT_EQUAL(1, record.edges[SYNC_LOSS_PRE_TEETH].tooth);
+    TEST_ASSERT_TRUE(BIT_CHECK(record.edges[SYNC_LOSS_PRE_TEETH].flags, SYNC_LOSS_EDGE_SYNC));
+    unlockSyncLossRecord(false);
+}
+
+void test_syncloss_held_until_cleared()
+{
+    test_setup_basic_distributor();
+    test_force_sync_loss();
+    triggerPrimaryISR(); //Sync again
+    test_force_sync_loss(); //2nd loss must not replace the first
+
+    const struct syncLossRecord &record = lockSyncLossRecord();
+    TEST_ASSERT_EQUAL(SYNC_LOSS_TOO_MANY_TEETH, record.reason);
+    TEST_ASSERT_EQUAL(1, record.syncLossCounter);
+    TEST_ASSERT_EQUAL(2, currentStatus.syncLossCounter);
+    unlockSyncLossRecord(true);
+
+    //Cleared, so nothing is recorded until the next loss
+    lockSyncLossRecord();
+    TEST_ASSERT_EQUAL(0, record.reason);
+    unlockSyncLossRecord(false);
+    triggerPrimaryISR();
+    test_force_sync_loss();
+    lockSyncLossRecord();
+    TEST_ASSERT_EQUAL(SYNC_LOSS_TOO_MANY_TEETH, record.reason);
+    TEST_ASSERT_EQUAL(3, record.syncLossCounter);
+    unlockSyncLossRecord(false);
+}
+
+void test_syncloss_locked()
+{
+    //The record doesn't change while it is being sent
+    test_setup_basic_distributor();
+    test_force_sync_loss();
+
+    const struct syncLossRecord &record = lockSyncLossRecord();
+    triggerPrimaryISR();
+    triggerPrimaryISR();
+    TEST_ASSERT_EQUAL(0, record.postEdges);
+    unlockSyncLossRecord(false);
+
+    triggerPrimaryISR();
+    TEST_ASSERT_EQUAL(1, record.postEdges);
+}
+
+void testSyncLoss()
+{
+  RUN_TEST(test_syncloss_record);
+  RUN_TEST(test_syncloss_held_until_cleared);
+  RUN_TEST(test_syncloss_locked);
+}
@@ -4,6 +4,9 @@
 
 #include "missing_tooth/missing_tooth.h"
 #include "dual_wheel/dual_wheel.h"
+#include "sync_loss/sync_loss.h"
+#include "trigger_filter/trigger_filter.h"
+#include "gm7x/gm7x.h"
 
 void setup()
 {
@@ -17,6 +20,9 @@ void setup()
 
     testMissingTooth();
     testDualWheel();
+    testSyncLoss();
+    testTriggerFilter();
+    testGM7X();
 
     UNITY_END(); // stop unit testing
 }
@@ -0,0 +1,91 @@
+#include <decoders.h>
+#include <globals.h>
+#include <unity.h>
+#include "trigger_filter.h"
+
+static void test_setup_dualwheel_filter(bool adaptive)
+{
+    //12 tooth dual wheel that already has sync, so every primary tooth is a regular one that sets the filter
+    configPage4.triggerTeeth = 12;
+    configPage4.TrigSpeed = CRANK_SPEED;
+    configPage4.triggerFilter = 3; //Aggressive, 75%
+    configPage4.triggerFilterAdaptive = adaptive;
+    configPage2.perToothIgn = false;
+    triggerSetup_DualWheel();
+    triggerHandler = triggerPri_DualWheel;
+    triggerSecondaryHandler = triggerSec_DualWheel;
+    triggerSetFilterReset();
+
+    currentStatus.hasSync = true;
+    currentStatus.priTriggerNoise = 0;
+    currentStatus.secTriggerNoise = 0;
+    toothCurrentCount = 1;
+}
+
+//Sends a primary tooth gap uS after the last one
+static void test_send_tooth(unsigned long gap)
+{
+    toothLastToothTime = micros() - gap;
+    triggerPrimaryISR();
+}
+
+void test_triggerfilter_adaptive_primary_noise()
+{
+    test_setup_dualwheel_filter(true);
+    test_send_tooth(1000);
+    TEST_ASSERT_EQUAL(2, toothCurrentCount);
+    TEST_ASSERT_UINT32_WITHIN(20, 750, triggerFilterTime); //Steady speed, so the full filter level
+
+    //An edge straight after the tooth is noise. It's counted and never reaches the decoder
+    triggerPrimaryISR();
+    TEST_ASSERT_EQUAL(2, toothCurrentCount);
+    TEST_ASSERT_FALSE(validTrigger);
+    TEST_ASSERT_EQUAL(1, currentStatus.priTriggerNoise);
+
+    test_send_tooth(1000);
+    TEST_ASSERT_EQUAL(3, toothCurrentCount);
+    TEST_ASSERT_EQUAL(1, currentStatus.priTriggerNoise);
+    TEST_ASSERT_EQUAL(0, currentStatus.secTriggerNoise);
+}
+
+void test_triggerfilter_adaptive_acceleration()
+{
+    test_setup_dualwheel_filter(true);
+    test_send_tooth(1000);
+    test_send_tooth(800);
+
+    //The next gap is predicted to be 600uS, so the window is 75% of that rather than 75% of the last gap
+    TEST_ASSERT_UINT32_WITHIN(20, 450, triggerFilterTime);
+}
+
+void test_triggerfilter_adaptive_secondary_noise()
+{
+    test_setup_dualwheel_filter(true);
+    test_send_tooth(1000);
+
+    triggerSecFilterTime = 1000;
+    toothLastSecToothTime = micros();
+    triggerSecondaryISR();
+    TEST_ASSERT_EQUAL(1, currentStatus.secTriggerNoise);
+    TEST_ASSERT_EQUAL(0, currentStatus.priTriggerNoise);
+}
+
+void test_triggerfilter_fixed_not_counted()
+{
+    //With the fixed filter the decoder still drops the edge itself, but nothing is counted
+    test_setup_dualwheel_filter(false);
+    test_send_tooth(1000);
+    TEST_ASSERT_UINT32_WITHIN(20, 750, triggerFilterTime);
+
+    triggerPrimaryISR();
+    TEST_ASSERT_EQUAL(2, toothCurrentCount);
+    TEST_ASSERT_EQUAL(0, currentStatus.priTriggerNoise);
+}
+
+void testTriggerFilter()
+{
+  RUN_TEST(test_triggerfilter_adaptive_primary_noise);
+  RUN_TEST(test_triggerfilter_adaptive_acceleration);
+  RUN_TEST(test_triggerfilter_adaptive_secondary_noise);
+  RUN_TEST(test_triggerfilter_fixed_not_counted);
+}
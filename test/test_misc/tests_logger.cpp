@@ -0,0 +1,55 @@
+#include <globals.h>
+#include <logger.h>
+#include <unity.h>
+#include "tests_logger.h"
+
+void testLogger()
+{
+  RUN_TEST(test_logger_createLog_fields);
+  RUN_TEST(test_logger_createLog_window);
+  RUN_TEST(test_logger_getLogEntryField);
+}
+
+void test_logger_createLog_fields(void)
+{
+  currentStatus.RPM = 0x1234;
+  currentStatus.IAT = -10;
+  currentStatus.AEamount = 300;
+  currentStatus.boostDuty = 5099;
+  uint8_t logBuffer[32];
+  createLog(logBuffer, 0, sizeof(logBuffer));
+
+  TEST_ASSERT_EQUAL_UINT8(0x34, logBuffer[14]); //Low byte first
+  TEST_ASSERT_EQUAL_UINT8(0x12, logBuffer[15]);
+  TEST_ASSERT_EQUAL_UINT8(30, logBuffer[6]); //Temperatures are offset by CALIBRATION_TEMPERATURE_OFFSET
+  TEST_ASSERT_EQUAL_UINT8(150, logBuffer[16]); //AE is halved
+  TEST_ASSERT_EQUAL_UINT8(50, logBuffer[30]); //Boost duty is divided by 100
+}
+
+void test_logger_createLog_window(void)
+{
+  //A window that starts on the high byte of RPM and runs past the end of the packet
+  currentStatus.RPM = 0x1234;
+  currentStatus.AEamount = 300;
+  currentStatus.secTriggerNoise = 0xABCD;
+  uint8_t logBuffer[4];
+  createLog(logBuffer, 15, 2);
+  TEST_ASSERT_EQUAL_UINT8(0x12, logBuffer[0]);
+  TEST_ASSERT_EQUAL_UINT8(150, logBuffer[1]);
+
+  createLog(logBuffer, 123, 4);
+  TEST_ASSERT_EQUAL_UINT8(0xCD, logBuffer[0]);
+  TEST_ASSERT_EQUAL_UINT8(0xAB, logBuffer[1]);
+  TEST_ASSERT_EQUAL_UINT8(0, logBuffer[2]);
+  TEST_ASSERT_EQUAL_UINT8(0, logBuffer[3]);
+}
+
+void test_logger_getLogEntryField(void)
+{
+  currentStatus.rpmDOT = -500;
+  currentStatus.advance = 15;
+  TEST_ASSERT_EQUAL(-500, getLogEntryField(32)); //2 byte fields are signed
+  TEST_ASSERT_EQUAL(highByte((uint16_t)-500), getLogEntryField(33)); //The high byte on its own
+  TEST_ASSERT_EQUAL(15, getLogEntryField(23));
+  TEST_ASSERT_EQUAL(0, getLogEntryField(200)); //Past the end of the packet
+}
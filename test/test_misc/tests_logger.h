@@ -0,0 +1,4 @@
+extern void testLogger();
+void test_logger_createLog_fields(void);
+void test_logger_createLog_window(void);
+void test_logger_getLogEntryField(void);
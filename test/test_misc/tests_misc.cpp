@@ -5,6 +5,8 @@
 #include "tests_init.h"
 #include "tests_tables.h"
 #include "tests_PW.h"
+#include "tests_logger.h"
+#include "tests_pages.h"
 
 #define UNITY_EXCLUDE_DETAILS
 
@@ -22,6 +24,8 @@ void setup()
     testCorrections();
     testPW();
     testTables();
+    testLogger();
+    testPages();
 
     UNITY_END(); // stop unit testing
 }
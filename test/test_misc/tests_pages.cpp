@@ -0,0 +1,88 @@
+#include <globals.h>
+#include <pages.h>
+#include <page_crc.h>
+#include <unity.h>
+#include "tests_pages.h"
+
+void testPages()
+{
+  RUN_TEST(test_pages_getPageValues);
+  RUN_TEST(test_pages_setPageValues);
+  RUN_TEST(test_pages_crc_cache);
+}
+
+//Windows that start and end part way through entities, and one that runs past the end of the page
+static void test_pages_check_window(byte page, uint16_t offset, uint16_t length)
+{
+  byte values[400];
+  getPageValues(page, offset, values, length);
+  for (uint16_t x = 0; x < length; x++)
+  {
+    TEST_ASSERT_EQUAL_UINT8(getPageValue(page, offset + x), values[x]);
+  }
+}
+
+void test_pages_getPageValues(void)
+{
+  for (byte page = 1; page < getPageCount(); page++)
+  {
+    uint16_t size = getPageSize(page);
+    byte saved[400];
+    getPageValues(page, 0, saved, size);
+    for (uint16_t x = 0; x < size; x++) { setPageValue(page, x, (byte)((x * 7) + page)); }
+
+    test_pages_check_window(page, 0, size);
+    test_pages_check_window(page, 5, 70);
+    test_pages_check_window(page, size - 10, 20);
+
+    setPageValues(page, 0, saved, size);
+  }
+}
+
+void test_pages_setPageValues(void)
+{
+  //Covers the end of the boost table (Values and both axes) and the start of the VVT table
+  byte saved[240];
+  getPageValues(boostvvtPage, 0, saved, sizeof(saved));
+
+  byte values[100];
+  for (uint16_t x = 0; x < sizeof(values); x++) { values[x] = 255 - x; }
+  boostTable.cacheIsValid = true;
+  vvtTable.cacheIsValid = true;
+  boostTable.binRecips[0] = 123;
+  setPageValues(boostvvtPage, 50, values, sizeof(values));
+
+  for (uint16_t x = 0; x < sizeof(values); x++)
+  {
+    TEST_ASSERT_EQUAL_UINT8(values[x], getPageValue(boostvvtPage, 50 + x));
+  }
+  TEST_ASSERT_EQUAL_UINT8(saved[49], getPageValue(boostvvtPage, 49));
+  TEST_ASSERT_EQUAL_UINT8(saved[150], getPageValue(boostvvtPage, 150));
+  TEST_ASSERT_FALSE(boostTable.cacheIsValid);
+  TEST_ASSERT_FALSE(vvtTable.cacheIsValid);
+  TEST_ASSERT_EQUAL_UINT8(0, boostTable.binRecips[0]); //The reciprocals were recalculated. The new X axis decreases, so the bin is not valid
+
+  setPageValues(boostvvtPage, 0, saved, sizeof(saved));
+}
+
+void test_pages_crc_cache(void)
+{
+  byte value = getPageValue(veMapPage, 0);
+  uint32_t crc = calculateCRC32(veMapPage);
+
+  //A change that bypasses setPageValue() is not seen until the page is invalidated
+  fuelTable.values[0] ^= 0xFF;
+  TEST_ASSERT_EQUAL_UINT32(crc, calculateCRC32(veMapPage));
+  invalidatePageCRC(veMapPage);
+  TEST_ASSERT_TRUE(crc != calculateCRC32(veMapPage));
+  fuelTable.values[0] ^= 0xFF;
+  invalidatePageCRC(veMapPage);
+
+  //Edits through the page functions are always picked up, and only for the page they are on
+  uint32_t ignCrc = calculateCRC32(ignMapPage);
+  setPageValue(veMapPage, 0, value + 1);
+  TEST_ASSERT_TRUE(crc != calculateCRC32(veMapPage));
+  setPageValues(veMapPage, 0, &value, 1);
+  TEST_ASSERT_EQUAL_UINT32(crc, calculateCRC32(veMapPage));
+  TEST_ASSERT_EQUAL_UINT32(ignCrc, calculateCRC32(ignMapPage));
+}
@@ -0,0 +1,4 @@
+extern void testPages();
+void test_pages_getPageValues(void);
+void test_pages_setPageValues(void);
+void test_pages_crc_cache(void);
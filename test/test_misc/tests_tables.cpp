@@ -32,41 +32,42 @@ void setup_FuelTable(void)
   for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.axisX[x] = tempXAxis[x]; }
   int tempYAxis[16] = {100, 96, 90, 86, 76, 70, 66, 60, 56, 50, 46, 40, 36, 30, 26, 16};
   for (byte x = 0; x< fuelTable.ySize; x++) { fuelTable.axisY[x] = tempYAxis[x]; }
+  table3D_axisChanged(&fuelTable);
 
 
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[0][x] = pgm_read_byte_near(tempRow1 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[1][x] = pgm_read_byte_near(tempRow2 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[2][x] = pgm_read_byte_near(tempRow3 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[3][x] = pgm_read_byte_near(tempRow4 + x);}
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[4][x] = pgm_read_byte_near(tempRow5 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[5][x] = pgm_read_byte_near(tempRow6 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[6][x] = pgm_read_byte_near(tempRow7 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[7][x] = pgm_read_byte_near(tempRow8 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[8][x] = pgm_read_byte_near(tempRow9 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[9][x] = pgm_read_byte_near(tempRow10 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[10][x] = pgm_read_byte_near(tempRow11 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[11][x] = pgm_read_byte_near(tempRow12 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[12][x] = pgm_read_byte_near(tempRow13 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[13][x] = pgm_read_byte_near(tempRow14 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[14][x] = pgm_read_byte_near(tempRow15 + x); }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[15][x] = pgm_read_byte_near(tempRow16 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(0 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow1 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(1 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow2 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(2 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow3 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(3 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow4 + x);}
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(4 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow5 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(5 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow6 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(6 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow7 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(7 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow8 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(8 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow9 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(9 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow10 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(10 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow11 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(11 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow12 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(12 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow13 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(13 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow14 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(14 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow15 + x); }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(15 * fuelTable.xSize) + x] = pgm_read_byte_near(tempRow16 + x); }
   /*
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[0][x] = tempRow1[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[1][x] = tempRow2[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[2][x] = tempRow3[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[3][x] = tempRow4[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[4][x] = tempRow5[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[5][x] = tempRow6[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[6][x] = tempRow7[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[7][x] = tempRow8[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[8][x] = tempRow9[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[9][x] = tempRow10[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[10][x] = tempRow11[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[11][x] = tempRow12[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[12][x] = tempRow13[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[13][x] = tempRow14[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[14][x] = tempRow15[x]; }
-  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[15][x] = tempRow16[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(0 * fuelTable.xSize) + x] = tempRow1[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(1 * fuelTable.xSize) + x] = tempRow2[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(2 * fuelTable.xSize) + x] = tempRow3[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(3 * fuelTable.xSize) + x] = tempRow4[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(4 * fuelTable.xSize) + x] = tempRow5[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(5 * fuelTable.xSize) + x] = tempRow6[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(6 * fuelTable.xSize) + x] = tempRow7[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(7 * fuelTable.xSize) + x] = tempRow8[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(8 * fuelTable.xSize) + x] = tempRow9[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(9 * fuelTable.xSize) + x] = tempRow10[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(10 * fuelTable.xSize) + x] = tempRow11[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(11 * fuelTable.xSize) + x] = tempRow12[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(12 * fuelTable.xSize) + x] = tempRow13[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(13 * fuelTable.xSize) + x] = tempRow14[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(14 * fuelTable.xSize) + x] = tempRow15[x]; }
+  for (byte x = 0; x< fuelTable.xSize; x++) { fuelTable.values[(15 * fuelTable.xSize) + x] = tempRow16[x]; }
   */
   
 }
@@ -80,6 +81,10 @@ void testTables()
   RUN_TEST(test_tableLookup_overMaxY);
   RUN_TEST(test_tableLookup_underMinX);
   RUN_TEST(test_tableLookup_underMinY);
+  RUN_TEST(test_tableLookup_sharedAxisContext);
+  RUN_TEST(test_tableLookup_sharedAxisContextMismatch);
+  RUN_TEST(test_tableLookup_binRecip);
+  RUN_TEST(test_tableLookup_binRecipNarrow);
   //RUN_TEST(test_all_incrementing);
   
 }
@@ -175,6 +180,137 @@ void test_tableLookup_underMinY(void)
   TEST_ASSERT_EQUAL(tempVE, 34);
 }
 
+//Sets up the AFR table with the same axis as the fuel table, but different values
+static void setup_AFRTableFromFuelTable(void)
+{
+  for (byte x = 0; x < afrTable.xSize; x++) { afrTable.axisX[x] = fuelTable.axisX[x]; }
+  for (byte y = 0; y < afrTable.ySize; y++) { afrTable.axisY[y] = fuelTable.axisY[y]; }
+  for (uint16_t x = 0; x < (afrTable.xSize * afrTable.ySize); x++) { afrTable.values[x] = fuelTable.values[x] + 20; }
+  afrTable.lastXMin = 0;
+  afrTable.lastXMax = 0;
+  table3D_axisChanged(&afrTable);
+}
+
+void test_tableLookup_sharedAxisContext(void)
+{
+  //Tests that a second table with the same axis is looked up using the bins found for the first
+  initialiseAll(); //Run the main initialise function
+  setup_FuelTable();
+  setup_AFRTableFromFuelTable();
+
+  struct table3DAxisContext context;
+  context.isValid = false;
+  uint16_t tempVE = get3DTableValue(&fuelTable, &context, 53, 2250);
+  TEST_ASSERT_EQUAL(tempVE, 69);
+  TEST_ASSERT_TRUE(context.isValid);
+
+  uint16_t tempAFR = get3DTableValue(&afrTable, &context, 53, 2250);
+  TEST_ASSERT_EQUAL(0, afrTable.lastXMax); //The bin search was skipped, so the tables own last bin is unchanged
+
+  //Must match a normal lookup
+  afrTable.cacheIsValid = false;
+  TEST_ASSERT_EQUAL(get3DTableValue(&afrTable, 53, 2250), tempAFR);
+}
+
+void test_tableLookup_sharedAxisContextMismatch(void)
+{
+  //Tests that a table whose axis differs at the bins in the context still gets the correct value
+  initialiseAll(); //Run the main initialise function
+  setup_FuelTable();
+  setup_AFRTableFromFuelTable();
+  afrTable.axisX[6] = 2400; //The 2000-2500 bin is now 2000-2400
+  table3D_axisChanged(&afrTable);
+
+  struct table3DAxisContext context;
+  context.isValid = false;
+  get3DTableValue(&fuelTable, &context, 53, 2250);
+  uint16_t tempAFR = get3DTableValue(&afrTable, &context, 53, 2250);
+  TEST_ASSERT_EQUAL(6, afrTable.lastXMax); //The axis was searched
+
+  afrTable.cacheIsValid = false;
+  struct table3DAxisContext newContext;
+  newContext.isValid = false;
+  TEST_ASSERT_EQUAL(get3DTableValue(&afrTable, &newContext, 53, 2250), tempAFR);
+}
+
+void test_tableLookup_binRecip(void)
+{
+  //Tests that the weights found using the bin width reciprocals match those from a division, including after the axis is edited
+  initialiseAll(); //Run the main initialise function
+  setup_FuelTable();
+
+  struct table3DAxisContext context;
+  for(int X = 500; X < 7000; X += 7)
+  {
+    context.isValid = false;
+    get3DTableValue(&fuelTable, &context, 53, X);
+    if(context.weightsValid == false) { continue; } //All 4 corners were the same, no weights needed
+    if(context.xMaxValue == context.xMinValue) { continue; }
+
+    uint16_t expectedP = ((uint32_t)(context.X - context.xMinValue) << TABLE_SHIFT_FACTOR) / (context.xMaxValue - context.xMinValue);
+    uint16_t expectedQ = TABLE_SHIFT_POWER - ( ((uint32_t)(context.Y - context.yMaxValue) << TABLE_SHIFT_FACTOR) / (context.yMinValue - context.yMaxValue) );
+    TEST_ASSERT_EQUAL(expectedP, context.p);
+    TEST_ASSERT_EQUAL(expectedQ, context.q);
+  }
+
+  //Widen the 2000-2500 bin to 2000-3000. The same bin is used, but its reciprocal must be recalculated
+  context.isValid = false;
+  get3DTableValue(&fuelTable, &context, 53, 2250);
+  TEST_ASSERT_EQUAL(128, context.p);
+  fuelTable.axisX[6] = 3000;
+  table3D_axisChanged(&fuelTable);
+  context.isValid = false;
+  get3DTableValue(&fuelTable, &context, 53, 2250);
+  TEST_ASSERT_EQUAL(64, context.p);
+
+  //Every position in bins either side of a power of 2 (Where the stored reciprocal is largest and smallest), and spread across a very narrow and a very wide bin
+  const int16_t widths[] = { 1, 2, 3, 255, 256, 257, 1000, 30000 };
+  fuelTable.axisX[0] = 0;
+  for (byte x = 1; x < fuelTable.xSize; x++) { fuelTable.axisX[x] = fuelTable.axisX[x-1] + ((x <= 8) ? widths[x-1] : 1); }
+  for (byte x = 0; x < fuelTable.xSize; x++) { fuelTable.values[(8 * fuelTable.xSize) + x] = (x & 1) ? 200 : 0; } //Neighbouring values always differ on this row, so the weights are always needed
+  table3D_axisChanged(&fuelTable);
+  for (int32_t X = 0; X < fuelTable.axisX[8]; X += ((X < 1600) ? 1 : 7))
+  {
+    context.isValid = false;
+    get3DTableValue(&fuelTable, &context, 56, X);
+    if(context.xMaxValue == context.xMinValue) { continue; }
+    uint16_t expectedP = ((uint32_t)(context.X - context.xMinValue) << TABLE_SHIFT_FACTOR) / (context.xMaxValue - context.xMinValue);
+    TEST_ASSERT_EQUAL(expectedP, context.p);
+  }
+  setup_FuelTable();
+}
+
+void test_tableLookup_binRecipNarrow(void)
+{
+  //Tests that the top of a 1 wide bin weighs the full TABLE_SHIFT_POWER, whether the bin is found by the axis search or by the previous/next bin checks
+  initialiseAll(); //Run the main initialise function
+  setup_FuelTable();
+
+  //Bins 0-1, 1-3 and 3-4 on the X axis
+  const int16_t axis[] = { 0, 1, 3, 4 };
+  for (byte x = 0; x < fuelTable.xSize; x++) { fuelTable.axisX[x] = (x < 4) ? axis[x] : (fuelTable.axisX[x-1] + 100); }
+  for (byte x = 0; x < fuelTable.xSize; x++) { fuelTable.values[(8 * fuelTable.xSize) + x] = (x & 1) ? 200 : 0; }
+  table3D_axisChanged(&fuelTable);
+
+  struct table3DAxisContext context;
+  context.isValid = false;
+  get3DTableValue(&fuelTable, &context, 56, 2); //Searches the axis, finding the 1-3 bin
+  context.isValid = false;
+  uint16_t value = get3DTableValue(&fuelTable, &context, 56, 1); //The previous bin check finds the 0-1 bin
+  TEST_ASSERT_EQUAL(0, context.xMin);
+  TEST_ASSERT_EQUAL(TABLE_SHIFT_POWER, context.p);
+  TEST_ASSERT_EQUAL(200, value); //The same as the value on the axis
+
+  context.isValid = false;
+  get3DTableValue(&fuelTable, &context, 56, 2);
+  context.isValid = false;
+  value = get3DTableValue(&fuelTable, &context, 56, 4); //The next bin check finds the 3-4 bin
+  TEST_ASSERT_EQUAL(2, context.xMin);
+  TEST_ASSERT_EQUAL(TABLE_SHIFT_POWER, context.p);
+  TEST_ASSERT_EQUAL(200, value);
+  setup_FuelTable();
+}
+
 void test_all_incrementing(void)
 {
   //Test the when going up both the load and RPM axis that the returned value is always equal or higher to the previous one
@@ -7,6 +7,10 @@ void test_tableLookup_overMaxX(void);
 void test_tableLookup_overMaxY(void);
 void test_tableLookup_underMinX(void);
 void test_tableLookup_underMinY(void);
+void test_tableLookup_sharedAxisContext(void);
+void test_tableLookup_sharedAxisContextMismatch(void);
+void test_tableLookup_binRecip(void);
+void test_tableLookup_binRecipNarrow(void);
 void test_all_incrementing(void);
 
   //Go through the 8 rows and add the column values
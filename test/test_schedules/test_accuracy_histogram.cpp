@@ -0,0 +1,76 @@
+#include <Arduino.h>
+#include <unity.h>
+
+#include "scheduler.h"
+#include "test_schedules.h"
+
+#define TIMEOUT 1000
+#define DURATION 1000
+#define MAX_LATE_BIN 5 //16-31 ticks, 64-124uS on the Mega
+
+#if defined(SCHEDULE_ACCURACY)
+static void emptyCallback(void) {  }
+
+static void assert_histogram(uint8_t channel)
+{
+    struct scheduleAccuracy accuracy;
+    TEST_ASSERT_TRUE(getScheduleAccuracy(channel, accuracy, true));
+
+    //The start and end interrupts should be the only 2 counted, and with nothing else running neither should be very late
+    uint16_t total = 0;
+    for(uint8_t bin = 0; bin < SCHEDULE_ACCURACY_BINS; bin++)
+    {
+        total += accuracy.lateCount[bin];
+        if(bin > MAX_LATE_BIN) { TEST_ASSERT_EQUAL_UINT16(0, accuracy.lateCount[bin]); }
+    }
+    TEST_ASSERT_EQUAL_UINT16(2, total);
+
+    //Reading with reset clears the histogram
+    TEST_ASSERT_TRUE(getScheduleAccuracy(channel, accuracy, false));
+    TEST_ASSERT_EQUAL_UINT16(0, accuracy.lateCount[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, accuracy.maxLate);
+}
+
+void test_accuracy_histogram_inj1(void)
+{
+    initialiseSchedulers();
+    setFuelSchedule1(TIMEOUT, DURATION);
+    while(fuelSchedule1.Status != OFF) { scheduleTestWait(); }
+    assert_histogram(0);
+}
+
+void test_accuracy_histogram_ign1(void)
+{
+    initialiseSchedulers();
+    setIgnitionSchedule1(emptyCallback, TIMEOUT, DURATION, emptyCallback);
+    while(ignitionSchedule1.Status != OFF) { scheduleTestWait(); }
+    assert_histogram(8);
+}
+
+void test_accuracy_histogram_channels(void)
+{
+    struct scheduleAccuracy accuracy;
+    TEST_ASSERT_TRUE(getScheduleAccuracy(3, accuracy, false));
+    TEST_ASSERT_TRUE(getScheduleAccuracy(11, accuracy, false));
+    TEST_ASSERT_FALSE(getScheduleAccuracy(16, accuracy, false));
+}
+#else
+void test_accuracy_histogram_disabled(void)
+{
+    //Without SCHEDULE_ACCURACY there are no histograms to read
+    struct scheduleAccuracy accuracy;
+    TEST_ASSERT_FALSE(getScheduleAccuracy(0, accuracy, false));
+    TEST_ASSERT_FALSE(getScheduleAccuracy(8, accuracy, false));
+}
+#endif
+
+void test_accuracy_histogram(void)
+{
+#if defined(SCHEDULE_ACCURACY)
+    RUN_TEST(test_accuracy_histogram_inj1);
+    RUN_TEST(test_accuracy_histogram_ign1);
+    RUN_TEST(test_accuracy_histogram_channels);
+#else
+    RUN_TEST(test_accuracy_histogram_disabled);
+#endif
+}
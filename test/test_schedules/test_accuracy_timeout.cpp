@@ -3,6 +3,7 @@
 #include <unity.h>
 
 #include "scheduler.h"
+#include "test_schedules.h"
 #include "scheduledIO.h"
 
 #define TIMEOUT 1000
@@ -18,7 +19,7 @@ void test_accuracy_timeout_inj1(void)
     initialiseSchedulers();
     start_time = micros();
     setFuelSchedule1(TIMEOUT, DURATION);
-    while(fuelSchedule1.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule1.Status == PENDING) { scheduleTestWait(); }
     end_time = micros();
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 }
@@ -28,7 +29,7 @@ void test_accuracy_timeout_inj2(void)
     initialiseSchedulers();
     start_time = micros();
     setFuelSchedule2(TIMEOUT, DURATION);
-    while(fuelSchedule2.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule2.Status == PENDING) { scheduleTestWait(); }
     end_time = micros();
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 }
@@ -38,7 +39,7 @@ void test_accuracy_timeout_inj3(void)
     initialiseSchedulers();
     start_time = micros();
     setFuelSchedule3(TIMEOUT, DURATION);
-    while(fuelSchedule3.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule3.Status == PENDING) { scheduleTestWait(); }
     end_time = micros();
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 }
@@ -48,7 +49,7 @@ void test_accuracy_timeout_inj4(void)
     initialiseSchedulers();
     start_time = micros();
     setFuelSchedule4(TIMEOUT, DURATION);
-    while(fuelSchedule4.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule4.Status == PENDING) { scheduleTestWait(); }
     end_time = micros();
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 }
@@ -59,7 +60,7 @@ void test_accuracy_timeout_inj5(void)
     initialiseSchedulers();
     start_time = micros();
     setFuelSchedule5(TIMEOUT, DURATION);
-    while(fuelSchedule5.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule5.Status == PENDING) { scheduleTestWait(); }
     end_time = micros();
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 #endif
@@ -71,7 +72,7 @@ void test_accuracy_timeout_inj6(void)
     initialiseSchedulers();
     start_time = micros();
     setFuelSchedule6(TIMEOUT, DURATION);
-    while(fuelSchedule6.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule6.Status == PENDING) { scheduleTestWait(); }
     end_time = micros();
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 #endif
@@ -83,7 +84,7 @@ void test_accuracy_timeout_inj7(void)
     initialiseSchedulers();
     start_time = micros();
     setFuelSchedule7(TIMEOUT, DURATION);
-    while(fuelSchedule7.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule7.Status == PENDING) { scheduleTestWait(); }
     end_time = micros();
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 #endif
@@ -95,7 +96,7 @@ void test_accuracy_timeout_inj8(void)
     initialiseSchedulers();
     start_time = micros();
     setFuelSchedule8(TIMEOUT, DURATION);
-    while(fuelSchedule8.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule8.Status == PENDING) { scheduleTestWait(); }
     end_time = micros();
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 #endif
@@ -107,7 +108,7 @@ void test_accuracy_timeout_ign1(void)
     initialiseSchedulers();
     start_time = micros();
     setIgnitionSchedule1(startCallback, TIMEOUT, DURATION, endCallback);
-    while(ignitionSchedule1.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule1.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 }
 
@@ -116,7 +117,7 @@ void test_accuracy_timeout_ign2(void)
     initialiseSchedulers();
     start_time = micros();
     setIgnitionSchedule2(startCallback, TIMEOUT, DURATION, endCallback);
-    while(ignitionSchedule2.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule2.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 }
 
@@ -125,7 +126,7 @@ void test_accuracy_timeout_ign3(void)
     initialiseSchedulers();
     start_time = micros();
     setIgnitionSchedule3(startCallback, TIMEOUT, DURATION, endCallback);
-    while(ignitionSchedule3.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule3.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 }
 
@@ -134,7 +135,7 @@ void test_accuracy_timeout_ign4(void)
     initialiseSchedulers();
     start_time = micros();
     setIgnitionSchedule4(startCallback, TIMEOUT, DURATION, endCallback);
-    while(ignitionSchedule4.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule4.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 }
 
@@ -144,7 +145,7 @@ void test_accuracy_timeout_ign5(void)
     initialiseSchedulers();
     start_time = micros();
     setIgnitionSchedule5(startCallback, TIMEOUT, DURATION, endCallback);
-    while(ignitionSchedule5.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule5.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 #endif
 }
@@ -155,7 +156,7 @@ void test_accuracy_timeout_ign6(void)
     initialiseSchedulers();
     start_time = micros();
     setIgnitionSchedule6(startCallback, TIMEOUT, DURATION, endCallback);
-    while(ignitionSchedule6.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule6.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 #endif
 }
@@ -166,7 +167,7 @@ void test_accuracy_timeout_ign7(void)
     initialiseSchedulers();
     start_time = micros();
     setIgnitionSchedule7(startCallback, TIMEOUT, DURATION, endCallback);
-    while(ignitionSchedule7.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule7.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 #endif
 }
@@ -177,7 +178,7 @@ void test_accuracy_timeout_ign8(void)
     initialiseSchedulers();
     start_time = micros();
     setIgnitionSchedule8(startCallback, TIMEOUT, DURATION, endCallback);
-    while(ignitionSchedule8.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule8.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 #endif
 }
@@ -0,0 +1,163 @@
+#include <Arduino.h>
+#include <unity.h>
+
+#include "globals.h"
+#include "scheduler.h"
+#include "decoders.h"
+
+#define TIMEOUT 50000 //Long enough that nothing starts during the test
+#define DURATION 1000
+#define DELTA 20
+#define TOOTH_GAP 10
+
+extern volatile uint16_t timePerDegreex16; //crankMaths.h defines (rather than declares) its variables, so cannot be included here
+
+static void emptyCallback(void) {  }
+
+static void setup_angle(void)
+{
+    initialiseSchedulers();
+    CRANK_ANGLE_MAX_IGN = 360;
+    CRANK_ANGLE_MAX_INJ = 360;
+    timePerDegreex16 = 100 * 16; //100uS per degree
+}
+
+void test_angle_ign_before_next_tooth(void)
+{
+    setup_angle();
+    setIgnitionSchedule1(emptyCallback, TIMEOUT, DURATION, emptyCallback);
+    setIgnitionScheduleAngle(1, 100);
+
+    //5 degrees to go, so the start is now 500uS away. The dwell is kept the same
+    adjustAngleSchedules(95, TOOTH_GAP);
+    TEST_ASSERT_UINT32_WITHIN(uS_TO_TIMER_COMPARE(DELTA), uS_TO_TIMER_COMPARE(500), (COMPARE_TYPE)(ignitionSchedule1.startCompare - IGN1_COUNTER));
+    TEST_ASSERT_EQUAL_UINT32(uS_TO_TIMER_COMPARE(DURATION), (COMPARE_TYPE)(ignitionSchedule1.endCompare - ignitionSchedule1.startCompare));
+    TEST_ASSERT_EQUAL(PENDING, ignitionSchedule1.Status);
+    initialiseSchedulers();
+}
+
+void test_angle_ign_after_next_tooth(void)
+{
+    setup_angle();
+    setIgnitionSchedule1(emptyCallback, TIMEOUT, DURATION, emptyCallback);
+    setIgnitionScheduleAngle(1, 100);
+    COMPARE_TYPE startCompare = ignitionSchedule1.startCompare;
+
+    //The start is more than a tooth away (Or has already passed), so this tooth leaves it alone
+    adjustAngleSchedules(80, TOOTH_GAP);
+    TEST_ASSERT_EQUAL_UINT32(startCompare, ignitionSchedule1.startCompare);
+    adjustAngleSchedules(105, TOOTH_GAP);
+    TEST_ASSERT_EQUAL_UINT32(startCompare, ignitionSchedule1.startCompare);
+    initialiseSchedulers();
+}
+
+void test_angle_fuel_wrap(void)
+{
+    setup_angle();
+    setFuelSchedule1(TIMEOUT, DURATION);
+    setFuelScheduleAngle(1, 360 + 2); //Angles past the end of the cycle are wrapped
+
+    //8 degrees to go, across the end of the cycle
+    adjustAngleSchedules(354, TOOTH_GAP);
+    TEST_ASSERT_UINT32_WITHIN(uS_TO_TIMER_COMPARE(DELTA), uS_TO_TIMER_COMPARE(800), (COMPARE_TYPE)(fuelSchedule1.startCompare - FUEL1_COUNTER));
+    TEST_ASSERT_EQUAL_UINT32(uS_TO_TIMER_COMPARE(DURATION), (COMPARE_TYPE)(fuelSchedule1.endCompare - fuelSchedule1.startCompare));
+    initialiseSchedulers();
+}
+
+void test_angle_not_set(void)
+{
+    setup_angle();
+    setFuelSchedule1(TIMEOUT, DURATION);
+    COMPARE_TYPE startCompare = fuelSchedule1.startCompare;
+
+    //A schedule set by time only is never moved
+    adjustAngleSchedules(0, TOOTH_GAP);
+    TEST_ASSERT_EQUAL_UINT32(startCompare, fuelSchedule1.startCompare);
+    initialiseSchedulers();
+}
+
+void test_angle_missing_tooth_gap(void)
+{
+    setup_angle();
+    setIgnitionSchedule1(emptyCallback, TIMEOUT, DURATION, emptyCallback);
+    setIgnitionScheduleAngle(1, 100);
+    COMPARE_TYPE startCompare = ignitionSchedule1.startCompare;
+
+    //25 degrees to go is past a regular tooth, but not past the next tooth when there are 2 missing teeth after this one
+    adjustAngleSchedules(75, TOOTH_GAP);
+    TEST_ASSERT_EQUAL_UINT32(startCompare, ignitionSchedule1.startCompare);
+    adjustAngleSchedules(75, TOOTH_GAP * 3);
+    TEST_ASSERT_UINT32_WITHIN(uS_TO_TIMER_COMPARE(DELTA), uS_TO_TIMER_COMPARE(2500), (COMPARE_TYPE)(ignitionSchedule1.startCompare - IGN1_COUNTER));
+    initialiseSchedulers();
+}
+
+void test_angle_pending_mask(void)
+{
+    setup_angle();
+    TEST_ASSERT_EQUAL_UINT16(0, angleSchedulesPending);
+
+    //Only the channels given an angle are marked
+    setFuelSchedule1(TIMEOUT, DURATION);
+    setIgnitionSchedule2(emptyCallback, TIMEOUT, DURATION, emptyCallback);
+    setIgnitionScheduleAngle(2, 100);
+    TEST_ASSERT_EQUAL_UINT16((1U << 9), angleSchedulesPending);
+
+    //Still pending, so still marked
+    adjustAngleSchedules(0, TOOTH_GAP);
+    TEST_ASSERT_EQUAL_UINT16((1U << 9), angleSchedulesPending);
+
+    //Once the schedule has started there is nothing left to track
+    ignitionSchedule2.Status = RUNNING;
+    adjustAngleSchedules(0, TOOTH_GAP);
+    TEST_ASSERT_EQUAL_UINT16(0, angleSchedulesPending);
+    initialiseSchedulers();
+}
+
+//Sets a pending ignition schedule 3 degrees after the given angle and runs a tooth of the decoder, which should re-target it
+static void test_angle_decoder_tooth(void (*triggerHandler)(void), int16_t toothAngle)
+{
+    setup_angle();
+    configPage4.triggerAngle = 0;
+    currentStatus.RPM = 1000;
+    setIgnitionSchedule1(emptyCallback, TIMEOUT, DURATION, emptyCallback);
+    setIgnitionScheduleAngle(1, toothAngle + 3);
+
+    triggerHandler();
+    TEST_ASSERT_UINT32_WITHIN(uS_TO_TIMER_COMPARE(DELTA), uS_TO_TIMER_COMPARE(300), (COMPARE_TYPE)(ignitionSchedule1.startCompare - IGN1_COUNTER));
+    currentStatus.RPM = 0;
+    initialiseSchedulers();
+}
+
+void test_angle_decoder_24X(void)
+{
+    //Tooth #1 (12 degrees) after the cam tooth, in the 2nd revolution
+    triggerSetup_24X();
+    toothCurrentCount = 0;
+    revolutionOne = 1;
+    currentStatus.hasSync = true;
+    test_angle_decoder_tooth(triggerPri_24X, 12);
+    TEST_ASSERT_EQUAL(1, toothCurrentCount);
+}
+
+void test_angle_decoder_Jeep2000(void)
+{
+    //Tooth #2 (194 degrees)
+    triggerSetup_Jeep2000();
+    toothCurrentCount = 1;
+    currentStatus.hasSync = true;
+    triggerFilterTime = 0;
+    test_angle_decoder_tooth(triggerPri_Jeep2000, 194);
+    TEST_ASSERT_EQUAL(2, toothCurrentCount);
+}
+
+void test_angle(void)
+{
+    RUN_TEST(test_angle_ign_before_next_tooth);
+    RUN_TEST(test_angle_ign_after_next_tooth);
+    RUN_TEST(test_angle_fuel_wrap);
+    RUN_TEST(test_angle_not_set);
+    RUN_TEST(test_angle_missing_tooth_gap);
+    RUN_TEST(test_angle_pending_mask);
+    RUN_TEST(test_angle_decoder_24X);
+    RUN_TEST(test_angle_decoder_Jeep2000);
+}
@@ -0,0 +1,155 @@
+#include <Arduino.h>
+#include <unity.h>
+
+#include "scheduler.h"
+#include "test_schedules.h"
+
+#define TIMEOUT 1000
+#define DURATION 1000
+
+static volatile uint8_t startCount;
+static void countCallback(void) { startCount++; }
+static void emptyCallback(void) {  }
+
+void test_queue_push_pop(void)
+{
+    struct scheduleQueue queue = {};
+    struct scheduleEvent event;
+
+    //Events that don't overlap are all added, in order, until the queue is full
+    for(uint8_t i = 0; i < SCHEDULE_QUEUE_SIZE; i++)
+    {
+        TEST_ASSERT_TRUE(scheduleQueuePush(queue, 0, 0, 1000U * (i+1), (1000U * (i+1)) + 500U));
+    }
+    TEST_ASSERT_FALSE(scheduleQueuePush(queue, 0, 0, 1000U * (SCHEDULE_QUEUE_SIZE+1), (1000U * (SCHEDULE_QUEUE_SIZE+1)) + 500U));
+
+    for(uint8_t i = 0; i < SCHEDULE_QUEUE_SIZE; i++)
+    {
+        TEST_ASSERT_TRUE(scheduleQueuePop(queue, event));
+        TEST_ASSERT_EQUAL_UINT32(1000U * (i+1), event.startCompare);
+        TEST_ASSERT_EQUAL_UINT8(i, event.sequence);
+    }
+    TEST_ASSERT_FALSE(scheduleQueuePop(queue, event));
+}
+
+void test_queue_revise(void)
+{
+    struct scheduleQueue queue = {};
+    struct scheduleEvent event;
+
+    //The loop sets the same event again on every pass. It must replace the queued one, not be added as well
+    TEST_ASSERT_TRUE(scheduleQueuePush(queue, 0, 0, 1000, 1500));
+    TEST_ASSERT_TRUE(scheduleQueuePush(queue, 100, 0, 1100, 1600));
+    TEST_ASSERT_TRUE(scheduleQueuePop(queue, event));
+    TEST_ASSERT_EQUAL_UINT32(1100, event.startCompare);
+    TEST_ASSERT_EQUAL_UINT32(1600, event.endCompare);
+    TEST_ASSERT_FALSE(scheduleQueuePop(queue, event));
+}
+
+void test_queue_revise_later(void)
+{
+    struct scheduleQueue queue = {};
+    struct scheduleEvent event;
+
+    //The running pulse started at 0, the next is queued at 10000. Setting that pulse again with a start after it would have ended is still the same pulse
+    TEST_ASSERT_TRUE(scheduleQueuePush(queue, 100, 0, 10000, 10500));
+    TEST_ASSERT_TRUE(scheduleQueuePush(queue, 200, 0, 11000, 11500));
+    //The pulse after that is added
+    TEST_ASSERT_TRUE(scheduleQueuePush(queue, 300, 0, 20000, 20500));
+
+    TEST_ASSERT_TRUE(scheduleQueuePop(queue, event));
+    TEST_ASSERT_EQUAL_UINT32(11000, event.startCompare);
+    TEST_ASSERT_EQUAL_UINT32(11500, event.endCompare);
+    uint8_t sequence = event.sequence;
+    TEST_ASSERT_TRUE(scheduleQueuePop(queue, event));
+    TEST_ASSERT_EQUAL_UINT32(20000, event.startCompare);
+    TEST_ASSERT_EQUAL_UINT8(sequence + 1, event.sequence);
+    TEST_ASSERT_FALSE(scheduleQueuePop(queue, event));
+}
+
+void test_queue_wrap(void)
+{
+    struct scheduleQueue queue = {};
+    struct scheduleEvent event;
+
+    //Overlap is checked relative to the counter, so an event after the counter wraps is still later than one before it
+    const COMPARE_TYPE counter = (COMPARE_TYPE)(0 - 2000);
+    TEST_ASSERT_TRUE(scheduleQueuePush(queue, counter, counter, (COMPARE_TYPE)(counter + 500), (COMPARE_TYPE)(counter + 1000)));
+    TEST_ASSERT_TRUE(scheduleQueuePush(queue, counter, counter, (COMPARE_TYPE)(counter + 3000), (COMPARE_TYPE)(counter + 3500)));
+    TEST_ASSERT_TRUE(scheduleQueuePop(queue, event));
+    TEST_ASSERT_TRUE(scheduleQueuePop(queue, event));
+    TEST_ASSERT_EQUAL_UINT32((COMPARE_TYPE)(counter + 3000), event.startCompare);
+}
+
+void test_queue_multiple_inj1(void)
+{
+    initialiseSchedulers();
+    void (*startCallback)(void) = fuelSchedule1.StartCallback;
+    fuelSchedule1.StartCallback = countCallback;
+    startCount = 0;
+    setFuelSchedule1(TIMEOUT, DURATION);
+    while(fuelSchedule1.Status == PENDING) { scheduleTestWait(); }
+    //3 more pulses queued while the first is still running
+    setFuelSchedule1(2*TIMEOUT, DURATION);
+    setFuelSchedule1(4*TIMEOUT, DURATION);
+    setFuelSchedule1(6*TIMEOUT, DURATION);
+    while(fuelSchedule1.Status != OFF) { scheduleTestWait(); }
+    fuelSchedule1.StartCallback = startCallback;
+    TEST_ASSERT_EQUAL(1 + min(3, SCHEDULE_QUEUE_SIZE), startCount);
+}
+
+void test_queue_revise_inj1(void)
+{
+    initialiseSchedulers();
+    void (*startCallback)(void) = fuelSchedule1.StartCallback;
+    fuelSchedule1.StartCallback = countCallback;
+    startCount = 0;
+    setFuelSchedule1(TIMEOUT, DURATION);
+    while(fuelSchedule1.Status == PENDING) { scheduleTestWait(); }
+    //The same next pulse set twice, as the main loop does, only runs once
+    setFuelSchedule1(2*TIMEOUT, DURATION);
+    setFuelSchedule1(2*TIMEOUT, DURATION);
+    while(fuelSchedule1.Status != OFF) { scheduleTestWait(); }
+    fuelSchedule1.StartCallback = startCallback;
+    TEST_ASSERT_EQUAL(2, startCount);
+}
+
+void test_queue_revise_later_inj1(void)
+{
+    initialiseSchedulers();
+    void (*startCallback)(void) = fuelSchedule1.StartCallback;
+    fuelSchedule1.StartCallback = countCallback;
+    startCount = 0;
+    setFuelSchedule1(TIMEOUT, DURATION);
+    while(fuelSchedule1.Status == PENDING) { scheduleTestWait(); }
+    //The next pulse set again with a start after the first setting would have ended. It must only run once
+    setFuelSchedule1(4*TIMEOUT, DURATION);
+    setFuelSchedule1((4*TIMEOUT) + (3*DURATION/2), DURATION);
+    while(fuelSchedule1.Status != OFF) { scheduleTestWait(); }
+    fuelSchedule1.StartCallback = startCallback;
+    TEST_ASSERT_EQUAL(2, startCount);
+}
+
+void test_queue_multiple_ign1(void)
+{
+    initialiseSchedulers();
+    startCount = 0;
+    setIgnitionSchedule1(countCallback, TIMEOUT, DURATION, emptyCallback);
+    while(ignitionSchedule1.Status == PENDING) { scheduleTestWait(); }
+    setIgnitionSchedule1(countCallback, 2*TIMEOUT, DURATION, emptyCallback);
+    setIgnitionSchedule1(countCallback, 4*TIMEOUT, DURATION, emptyCallback);
+    while(ignitionSchedule1.Status != OFF) { scheduleTestWait(); }
+    TEST_ASSERT_EQUAL(3, startCount);
+}
+
+void test_queue(void)
+{
+    RUN_TEST(test_queue_push_pop);
+    RUN_TEST(test_queue_revise);
+    RUN_TEST(test_queue_revise_later);
+    RUN_TEST(test_queue_wrap);
+    RUN_TEST(test_queue_multiple_inj1);
+    RUN_TEST(test_queue_revise_inj1);
+    RUN_TEST(test_queue_revise_later_inj1);
+    RUN_TEST(test_queue_multiple_ign1);
+}
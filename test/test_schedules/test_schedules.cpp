@@ -1,6 +1,8 @@
 #include <Arduino.h>
 #include <unity.h>
 #include <init.h>
+#include "scheduler.h"
+#include "scheduledIO.h"
 
 #include "test_schedules.h"
 
@@ -12,6 +14,13 @@ void setup()
   UNITY_BEGIN(); // start unit testing
 
   initialiseAll(); //Run the main initialise function
+
+  //The callbacks of the fuel channels are set by initialiseAll() from the injector layout, which leaves any the (empty) config doesn't use unset. Those get empty ones so that every channel can be tested
+  for(uint8_t x = 0; x < INJ_CHANNELS; x++)
+  {
+    if(fuelSchedules[x].StartCallback == NULL) { fuelSchedules[x].StartCallback = nullCallback; }
+    if(fuelSchedules[x].EndCallback == NULL) { fuelSchedules[x].EndCallback = nullCallback; }
+  }
   test_status_initial_off();
   //test_status_off_to_pending();
   //test_status_pending_to_running();
@@ -19,6 +28,9 @@ void setup()
   //test_status_running_to_off();
   test_accuracy_timeout();
   test_accuracy_duration();
+  test_accuracy_histogram();
+  test_queue();
+  test_angle();
 
   UNITY_END(); // stop unit testing
 
@@ -1,6 +1,16 @@
 #if !defined(__TEST_SCHEDULE_H__)
 #define __TEST_SCHEDULE_H__
 
+#include "globals.h"
+
+//The tests wait for the schedules by polling their status. On the native board time only moves when nativeAdvanceTime() is called, so each poll moves it on by 1 timer tick
+static inline void scheduleTestWait(void)
+{
+#if defined(NATIVE_BOARD)
+  nativeAdvanceTime(4);
+#endif
+}
+
 void testSchedules();
 void test_status_initial_off(void);
 void test_status_off_to_pending(void);
@@ -10,5 +20,9 @@ void test_status_running_to_pending(void);
 
 void test_accuracy_timeout(void);
 void test_accuracy_duration(void);
+void test_accuracy_histogram(void);
+
+void test_queue(void);
+void test_angle(void);
 
 #endif // __TEST_SCHEDULE_H__
\ No newline at end of file
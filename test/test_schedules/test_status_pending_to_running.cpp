@@ -3,6 +3,7 @@
 #include <unity.h>
 
 #include "scheduler.h"
+#include "test_schedules.h"
 
 #define TIMEOUT 1000
 #define DURATION 1000
@@ -13,7 +14,7 @@ void test_status_pending_to_running_inj1(void)
 {
     initialiseSchedulers();
     setFuelSchedule1(TIMEOUT, DURATION);
-    while(fuelSchedule1.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule1.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule1.Status);
 }
 
@@ -21,7 +22,7 @@ void test_status_pending_to_running_inj2(void)
 {
     initialiseSchedulers();
     setFuelSchedule2(TIMEOUT, DURATION);
-    while(fuelSchedule2.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule2.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule2.Status);
 }
 
@@ -29,7 +30,7 @@ void test_status_pending_to_running_inj3(void)
 {
     initialiseSchedulers();
     setFuelSchedule3(TIMEOUT, DURATION);
-    while(fuelSchedule3.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule3.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule3.Status);
 }
 
@@ -37,7 +38,7 @@ void test_status_pending_to_running_inj4(void)
 {
     initialiseSchedulers();
     setFuelSchedule4(TIMEOUT, DURATION);
-    while(fuelSchedule4.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule4.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule4.Status);
 }
 
@@ -46,7 +47,7 @@ void test_status_pending_to_running_inj5(void)
 #if INJ_CHANNELS >= 5
     initialiseSchedulers();
     setFuelSchedule5(TIMEOUT, DURATION);
-    while(fuelSchedule5.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule5.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule5.Status);
 #endif
 }
@@ -56,7 +57,7 @@ void test_status_pending_to_running_inj6(void)
 #if INJ_CHANNELS >= 6
     initialiseSchedulers();
     setFuelSchedule6(TIMEOUT, DURATION);
-    while(fuelSchedule6.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule6.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule6.Status);
 #endif
 }
@@ -66,7 +67,7 @@ void test_status_pending_to_running_inj7(void)
 #if INJ_CHANNELS >= 7
     initialiseSchedulers();
     setFuelSchedule7(TIMEOUT, DURATION);
-    while(fuelSchedule7.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule7.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule7.Status);
 #endif
 }
@@ -76,7 +77,7 @@ void test_status_pending_to_running_inj8(void)
 #if INJ_CHANNELS >= 8
     initialiseSchedulers();
     setFuelSchedule8(TIMEOUT, DURATION);
-    while(fuelSchedule8.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule8.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule8.Status);
 #endif
 }
@@ -86,7 +87,7 @@ void test_status_pending_to_running_ign1(void)
 {
     initialiseSchedulers();
     setIgnitionSchedule1(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule1.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule1.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule1.Status);
 }
 
@@ -94,7 +95,7 @@ void test_status_pending_to_running_ign2(void)
 {
     initialiseSchedulers();
     setIgnitionSchedule2(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule2.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule2.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule2.Status);
 }
 
@@ -102,7 +103,7 @@ void test_status_pending_to_running_ign3(void)
 {
     initialiseSchedulers();
     setIgnitionSchedule3(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule3.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule3.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule3.Status);
 }
 
@@ -110,7 +111,7 @@ void test_status_pending_to_running_ign4(void)
 {
     initialiseSchedulers();
     setIgnitionSchedule4(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule4.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule4.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule4.Status);
 }
 
@@ -119,7 +120,7 @@ void test_status_pending_to_running_ign5(void)
 #if IGN_CHANNELS >= 5
     initialiseSchedulers();
     setIgnitionSchedule5(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule5.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule5.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule5.Status);
 #endif
 }
@@ -129,7 +130,7 @@ void test_status_pending_to_running_ign6(void)
 #if INJ_CHANNELS >= 6
     initialiseSchedulers();
     setIgnitionSchedule6(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule6.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule6.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule6.Status);
 #endif
 }
@@ -139,7 +140,7 @@ void test_status_pending_to_running_ign7(void)
 #if INJ_CHANNELS >= 7
     initialiseSchedulers();
     setIgnitionSchedule7(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule7.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule7.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule7.Status);
 #endif
 }
@@ -149,7 +150,7 @@ void test_status_pending_to_running_ign8(void)
 #if INJ_CHANNELS >= 8
     initialiseSchedulers();
     setIgnitionSchedule8(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule8.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule8.Status == PENDING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule8.Status);
 #endif
 }
@@ -3,6 +3,7 @@
 #include <unity.h>
 
 #include "scheduler.h"
+#include "test_schedules.h"
 
 #define TIMEOUT 1000
 #define DURATION 1000
@@ -13,9 +14,9 @@ void test_status_running_to_pending_inj1(void)
 {
     initialiseSchedulers();
     setFuelSchedule1(TIMEOUT, DURATION);
-    while(fuelSchedule1.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule1.Status == PENDING) { scheduleTestWait(); }
     setFuelSchedule1(2*TIMEOUT, DURATION);
-    while(fuelSchedule1.Status == RUNNING) /*Wait*/ ;
+    while(fuelSchedule1.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule1.Status);
 }
 
@@ -23,9 +24,9 @@ void test_status_running_to_pending_inj2(void)
 {
     initialiseSchedulers();
     setFuelSchedule2(TIMEOUT, DURATION);
-    while(fuelSchedule2.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule2.Status == PENDING) { scheduleTestWait(); }
     setFuelSchedule2(2*TIMEOUT, DURATION);
-    while(fuelSchedule2.Status == RUNNING) /*Wait*/ ;
+    while(fuelSchedule2.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule2.Status);
 }
 
@@ -33,9 +34,9 @@ void test_status_running_to_pending_inj3(void)
 {
     initialiseSchedulers();
     setFuelSchedule3(TIMEOUT, DURATION);
-    while(fuelSchedule3.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule3.Status == PENDING) { scheduleTestWait(); }
     setFuelSchedule3(2*TIMEOUT, DURATION);
-    while(fuelSchedule3.Status == RUNNING) /*Wait*/ ;
+    while(fuelSchedule3.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule3.Status);
 }
 
@@ -43,9 +44,9 @@ void test_status_running_to_pending_inj4(void)
 {
     initialiseSchedulers();
     setFuelSchedule4(TIMEOUT, DURATION);
-    while(fuelSchedule4.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule4.Status == PENDING) { scheduleTestWait(); }
     setFuelSchedule4(2*TIMEOUT, DURATION);
-    while(fuelSchedule4.Status == RUNNING) /*Wait*/ ;
+    while(fuelSchedule4.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule4.Status);
 }
 
@@ -54,9 +55,9 @@ void test_status_running_to_pending_inj5(void)
 #if INJ_CHANNELS >= 5
     initialiseSchedulers();
     setFuelSchedule5(TIMEOUT, DURATION);
-    while(fuelSchedule5.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule5.Status == PENDING) { scheduleTestWait(); }
     setFuelSchedule5(2*TIMEOUT, DURATION);
-    while(fuelSchedule5.Status == RUNNING) /*Wait*/ ;
+    while(fuelSchedule5.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule5.Status);
 #endif
 }
@@ -66,9 +67,9 @@ void test_status_running_to_pending_inj6(void)
 #if INJ_CHANNELS >= 6
     initialiseSchedulers();
     setFuelSchedule6(TIMEOUT, DURATION);
-    while(fuelSchedule6.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule6.Status == PENDING) { scheduleTestWait(); }
     setFuelSchedule6(2*TIMEOUT, DURATION);
-    while(fuelSchedule6.Status == RUNNING) /*Wait*/ ;
+    while(fuelSchedule6.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule6.Status);
 #endif
 }
@@ -78,9 +79,9 @@ void test_status_running_to_pending_inj7(void)
 #if INJ_CHANNELS >= 7
     initialiseSchedulers();
     setFuelSchedule7(TIMEOUT, DURATION);
-    while(fuelSchedule7.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule7.Status == PENDING) { scheduleTestWait(); }
     setFuelSchedule7(2*TIMEOUT, DURATION);
-    while(fuelSchedule7.Status == RUNNING) /*Wait*/ ;
+    while(fuelSchedule7.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule7.Status);
 #endif
 }
@@ -90,9 +91,9 @@ void test_status_running_to_pending_inj8(void)
 #if INJ_CHANNELS >= 8
     initialiseSchedulers();
     setFuelSchedule8(TIMEOUT, DURATION);
-    while(fuelSchedule8.Status == PENDING) /*Wait*/ ;
+    while(fuelSchedule8.Status == PENDING) { scheduleTestWait(); }
     setFuelSchedule8(2*TIMEOUT, DURATION);
-    while(fuelSchedule8.Status == RUNNING) /*Wait*/ ;
+    while(fuelSchedule8.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule8.Status);
 #endif
 }
@@ -102,9 +103,9 @@ void test_status_running_to_pending_ign1(void)
 {
     initialiseSchedulers();
     setIgnitionSchedule1(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule1.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule1.Status == PENDING) { scheduleTestWait(); }
     setIgnitionSchedule1(emptyCallback, 2*TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule1.Status == RUNNING) /*Wait*/ ;
+    while(ignitionSchedule1.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule1.Status);
 }
 
@@ -112,9 +113,9 @@ void test_status_running_to_pending_ign2(void)
 {
     initialiseSchedulers();
     setIgnitionSchedule2(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule2.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule2.Status == PENDING) { scheduleTestWait(); }
     setIgnitionSchedule2(emptyCallback, 2*TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule2.Status == RUNNING) /*Wait*/ ;
+    while(ignitionSchedule2.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule2.Status);
 }
 
@@ -122,9 +123,9 @@ void test_status_running_to_pending_ign3(void)
 {
     initialiseSchedulers();
     setIgnitionSchedule3(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule3.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule3.Status == PENDING) { scheduleTestWait(); }
     setIgnitionSchedule3(emptyCallback, 2*TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule3.Status == RUNNING) /*Wait*/ ;
+    while(ignitionSchedule3.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule3.Status);
 }
 
@@ -132,9 +133,9 @@ void test_status_running_to_pending_ign4(void)
 {
     initialiseSchedulers();
     setIgnitionSchedule4(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule4.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule4.Status == PENDING) { scheduleTestWait(); }
     setIgnitionSchedule4(emptyCallback, 2*TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule4.Status == RUNNING) /*Wait*/ ;
+    while(ignitionSchedule4.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule4.Status);
 }
 
@@ -143,9 +144,9 @@ void test_status_running_to_pending_ign5(void)
 #if IGN_CHANNELS >= 5
     initialiseSchedulers();
     setIgnitionSchedule5(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule5.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule5.Status == PENDING) { scheduleTestWait(); }
     setIgnitionSchedule5(emptyCallback, 2*TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule5.Status == RUNNING) /*Wait*/ ;
+    while(ignitionSchedule5.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule5.Status);
 #endif
 }
@@ -155,9 +156,9 @@ void test_status_running_to_pending_ign6(void)
 #if INJ_CHANNELS >= 6
     initialiseSchedulers();
     setIgnitionSchedule6(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule6.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule6.Status == PENDING) { scheduleTestWait(); }
     setIgnitionSchedule6(emptyCallback, 2*TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule6.Status == RUNNING) /*Wait*/ ;
+    while(ignitionSchedule6.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule6.Status);
 #endif
 }
@@ -167,9 +168,9 @@ void test_status_running_to_pending_ign7(void)
 #if INJ_CHANNELS >= 7
     initialiseSchedulers();
     setIgnitionSchedule7(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule7.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule7.Status == PENDING) { scheduleTestWait(); }
     setIgnitionSchedule7(emptyCallback, 2*TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule7.Status == RUNNING) /*Wait*/ ;
+    while(ignitionSchedule7.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule7.Status);
 #endif
 }
@@ -179,9 +180,9 @@ void test_status_running_to_pending_ign8(void)
 #if INJ_CHANNELS >= 8
     initialiseSchedulers();
     setIgnitionSchedule8(emptyCallback, TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule8.Status == PENDING) /*Wait*/ ;
+    while(ignitionSchedule8.Status == PENDING) { scheduleTestWait(); }
     setIgnitionSchedule8(emptyCallback, 2*TIMEOUT, DURATION, emptyCallback);
-    while(ignitionSchedule8.Status == RUNNING) /*Wait*/ ;
+    while(ignitionSchedule8.Status == RUNNING) { scheduleTestWait(); }
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule8.Status);
 #endif
 }